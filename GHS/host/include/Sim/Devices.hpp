@@ -0,0 +1,80 @@
+#ifndef DEVICES_HPP
+#define DEVICES_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include "Sim/I2CSim.hpp"
+
+// Register/command level models of the I2C parts on the GHS board. Only the
+// behavior the GHS drivers rely on is modeled.
+
+namespace Sim {
+
+// SHT31 temperature and humidity. Single shot measurement commands latch a
+// 6 byte reply, temp MSB/LSB/CRC followed by hum MSB/LSB/CRC.
+class SHT31 : public I2CDevice {
+    private:
+    std::mutex mtx;
+    uint8_t reply[6];
+    size_t replyLen;
+    uint16_t status; // Status register, bit 13 is the heater.
+    void latch(uint16_t a, uint16_t b);
+
+    public:
+    SHT31();
+    static uint8_t crc8(const uint8_t* buf, size_t len);
+    esp_err_t write(const uint8_t* buf, size_t len) override;
+    esp_err_t read(uint8_t* buf, size_t len) override;
+};
+
+// AS7341 spectral sensor. Holds the register file, the register bank select,
+// and the SMUX RAM. Enabling SMUX completes immediately and maps either F1-F4
+// or F5-F8 onto ADC0 - ADC3, enabling the spectrum latches the channel data.
+class AS7341 : public I2CDevice {
+    private:
+    std::mutex mtx;
+    uint8_t regs[256]; // Register file, 0x60 - 0x74 are low bank.
+    uint8_t smux[0x20]; // Lower bank SMUX RAM 0x00 - 0x13.
+    uint8_t pointer; // Register of the next read.
+    bool lowBank; // True when 0xA9 bit 3 is set.
+    bool lowGroup; // True if SMUX maps F1 - F4.
+    void measure();
+
+    public:
+    AS7341();
+    esp_err_t write(const uint8_t* buf, size_t len) override;
+    esp_err_t read(uint8_t* buf, size_t len) override;
+};
+
+// ADS1115 4 channel ADC. Single shot conversions complete immediately. The
+// source selects which environment voltages are presented on AIN0 - AIN3.
+class ADS1115 : public I2CDevice {
+    public:
+    enum class SOURCE {SOIL, PHOTO};
+
+    private:
+    std::mutex mtx;
+    SOURCE src;
+    uint8_t pointer; // 0 conversion, 1 config.
+    uint16_t config;
+    int16_t conversion;
+
+    public:
+    ADS1115(SOURCE src);
+    esp_err_t write(const uint8_t* buf, size_t len) override;
+    esp_err_t read(uint8_t* buf, size_t len) override;
+};
+
+// SSD1306 OLED. Accepts all command and data writes.
+class SSD1306 : public I2CDevice {
+    public:
+    esp_err_t write(const uint8_t* buf, size_t len) override;
+    esp_err_t read(uint8_t* buf, size_t len) override;
+};
+
+void attachBoard(); // Attaches the GHS board devices at their addresses.
+
+}
+
+#endif // DEVICES_HPP
@@ -0,0 +1,47 @@
+#ifndef ENVIRONMENT_HPP
+#define ENVIRONMENT_HPP
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace Sim {
+
+#define ENV_COLOR_CHANNELS 10 // F1 - F8, Clear, NIR.
+#define ENV_ADC_CHANNELS 4 // ADS1115 inputs AIN0 - AIN3.
+
+// Physical conditions seen by the simulated sensors at a point in time.
+// Spectral values are counts at 50 ms integration and 256x gain, which the
+// AS7341 sim scales to the configured ATIME, ASTEP and AGAIN.
+struct Readings {
+    float tempC; // Celcius.
+    float hum; // Relative humidity percent.
+    float color[ENV_COLOR_CHANNELS]; // Counts, F1 - F8, Clear, NIR.
+    float photoV[ENV_ADC_CHANNELS]; // Photoresistor ADC volts.
+    float soilV[ENV_ADC_CHANNELS]; // Soil ADC volts.
+};
+
+// Requires time in micros since boot, and the readings to populate.
+using EnvModel = std::function<void(uint64_t micros, Readings &out)>;
+
+// Source of all simulated sensor values. Defaults to a diurnal model with a
+// 24 hour period starting at midnight on boot. Replace with setModel() to
+// drive the sensors from a script or trace.
+class Environment {
+    private:
+    std::mutex mtx;
+    EnvModel model;
+    Environment();
+    Environment(const Environment&) = delete; // prevent copying
+    Environment &operator=(const Environment&) = delete; // prevent assignment
+
+    public:
+    static Environment* get();
+    void setModel(EnvModel model);
+    Readings sample(); // Samples the model at the current host clock time.
+    static void diurnal(uint64_t micros, Readings &out); // Default model.
+};
+
+}
+
+#endif // ENVIRONMENT_HPP
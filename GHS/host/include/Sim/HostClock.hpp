@@ -0,0 +1,82 @@
+#ifndef HOSTCLOCK_HPP
+#define HOSTCLOCK_HPP
+
+#include <cstdint>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <list>
+#include <functional>
+
+namespace Sim {
+
+// Single time source of the host build. esp_timer_get_time(), the kernel tick
+// count, vTaskDelay, ets_delay_us and semaphore timeouts all block and read
+// through here, so that every timing path within the firmware agrees.
+//
+// REAL mode follows the host steady clock. VIRTUAL mode only moves time when
+// every participating thread (firmware tasks, the http server thread, and the
+// harness) is blocked within the kernel, at which point time jumps to the
+// earliest pending deadline. Simulated time then advances as fast as the CPU
+// allows, and work between two blocking calls takes zero simulated time.
+//
+// ATTENTION. A participant blocked outside of the kernel (a static local
+// init guard, a std::mutex) still counts as running, and would stall virtual
+// time if it waits on a participant sleeping within the kernel. A watchdog
+// advances the clock whenever the kernel has been idle for
+// CLOCK_STALL_MS of real time with participants still running.
+
+#define CLOCK_FOREVER UINT64_MAX // Deadline of an untimed block.
+#define CLOCK_STALL_MS 2 // Real millis of kernel inactivity before advance.
+
+enum class ClockMode {REAL, VIRTUAL};
+
+class HostClock {
+    private:
+    struct Waiter {
+        std::condition_variable cv;
+        const void* key; // Object waited on, used by wake().
+        uint64_t deadline; // Micros, or CLOCK_FOREVER.
+        bool woken;
+    };
+
+    std::mutex mtx; // Kernel lock, guards all blocking state.
+    std::list<Waiter*> waiters;
+    std::chrono::steady_clock::time_point start; // Host process start.
+    std::atomic<uint64_t> now; // Virtual time in micros.
+    ClockMode mode;
+    uint32_t running; // Participants not blocked within the kernel.
+    uint32_t participants;
+    bool stalled; // All participants blocked with no deadline.
+    std::atomic<uint64_t> activity; // Kernel calls, used by the watchdog.
+    uint64_t forced; // Advances made by the watchdog.
+    HostClock();
+    HostClock(const HostClock&) = delete; // prevent copying
+    HostClock &operator=(const HostClock&) = delete; // prevent assignment
+    void advance();
+    void suspendSelf(Waiter &w, std::unique_lock<std::mutex> &lock);
+    void watchdog();
+
+    public:
+    static HostClock* get();
+    void setMode(ClockMode mode);
+    ClockMode getMode() const;
+    uint64_t micros();
+    std::mutex &kernelLock();
+    void enroll(); // Counts a new participant, called by its creator.
+    void adopt(); // Marks the calling thread as the enrolled participant.
+    void attach(); // enroll() and adopt() for the calling thread.
+    void detach(); // Calling participant exits.
+    void withdraw(); // Reverses an enroll() with no thread adopted.
+    bool block(std::unique_lock<std::mutex> &lock, const void* key,
+        uint64_t deadline, const std::function<bool()> &pred);
+
+    void wake(const void* key);
+    void sleepUntilMicros(uint64_t target);
+    uint64_t getForced(); // Returns the count of watchdog advances.
+};
+
+}
+
+#endif // HOSTCLOCK_HPP
@@ -0,0 +1,41 @@
+#ifndef HTTPDSIM_HPP
+#define HTTPDSIM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "esp_http_server.h"
+
+namespace Sim {
+
+// Client side of the host http server. All calls are executed on the server
+// thread, in order, as the ESP-IDF httpd task would process them, and block
+// the caller until the handler has returned. Returns false/-1 if no server
+// is running or the URI is not registered.
+
+// Requires fd, payload, length, and frame type of a frame sent by the
+// firmware to the client through httpd_ws_send_frame_async.
+using WsReceiver = std::function<void(int fd, const uint8_t* payload,
+    size_t len, httpd_ws_type_t type)>;
+
+bool serverRunning();
+void setWsReceiver(WsReceiver receiver);
+int wsConnect(const char* uri = "/ws"); // Returns fd once handshaked, or -1.
+bool wsSend(int fd, const char* text, const char* uri = "/ws");
+
+// Requires fd and control frame type, PING, PONG or CLOSE. Reaches the
+// handler only if registered with handle_ws_control_frames, as ESP-IDF.
+bool wsControl(int fd, httpd_ws_type_t type, const char* uri = "/ws");
+void wsClose(int fd);
+
+// Requires URI with optional query, body, and response. Issues the request
+// and populates the response body. Returns true if handled with ESP_OK.
+bool request(const char* uri, std::string &response, 
+    httpd_method_t method = HTTP_GET, const std::string &body = "");
+
+void drain(); // Blocks until all queued server work has run.
+
+}
+
+#endif // HTTPDSIM_HPP
@@ -0,0 +1,37 @@
+#ifndef I2CSIM_HPP
+#define I2CSIM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+
+namespace Sim {
+
+// Simulated I2C client. The host master routes every transfer by device
+// address to the attached client, which responds as the physical part would
+// at the register/command level. transmit_receive is issued as a write
+// immediately followed by a read without releasing the device.
+
+class I2CDevice {
+    public:
+    virtual ~I2CDevice() = default;
+    virtual esp_err_t write(const uint8_t* buf, size_t len) = 0;
+    virtual esp_err_t read(uint8_t* buf, size_t len) = 0;
+};
+
+void attachDevice(uint16_t addr, I2CDevice* dev); // nullptr detaches.
+
+// Requires address and error. Forces every transfer to the address to fail
+// with err until cleared by passing ESP_OK. Used to exercise recovery paths.
+void setFault(uint16_t addr, esp_err_t err);
+
+struct I2CStats { // Per address transfer counters.
+    uint32_t tx, rx, txrx, errors;
+    uint64_t bytes;
+};
+
+I2CStats getStats(uint16_t addr);
+
+}
+
+#endif // I2CSIM_HPP
@@ -0,0 +1,27 @@
+#ifndef SIM_HPP
+#define SIM_HPP
+
+#include "driver/gpio.h"
+
+// Harness side controls of the host build. These do not exist on target and
+// must only be called from host/src.
+
+namespace Sim {
+
+void setPin(gpio_num_t pin, int level); // Drives an input pin.
+int getPin(gpio_num_t pin); // Returns the current pin level.
+uint32_t getToggles(gpio_num_t pin); // Returns output level changes.
+
+// Data partition flash, erased on start unless backed by a file, which 
+// persists it across runs, as flash does across restarts.
+bool setFlashFile(const char* path); // Loads, or creates, the backing file.
+void getFlashStats(uint32_t &writes, uint32_t &erases, uint64_t &bytes);
+
+// Spiffs mount, a temporary directory removed upon exit unless set, which
+// keeps its files across runs.
+bool setSpiffsDir(const char* path); // Creates the directory if absent.
+void removeSpiffsTemp(); // Removes the temporary directory, if any.
+
+}
+
+#endif // SIM_HPP
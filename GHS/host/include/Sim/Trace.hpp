@@ -0,0 +1,49 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Sim/Environment.hpp"
+
+namespace Sim {
+
+// Scripted sensor trace. Loaded from a CSV whose first row names the columns,
+// and whose first column is the time in seconds since boot. Recognized
+// columns are tempC, hum, F1 - F8, clear, nir, photo0 - photo3, and
+// soil0 - soil3. Values are linearly interpolated between rows, columns that
+// are not present fall back to the diurnal model. Rows must be in ascending
+// time. If looped, the trace repeats with a period of the final row time.
+//
+// Example, a cold night and a relay worthy hot afternoon:
+//   t,tempC,hum
+//   0,12,80
+//   43200,35,30
+//   86400,12,80
+
+#define TRACE_FIELD_COUNT (2 + ENV_COLOR_CHANNELS + 2 * ENV_ADC_CHANNELS)
+
+class Trace {
+    private:
+    struct Row {
+        double t; // Seconds since boot.
+        float val[TRACE_FIELD_COUNT];
+    };
+
+    std::vector<Row> rows;
+    bool used[TRACE_FIELD_COUNT]; // Column present in the trace.
+    bool loop;
+    static float* field(Readings &r, int idx);
+    static int fieldIdx(const std::string &name);
+
+    public:
+    Trace();
+    bool load(const char* path, std::string &err);
+    void setLoop(bool loop);
+    void apply(uint64_t micros, Readings &out) const;
+    void install() const; // Copies the trace into the environment model.
+};
+
+}
+
+#endif // TRACE_HPP
@@ -0,0 +1,24 @@
+#ifndef HOST_CJSON_H
+#define HOST_CJSON_H
+
+// Host cJSON. Only the WAP setup and OTA handlers parse JSON, neither of
+// which is exercised on the host, so parsing always fails and handlers take
+// their invalid JSON path.
+
+struct cJSON {
+    cJSON* next;
+    cJSON* prev;
+    cJSON* child;
+    int type;
+    char* valuestring;
+    int valueint;
+    double valuedouble;
+    char* string;
+};
+
+cJSON* cJSON_Parse(const char* value);
+cJSON* cJSON_GetObjectItem(const cJSON* object, const char* key);
+int cJSON_IsString(const cJSON* item);
+void cJSON_Delete(cJSON* item);
+
+#endif // HOST_CJSON_H
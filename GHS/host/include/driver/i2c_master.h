@@ -0,0 +1,62 @@
+#ifndef HOST_I2C_MASTER_H
+#define HOST_I2C_MASTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+// Host I2C master. Transfers are routed by device address to the simulated
+// devices registered in i2cHost.cpp, see Sim/I2CSim.hpp.
+
+struct hostI2CBus;
+struct hostI2CDev;
+typedef hostI2CBus* i2c_master_bus_handle_t;
+typedef hostI2CDev* i2c_master_dev_handle_t;
+
+typedef enum {I2C_NUM_0, I2C_NUM_1} i2c_port_num_t;
+typedef enum {I2C_CLK_SRC_DEFAULT} i2c_clock_source_t;
+typedef enum {I2C_ADDR_BIT_LEN_7, I2C_ADDR_BIT_LEN_10} i2c_addr_bit_len_t;
+
+struct i2c_master_bus_config_t {
+    i2c_port_num_t i2c_port;
+    gpio_num_t sda_io_num;
+    gpio_num_t scl_io_num;
+    i2c_clock_source_t clk_source;
+    uint8_t glitch_ignore_cnt;
+    int intr_priority;
+    size_t trans_queue_depth;
+    struct {
+        uint32_t enable_internal_pullup: 1;
+    } flags;
+};
+
+struct i2c_device_config_t {
+    i2c_addr_bit_len_t dev_addr_length;
+    uint16_t device_address;
+    uint32_t scl_speed_hz;
+    uint32_t scl_wait_us;
+    struct {
+        uint32_t disable_ack_check: 1;
+    } flags;
+};
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t* conf,
+    i2c_master_bus_handle_t* handle);
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t handle);
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus,
+    const i2c_device_config_t* conf, i2c_master_dev_handle_t* handle);
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle);
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev,
+    const uint8_t* writeBuf, size_t writeSize, int timeout_ms);
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t dev, uint8_t* readBuf,
+    size_t readSize, int timeout_ms);
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t dev,
+    const uint8_t* writeBuf, size_t writeSize, uint8_t* readBuf,
+    size_t readSize, int timeout_ms);
+
+#endif // HOST_I2C_MASTER_H
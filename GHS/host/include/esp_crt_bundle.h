@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_CRT_BUNDLE_H
+#define HOST_ESP_CRT_BUNDLE_H
+
+#include "esp_err.h"
+
+esp_err_t esp_crt_bundle_attach(void* conf);
+
+#endif // HOST_ESP_CRT_BUNDLE_H
@@ -0,0 +1,22 @@
+#ifndef HOST_ESP_EVENT_H
+#define HOST_ESP_EVENT_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t base,
+    int32_t id, void* data);
+
+extern esp_event_base_t const IP_EVENT;
+extern esp_event_base_t const WIFI_EVENT;
+#define ESP_EVENT_ANY_ID -1
+
+esp_err_t esp_event_loop_create_default();
+esp_err_t esp_event_handler_register(esp_event_base_t base, int32_t id,
+    esp_event_handler_t handler, void* arg);
+
+esp_err_t esp_event_handler_unregister(esp_event_base_t base, int32_t id,
+    esp_event_handler_t handler);
+
+#endif // HOST_ESP_EVENT_H
@@ -0,0 +1,48 @@
+#ifndef HOST_ESP_HTTP_CLIENT_H
+#define HOST_ESP_HTTP_CLIENT_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+
+// Host http client. Outbound web requests (alerts, OTA) are not simulated,
+// every connection attempt fails to open, see netHost.cpp.
+
+struct esp_http_client;
+typedef esp_http_client* esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_METHOD_GET, HTTP_METHOD_POST, HTTP_METHOD_PUT, HTTP_METHOD_PATCH,
+    HTTP_METHOD_DELETE, HTTP_METHOD_HEAD
+} esp_http_client_method_t;
+
+struct esp_http_client_config_t {
+    const char* url;
+    const char* cert_pem;
+    esp_http_client_method_t method;
+    int timeout_ms;
+    bool skip_cert_common_name_check;
+    esp_err_t (*crt_bundle_attach)(void* conf);
+};
+
+esp_http_client_handle_t esp_http_client_init(
+    const esp_http_client_config_t* config);
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client,
+    const char* key, const char* value);
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client,
+    const char* data, int len);
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int writeLen);
+int esp_http_client_write(esp_http_client_handle_t client, const char* buf,
+    int len);
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client);
+int esp_http_client_read(esp_http_client_handle_t client, char* buf,
+    int len);
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+#endif // HOST_ESP_HTTP_CLIENT_H
@@ -0,0 +1,123 @@
+#ifndef HOST_ESP_HTTP_SERVER_H
+#define HOST_ESP_HTTP_SERVER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <sys/types.h>
+#include "esp_err.h"
+
+// Host http server. There is no listening socket; requests and websocket
+// frames are injected through Sim/HttpdSim.hpp and dispatched to the
+// registered URI handlers. Work queued with httpd_queue_work runs on a
+// dedicated server thread as it would within the ESP-IDF httpd task.
+
+typedef void* httpd_handle_t;
+
+typedef enum {HTTP_DELETE = 0, HTTP_GET = 1, HTTP_HEAD = 2, HTTP_POST = 3,
+    HTTP_PUT = 4} httpd_method_t;
+
+struct httpd_req_t {
+    httpd_handle_t handle;
+    int method;
+    const char* uri;
+    size_t content_len;
+    void* aux; // Host request context.
+    void* user_ctx;
+    void* sess_ctx;
+};
+
+struct httpd_uri_t {
+    const char* uri;
+    httpd_method_t method;
+    esp_err_t (*handler)(httpd_req_t* req);
+    void* user_ctx;
+    bool is_websocket;
+    bool handle_ws_control_frames;
+    const char* supported_subprotocol;
+};
+
+typedef enum {
+    HTTPD_WS_TYPE_CONTINUE = 0x0, HTTPD_WS_TYPE_TEXT = 0x1,
+    HTTPD_WS_TYPE_BINARY = 0x2, HTTPD_WS_TYPE_CLOSE = 0x8,
+    HTTPD_WS_TYPE_PING = 0x9, HTTPD_WS_TYPE_PONG = 0xA
+} httpd_ws_type_t;
+
+struct httpd_ws_frame_t {
+    bool final;
+    bool fragmented;
+    httpd_ws_type_t type;
+    uint8_t* payload;
+    size_t len;
+};
+
+typedef bool (*httpd_uri_match_func_t)(const char* templ, const char* uri,
+    size_t len);
+
+struct httpd_config_t {
+    unsigned task_priority;
+    size_t stack_size;
+    int core_id;
+    uint16_t server_port;
+    uint16_t ctrl_port;
+    uint16_t max_open_sockets;
+    uint16_t max_uri_handlers;
+    uint16_t max_resp_headers;
+    uint16_t backlog_conn;
+    bool lru_purge_enable;
+    uint16_t recv_wait_timeout;
+    uint16_t send_wait_timeout;
+    httpd_uri_match_func_t uri_match_fn;
+};
+
+typedef httpd_config_t httpd_config;
+
+#define HTTPD_DEFAULT_CONFIG() { \
+    .task_priority = 5, .stack_size = 4096, .core_id = 0x7FFFFFFF, \
+    .server_port = 80, .ctrl_port = 32768, .max_open_sockets = 7, \
+    .max_uri_handlers = 8, .max_resp_headers = 8, .backlog_conn = 5, \
+    .lru_purge_enable = false, .recv_wait_timeout = 5, \
+    .send_wait_timeout = 5, .uri_match_fn = NULL}
+
+typedef void (*httpd_work_fn_t)(void* arg);
+
+esp_err_t httpd_start(httpd_handle_t* handle, const httpd_config_t* config);
+esp_err_t httpd_stop(httpd_handle_t handle);
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+    const httpd_uri_t* uri);
+
+esp_err_t httpd_resp_set_type(httpd_req_t* req, const char* type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t* req, const char* field,
+    const char* value);
+esp_err_t httpd_resp_send(httpd_req_t* req, const char* buf, ssize_t len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t* req, const char* buf, 
+    ssize_t len);
+esp_err_t httpd_resp_sendstr(httpd_req_t* req, const char* str);
+int httpd_req_recv(httpd_req_t* req, char* buf, size_t len);
+int httpd_req_to_sockfd(httpd_req_t* req);
+esp_err_t httpd_req_get_url_query_str(httpd_req_t* req, char* buf,
+    size_t len);
+
+esp_err_t httpd_query_key_value(const char* query, const char* key,
+    char* val, size_t len);
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work,
+    void* arg);
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t* req, httpd_ws_frame_t* pkt,
+    size_t maxLen);
+
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd,
+    httpd_ws_frame_t* frame);
+
+esp_err_t httpd_ws_send_frame(httpd_req_t* req, httpd_ws_frame_t* frame);
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd);
+
+typedef enum {
+    HTTPD_WS_CLIENT_INVALID = 0x0, HTTPD_WS_CLIENT_HTTP = 0x1,
+    HTTPD_WS_CLIENT_WEBSOCKET = 0x2
+} httpd_ws_client_info_t;
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd);
+
+#endif // HOST_ESP_HTTP_SERVER_H
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_HTTPS_OTA_H
+#define HOST_ESP_HTTPS_OTA_H
+
+#include "esp_http_client.h"
+
+#endif // HOST_ESP_HTTPS_OTA_H
@@ -0,0 +1,13 @@
+#ifndef HOST_ESP_LOG_H
+#define HOST_ESP_LOG_H
+
+typedef enum {
+    ESP_LOG_NONE, ESP_LOG_ERROR, ESP_LOG_WARN, ESP_LOG_INFO, ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+inline void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    (void)tag; (void)level;
+}
+
+#endif // HOST_ESP_LOG_H
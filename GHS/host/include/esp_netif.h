@@ -0,0 +1,48 @@
+#ifndef HOST_ESP_NETIF_H
+#define HOST_ESP_NETIF_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+#include "esp_event.h"
+
+#define ESP_ERR_ESP_NETIF_BASE 0x5000
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED (ESP_ERR_ESP_NETIF_BASE + 0x03)
+#define ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED (ESP_ERR_ESP_NETIF_BASE + 0x04)
+
+struct esp_netif_obj;
+typedef esp_netif_obj esp_netif_t;
+
+struct esp_ip4_addr_t {
+    uint32_t addr;
+};
+
+struct esp_netif_ip_info_t {
+    esp_ip4_addr_t ip;
+    esp_ip4_addr_t netmask;
+    esp_ip4_addr_t gw;
+};
+
+struct ip_event_got_ip_t {
+    esp_netif_t* esp_netif;
+    esp_netif_ip_info_t ip_info;
+    bool ip_changed;
+};
+
+typedef enum {IP_EVENT_STA_GOT_IP, IP_EVENT_STA_LOST_IP} ip_event_t;
+
+#define IP4_ADDR(ipaddr, a, b, c, d) (ipaddr)->addr = \
+    ((uint32_t)((d) & 0xff) << 24) | ((uint32_t)((c) & 0xff) << 16) | \
+    ((uint32_t)((b) & 0xff) << 8) | (uint32_t)((a) & 0xff)
+
+esp_err_t esp_netif_init();
+esp_netif_t* esp_netif_create_default_wifi_ap();
+esp_netif_t* esp_netif_create_default_wifi_sta();
+esp_err_t esp_netif_dhcps_start(esp_netif_t* netif);
+esp_err_t esp_netif_dhcps_stop(esp_netif_t* netif);
+esp_err_t esp_netif_set_ip_info(esp_netif_t* netif,
+    const esp_netif_ip_info_t* info);
+
+char* esp_ip4addr_ntoa(const esp_ip4_addr_t* addr, char* buf, int len);
+
+#endif // HOST_ESP_NETIF_H
@@ -0,0 +1,24 @@
+#ifndef HOST_ESP_OTA_OPS_H
+#define HOST_ESP_OTA_OPS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+typedef uint32_t esp_ota_handle_t;
+
+const esp_partition_t* esp_ota_get_running_partition();
+const esp_partition_t* esp_ota_get_next_update_partition(
+    const esp_partition_t* start);
+
+esp_err_t esp_ota_begin(const esp_partition_t* partition, size_t size,
+    esp_ota_handle_t* handle);
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void* data,
+    size_t size);
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition);
+
+#endif // HOST_ESP_OTA_OPS_H
@@ -0,0 +1,10 @@
+#ifndef HOST_PERIPH_CTRL_H
+#define HOST_PERIPH_CTRL_H
+
+typedef enum {PERIPH_I2C0_MODULE, PERIPH_I2C1_MODULE} periph_module_t;
+
+inline void periph_module_enable(periph_module_t mod) {(void)mod;}
+inline void periph_module_disable(periph_module_t mod) {(void)mod;}
+inline void periph_module_reset(periph_module_t mod) {(void)mod;}
+
+#endif // HOST_PERIPH_CTRL_H
@@ -0,0 +1,8 @@
+#ifndef HOST_ESP_RANDOM_H
+#define HOST_ESP_RANDOM_H
+
+#include <cstdint>
+
+uint32_t esp_random(); // Host random device in place of the hardware RNG.
+
+#endif // HOST_ESP_RANDOM_H
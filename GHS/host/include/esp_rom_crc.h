@@ -0,0 +1,10 @@
+#ifndef HOST_ESP_ROM_CRC_H
+#define HOST_ESP_ROM_CRC_H
+
+#include <cstdint>
+
+// Little endian CRC32 as the ROM computes it, passing the previous result
+// as crc to continue across buffers, 0 to begin.
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif // HOST_ESP_ROM_CRC_H
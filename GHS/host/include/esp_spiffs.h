@@ -0,0 +1,16 @@
+#ifndef HOST_ESP_SPIFFS_H
+#define HOST_ESP_SPIFFS_H
+
+#include <cstddef>
+#include "esp_err.h"
+
+struct esp_vfs_spiffs_conf_t {
+    const char* base_path;
+    const char* partition_label;
+    size_t max_files;
+    bool format_if_mount_failed;
+};
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf);
+
+#endif // HOST_ESP_SPIFFS_H
@@ -0,0 +1,10 @@
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+void esp_restart(); // Terminates the host process.
+uint32_t esp_get_free_heap_size();
+
+#endif // HOST_ESP_SYSTEM_H
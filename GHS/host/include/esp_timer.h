@@ -0,0 +1,9 @@
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <cstdint>
+
+// Returns microseconds since the host kernel started, see hostClock.cpp.
+int64_t esp_timer_get_time();
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,6 @@
+#ifndef HOST_ESP_TRANSPORT_H
+#define HOST_ESP_TRANSPORT_H
+
+#include "esp_err.h"
+
+#endif // HOST_ESP_TRANSPORT_H
@@ -0,0 +1,7 @@
+#ifndef HOST_ESP_VFS_H
+#define HOST_ESP_VFS_H
+
+#include <cstdio>
+#include "esp_err.h"
+
+#endif // HOST_ESP_VFS_H
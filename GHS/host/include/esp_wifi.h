@@ -0,0 +1,91 @@
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+#include <cstdint>
+#include "esp_err.h"
+#include "esp_netif.h"
+
+// Host wifi. The radio is simulated as always associated once started in
+// station mode, see netHost.cpp.
+
+#define ESP_ERR_WIFI_BASE 0x3000
+#define ESP_ERR_WIFI_NOT_INIT (ESP_ERR_WIFI_BASE + 1)
+#define ESP_ERR_WIFI_NOT_STARTED (ESP_ERR_WIFI_BASE + 2)
+#define ESP_ERR_WIFI_NOT_CONNECT (ESP_ERR_WIFI_BASE + 15)
+
+typedef enum {WIFI_MODE_NULL, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA}
+    wifi_mode_t;
+
+typedef enum {WIFI_IF_STA, WIFI_IF_AP} wifi_interface_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK
+} wifi_auth_mode_t;
+
+struct wifi_init_config_t {
+    int magic;
+};
+
+#define WIFI_INIT_CONFIG_DEFAULT() {0x1F2F3F4F}
+
+struct wifi_ap_config_t {
+    uint8_t ssid[32];
+    uint8_t password[64];
+    uint8_t ssid_len;
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+    uint8_t ssid_hidden;
+    uint8_t max_connection;
+    uint16_t beacon_interval;
+};
+
+struct wifi_sta_config_t {
+    uint8_t ssid[32];
+    uint8_t password[64];
+    uint8_t bssid_set;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+union wifi_config_t {
+    wifi_ap_config_t ap;
+    wifi_sta_config_t sta;
+};
+
+struct wifi_ap_record_t {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int8_t rssi;
+    wifi_auth_mode_t authmode;
+};
+
+struct wifi_sta_info_t {
+    uint8_t mac[6];
+    int8_t rssi;
+};
+
+struct wifi_sta_list_t {
+    wifi_sta_info_t sta[10];
+    int num;
+};
+
+struct wifi_scan_config_t;
+
+esp_err_t esp_wifi_init(const wifi_init_config_t* config);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_get_mode(wifi_mode_t* mode);
+esp_err_t esp_wifi_set_config(wifi_interface_t iface, wifi_config_t* conf);
+esp_err_t esp_wifi_get_config(wifi_interface_t iface, wifi_config_t* conf);
+esp_err_t esp_wifi_start();
+esp_err_t esp_wifi_stop();
+esp_err_t esp_wifi_connect();
+esp_err_t esp_wifi_disconnect();
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t* info);
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t* list);
+esp_err_t esp_wifi_scan_start(const wifi_scan_config_t* conf, bool block);
+esp_err_t esp_wifi_scan_get_ap_records(uint16_t* number,
+    wifi_ap_record_t* records);
+
+#endif // HOST_ESP_WIFI_H
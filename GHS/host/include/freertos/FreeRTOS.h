@@ -0,0 +1,41 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// Host shim of the FreeRTOS kernel API subset used by the GHS firmware. Tasks
+// are backed by pthreads and block through Sim::HostClock, see
+// host/src/freertosHost.cpp. Only the calls used within src/ are provided,
+// extend this file if new kernel calls are introduced into the firmware.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "esp_err.h"
+#include "esp_system.h" // Pulled in through portmacro.h on target.
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t; // ESP-IDF defines the stack type as 1 byte.
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL 0
+
+// The host kernel ticks at 1 kHz, to keep pdMS_TO_TICKS resolution at 1 ms.
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY (TickType_t)0xFFFFFFFF
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) \
+    / 1000))
+
+#define CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ 240
+#define configMAX_PRIORITIES 25
+
+#define taskDISABLE_INTERRUPTS()
+#define taskENTER_CRITICAL(mux)
+#define taskEXIT_CRITICAL(mux)
+
+#endif // HOST_FREERTOS_H
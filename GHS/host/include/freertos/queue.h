@@ -0,0 +1,23 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+struct hostQueue; // Defined in freertosHost.cpp.
+typedef hostQueue* QueueHandle_t;
+
+struct StaticQueue_t { // Placeholder, the queue is allocated by the host.
+    uint8_t reserved[16];
+};
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+    uint8_t* storage, StaticQueue_t* queueBuf);
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, 
+    TickType_t wait);
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+#endif // HOST_FREERTOS_QUEUE_H
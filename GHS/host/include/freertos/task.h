@@ -0,0 +1,37 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+struct hostTask; // Defined in freertosHost.cpp.
+typedef hostTask* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+struct StaticTask_t { // Placeholder, TCB is allocated by the host kernel.
+    uint8_t reserved[16];
+};
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t func,
+    const char* name, uint32_t stackDepth, void* params,
+    UBaseType_t priority, StackType_t* stack, StaticTask_t* TCB,
+    BaseType_t core);
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t func, const char* name,
+    uint32_t stackDepth, void* params, UBaseType_t priority,
+    StackType_t* stack, StaticTask_t* TCB);
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char* name,
+    uint32_t stackDepth, void* params, UBaseType_t priority,
+    TaskHandle_t* handle);
+
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* prevWake, TickType_t increment);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+void vTaskDelete(TaskHandle_t task);
+const char* pcTaskGetName(TaskHandle_t task);
+
+#endif // HOST_FREERTOS_TASK_H
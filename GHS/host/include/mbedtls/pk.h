@@ -0,0 +1,25 @@
+#ifndef HOST_MBEDTLS_PK_H
+#define HOST_MBEDTLS_PK_H
+
+#include <cstdint>
+#include <cstddef>
+
+typedef enum {MBEDTLS_PK_NONE, MBEDTLS_PK_RSA} mbedtls_pk_type_t;
+typedef enum {MBEDTLS_MD_NONE, MBEDTLS_MD_SHA256 = 9} mbedtls_md_type_t;
+
+struct mbedtls_pk_context {
+    mbedtls_pk_type_t type;
+};
+
+void mbedtls_pk_init(mbedtls_pk_context* ctx);
+void mbedtls_pk_free(mbedtls_pk_context* ctx);
+int mbedtls_pk_parse_public_key(mbedtls_pk_context* ctx,
+    const unsigned char* key, size_t keyLen);
+
+mbedtls_pk_type_t mbedtls_pk_get_type(const mbedtls_pk_context* ctx);
+size_t mbedtls_pk_get_bitlen(const mbedtls_pk_context* ctx);
+int mbedtls_pk_verify(mbedtls_pk_context* ctx, mbedtls_md_type_t md,
+    const unsigned char* hash, size_t hashLen, const unsigned char* sig,
+    size_t sigLen);
+
+#endif // HOST_MBEDTLS_PK_H
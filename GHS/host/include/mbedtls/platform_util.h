@@ -0,0 +1,12 @@
+#ifndef HOST_MBEDTLS_PLATFORM_UTIL_H
+#define HOST_MBEDTLS_PLATFORM_UTIL_H
+
+#include <cstddef>
+#include <cstring>
+
+inline void mbedtls_platform_zeroize(void* buf, size_t len) {
+    volatile unsigned char* p = static_cast<volatile unsigned char*>(buf);
+    while (len--) *p++ = 0;
+}
+
+#endif // HOST_MBEDTLS_PLATFORM_UTIL_H
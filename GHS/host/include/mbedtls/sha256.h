@@ -0,0 +1,22 @@
+#ifndef HOST_MBEDTLS_SHA256_H
+#define HOST_MBEDTLS_SHA256_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Host builds bypass firmware validation (BYPASS_VAL), so the digest is not
+// computed. Every call fails, keeping validation closed if ever reached.
+
+struct mbedtls_sha256_context {
+    uint8_t reserved[128];
+};
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx);
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx);
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224);
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const uint8_t* input,
+    size_t len);
+
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, uint8_t* output);
+
+#endif // HOST_MBEDTLS_SHA256_H
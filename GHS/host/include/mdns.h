@@ -0,0 +1,25 @@
+#ifndef HOST_MDNS_H
+#define HOST_MDNS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+#include "esp_netif.h"
+
+struct mdns_txt_item_t {
+    const char* key;
+    const char* value;
+};
+
+esp_err_t mdns_init();
+void mdns_free();
+esp_err_t mdns_hostname_set(const char* hostname);
+esp_err_t mdns_hostname_get(char* hostname);
+esp_err_t mdns_instance_name_set(const char* name);
+esp_err_t mdns_query_a(const char* host_name, uint32_t timeout,
+    esp_ip4_addr_t* addr);
+
+esp_err_t mdns_service_add(const char* instance, const char* service,
+    const char* proto, uint16_t port, mdns_txt_item_t* txt, size_t txtCount);
+
+#endif // HOST_MDNS_H
@@ -0,0 +1,36 @@
+#ifndef HOST_NVS_H
+#define HOST_NVS_H
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_err.h"
+
+// Host NVS. Entries are held in memory by nvsHost.cpp per namespace.
+
+#define ESP_ERR_NVS_BASE 0x1100
+#define ESP_ERR_NVS_NOT_INITIALIZED (ESP_ERR_NVS_BASE + 0x01)
+#define ESP_ERR_NVS_NOT_FOUND (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_INVALID_HANDLE (ESP_ERR_NVS_BASE + 0x07)
+#define ESP_ERR_NVS_INVALID_LENGTH (ESP_ERR_NVS_BASE + 0x0c)
+#define ESP_ERR_NVS_NO_FREE_PAGES (ESP_ERR_NVS_BASE + 0x0d)
+#define ESP_ERR_NVS_NEW_VERSION_FOUND (ESP_ERR_NVS_BASE + 0x10)
+
+typedef uint32_t nvs_handle_t;
+typedef enum {NVS_READONLY, NVS_READWRITE} nvs_open_mode_t;
+
+esp_err_t nvs_open(const char* nameSpace, nvs_open_mode_t mode,
+    nvs_handle_t* handle);
+
+void nvs_close(nvs_handle_t handle);
+esp_err_t nvs_commit(nvs_handle_t handle);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key,
+    const void* value, size_t length);
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* value,
+    size_t* length);
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value);
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* value);
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
+
+#endif // HOST_NVS_H
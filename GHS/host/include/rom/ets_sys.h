@@ -0,0 +1,8 @@
+#ifndef HOST_ETS_SYS_H
+#define HOST_ETS_SYS_H
+
+#include <cstdint>
+
+void ets_delay_us(uint32_t us); // Busy waits on the host clock.
+
+#endif // HOST_ETS_SYS_H
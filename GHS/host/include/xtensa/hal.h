@@ -0,0 +1,9 @@
+#ifndef HOST_XTENSA_HAL_H
+#define HOST_XTENSA_HAL_H
+
+#include <cstdint>
+
+// Returns the cycle count, emulated as host micros * CPU MHz.
+uint32_t xthal_get_ccount();
+
+#endif // HOST_XTENSA_HAL_H
@@ -0,0 +1,241 @@
+#include "Sim/Devices.hpp"
+#include "Sim/Environment.hpp"
+#include "Config/config.hpp"
+#include <cstring>
+#include <cmath>
+
+namespace Sim {
+
+// SHT31
+
+SHT31::SHT31() : reply{0}, replyLen(0), status(0x8010) {}
+
+// Requires buffer and length. Returns the CRC8 per the SHT31 datasheet,
+// polynomial 0x31 and init 0xFF.
+uint8_t SHT31::crc8(const uint8_t* buf, size_t len) {
+    uint8_t crc = 0xFF;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x31 : (crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+// Requires two words. Latches the words, each followed by their CRC.
+void SHT31::latch(uint16_t a, uint16_t b) {
+    this->reply[0] = a >> 8; this->reply[1] = a & 0xFF;
+    this->reply[2] = SHT31::crc8(&this->reply[0], 2);
+    this->reply[3] = b >> 8; this->reply[4] = b & 0xFF;
+    this->reply[5] = SHT31::crc8(&this->reply[3], 2);
+    this->replyLen = 6;
+}
+
+esp_err_t SHT31::write(const uint8_t* buf, size_t len) {
+    if (len != 2) return ESP_FAIL; // All commands are 16-bit.
+
+    std::lock_guard<std::mutex> lock(this->mtx);
+    uint16_t cmd = (buf[0] << 8) | buf[1];
+
+    switch (cmd) {
+        case 0x2C06: case 0x2C0D: case 0x2C10: // Single shot, stretch.
+        case 0x2400: case 0x240B: case 0x2416: { // Single shot, no stretch.
+            Readings env = Environment::get()->sample();
+            float temp = env.tempC + ((this->status & 0x2000) ? 2.0f : 0.0f);
+            float rawT = (temp + 45.0f) * 65535.0f / 175.0f;
+            float rawH = env.hum * 65535.0f / 100.0f;
+            rawT = std::fmin(std::fmax(rawT, 0.0f), 65535.0f);
+            rawH = std::fmin(std::fmax(rawH, 0.0f), 65535.0f);
+            this->latch((uint16_t)rawT, (uint16_t)rawH);
+            break;
+        }
+
+        case 0xF32D: this->latch(this->status, 0); break; // Status.
+        case 0x306D: this->status |= 0x2000; this->replyLen = 0; break;
+        case 0x3066: this->status &= ~0x2000; this->replyLen = 0; break;
+        case 0x3041: this->status &= 0x2000; this->replyLen = 0; break;
+        case 0x30A2: this->status = 0x0010; this->replyLen = 0; break;
+        default: return ESP_FAIL; // NACK unknown commands.
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t SHT31::read(uint8_t* buf, size_t len) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    if (len > this->replyLen) return ESP_FAIL; // Nothing latched, NACK.
+
+    memcpy(buf, this->reply, len);
+    this->replyLen = 0;
+    return ESP_OK;
+}
+
+// AS7341
+
+AS7341::AS7341() : regs{0}, smux{0}, pointer(0), lowBank(false),
+    lowGroup(true) {
+
+    this->regs[0xAA] = 0x09; // AGAIN reset value, 256x.
+    this->regs[0x81] = 0x00; // ATIME
+    this->regs[0xCA] = 0xE7; // ASTEP reset value 999.
+    this->regs[0xCB] = 0x03;
+}
+
+// Requires no params. Latches the channel registers from the environment,
+// scaled by the integration time and gain relative to 50 ms at 256x.
+void AS7341::measure() {
+    Readings env = Environment::get()->sample();
+
+    uint16_t astep = this->regs[0xCA] | (this->regs[0xCB] << 8);
+    double tint = (this->regs[0x81] + 1) * (astep + 1) * 2.78e-6;
+    uint8_t again = this->regs[0xAA] & 0x1F;
+    double gain = (again == 0) ? 0.5 : std::pow(2.0, again - 1);
+    double scale = (tint / 0.050) * (gain / 256.0);
+    double fullScale = std::fmin(65535.0, (this->regs[0x81] + 1) * 
+        (astep + 1.0));
+
+    int group = this->lowGroup ? 0 : 4; // F1 - F4 or F5 - F8 on ADC0 - 3.
+    int map[6] = {group, group + 1, group + 2, group + 3, 8, 9};
+
+    for (int ch = 0; ch < 6; ch++) {
+        double counts = std::fmin(env.color[map[ch]] * scale, fullScale);
+        uint16_t val = (uint16_t)counts;
+        this->regs[0x95 + ch * 2] = val & 0xFF;
+        this->regs[0x96 + ch * 2] = val >> 8;
+    }
+
+    this->regs[0xA3] |= 0x40; // AVALID.
+}
+
+esp_err_t AS7341::write(const uint8_t* buf, size_t len) {
+    if (len == 0) return ESP_FAIL;
+
+    std::lock_guard<std::mutex> lock(this->mtx);
+    uint8_t reg = buf[0];
+    this->pointer = reg;
+
+    if (len == 1) return ESP_OK; // Sets the read pointer only.
+    uint8_t val = buf[1];
+
+    if (reg < sizeof(this->smux) && this->lowBank) { // SMUX RAM.
+        this->smux[reg] = val;
+        return ESP_OK;
+    }
+
+    switch (reg) {
+        case 0xA9: // Register bank.
+        this->lowBank = (val >> 3) & 0x1;
+        this->regs[reg] = val;
+        break;
+
+        case 0x80: // ENABLE
+        if (val & 0x10) { // SMUX executes, and the bit self clears.
+            this->lowGroup = (this->smux[0x01] == 0x01);
+            val &= ~0x10;
+        }
+
+        if ((val & 0x02) && !(this->regs[0x80] & 0x02)) { // SP_EN rising.
+            this->regs[0x80] = val;
+            this->measure();
+        } else if (!(val & 0x02)) {
+            this->regs[0xA3] &= ~0x40;
+        }
+
+        this->regs[0x80] = val;
+        break;
+
+        default:
+        this->regs[reg] = val;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t AS7341::read(uint8_t* buf, size_t len) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t reg = this->pointer + i;
+        buf[i] = (reg < sizeof(this->smux) && this->lowBank) ?
+            this->smux[reg] : this->regs[reg];
+    }
+
+    return ESP_OK;
+}
+
+// ADS1115
+
+ADS1115::ADS1115(SOURCE src) : src(src), pointer(0), config(0x8583),
+    conversion(0) {}
+
+esp_err_t ADS1115::write(const uint8_t* buf, size_t len) {
+    if (len == 0) return ESP_FAIL;
+
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->pointer = buf[0] & 0x03;
+
+    if (len < 3 || this->pointer != 0x01) return ESP_OK; // Pointer only.
+
+    this->config = (buf[1] << 8) | buf[2];
+
+    if (this->config & 0x8000) { // Start single shot, completes immediately.
+        static const float FSR[8] = {6.144f, 4.096f, 2.048f, 1.024f, 0.512f,
+            0.256f, 0.256f, 0.256f};
+
+        uint8_t mux = (this->config >> 12) & 0x7;
+        uint8_t ain = (mux >= 4) ? mux - 4 : 0; // Single ended only.
+        float fsr = FSR[(this->config >> 9) & 0x7];
+
+        Readings env = Environment::get()->sample();
+        float volts = (this->src == SOURCE::SOIL) ? env.soilV[ain] : 
+            env.photoV[ain];
+
+        float raw = volts / fsr * 32767.0f;
+        raw = std::fmin(std::fmax(raw, -32768.0f), 32767.0f);
+        this->conversion = (int16_t)raw;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ADS1115::read(uint8_t* buf, size_t len) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    // OS bit always reads 1, conversions are never in progress.
+    uint16_t val = (this->pointer == 0x00) ? (uint16_t)this->conversion :
+        (this->config | 0x8000);
+
+    if (len > 0) buf[0] = val >> 8;
+    if (len > 1) buf[1] = val & 0xFF;
+    return ESP_OK;
+}
+
+// SSD1306
+
+esp_err_t SSD1306::write(const uint8_t* buf, size_t len) {return ESP_OK;}
+esp_err_t SSD1306::read(uint8_t* buf, size_t len) {
+    memset(buf, 0, len);
+    return ESP_OK;
+}
+
+// Requires no params. Attaches the board devices at the addresses used by
+// the firmware.
+void attachBoard() {
+    static SHT31 sht;
+    static AS7341 spectral;
+    static ADS1115 soil(ADS1115::SOURCE::SOIL);
+    static ADS1115 photo(ADS1115::SOURCE::PHOTO);
+    static SSD1306 oled;
+
+    attachDevice(SHT_ADDR, &sht);
+    attachDevice(AS7341_ADDR, &spectral);
+    attachDevice(ADC1_ADDR, &soil);
+    attachDevice(ADC2_ADDR, &photo);
+    attachDevice(OLED_ADDR, &oled);
+}
+
+}
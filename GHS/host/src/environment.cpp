@@ -0,0 +1,68 @@
+#include "Sim/Environment.hpp"
+#include "Sim/HostClock.hpp"
+#include <cmath>
+
+namespace Sim {
+
+Environment::Environment() : model(Environment::diurnal) {}
+
+// Requires no params. Returns the singleton instance.
+Environment* Environment::get() {
+    static Environment instance;
+    return &instance;
+}
+
+// Requires model. Replaces the environment model used by all sensors. A
+// null model restores the default diurnal model.
+void Environment::setModel(EnvModel model) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->model = model ? model : EnvModel(Environment::diurnal);
+}
+
+// Requires no params. Returns the readings of the model at the current host
+// clock time.
+Readings Environment::sample() {
+    Readings out{};
+    EnvModel current;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        current = this->model;
+    }
+
+    current(HostClock::get()->micros(), out);
+    return out;
+}
+
+// Requires time in micros and readings. Populates a 24 hour cycle where the
+// light is a half sine between 06:00 and 18:00, temperature peaks mid
+// afternoon, and humidity runs opposite of the temperature. Soil dries
+// slowly through the day.
+void Environment::diurnal(uint64_t micros, Readings &out) {
+    const double day = 86400.0;
+    const double pi = 3.14159265358979;
+    double t = std::fmod(micros / 1e6, day) / day; // Fraction of the day.
+
+    double sun = std::sin((t - 0.25) * 2 * pi); // Peaks at noon.
+    double light = (sun > 0) ? sun : 0;
+    double heat = std::sin((t - 0.375) * 2 * pi); // Peaks at 15:00.
+
+    out.tempC = 22.0f + 6.0f * heat;
+    out.hum = 55.0f - 15.0f * heat;
+
+    // Relative spectral response of a broad spectrum grow light.
+    static const float profile[ENV_COLOR_CHANNELS] = {
+        0.30f, 0.55f, 0.70f, 0.60f, 0.65f, 0.70f, 0.85f, 0.90f, 1.00f, 0.25f
+    };
+
+    for (int i = 0; i < ENV_COLOR_CHANNELS; i++) {
+        out.color[i] = 20.0f + 8000.0f * profile[i] * light;
+    }
+
+    for (int i = 0; i < ENV_ADC_CHANNELS; i++) {
+        out.photoV[i] = (i == 0) ? 0.2f + 2.8f * light : 0.0f;
+        out.soilV[i] = 1.6f + 0.1f * i + 0.3f * t;
+    }
+}
+
+}
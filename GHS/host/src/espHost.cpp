@@ -0,0 +1,85 @@
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_random.h"
+#include "rom/ets_sys.h"
+#include "esp_rom_crc.h"
+#include "xtensa/hal.h"
+#include "freertos/FreeRTOS.h"
+#include "Sim/HostClock.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Host implementations of the ESP system calls, timing is routed through the
+// host clock.
+
+int64_t esp_timer_get_time() {
+    return (int64_t)Sim::HostClock::get()->micros();
+}
+
+// Busy waits as the ROM function does. In virtual time a busy wait would
+// never end, so the caller sleeps instead.
+void ets_delay_us(uint32_t us) {
+    Sim::HostClock* clock = Sim::HostClock::get();
+    uint64_t end = clock->micros() + us;
+
+    if (clock->getMode() == Sim::ClockMode::VIRTUAL) {
+        clock->sleepUntilMicros(end);
+        return;
+    }
+
+    while (clock->micros() < end) {}
+}
+
+uint32_t xthal_get_ccount() {
+    return (uint32_t)(Sim::HostClock::get()->micros() * 
+        CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ);
+}
+
+void esp_restart() {
+    uint64_t secs = Sim::HostClock::get()->micros() / 1000000;
+    printf("HOST: esp_restart() called at %llu s uptime, exiting\n",
+        (unsigned long long)secs);
+    fflush(stdout);
+    std::_Exit(0); // Skip static destructors, tasks are still running.
+}
+
+uint32_t esp_get_free_heap_size() {
+    return 200000; // Nominal free heap on target after init.
+}
+
+uint32_t esp_random() {
+    static std::random_device rd;
+    return rd();
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+        default: return "ESP_ERR_UNKNOWN";
+    }
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+
+    return ~crc;
+}
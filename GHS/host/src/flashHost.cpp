@@ -0,0 +1,174 @@
+#include "esp_partition.h"
+#include "Sim/Sim.hpp"
+#include "Peripherals/Checkpoint.hpp"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Host flash of the data partitions following the app partitions, see
+// partitions_custom.csv. Writes behave as NOR flash, only clearing bits, so
+// that writing over unerased flash corrupts as it would on target. Backed by
+// memory, or a file if set, which is written through upon each change.
+
+namespace {
+
+// Offset auto assigned by the partition table, following app1. The ckpt
+// size follows the snapshot, see CKPT_PART_SIZE.
+const esp_partition_t dataParts[] = {
+    {0x3ED000, 0x10000, "logjrnl", false, ESP_PARTITION_TYPE_DATA,
+        static_cast<esp_partition_subtype_t>(0x40)},
+    {0x3FD000, (uint32_t)Peripheral::CKPT_PART_SIZE, "ckpt", false,
+        ESP_PARTITION_TYPE_DATA,
+        static_cast<esp_partition_subtype_t>(0x41)}
+};
+
+const size_t PART_QTY = sizeof(dataParts) / sizeof(dataParts[0]);
+
+struct Flash {
+    std::mutex mtx;
+    std::vector<uint8_t> mem[PART_QTY]; // Partition contents.
+    FILE* file = nullptr; // Partitions in table order, if set.
+    uint32_t writes = 0, erases = 0;
+    uint64_t bytes = 0;
+
+    Flash() {
+        for (size_t i = 0; i < PART_QTY; i++) {
+            mem[i].assign(dataParts[i].size, 0xFF); // Erased.
+        }
+    }
+};
+
+Flash &flash() {
+    static Flash instance;
+    return instance;
+}
+
+// Requires the partition. Returns its index, or -1 if not a data partition.
+int partIndex(const esp_partition_t* partition) {
+    for (size_t i = 0; i < PART_QTY; i++) {
+        if (partition == &dataParts[i]) return (int)i;
+    }
+
+    return -1;
+}
+
+// Requires the lock, partition index, offset and size. Writes the range
+// through to the backing file, if set.
+void persist(int idx, size_t offset, size_t size) {
+    Flash &f = flash();
+    if (f.file == nullptr) return;
+
+    size_t base = 0;
+    for (int i = 0; i < idx; i++) base += dataParts[i].size;
+
+    fseek(f.file, (long)(base + offset), SEEK_SET);
+    fwrite(&f.mem[idx][offset], 1, size, f.file);
+    fflush(f.file);
+}
+
+}
+
+namespace Sim {
+
+bool setFlashFile(const char* path) {
+    Flash &f = flash();
+    std::lock_guard<std::mutex> lock(f.mtx);
+
+    f.file = fopen(path, "r+b");
+    bool exists = (f.file != nullptr);
+    if (!exists) f.file = fopen(path, "w+b");
+    if (f.file == nullptr) return false;
+
+    for (size_t i = 0; i < PART_QTY; i++) {
+        if (exists) {
+            size_t got = fread(f.mem[i].data(), 1, f.mem[i].size(), f.file);
+            if (got < f.mem[i].size()) { // Short file, remainder erased.
+                memset(&f.mem[i][got], 0xFF, f.mem[i].size() - got);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < PART_QTY; i++) {
+        persist((int)i, 0, f.mem[i].size());
+    }
+
+    return true;
+}
+
+void getFlashStats(uint32_t &writes, uint32_t &erases, uint64_t &bytes) {
+    Flash &f = flash();
+    std::lock_guard<std::mutex> lock(f.mtx);
+    writes = f.writes;
+    erases = f.erases;
+    bytes = f.bytes;
+}
+
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type,
+    esp_partition_subtype_t subtype, const char* label) {
+
+    for (const esp_partition_t &p : dataParts) {
+        if (type != ESP_PARTITION_TYPE_ANY && type != p.type) continue;
+        if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != p.subtype) {
+            continue;
+        }
+
+        if (label != nullptr && strcmp(label, p.label) != 0) continue;
+        return &p;
+    }
+
+    return nullptr;
+}
+
+// The app partitions are not readable on the host.
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset,
+    void* dst, size_t size) {
+
+    int idx = partIndex(partition);
+    if (idx < 0 || dst == nullptr) return ESP_FAIL;
+    if (offset + size > partition->size) return ESP_ERR_INVALID_SIZE;
+
+    Flash &f = flash();
+    std::lock_guard<std::mutex> lock(f.mtx);
+    memcpy(dst, &f.mem[idx][offset], size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset,
+    const void* src, size_t size) {
+
+    int idx = partIndex(partition);
+    if (idx < 0 || src == nullptr) return ESP_FAIL;
+    if (offset + size > partition->size) return ESP_ERR_INVALID_SIZE;
+
+    Flash &f = flash();
+    std::lock_guard<std::mutex> lock(f.mtx);
+    const uint8_t* bytes = static_cast<const uint8_t*>(src);
+
+    for (size_t i = 0; i < size; i++) {
+        f.mem[idx][offset + i] &= bytes[i]; // NOR, bits only clear.
+    }
+
+    f.writes++;
+    f.bytes += size;
+    persist(idx, offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition,
+    size_t offset, size_t size) {
+
+    int idx = partIndex(partition);
+    if (idx < 0) return ESP_FAIL;
+    if (offset % 4096 != 0 || size % 4096 != 0 ||
+        offset + size > partition->size) return ESP_ERR_INVALID_ARG;
+
+    Flash &f = flash();
+    std::lock_guard<std::mutex> lock(f.mtx);
+    memset(&f.mem[idx][offset], 0xFF, size);
+    f.erases += size / 4096;
+    persist(idx, offset, size);
+    return ESP_OK;
+}
@@ -0,0 +1,391 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "Sim/HostClock.hpp"
+#include <pthread.h>
+#include <mutex>
+#include <string>
+
+// ATTENTION. The FreeRTOS POSIX port is not vendored, so this is a minimal
+// kernel built on pthreads that covers the calls made within src/. Tasks run
+// truly parallel instead of being scheduled by priority, which is closer to
+// the dual core target than a single threaded port. Suspension is
+// cooperative, a task suspended by another task parks at its next kernel
+// call (delay, semaphore take), which is where the firmware tasks spend
+// their idle time anyway. Every blocking call goes through Sim::HostClock so
+// that the same kernel runs in real or virtual time.
+
+#define HOST_TASK_STACK (1024 * 1024) // Host stacks are not the target stack.
+
+struct hostTask {
+    pthread_t thread;
+    std::string name;
+    TaskFunction_t func;
+    void* params;
+    uint32_t stackDepth; // Target stack depth, reported as the high water.
+    bool suspended; // Guarded by the kernel lock.
+    bool deleted;
+    hostTask() : thread(), func(nullptr), params(nullptr), stackDepth(0),
+        suspended(false), deleted(false) {}
+};
+
+struct hostSemaphore { // All fields guarded by the kernel lock.
+    bool isMutex; // Binary semaphores start empty, mutexes start given.
+    pthread_t owner;
+    bool owned;
+    uint32_t count; // Recursion depth, or binary count.
+    hostSemaphore(bool isMutex) : isMutex(isMutex), owner(), owned(false), 
+        count(0) {}
+};
+
+struct hostQueue { // All fields guarded by the kernel lock.
+    uint8_t* storage; // Caller provided, length * itemSize bytes.
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head; // Index of the oldest item.
+    UBaseType_t count;
+    hostQueue(uint8_t* storage, UBaseType_t length, UBaseType_t itemSize) :
+        storage(storage), length(length), itemSize(itemSize), head(0), 
+        count(0) {}
+};
+
+namespace {
+
+thread_local hostTask* currentTask = nullptr;
+
+Sim::HostClock* kernel() {return Sim::HostClock::get();}
+
+// Requires ticks. Returns the deadline in micros, ticks after now.
+uint64_t deadlineIn(TickType_t ticks) {
+    if (ticks == portMAX_DELAY) return CLOCK_FOREVER;
+    return kernel()->micros() + (uint64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+// Requires task and held kernel lock. Blocks while the task is suspended, 
+// and exits the thread if the task has been deleted by another task.
+void parkIfSuspended(hostTask* task, std::unique_lock<std::mutex> &lock) {
+    if (task == nullptr) return;
+
+    kernel()->block(lock, task, CLOCK_FOREVER, 
+        [task] {return !task->suspended || task->deleted;});
+
+    if (task->deleted) {
+        lock.unlock();
+        pthread_exit(nullptr); // Unwinds through taskEntry's guard.
+    }
+}
+
+struct participant { // Removes the task from the kernel on exit.
+    ~participant() {kernel()->detach();}
+};
+
+void* taskEntry(void* arg) {
+    hostTask* task = static_cast<hostTask*>(arg);
+    currentTask = task;
+    kernel()->adopt(); // Enrolled by the creator.
+    participant guard;
+
+    pthread_setname_np(pthread_self(), task->name.substr(0, 15).c_str());
+    task->func(task->params);
+
+    // FreeRTOS tasks must never return. Treat as self delete.
+    return nullptr;
+}
+
+TaskHandle_t spawn(TaskFunction_t func, const char* name, uint32_t depth,
+    void* params) {
+
+    hostTask* task = new hostTask();
+    task->name = (name != nullptr) ? name : "task";
+    task->func = func;
+    task->params = params;
+    task->stackDepth = depth;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, HOST_TASK_STACK);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    // Enroll before the thread exists, so that virtual time cannot advance
+    // between creation and the first instruction of the task.
+    kernel()->enroll();
+    int err = pthread_create(&task->thread, &attr, taskEntry, task);
+    pthread_attr_destroy(&attr);
+
+    if (err != 0) {
+        kernel()->withdraw(); // Task never started.
+        delete task;
+        return nullptr;
+    }
+
+    return task;
+}
+
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t func,
+    const char* name, uint32_t stackDepth, void* params,
+    UBaseType_t priority, StackType_t* stack, StaticTask_t* TCB,
+    BaseType_t core) {
+
+    (void)priority; (void)stack; (void)TCB; (void)core;
+    return spawn(func, name, stackDepth, params);
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t func, const char* name,
+    uint32_t stackDepth, void* params, UBaseType_t priority,
+    StackType_t* stack, StaticTask_t* TCB) {
+
+    return xTaskCreateStaticPinnedToCore(func, name, stackDepth, params,
+        priority, stack, TCB, 0);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t func, const char* name,
+    uint32_t stackDepth, void* params, UBaseType_t priority,
+    TaskHandle_t* handle) {
+
+    (void)priority;
+    TaskHandle_t task = spawn(func, name, stackDepth, params);
+    if (handle != nullptr) *handle = task;
+    return (task != nullptr) ? pdPASS : pdFAIL;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+    kernel()->block(lock, nullptr, deadlineIn(ticks), [] {return false;});
+    parkIfSuspended(currentTask, lock);
+}
+
+void vTaskDelayUntil(TickType_t* prevWake, TickType_t increment) {
+    *prevWake += increment;
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+    kernel()->block(lock, nullptr, 
+        (uint64_t)(*prevWake) * portTICK_PERIOD_MS * 1000, 
+        [] {return false;});
+
+    parkIfSuspended(currentTask, lock);
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(kernel()->micros() / (portTICK_PERIOD_MS * 1000));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {return currentTask;}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    return (task != nullptr) ? task->stackDepth : 0;
+}
+
+void vTaskSuspend(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    if (task == nullptr) return;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+    task->suspended = true;
+    if (task == currentTask) parkIfSuspended(task, lock);
+}
+
+void vTaskResume(TaskHandle_t task) {
+    if (task == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+    task->suspended = false;
+    kernel()->wake(task);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    if (task == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+        task->deleted = true;
+        task->suspended = true; // Parks, and exits, at the next kernel call.
+        kernel()->wake(task);
+    }
+
+    if (task == currentTask) pthread_exit(nullptr);
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    if (task == nullptr) task = currentTask;
+    return (task != nullptr) ? task->name.c_str() : "main";
+}
+
+// SEMAPHORES. All state is guarded by the kernel lock, and blocked takers
+// are woken through the kernel by the semaphore address.
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() {
+    return new hostSemaphore(true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    return new hostSemaphore(true);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+    return new hostSemaphore(false);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t wait) {
+    if (sem == nullptr) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+    pthread_t self = pthread_self();
+
+    if (sem->owned && pthread_equal(sem->owner, self)) {
+        sem->count++;
+        return pdTRUE;
+    }
+
+    if (!kernel()->block(lock, sem, deadlineIn(wait), 
+        [sem] {return !sem->owned;})) {
+        return pdFALSE;
+    }
+
+    sem->owned = true;
+    sem->owner = self;
+    sem->count = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+    if (sem == nullptr) return pdFALSE;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+
+    if (!sem->owned || !pthread_equal(sem->owner, pthread_self())) {
+        return pdFALSE;
+    }
+
+    if (--sem->count == 0) {
+        sem->owned = false;
+        kernel()->wake(sem);
+    }
+
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    if (sem == nullptr) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+
+    if (sem->isMutex) {
+        if (!kernel()->block(lock, sem, deadlineIn(wait), 
+            [sem] {return !sem->owned;})) {
+            return pdFALSE;
+        }
+
+        sem->owned = true;
+        sem->owner = pthread_self();
+        return pdTRUE;
+    }
+
+    if (!kernel()->block(lock, sem, deadlineIn(wait), 
+        [sem] {return sem->count > 0;})) {
+        return pdFALSE;
+    }
+
+    sem->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (sem == nullptr) return pdFALSE;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+
+    if (sem->isMutex) {
+        if (!sem->owned) return pdFALSE;
+        sem->owned = false;
+        kernel()->wake(sem);
+        return pdTRUE;
+    }
+
+    if (sem->count > 0) return pdFALSE; // Binary, already given.
+    sem->count = 1;
+    kernel()->wake(sem);
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    // Global mutexes are destroyed at exit while detached tasks may still
+    // hold them. Leak intentionally, the process is ending.
+    (void)sem;
+}
+
+// QUEUES. Items are copied into the caller provided storage, as on target.
+// Senders and receivers block through the kernel by the queue address.
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize,
+    uint8_t* storage, StaticQueue_t* queueBuf) {
+
+    (void)queueBuf;
+    if (storage == nullptr || length == 0 || itemSize == 0) return nullptr;
+    return new hostQueue(storage, length, itemSize);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, 
+    TickType_t wait) {
+
+    if (queue == nullptr || item == nullptr) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+
+    if (!kernel()->block(lock, queue, deadlineIn(wait), 
+        [queue] {return queue->count < queue->length;})) {
+        return errQUEUE_FULL;
+    }
+
+    UBaseType_t idx = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + idx * queue->itemSize, item, queue->itemSize);
+    queue->count++;
+    kernel()->wake(queue);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+    if (queue == nullptr || item == nullptr) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+
+    if (!kernel()->block(lock, queue, deadlineIn(wait), 
+        [queue] {return queue->count > 0;})) {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->storage + queue->head * queue->itemSize, 
+        queue->itemSize);
+
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    kernel()->wake(queue);
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t wait) {
+    if (queue == nullptr || item == nullptr) return pdFALSE;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+
+    if (!kernel()->block(lock, queue, deadlineIn(wait), 
+        [queue] {return queue->count > 0;})) {
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->storage + queue->head * queue->itemSize, 
+        queue->itemSize);
+
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (queue == nullptr) return 0;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+    return queue->count;
+}
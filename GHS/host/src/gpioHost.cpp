@@ -0,0 +1,62 @@
+#include "driver/gpio.h"
+#include "Sim/Sim.hpp"
+#include <atomic>
+
+// Simulated pin levels. Inputs read HIGH until driven low by the harness,
+// matching the pullups configured on every firmware input.
+
+namespace {
+
+std::atomic<int> levels[GPIO_NUM_MAX];
+std::atomic<bool> driven[GPIO_NUM_MAX]; // True if set by the harness.
+std::atomic<gpio_mode_t> modes[GPIO_NUM_MAX];
+std::atomic<uint32_t> toggles[GPIO_NUM_MAX]; // Output level changes.
+
+bool valid(gpio_num_t pin) {return pin >= 0 && pin < GPIO_NUM_MAX;}
+
+}
+
+namespace Sim {
+
+void setPin(gpio_num_t pin, int level) {
+    if (!valid(pin)) return;
+    levels[pin] = level;
+    driven[pin] = true;
+}
+
+int getPin(gpio_num_t pin) {
+    return valid(pin) ? levels[pin].load() : 0;
+}
+
+uint32_t getToggles(gpio_num_t pin) {
+    return valid(pin) ? toggles[pin].load() : 0;
+}
+
+}
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode) {
+    if (!valid(pin)) return ESP_ERR_INVALID_ARG;
+    modes[pin] = mode;
+    if (mode == GPIO_MODE_INPUT && !driven[pin]) levels[pin] = 1;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_pull_mode(gpio_num_t pin, gpio_pull_mode_t pull) {
+    if (!valid(pin)) return ESP_ERR_INVALID_ARG;
+    if (!driven[pin]) levels[pin] = (pull == GPIO_PULLDOWN_ONLY) ? 0 : 1;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level) {
+    if (!valid(pin)) return ESP_ERR_INVALID_ARG;
+    if (levels[pin].exchange(level != 0) != (level != 0)) toggles[pin]++;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin) {
+    if (!valid(pin)) return 0;
+
+    // Unconfigured inputs float high on the harness, as the pullups would.
+    if (modes[pin] == GPIO_MODE_DISABLE && !driven[pin]) return 1;
+    return levels[pin];
+}
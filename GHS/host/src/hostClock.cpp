@@ -0,0 +1,212 @@
+#include "Sim/HostClock.hpp"
+#include <cstdio>
+#include <thread>
+
+namespace Sim {
+
+namespace {
+thread_local bool adopted = false; // Calling thread is a participant.
+}
+
+HostClock::HostClock() : start(std::chrono::steady_clock::now()), now(0),
+    mode(ClockMode::REAL), running(0), participants(0), stalled(false),
+    activity(0), forced(0) {}
+
+// Requires no params. Returns the singleton instance.
+HostClock* HostClock::get() {
+    static HostClock instance;
+    return &instance;
+}
+
+// Requires mode. Must be set before any task is created.
+void HostClock::setMode(ClockMode mode) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    bool start = (mode == ClockMode::VIRTUAL && this->mode != mode);
+    this->mode = mode;
+
+    if (start) std::thread(&HostClock::watchdog, this).detach();
+}
+
+// Requires no params. Runs for the life of the process in virtual mode. If
+// no participant has entered the kernel within CLOCK_STALL_MS, those still
+// counted as running are blocked elsewhere, and time is advanced for them.
+void HostClock::watchdog() {
+    uint64_t last = this->activity.load();
+
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(CLOCK_STALL_MS));
+        uint64_t current = this->activity.load();
+
+        if (current == last) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+
+            if (this->running > 0 && !this->waiters.empty()) {
+                this->forced++;
+                this->advance();
+            }
+        }
+
+        last = this->activity.load();
+    }
+}
+
+uint64_t HostClock::getForced() {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    return this->forced;
+}
+
+ClockMode HostClock::getMode() const {return this->mode;}
+
+// Requires no params. Returns microseconds since boot.
+uint64_t HostClock::micros() {
+    if (this->mode == ClockMode::VIRTUAL) return this->now.load();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - this->start).count();
+}
+
+std::mutex &HostClock::kernelLock() {return this->mtx;}
+
+void HostClock::enroll() {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->participants++;
+    this->running++;
+}
+
+void HostClock::adopt() {adopted = true;}
+
+void HostClock::attach() {
+    this->enroll();
+    this->adopt();
+}
+
+// Requires no params. Removes the calling participant.
+void HostClock::detach() {
+    if (!adopted) return;
+    adopted = false;
+    this->withdraw();
+}
+
+// Requires no params. Removes a running participant. If it was the last
+// one running, the clock advances for those remaining.
+void HostClock::withdraw() {
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->participants--;
+    this->running--;
+    if (this->running == 0) this->advance();
+}
+
+// Requires kernel lock held, with no participant running. Moves virtual time
+// to the earliest deadline and wakes every waiter due at that time. 
+void HostClock::advance() {
+    if (this->mode != ClockMode::VIRTUAL) return;
+
+    uint64_t next = CLOCK_FOREVER;
+    for (Waiter* w : this->waiters) {
+        if (w->deadline < next) next = w->deadline;
+    }
+
+    if (next == CLOCK_FOREVER) { // Nothing can ever wake, report once.
+        if (!this->stalled && this->participants > 0) {
+            printf("HOST: all %u participants blocked without deadline\n",
+                this->participants);
+        }
+
+        this->stalled = true;
+        return;
+    }
+
+    this->stalled = false;
+    if (next > this->now) this->now = next;
+
+    for (auto it = this->waiters.begin(); it != this->waiters.end();) {
+        Waiter* w = *it;
+
+        if (w->deadline <= this->now) {
+            it = this->waiters.erase(it);
+            w->woken = true;
+            this->running++;
+            w->cv.notify_one();
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Requires waiter and held kernel lock. Parks the caller until woken by a
+// wake(), or by the deadline.
+void HostClock::suspendSelf(Waiter &w, std::unique_lock<std::mutex> &lock) {
+    w.woken = false;
+    this->waiters.push_back(&w);
+
+    if (this->mode == ClockMode::VIRTUAL) {
+        this->running--;
+        if (this->running == 0) this->advance();
+        w.cv.wait(lock, [&w] {return w.woken;});
+        return;
+    }
+
+    auto until = this->start + std::chrono::microseconds(w.deadline);
+
+    while (!w.woken) {
+        if (w.deadline == CLOCK_FOREVER) {
+            w.cv.wait(lock);
+        } else if (w.cv.wait_until(lock, until) == 
+            std::cv_status::timeout && !w.woken) {
+            this->waiters.remove(&w);
+            return;
+        }
+    }
+}
+
+// Requires held kernel lock, the key woken by wake(), deadline in micros, and
+// predicate. Blocks until the predicate is true or the deadline passes. 
+// Returns the predicate result.
+bool HostClock::block(std::unique_lock<std::mutex> &lock, const void* key,
+    uint64_t deadline, const std::function<bool()> &pred) {
+
+    if (!adopted && this->mode == ClockMode::VIRTUAL) { // Late participant.
+        this->participants++;
+        this->running++;
+        adopted = true;
+    }
+
+    Waiter w;
+    w.key = key;
+    w.deadline = deadline;
+    this->activity++;
+
+    while (!pred()) {
+        if (this->micros() >= deadline) return false;
+        this->suspendSelf(w, lock);
+    }
+
+    return true;
+}
+
+// Requires held kernel lock and key. Wakes every waiter blocked on key.
+void HostClock::wake(const void* key) {
+    this->activity++;
+
+    for (auto it = this->waiters.begin(); it != this->waiters.end();) {
+        Waiter* w = *it;
+
+        if (w->key == key && key != nullptr) {
+            it = this->waiters.erase(it);
+            w->woken = true;
+            if (this->mode == ClockMode::VIRTUAL) this->running++;
+            w->cv.notify_one();
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Requires target in micros since boot. Blocks the caller until the clock
+// has reached the target. Returns immediately if already passed.
+void HostClock::sleepUntilMicros(uint64_t target) {
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->block(lock, nullptr, target, [] {return false;});
+}
+
+}
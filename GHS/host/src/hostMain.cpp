@@ -0,0 +1,328 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "Config/config.hpp"
+#include "Network/NetCreds.hpp"
+#include "Sim/Sim.hpp"
+#include "Sim/Devices.hpp"
+#include "Sim/I2CSim.hpp"
+#include "Sim/HttpdSim.hpp"
+#include "Sim/HostClock.hpp"
+#include "Sim/Trace.hpp"
+#include "Common/Timing.hpp"
+#include "Network/UDPSender.hpp"
+#include <cstdio>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Host entry. Attaches the simulated board, sets the network switch, starts
+// the firmware through its unmodified app_main(), and optionally drives the
+// websocket/http interface while the firmware tasks run. With --virtual the
+// run length is simulated time, so that --days 30 exercises relay timers,
+// the end of day average clearing, hourly trends and heartbeat expiry in
+// minutes of wall time.
+
+extern "C" void app_main();
+
+namespace {
+
+struct Options {
+    uint64_t seconds; // Run time before exit.
+    bool sta; // Station mode with host creds, else WAP setup.
+    bool virt; // Virtual time.
+    int clockSecs; // Calibrated seconds past midnight, -1 if not set.
+    int clockDay; // Calibrated day, 0 = monday.
+    const char* trace; // Sensor trace path.
+    bool traceLoop; // Repeat the trace.
+    std::vector<std::string> ws; // Socket commands, cmd/supp/id/.
+    std::vector<std::string> get; // http GET URIs.
+    const char* flash; // Data partition backing file, persists the journal.
+    const char* spiffs; // Spiffs backing directory, persists the history.
+    std::vector<uint16_t> faults; // I2C addresses failing every transfer.
+    bool pong; // Answer keepalive pings.
+    uint64_t wsDelay; // Seconds after the server is up to send commands.
+};
+
+void usage() {
+    printf("usage: ghs_host [options]\n"
+        "  --seconds N      run for N seconds, default 10\n"
+        "  --days N         run for N days\n"
+        "  --virtual        run in virtual time, as fast as the CPU allows\n"
+        "  --clock S,D      calibrate to S seconds past midnight, day D\n"
+        "                   (0 = monday) once the firmware is up\n"
+        "  --trace FILE     drive the sensors from a CSV trace\n"
+        "  --trace-loop     repeat the trace\n"
+        "  --sta            station mode, else WAP setup mode\n"
+        "  --ws CMD         send socket command once the server is up\n"
+        "  --pong           answer keepalive pings, else the socket is reaped\n"
+        "  --ws-delay N     send the socket commands N seconds later\n"
+        "  --get URI        issue an http GET once the server is up\n"
+        "  --flash FILE     back the data partitions by FILE, keeping the\n"
+        "                   log journal and checkpoint across runs, else\n"
+        "                   erased\n"
+        "  --spiffs DIR     back the spiffs by DIR, keeping the history\n"
+        "                   across runs, else a temporary directory\n"
+        "  --fault ADDR     fail every I2C transfer to ADDR, e.g. 0x44\n");
+}
+
+bool parse(int argc, char** argv, Options &opt) {
+    opt.seconds = 10;
+    opt.sta = false;
+    opt.virt = false;
+    opt.clockSecs = -1;
+    opt.clockDay = 0;
+    opt.trace = nullptr;
+    opt.traceLoop = false;
+    opt.flash = nullptr;
+    opt.spiffs = nullptr;
+    opt.pong = false;
+    opt.wsDelay = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasVal = (i + 1 < argc);
+
+        if (strcmp(arg, "--seconds") == 0 && hasVal) {
+            opt.seconds = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--days") == 0 && hasVal) {
+            opt.seconds = strtoull(argv[++i], nullptr, 10) * SEC_PER_DAY;
+        } else if (strcmp(arg, "--virtual") == 0) {
+            opt.virt = true;
+        } else if (strcmp(arg, "--clock") == 0 && hasVal) {
+            if (sscanf(argv[++i], "%d,%d", &opt.clockSecs, &opt.clockDay) 
+                != 2) return false;
+        } else if (strcmp(arg, "--trace") == 0 && hasVal) {
+            opt.trace = argv[++i];
+        } else if (strcmp(arg, "--trace-loop") == 0) {
+            opt.traceLoop = true;
+        } else if (strcmp(arg, "--sta") == 0) {
+            opt.sta = true;
+        } else if (strcmp(arg, "--ws") == 0 && hasVal) {
+            opt.ws.push_back(argv[++i]);
+        } else if (strcmp(arg, "--pong") == 0) {
+            opt.pong = true;
+        } else if (strcmp(arg, "--ws-delay") == 0 && hasVal) {
+            opt.wsDelay = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--get") == 0 && hasVal) {
+            opt.get.push_back(argv[++i]);
+        } else if (strcmp(arg, "--flash") == 0 && hasVal) {
+            opt.flash = argv[++i];
+        } else if (strcmp(arg, "--spiffs") == 0 && hasVal) {
+            opt.spiffs = argv[++i];
+        } else if (strcmp(arg, "--fault") == 0 && hasVal) {
+            opt.faults.push_back(strtoul(argv[++i], nullptr, 16));
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Requires network mode. Sets the switch inputs, active LOW.
+void setNetSwitch(bool sta) {
+    gpio_num_t wapPin = CONF_PINS::pinMapD[
+        static_cast<uint8_t>(CONF_PINS::DPIN::WAP)];
+
+    gpio_num_t staPin = CONF_PINS::pinMapD[
+        static_cast<uint8_t>(CONF_PINS::DPIN::STA)];
+
+    Sim::setPin(wapPin, 1);
+    Sim::setPin(staPin, sta ? 0 : 1);
+}
+
+// Requires no params. Preloads the station credentials that would have been
+// entered on the WAP setup page.
+void loadHostCreds() {
+    static NVS::CredParams cp = {CRED_NAMESPACE};
+    NVS::Creds* creds = NVS::Creds::get(&cp);
+    const char ssid[] = "hostnet";
+    const char pass[] = "hostpass";
+    creds->write("ssid", ssid, sizeof(ssid));
+    creds->write("pass", pass, sizeof(pass));
+}
+
+void printRelayStats() {
+    CONF_PINS::DPIN relays[] = {CONF_PINS::DPIN::RE0, CONF_PINS::DPIN::RE1,
+        CONF_PINS::DPIN::RE2, CONF_PINS::DPIN::RE3};
+
+    for (int i = 0; i < 4; i++) {
+        gpio_num_t pin = CONF_PINS::pinMapD[static_cast<uint8_t>(relays[i])];
+        printf("HOST: relay %d  level %d, %u transitions\n", i, 
+            Sim::getPin(pin), Sim::getToggles(pin));
+    }
+}
+
+void printI2CStats() {
+    struct dev {const char* name; uint16_t addr;} devs[] = {
+        {"SSD1306", OLED_ADDR}, {"AS7341", AS7341_ADDR}, {"SHT31", SHT_ADDR},
+        {"ADS soil", ADC1_ADDR}, {"ADS photo", ADC2_ADDR}
+    };
+
+    printf("HOST: I2C  %-10s %8s %8s %8s %8s %10s\n", "device", "tx", "rx",
+        "txrx", "errors", "bytes");
+
+    for (const dev &d : devs) {
+        Sim::I2CStats s = Sim::getStats(d.addr);
+        printf("HOST: I2C  %-10s %8u %8u %8u %8u %10llu\n", d.name, s.tx, 
+            s.rx, s.txrx, s.errors, (unsigned long long)s.bytes);
+    }
+}
+
+void printUDPStats() {
+    Comms::UDPStats s;
+    Comms::UDPSender::get()->getStats(s);
+    printf("HOST: UDP  %u datagrams, %u log entries, %u dropped, %u send "
+        "fails, %u resolves\n", s.datagrams, s.entries, s.dropped, 
+        s.sendFails, s.resolves);
+}
+
+void printFlashStats() {
+    uint32_t writes{0}, erases{0};
+    uint64_t bytes{0};
+    Sim::getFlashStats(writes, erases, bytes);
+    printf("HOST: flash  %u writes, %llu bytes, %u sector erases\n", writes,
+        (unsigned long long)bytes, erases);
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+
+    if (!parse(argc, argv, opt)) {
+        usage();
+        return 1;
+    }
+
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    Sim::HostClock* clock = Sim::HostClock::get();
+    clock->setMode(opt.virt ? Sim::ClockMode::VIRTUAL : Sim::ClockMode::REAL);
+    clock->attach(); // The harness is a participant in virtual time.
+
+    if (opt.trace != nullptr) {
+        Sim::Trace trace;
+        std::string err;
+
+        if (!trace.load(opt.trace, err)) {
+            printf("HOST: trace %s\n", err.c_str());
+            return 1;
+        }
+
+        trace.setLoop(opt.traceLoop);
+        trace.install();
+    }
+
+    if (opt.flash != nullptr && !Sim::setFlashFile(opt.flash)) {
+        printf("HOST: flash file %s unavailable\n", opt.flash);
+        return 1;
+    }
+
+    if (opt.spiffs != nullptr && !Sim::setSpiffsDir(opt.spiffs)) {
+        printf("HOST: spiffs dir %s unavailable\n", opt.spiffs);
+        return 1;
+    }
+
+    Sim::attachBoard();
+    for (uint16_t addr : opt.faults) Sim::setFault(addr, ESP_FAIL);
+    setNetSwitch(opt.sta);
+    if (opt.sta) loadHostCreds();
+
+    std::atomic<uint32_t> frames{0};
+    Sim::setWsReceiver([&frames, &opt](int fd, const uint8_t* payload, 
+        size_t len, httpd_ws_type_t type) {
+        if (type == HTTPD_WS_TYPE_PING) {
+            printf("HOST: ws fd %d <- ping\n", fd);
+            if (opt.pong) Sim::wsControl(fd, HTTPD_WS_TYPE_PONG);
+        } else if (type == HTTPD_WS_TYPE_BINARY) { // Hex, see sktWire.js.
+            printf("HOST: ws fd %d <- bin %zu:", fd, len);
+            for (size_t i = 0; i < len; i++) printf("%02x", payload[i]);
+            printf("\n");
+        } else {
+            printf("HOST: ws fd %d <- %.*s\n", fd, (int)len, payload);
+        }
+
+        frames++;
+    });
+
+    auto wallStart = std::chrono::steady_clock::now();
+    app_main();
+
+    if (opt.clockSecs >= 0) {
+        Clock::DateTime::get()->calibrate(opt.clockSecs, opt.clockDay);
+    }
+
+    // Wait for the net task to bring up the server before driving it.
+    uint64_t deadline = clock->micros() + opt.seconds * 1000000;
+
+    while (!Sim::serverRunning() && clock->micros() < deadline) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+
+    if (Sim::serverRunning()) {
+        for (const std::string &uri : opt.get) {
+            std::string resp;
+            bool ok = Sim::request(uri.c_str(), resp);
+            printf("HOST: GET %s -> %s, %zu bytes\n%s\n", uri.c_str(), 
+                ok ? "OK" : "FAIL", resp.size(), resp.c_str());
+        }
+
+        if (!opt.ws.empty()) {
+            uint64_t sendAt = clock->micros() + opt.wsDelay * 1000000;
+            if (sendAt < deadline) clock->sleepUntilMicros(sendAt);
+            int fd = Sim::wsConnect();
+
+            for (const std::string &cmd : opt.ws) {
+                if (!Sim::wsSend(fd, cmd.c_str())) {
+                    printf("HOST: ws send %s failed\n", cmd.c_str());
+                }
+            }
+
+            Sim::drain();
+        }
+    }
+
+    // Sleep out the run one simulated day at a time to report progress.
+    const uint64_t dayMicros = (uint64_t)SEC_PER_DAY * 1000000;
+    uint64_t day = 0;
+
+    while (clock->micros() < deadline) {
+        uint64_t next = (clock->micros() / dayMicros + 1) * dayMicros;
+        clock->sleepUntilMicros((next < deadline) ? next : deadline);
+
+        if (opt.virt && clock->micros() >= next) {
+            Clock::TIME t;
+            Clock::DateTime::get()->getTime(&t);
+            double wall = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - wallStart).count();
+
+            printf("HOST: day %llu complete, clock %02u:%02u:%02u day %u, "
+                "%.1f s wall\n", (unsigned long long)++day, t.hour, 
+                t.minute, t.second, t.day, wall);
+        }
+    }
+
+    double wall = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - wallStart).count();
+
+    printf("HOST: ran %llu s %s time in %.1f s wall, %u ws frames received\n",
+        (unsigned long long)opt.seconds, opt.virt ? "virtual" : "real", wall,
+        frames.load());
+
+    if (opt.virt) {
+        printf("HOST: %llu stall advances\n", 
+            (unsigned long long)clock->getForced());
+    }
+
+    printRelayStats();
+    printI2CStats();
+    printUDPStats();
+    printFlashStats();
+    fflush(stdout);
+    Sim::removeSpiffsTemp();
+    std::_Exit(0); // Tasks never return, skip static destruction.
+}
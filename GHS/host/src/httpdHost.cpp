@@ -0,0 +1,472 @@
+#include "esp_http_server.h"
+#include "Sim/HttpdSim.hpp"
+#include "Sim/HostClock.hpp"
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Host http server. A single server thread runs injected requests and work
+// queued with httpd_queue_work, in submission order, mirroring the single
+// httpd task on target. The server thread and callers waiting on it block
+// through the host kernel so that virtual time accounts for them.
+
+namespace {
+
+struct hostReq { // Held in httpd_req_t::aux.
+    std::string uri; // Full URI including query.
+    std::string body; // Request body, or websocket frame payload.
+    size_t recvPos;
+    std::string response;
+    std::string headers; // Custom response headers, field: value lines.
+    httpd_ws_type_t wsType;
+    int fd;
+};
+
+struct hostServer { // Work and running are guarded by the kernel lock.
+    httpd_config_t conf;
+    std::vector<httpd_uri_t> uris;
+    std::deque<std::function<void()>> work;
+    bool running;
+    std::thread thread;
+};
+
+Sim::HostClock* kernel() {return Sim::HostClock::get();}
+
+std::mutex serverMtx;
+hostServer* active = nullptr; // Only one server runs at a time.
+Sim::WsReceiver receiver;
+std::mutex receiverMtx;
+std::set<int> openFds;
+int nextFd = 60; // Host socket numbers start above the lwip range.
+
+void serverLoop(hostServer* srv) {
+    kernel()->adopt(); // Enrolled by httpd_start.
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+
+    while (true) {
+        kernel()->block(lock, srv, CLOCK_FOREVER, 
+            [srv] {return !srv->work.empty() || !srv->running;});
+
+        if (!srv->running && srv->work.empty()) break;
+
+        std::function<void()> job = std::move(srv->work.front());
+        srv->work.pop_front();
+        lock.unlock();
+
+        job();
+
+        lock.lock();
+    }
+
+    lock.unlock();
+    kernel()->detach();
+}
+
+// Requires job. Queues the job to the active server. Returns false if no 
+// server is running.
+bool post(std::function<void()> job) {
+    std::lock_guard<std::mutex> guard(serverMtx);
+    if (active == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+    if (!active->running) return false;
+    active->work.push_back(std::move(job));
+    kernel()->wake(active);
+    return true;
+}
+
+// Requires job. Runs the job on the server thread and blocks until complete.
+// Returns false if no server is running.
+bool run(std::function<void()> job) {
+    bool done = false;
+
+    bool posted = post([&] {
+        job();
+        std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+        done = true;
+        kernel()->wake(&done);
+    });
+
+    if (!posted) return false;
+
+    std::unique_lock<std::mutex> lock(kernel()->kernelLock());
+    kernel()->block(lock, &done, CLOCK_FOREVER, [&done] {return done;});
+    return true;
+}
+
+// Requires server, URI and method. Matches the URI up to the query against
+// the registered handlers. Returns the handler or nullptr.
+const httpd_uri_t* match(hostServer* srv, const std::string &uri, 
+    int method) {
+
+    std::string path = uri.substr(0, uri.find('?'));
+
+    for (const httpd_uri_t &entry : srv->uris) {
+        if (path == entry.uri && (entry.method == method || 
+            entry.is_websocket)) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+// Requires URI, method, body, fd and ws type. Dispatches a request to its
+// handler on the server thread. Returns the handler result and populates
+// response.
+esp_err_t dispatch(const std::string &uri, int method, const std::string &body,
+    int fd, httpd_ws_type_t wsType, std::string* response) {
+
+    esp_err_t result = ESP_ERR_NOT_FOUND;
+
+    bool ran = run([&] {
+        hostServer* srv = active;
+        httpd_uri_t handler;
+
+        {
+            std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+            const httpd_uri_t* found = match(srv, uri, method);
+            if (found == nullptr) return;
+            handler = *found; // Registration may continue concurrently.
+        }
+
+        const httpd_uri_t* entry = &handler;
+
+        // Control frames are consumed by the server unless requested.
+        if (wsType >= HTTPD_WS_TYPE_CLOSE && !entry->handle_ws_control_frames) {
+            result = ESP_OK;
+            return;
+        }
+
+        hostReq ctx{uri, body, 0, "", "", wsType, fd};
+        httpd_req_t req{};
+        req.handle = srv;
+        req.method = method;
+        req.uri = ctx.uri.c_str();
+        req.content_len = body.size();
+        req.aux = &ctx;
+        req.user_ctx = entry->user_ctx;
+
+        result = entry->handler(&req);
+        if (response == nullptr) return;
+
+        // Custom headers precede the body as in HTTP, only when set so that
+        // other responses are unchanged.
+        *response = ctx.headers.empty() ? ctx.response : 
+            ctx.headers + "\r\n" + ctx.response;
+    });
+
+    return ran ? result : ESP_FAIL;
+}
+
+hostReq* ctxOf(httpd_req_t* req) {return static_cast<hostReq*>(req->aux);}
+
+}
+
+namespace Sim {
+
+bool serverRunning() {
+    std::lock_guard<std::mutex> guard(serverMtx);
+    return active != nullptr;
+}
+
+void setWsReceiver(WsReceiver rcv) {
+    std::lock_guard<std::mutex> lock(receiverMtx);
+    receiver = rcv;
+}
+
+int wsConnect(const char* uri) {
+    int fd;
+
+    {
+        std::lock_guard<std::mutex> guard(serverMtx);
+        fd = nextFd++;
+    }
+
+    // The handshake reaches the handler as a GET, frames do not.
+    if (dispatch(uri, HTTP_GET, "", fd, HTTPD_WS_TYPE_TEXT, nullptr) != 
+        ESP_OK) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> guard(serverMtx);
+    openFds.insert(fd);
+    return fd;
+}
+
+bool wsSend(int fd, const char* text, const char* uri) {
+    {
+        std::lock_guard<std::mutex> guard(serverMtx);
+        if (openFds.count(fd) == 0) return false;
+    }
+
+    return dispatch(uri, 0, text, fd, HTTPD_WS_TYPE_TEXT, nullptr) == ESP_OK;
+}
+
+bool wsControl(int fd, httpd_ws_type_t type, const char* uri) {
+    {
+        std::lock_guard<std::mutex> guard(serverMtx);
+        if (openFds.count(fd) == 0) return false;
+    }
+
+    return dispatch(uri, 0, "", fd, type, nullptr) == ESP_OK;
+}
+
+void wsClose(int fd) {
+    std::lock_guard<std::mutex> guard(serverMtx);
+    openFds.erase(fd);
+}
+
+bool request(const char* uri, std::string &response, httpd_method_t method,
+    const std::string &body) {
+
+    return dispatch(uri, method, body, -1, HTTPD_WS_TYPE_TEXT, &response) 
+        == ESP_OK;
+}
+
+void drain() {
+    run([] {}); // Everything queued before this has completed.
+}
+
+}
+
+esp_err_t httpd_start(httpd_handle_t* handle, const httpd_config_t* config) {
+    std::lock_guard<std::mutex> guard(serverMtx);
+    if (active != nullptr) return ESP_ERR_INVALID_STATE;
+
+    hostServer* srv = new hostServer();
+    srv->conf = *config;
+    srv->running = true;
+    kernel()->enroll();
+    srv->thread = std::thread(serverLoop, srv);
+
+    active = srv;
+    *handle = srv;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+    hostServer* srv = static_cast<hostServer*>(handle);
+    if (srv == nullptr) return ESP_ERR_INVALID_ARG;
+
+    {
+        std::lock_guard<std::mutex> guard(serverMtx);
+        if (active == srv) active = nullptr;
+        openFds.clear(); // Sessions close with the server.
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+        srv->running = false;
+        kernel()->wake(srv);
+    }
+
+    if (srv->thread.get_id() != std::this_thread::get_id()) {
+        srv->thread.join();
+        delete srv;
+    } else {
+        srv->thread.detach(); // Stopped from within a handler.
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+    const httpd_uri_t* uri) {
+
+    hostServer* srv = static_cast<hostServer*>(handle);
+    if (srv == nullptr || uri == nullptr) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+    if (srv->uris.size() >= srv->conf.max_uri_handlers) return ESP_FAIL;
+
+    for (const httpd_uri_t &entry : srv->uris) {
+        if (strcmp(entry.uri, uri->uri) == 0 && entry.method == uri->method) {
+            return ESP_FAIL; // Handler exists.
+        }
+    }
+
+    srv->uris.push_back(*uri);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t* req, const char* type) {
+    return (req != nullptr) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t* req, const char* field,
+    const char* value) {
+
+    if (req == nullptr || field == nullptr || value == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ctxOf(req)->headers.append(field).append(": ").append(value)
+        .append("\r\n");
+
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t* req, const char* buf, ssize_t len) {
+    if (req == nullptr) return ESP_ERR_INVALID_ARG;
+    if (buf == nullptr) return ESP_OK;
+    if (len < 0) len = strlen(buf); // HTTPD_RESP_USE_STRLEN
+
+    ctxOf(req)->response.append(buf, len);
+    return ESP_OK;
+}
+
+// Chunks are appended to the same response, a null buf terminates it.
+esp_err_t httpd_resp_send_chunk(httpd_req_t* req, const char* buf, 
+    ssize_t len) {
+
+    return httpd_resp_send(req, buf, len);
+}
+
+esp_err_t httpd_resp_sendstr(httpd_req_t* req, const char* str) {
+    return httpd_resp_send(req, str, -1);
+}
+
+int httpd_req_recv(httpd_req_t* req, char* buf, size_t len) {
+    hostReq* ctx = ctxOf(req);
+    size_t remaining = ctx->body.size() - ctx->recvPos;
+    size_t n = (len < remaining) ? len : remaining;
+
+    memcpy(buf, ctx->body.data() + ctx->recvPos, n);
+    ctx->recvPos += n;
+    return (int)n;
+}
+
+int httpd_req_to_sockfd(httpd_req_t* req) {
+    return (req != nullptr) ? ctxOf(req)->fd : -1;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t* req, char* buf,
+    size_t len) {
+
+    const std::string &uri = ctxOf(req)->uri;
+    size_t q = uri.find('?');
+    if (q == std::string::npos) return ESP_ERR_NOT_FOUND;
+
+    std::string query = uri.substr(q + 1);
+    if (query.size() >= len) return ESP_ERR_INVALID_SIZE;
+
+    memcpy(buf, query.c_str(), query.size() + 1);
+    return ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char* query, const char* key,
+    char* val, size_t len) {
+
+    std::string q(query);
+    std::string k(key);
+    size_t pos = 0;
+
+    while (pos <= q.size()) {
+        size_t end = q.find('&', pos);
+        if (end == std::string::npos) end = q.size();
+
+        std::string pair = q.substr(pos, end - pos);
+        size_t eq = pair.find('=');
+
+        if (pair.substr(0, eq) == k) {
+            std::string v = (eq == std::string::npos) ? "" : 
+                pair.substr(eq + 1);
+
+            if (v.size() >= len) {
+                snprintf(val, len, "%s", v.c_str()); // Truncates as IDF.
+                return ESP_ERR_INVALID_SIZE;
+            }
+
+            memcpy(val, v.c_str(), v.size() + 1);
+            return ESP_OK;
+        }
+
+        pos = end + 1;
+    }
+
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work,
+    void* arg) {
+
+    hostServer* srv = static_cast<hostServer*>(handle);
+    if (srv == nullptr || work == nullptr) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard<std::mutex> lock(kernel()->kernelLock());
+    if (!srv->running) return ESP_FAIL;
+
+    srv->work.push_back([work, arg] {work(arg);});
+    kernel()->wake(srv);
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_recv_frame(httpd_req_t* req, httpd_ws_frame_t* pkt,
+    size_t maxLen) {
+
+    hostReq* ctx = ctxOf(req);
+    pkt->type = ctx->wsType;
+    pkt->final = true;
+    pkt->fragmented = false;
+
+    if (maxLen == 0) { // Length query.
+        pkt->len = ctx->body.size();
+        return ESP_OK;
+    }
+
+    if (pkt->payload == nullptr) return ESP_ERR_INVALID_ARG;
+
+    size_t n = (maxLen < ctx->body.size()) ? maxLen : ctx->body.size();
+    memcpy(pkt->payload, ctx->body.data(), n);
+    pkt->len = n;
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd,
+    httpd_ws_frame_t* frame) {
+
+    if (hd == nullptr || frame == nullptr) return ESP_ERR_INVALID_ARG;
+
+    {
+        std::lock_guard<std::mutex> guard(serverMtx);
+        if (openFds.count(fd) == 0) return ESP_FAIL; // Session closed.
+    }
+
+    Sim::WsReceiver rcv;
+
+    {
+        std::lock_guard<std::mutex> lock(receiverMtx);
+        rcv = receiver;
+    }
+
+    if (rcv) rcv(fd, frame->payload, frame->len, frame->type);
+    return ESP_OK;
+}
+
+esp_err_t httpd_ws_send_frame(httpd_req_t* req, httpd_ws_frame_t* frame) {
+    if (req == nullptr) return ESP_ERR_INVALID_ARG;
+    return httpd_ws_send_frame_async(req->handle, ctxOf(req)->fd, frame);
+}
+
+// The session closes once the server processes the request, as ESP-IDF.
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+    if (handle == nullptr) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard<std::mutex> guard(serverMtx);
+    return (openFds.erase(sockfd) > 0) ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+httpd_ws_client_info_t httpd_ws_get_fd_info(httpd_handle_t hd, int fd) {
+    if (hd == nullptr) return HTTPD_WS_CLIENT_INVALID;
+
+    std::lock_guard<std::mutex> guard(serverMtx);
+    return (openFds.count(fd) == 0) ? HTTPD_WS_CLIENT_INVALID :
+        HTTPD_WS_CLIENT_WEBSOCKET; // Only websocket sessions stay open.
+}
@@ -0,0 +1,123 @@
+#include "driver/i2c_master.h"
+#include "Sim/I2CSim.hpp"
+#include <mutex>
+#include <map>
+
+// Host I2C master. Transfers are dispatched to the attached simulated client
+// at the device address. Unattached addresses NACK with ESP_FAIL, as they
+// would on a real bus.
+
+struct hostI2CBus {
+    i2c_master_bus_config_t conf;
+};
+
+struct hostI2CDev {
+    uint16_t addr;
+    uint32_t speed;
+};
+
+namespace {
+
+struct slot {
+    Sim::I2CDevice* dev;
+    esp_err_t fault;
+    Sim::I2CStats stats;
+};
+
+std::mutex busMtx; // Serializes the bus, as the master would.
+std::map<uint16_t, slot> slots;
+
+// Requires device handle and the transfer. Runs the transfer against the
+// attached client with the bus held. Returns the transfer result.
+template <typename Fn>
+esp_err_t transfer(i2c_master_dev_handle_t dev, size_t bytes, 
+    uint32_t Sim::I2CStats::*counter, Fn fn) {
+
+    if (dev == nullptr) return ESP_ERR_INVALID_ARG;
+
+    std::lock_guard<std::mutex> lock(busMtx);
+    slot &s = slots[dev->addr];
+
+    s.stats.*counter += 1;
+    esp_err_t err = (s.dev == nullptr) ? ESP_FAIL : 
+        (s.fault != ESP_OK) ? s.fault : fn(s.dev);
+
+    if (err != ESP_OK) {
+        s.stats.errors++;
+    } else {
+        s.stats.bytes += bytes;
+    }
+
+    return err;
+}
+
+}
+
+namespace Sim {
+
+void attachDevice(uint16_t addr, I2CDevice* dev) {
+    std::lock_guard<std::mutex> lock(busMtx);
+    slots[addr].dev = dev;
+}
+
+void setFault(uint16_t addr, esp_err_t err) {
+    std::lock_guard<std::mutex> lock(busMtx);
+    slots[addr].fault = err;
+}
+
+I2CStats getStats(uint16_t addr) {
+    std::lock_guard<std::mutex> lock(busMtx);
+    return slots[addr].stats;
+}
+
+}
+
+esp_err_t i2c_new_master_bus(const i2c_master_bus_config_t* conf,
+    i2c_master_bus_handle_t* handle) {
+
+    *handle = new hostI2CBus{*conf};
+    return ESP_OK;
+}
+
+esp_err_t i2c_del_master_bus(i2c_master_bus_handle_t handle) {
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_add_device(i2c_master_bus_handle_t bus,
+    const i2c_device_config_t* conf, i2c_master_dev_handle_t* handle) {
+
+    if (bus == nullptr) return ESP_ERR_INVALID_ARG;
+    *handle = new hostI2CDev{conf->device_address, conf->scl_speed_hz};
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_bus_rm_device(i2c_master_dev_handle_t handle) {
+    delete handle;
+    return ESP_OK;
+}
+
+esp_err_t i2c_master_transmit(i2c_master_dev_handle_t dev,
+    const uint8_t* writeBuf, size_t writeSize, int timeout_ms) {
+
+    return transfer(dev, writeSize, &Sim::I2CStats::tx, 
+        [&](Sim::I2CDevice* d) {return d->write(writeBuf, writeSize);});
+}
+
+esp_err_t i2c_master_receive(i2c_master_dev_handle_t dev, uint8_t* readBuf,
+    size_t readSize, int timeout_ms) {
+
+    return transfer(dev, readSize, &Sim::I2CStats::rx,
+        [&](Sim::I2CDevice* d) {return d->read(readBuf, readSize);});
+}
+
+esp_err_t i2c_master_transmit_receive(i2c_master_dev_handle_t dev,
+    const uint8_t* writeBuf, size_t writeSize, uint8_t* readBuf,
+    size_t readSize, int timeout_ms) {
+
+    return transfer(dev, writeSize + readSize, &Sim::I2CStats::txrx,
+        [&](Sim::I2CDevice* d) {
+            esp_err_t err = d->write(writeBuf, writeSize);
+            return (err == ESP_OK) ? d->read(readBuf, readSize) : err;
+        });
+}
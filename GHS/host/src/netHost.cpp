@@ -0,0 +1,315 @@
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "mdns.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/pk.h"
+#include <arpa/inet.h>
+#include "cJSON.h"
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+// Network stack shims. The radio is simulated as an access point that always
+// associates. Station connections fire IP_EVENT_STA_GOT_IP synchronously on
+// connect. Outbound http, OTA and signature checks are not simulated and fail
+// closed.
+
+esp_event_base_t const IP_EVENT = "IP_EVENT";
+esp_event_base_t const WIFI_EVENT = "WIFI_EVENT";
+
+namespace {
+
+std::mutex netMtx;
+esp_event_handler_t ipHandler = nullptr;
+void* ipHandlerArg = nullptr;
+wifi_mode_t wifiMode = WIFI_MODE_NULL;
+wifi_config_t staConf{}, apConf{};
+bool started = false, connected = false;
+char mdnsName[32] = "greenhouse";
+esp_netif_obj* const netifSTA = reinterpret_cast<esp_netif_obj*>(0x1);
+esp_netif_obj* const netifAP = reinterpret_cast<esp_netif_obj*>(0x2);
+
+}
+
+// EVENTS
+
+esp_err_t esp_event_loop_create_default() {return ESP_OK;}
+
+esp_err_t esp_event_handler_register(esp_event_base_t base, int32_t id,
+    esp_event_handler_t handler, void* arg) {
+
+    std::lock_guard<std::mutex> lock(netMtx);
+    if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        ipHandler = handler;
+        ipHandlerArg = arg;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_unregister(esp_event_base_t base, int32_t id,
+    esp_event_handler_t handler) {
+
+    std::lock_guard<std::mutex> lock(netMtx);
+    if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP && handler == ipHandler) {
+        ipHandler = nullptr;
+    }
+
+    return ESP_OK;
+}
+
+// NETIF
+
+esp_err_t esp_netif_init() {return ESP_OK;}
+esp_netif_t* esp_netif_create_default_wifi_ap() {return netifAP;}
+esp_netif_t* esp_netif_create_default_wifi_sta() {return netifSTA;}
+esp_err_t esp_netif_dhcps_start(esp_netif_t* netif) {return ESP_OK;}
+esp_err_t esp_netif_dhcps_stop(esp_netif_t* netif) {return ESP_OK;}
+esp_err_t esp_netif_set_ip_info(esp_netif_t* netif,
+    const esp_netif_ip_info_t* info) {return ESP_OK;}
+
+char* esp_ip4addr_ntoa(const esp_ip4_addr_t* addr, char* buf, int len) {
+    uint32_t a = addr->addr;
+    snprintf(buf, len, "%u.%u.%u.%u", a & 0xFF, (a >> 8) & 0xFF,
+        (a >> 16) & 0xFF, (a >> 24) & 0xFF);
+    return buf;
+}
+
+// WIFI
+
+esp_err_t esp_wifi_init(const wifi_init_config_t* config) {return ESP_OK;}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    wifiMode = mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_mode(wifi_mode_t* mode) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    if (!started) return ESP_ERR_WIFI_NOT_INIT;
+    *mode = wifiMode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t iface, wifi_config_t* conf) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    if (iface == WIFI_IF_STA) {staConf = *conf;} else {apConf = *conf;}
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t iface, wifi_config_t* conf) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    *conf = (iface == WIFI_IF_STA) ? staConf : apConf;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start() {
+    std::lock_guard<std::mutex> lock(netMtx);
+    started = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_stop() {
+    std::lock_guard<std::mutex> lock(netMtx);
+    started = connected = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect() {
+    esp_event_handler_t handler;
+    void* arg;
+
+    {
+        std::lock_guard<std::mutex> lock(netMtx);
+        if (!started) return ESP_ERR_WIFI_NOT_STARTED;
+        connected = true;
+        handler = ipHandler;
+        arg = ipHandlerArg;
+    }
+
+    if (handler != nullptr) { // Lease a fixed address.
+        ip_event_got_ip_t event{};
+        event.esp_netif = netifSTA;
+        IP4_ADDR(&event.ip_info.ip, 192, 168, 1, 50);
+        IP4_ADDR(&event.ip_info.netmask, 255, 255, 255, 0);
+        IP4_ADDR(&event.ip_info.gw, 192, 168, 1, 1);
+        handler(arg, IP_EVENT, IP_EVENT_STA_GOT_IP, &event);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_disconnect() {
+    std::lock_guard<std::mutex> lock(netMtx);
+    connected = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t* info) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    if (!connected) return ESP_ERR_WIFI_NOT_CONNECT;
+
+    memset(info, 0, sizeof(wifi_ap_record_t));
+    memcpy(info->ssid, staConf.sta.ssid, sizeof(staConf.sta.ssid));
+    info->rssi = -55;
+    info->primary = 6;
+    info->authmode = WIFI_AUTH_WPA2_PSK;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t* list) {
+    memset(list, 0, sizeof(wifi_sta_list_t));
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_start(const wifi_scan_config_t* conf, bool block) {
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_scan_get_ap_records(uint16_t* number,
+    wifi_ap_record_t* records) {
+
+    *number = 0; // No mesh APs, current association is kept.
+    return ESP_OK;
+}
+
+// MDNS
+
+esp_err_t mdns_init() {return ESP_OK;}
+void mdns_free() {}
+
+esp_err_t mdns_hostname_set(const char* hostname) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    snprintf(mdnsName, sizeof(mdnsName), "%s", hostname);
+    return ESP_OK;
+}
+
+esp_err_t mdns_hostname_get(char* hostname) {
+    std::lock_guard<std::mutex> lock(netMtx);
+    strcpy(hostname, mdnsName);
+    return ESP_OK;
+}
+
+esp_err_t mdns_instance_name_set(const char* name) {return ESP_OK;}
+
+// The primary node is simulated on loopback, receive with ghs_logdecode.
+esp_err_t mdns_query_a(const char* host_name, uint32_t timeout,
+    esp_ip4_addr_t* addr) {
+
+    if (host_name == nullptr || addr == nullptr) return ESP_ERR_INVALID_ARG;
+    addr->addr = htonl(INADDR_LOOPBACK);
+    return ESP_OK;
+}
+esp_err_t mdns_service_add(const char* instance, const char* service,
+    const char* proto, uint16_t port, mdns_txt_item_t* txt,
+    size_t txtCount) {return ESP_OK;}
+
+// HTTP CLIENT. Handles are valid, but connections never open.
+
+struct esp_http_client {int unused;};
+
+esp_http_client_handle_t esp_http_client_init(
+    const esp_http_client_config_t* config) {
+
+    return new esp_http_client{0};
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client,
+    const char* key, const char* value) {return ESP_OK;}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client,
+    const char* data, int len) {return ESP_OK;}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client,
+    int writeLen) {return ESP_FAIL;}
+
+int esp_http_client_write(esp_http_client_handle_t client, const char* buf,
+    int len) {return -1;}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client) {
+    return -1;
+}
+
+int esp_http_client_read(esp_http_client_handle_t client, char* buf,
+    int len) {return -1;}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+    delete client;
+    return ESP_OK;
+}
+
+esp_err_t esp_crt_bundle_attach(void* conf) {return ESP_OK;}
+
+// OTA. No second image exists on the host, the app partitions are not 
+// readable, see flashHost.cpp.
+
+namespace {
+const esp_partition_t runningPart = {0x10000, 0x1E0000, "app0", false};
+}
+
+const esp_partition_t* esp_ota_get_running_partition() {
+    return &runningPart;
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(
+    const esp_partition_t* start) {return nullptr;}
+
+esp_err_t esp_ota_begin(const esp_partition_t* partition, size_t size,
+    esp_ota_handle_t* handle) {return ESP_FAIL;}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void* data,
+    size_t size) {return ESP_FAIL;}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle) {return ESP_FAIL;}
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+    return ESP_FAIL;
+}
+
+// MBEDTLS
+
+void mbedtls_sha256_init(mbedtls_sha256_context* ctx) {}
+void mbedtls_sha256_free(mbedtls_sha256_context* ctx) {}
+int mbedtls_sha256_starts(mbedtls_sha256_context* ctx, int is224) {
+    return -1;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context* ctx, const uint8_t* input,
+    size_t len) {return -1;}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context* ctx, uint8_t* output) {
+    return -1;
+}
+
+void mbedtls_pk_init(mbedtls_pk_context* ctx) {ctx->type = MBEDTLS_PK_NONE;}
+void mbedtls_pk_free(mbedtls_pk_context* ctx) {}
+int mbedtls_pk_parse_public_key(mbedtls_pk_context* ctx,
+    const unsigned char* key, size_t keyLen) {return -1;}
+
+mbedtls_pk_type_t mbedtls_pk_get_type(const mbedtls_pk_context* ctx) {
+    return ctx->type;
+}
+
+size_t mbedtls_pk_get_bitlen(const mbedtls_pk_context* ctx) {return 0;}
+int mbedtls_pk_verify(mbedtls_pk_context* ctx, mbedtls_md_type_t md,
+    const unsigned char* hash, size_t hashLen, const unsigned char* sig,
+    size_t sigLen) {return -1;}
+
+// CJSON
+
+cJSON* cJSON_Parse(const char* value) {return nullptr;}
+cJSON* cJSON_GetObjectItem(const cJSON* object, const char* key) {
+    return nullptr;
+}
+
+int cJSON_IsString(const cJSON* item) {return 0;}
+void cJSON_Delete(cJSON* item) {}
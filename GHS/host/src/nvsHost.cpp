@@ -0,0 +1,121 @@
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// In memory NVS. Each namespace maps keys to raw bytes, and values persist
+// for the life of the host process. Sized entries behave as they do on
+// target, a get_blob with a null buffer returns the stored length.
+
+namespace {
+
+typedef std::map<std::string, std::vector<uint8_t>> nvsSpace;
+
+std::mutex nvsMtx;
+std::map<std::string, nvsSpace> spaces;
+std::map<nvs_handle_t, std::string> handles; // handle -> namespace
+nvs_handle_t nextHandle = 1;
+bool flashInit = false;
+
+// Requires handle. Returns the namespace of the handle, or nullptr.
+nvsSpace* getSpace(nvs_handle_t handle) {
+    auto it = handles.find(handle);
+    if (it == handles.end()) return nullptr;
+    return &spaces[it->second];
+}
+
+esp_err_t setRaw(nvs_handle_t handle, const char* key, const void* value,
+    size_t length) {
+
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    nvsSpace* space = getSpace(handle);
+    if (space == nullptr) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    (*space)[key].assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+}
+
+esp_err_t nvs_flash_init() {
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    flashInit = true;
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase() {
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    spaces.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* nameSpace, nvs_open_mode_t mode,
+    nvs_handle_t* handle) {
+
+    (void)mode;
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    if (!flashInit) return ESP_ERR_NVS_NOT_INITIALIZED;
+
+    *handle = nextHandle++;
+    handles[*handle] = nameSpace;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    handles.erase(handle);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    return (getSpace(handle) != nullptr) ? ESP_OK : 
+        ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key,
+    const void* value, size_t length) {
+
+    return setRaw(handle, key, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* value,
+    size_t* length) {
+
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    nvsSpace* space = getSpace(handle);
+    if (space == nullptr) return ESP_ERR_NVS_INVALID_HANDLE;
+
+    auto it = space->find(key);
+    if (it == space->end()) return ESP_ERR_NVS_NOT_FOUND;
+
+    if (value == nullptr) { // Length query.
+        *length = it->second.size();
+        return ESP_OK;
+    }
+
+    if (*length < it->second.size()) return ESP_ERR_NVS_INVALID_LENGTH;
+
+    memcpy(value, it->second.data(), it->second.size());
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char* key, uint32_t value) {
+    return setRaw(handle, key, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char* key, uint32_t* value) {
+    size_t len = sizeof(uint32_t);
+    return nvs_get_blob(handle, key, value, &len);
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    std::lock_guard<std::mutex> lock(nvsMtx);
+    nvsSpace* space = getSpace(handle);
+    if (space == nullptr) return ESP_ERR_NVS_INVALID_HANDLE;
+    return (space->erase(key) > 0) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
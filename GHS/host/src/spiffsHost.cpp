@@ -0,0 +1,95 @@
+#include "esp_spiffs.h"
+#include "Sim/Sim.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+// Host spiffs. Registering the spiffs maps its base path, such as /spiffs,
+// to a host directory, so that the firmware stdio on the mount reaches it.
+// fopen is wrapped at link, see CMakeLists.txt, paths beyond the mount pass
+// through. The directory is a temporary one, removed by the harness upon
+// exit, as an erased spiffs, unless set, which keeps the files across runs
+// as across restarts.
+
+namespace {
+
+struct Spiffs {
+    std::mutex mtx;
+    std::string base; // Mount path of the firmware, empty until registered.
+    std::string dir; // Host directory backing the mount.
+    bool temp = false; // dir is temporary, removed upon exit.
+};
+
+Spiffs &spiffs() {
+    static Spiffs instance;
+    return instance;
+}
+
+}
+
+namespace Sim {
+
+bool setSpiffsDir(const char* path) {
+    Spiffs &s = spiffs();
+    std::lock_guard<std::mutex> lock(s.mtx);
+
+    std::error_code err;
+    std::filesystem::create_directories(path, err);
+    if (!std::filesystem::is_directory(path, err)) return false;
+
+    s.dir = path;
+    return true;
+}
+
+void removeSpiffsTemp() {
+    Spiffs &s = spiffs();
+    std::lock_guard<std::mutex> lock(s.mtx);
+
+    std::error_code err;
+    if (s.temp) std::filesystem::remove_all(s.dir, err);
+    s.temp = false;
+}
+
+}
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf) {
+    if (conf == nullptr || conf->base_path == nullptr) return ESP_FAIL;
+
+    Spiffs &s = spiffs();
+    std::lock_guard<std::mutex> lock(s.mtx);
+
+    if (s.dir.empty()) {
+        char tmpl[] = "/tmp/ghs_spiffsXXXXXX";
+        if (mkdtemp(tmpl) == nullptr) return ESP_FAIL;
+        s.dir = tmpl;
+        s.temp = true;
+    }
+
+    s.base = conf->base_path;
+    return ESP_OK;
+}
+
+extern "C" FILE* __real_fopen(const char* path, const char* mode);
+
+// Requires the path and mode. Opens the path within the host directory if
+// upon the spiffs mount, else the path as is.
+extern "C" FILE* __wrap_fopen(const char* path, const char* mode) {
+    Spiffs &s = spiffs();
+    std::string mapped;
+
+    {
+        std::lock_guard<std::mutex> lock(s.mtx);
+        size_t len = s.base.size();
+
+        if (path != nullptr && len > 0 &&
+            strncmp(path, s.base.c_str(), len) == 0 && path[len] == '/') {
+
+            mapped = s.dir + (path + len);
+        }
+    }
+
+    return __real_fopen(mapped.empty() ? path : mapped.c_str(), mode);
+}
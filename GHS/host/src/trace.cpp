@@ -0,0 +1,145 @@
+#include "Sim/Trace.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace Sim {
+
+Trace::Trace() : used{false}, loop(false) {}
+
+// Requires readings and field index. Returns pointer to the field within the
+// readings, in the column order documented in the header.
+float* Trace::field(Readings &r, int idx) {
+    if (idx == 0) return &r.tempC;
+    if (idx == 1) return &r.hum;
+    idx -= 2;
+    if (idx < ENV_COLOR_CHANNELS) return &r.color[idx];
+    idx -= ENV_COLOR_CHANNELS;
+    if (idx < ENV_ADC_CHANNELS) return &r.photoV[idx];
+    return &r.soilV[idx - ENV_ADC_CHANNELS];
+}
+
+// Requires column name. Returns the field index or -1 if unrecognized.
+int Trace::fieldIdx(const std::string &name) {
+    static const char* names[TRACE_FIELD_COUNT] = {
+        "tempC", "hum", "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8",
+        "clear", "nir", "photo0", "photo1", "photo2", "photo3", 
+        "soil0", "soil1", "soil2", "soil3"
+    };
+
+    for (int i = 0; i < TRACE_FIELD_COUNT; i++) {
+        if (name == names[i]) return i;
+    }
+
+    return -1;
+}
+
+// Requires path and error string. Loads the CSV trace. Returns true if 
+// loaded, or false with err populated.
+bool Trace::load(const char* path, std::string &err) {
+    std::ifstream file(path);
+    if (!file) {
+        err = std::string("cannot open ") + path;
+        return false;
+    }
+
+    std::string line;
+    std::vector<int> cols; // Field index per column after time.
+
+    while (std::getline(file, line)) { // Header, skipping comments.
+        if (line.empty() || line[0] == '#') continue;
+
+        std::stringstream ss(line);
+        std::string name;
+        std::getline(ss, name, ','); // Time column.
+
+        while (std::getline(ss, name, ',')) {
+            int idx = Trace::fieldIdx(name);
+            if (idx < 0) {
+                err = "unknown column " + name;
+                return false;
+            }
+
+            cols.push_back(idx);
+            this->used[idx] = true;
+        }
+
+        break;
+    }
+
+    size_t lineNum = 1;
+    while (std::getline(file, line)) {
+        lineNum++;
+        if (line.empty() || line[0] == '#') continue;
+
+        Row row{};
+        std::stringstream ss(line);
+        std::string cell;
+
+        std::getline(ss, cell, ',');
+        row.t = atof(cell.c_str());
+
+        for (size_t i = 0; i < cols.size(); i++) {
+            if (!std::getline(ss, cell, ',')) {
+                err = "short row at line " + std::to_string(lineNum);
+                return false;
+            }
+
+            row.val[cols[i]] = atof(cell.c_str());
+        }
+
+        if (!this->rows.empty() && row.t < this->rows.back().t) {
+            err = "time out of order at line " + std::to_string(lineNum);
+            return false;
+        }
+
+        this->rows.push_back(row);
+    }
+
+    if (this->rows.empty()) {
+        err = "no rows";
+        return false;
+    }
+
+    return true;
+}
+
+void Trace::setLoop(bool loop) {this->loop = loop;}
+
+// Requires time in micros and readings. Populates the readings from the
+// trace, interpolated, on top of the diurnal model.
+void Trace::apply(uint64_t micros, Readings &out) const {
+    Environment::diurnal(micros, out);
+
+    double t = micros / 1e6;
+    double period = this->rows.back().t;
+    if (this->loop && period > 0) t = std::fmod(t, period);
+
+    // Locate the bracketing rows, and clamp outside of the trace.
+    size_t hi = 0;
+    while (hi < this->rows.size() && this->rows[hi].t < t) hi++;
+
+    const Row &b = this->rows[(hi < this->rows.size()) ? hi : hi - 1];
+    const Row &a = this->rows[(hi > 0) ? hi - 1 : 0];
+    double span = b.t - a.t;
+    double frac = (span > 0) ? (t - a.t) / span : 0;
+    if (frac < 0) frac = 0;
+    if (frac > 1) frac = 1;
+
+    for (int i = 0; i < TRACE_FIELD_COUNT; i++) {
+        if (!this->used[i]) continue;
+        *Trace::field(out, i) = a.val[i] + (b.val[i] - a.val[i]) * frac;
+    }
+}
+
+// Requires no params. Installs a copy of this trace as the environment model.
+void Trace::install() const {
+    Trace copy = *this;
+    Environment::get()->setModel([copy](uint64_t micros, Readings &out) {
+        copy.apply(micros, out);
+    });
+}
+
+}
@@ -0,0 +1,281 @@
+// Host decoder of the GHS UDP log stream. Binary entries, logged by
+// MsgLogHandler::handleFmt(), carry only a format ID and raw arguments, and
+// are rendered here from the same format table the firmware was built with,
+// see include/UI/LogFormats.hpp. Text entries are printed as received. Run
+// with --listen alongside ghs_host, which sends to loopback.
+//
+//   ghs_logdecode --listen [port] [--save FILE]   decode live datagrams
+//   ghs_logdecode FILE                            decode a saved capture
+//   ghs_logdecode --check                         verify malformed entries
+//
+// A capture is a sequence of datagrams, each prefixed by its length as a
+// little endian uint16.
+
+#include "UI/LogCodec.hpp"
+#include "UI/LogFormats.hpp"
+#include "UI/LogRing.hpp"
+#include "Config/config.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace {
+
+#define DECODE_DGRAM_MAX 2048 // Larger than any datagram the firmware sends.
+
+// Requires the mDNS name, its length, and a version 2 record list and its
+// length. Prints each record, rendering binary records. Returns false if
+// malformed.
+bool decodeRecords(const char* mdns, size_t mdnsLen, const uint8_t* rec, 
+    size_t len) {
+
+    const size_t recHdr = 3; // LogKind, uint16 length.
+
+    while (len > 0) {
+        if (len < recHdr) return false;
+
+        uint8_t kind = rec[0];
+        uint16_t recLen = rec[1] | (rec[2] << 8);
+        if (recHdr + recLen > len) return false;
+
+        const uint8_t* entry = rec + recHdr;
+        char text[512];
+
+        if (kind == static_cast<uint8_t>(Messaging::LogKind::BIN)) {
+            Messaging::LogCodec::render(entry, recLen, text, sizeof(text));
+        } else {
+            snprintf(text, sizeof(text), "%.*s", (int)recLen, 
+                reinterpret_cast<const char*>(entry));
+        }
+
+        printf("%.*s: %s\n", (int)mdnsLen, mdns, text);
+        rec += recHdr + recLen;
+        len -= recHdr + recLen;
+    }
+
+    return true;
+}
+
+// Requires a datagram and its length. Prints the decoded entries. Version 1
+// datagrams hold a single binary entry, version 2 hold records, see 
+// include/Network/UDPSender.hpp. Text datagrams are printed as received.
+void decode(const uint8_t* dgram, size_t len) {
+    const size_t head = LOG_BIN_MAGIC_LEN + 2; // Magic, version, mDNS len.
+
+    if (len < head || memcmp(dgram, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN) != 0) {
+        printf("%.*s", (int)len, reinterpret_cast<const char*>(dgram));
+        if (len > 0 && dgram[len - 1] != '\n') printf("\n");
+        return;
+    }
+
+    uint8_t version = dgram[LOG_BIN_MAGIC_LEN];
+    size_t mdnsLen = dgram[LOG_BIN_MAGIC_LEN + 1];
+    const char* mdns = reinterpret_cast<const char*>(dgram + head);
+    const uint8_t* body = dgram + head + mdnsLen;
+
+    if (head + mdnsLen > len) {
+        printf("<malformed datagram, %zu bytes>\n", len);
+        return;
+    }
+
+    size_t bodyLen = len - head - mdnsLen;
+
+    if (version == 1) {
+        char entry[512];
+        Messaging::LogCodec::render(body, bodyLen, entry, sizeof(entry));
+        printf("%.*s: %s\n", (int)mdnsLen, mdns, entry);
+
+    } else if (version == 2) {
+        if (!decodeRecords(mdns, mdnsLen, body, bodyLen)) {
+            printf("<malformed records, %zu bytes>\n", len);
+        }
+
+    } else {
+        printf("<unsupported datagram, version %u, %zu bytes>\n", version, 
+            len);
+    }
+}
+
+// Requires the capture path. Decodes each datagram. Returns exit status.
+int readCapture(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) {
+        perror(path);
+        return 1;
+    }
+
+    uint8_t lenBytes[2];
+    uint8_t dgram[DECODE_DGRAM_MAX];
+
+    while (fread(lenBytes, 1, sizeof(lenBytes), f) == sizeof(lenBytes)) {
+        size_t len = lenBytes[0] | (lenBytes[1] << 8);
+
+        if (len > sizeof(dgram) || fread(dgram, 1, len, f) != len) {
+            fprintf(stderr, "%s: truncated capture\n", path);
+            fclose(f);
+            return 1;
+        }
+
+        decode(dgram, len);
+    }
+
+    fclose(f);
+    return 0;
+}
+
+// Requires the UDP port and optional capture path. Decodes datagrams as
+// they arrive, saving each to the capture if passed. Runs until killed.
+int listen(uint16_t port, const char* savePath) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        perror("bind");
+        close(sock);
+        return 1;
+    }
+
+    FILE* save = nullptr;
+    if (savePath != nullptr && (save = fopen(savePath, "ab")) == nullptr) {
+        perror(savePath);
+        close(sock);
+        return 1;
+    }
+
+    uint8_t dgram[DECODE_DGRAM_MAX];
+
+    while (true) {
+        ssize_t len = recv(sock, dgram, sizeof(dgram), 0);
+        if (len < 0) continue;
+
+        if (save != nullptr) {
+            uint8_t lenBytes[2] = {(uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+            fwrite(lenBytes, 1, sizeof(lenBytes), save);
+            fwrite(dgram, 1, len, save);
+            fflush(save);
+        }
+
+        decode(dgram, len);
+        fflush(stdout);
+    }
+}
+
+// Requires the case name, format ID, packed arguments and their length, the
+// argBytes of the header, and the expected render, or nullptr if the entry
+// must be rejected. Renders the entry and compares. Returns true if matched.
+bool checkEntry(const char* name, Messaging::LogFmt fmt, const uint8_t* args,
+    size_t argLen, uint8_t argBytes, const char* expect) {
+
+    Messaging::LogBinHdr hdr = {1, 0, static_cast<uint16_t>(fmt), argBytes};
+    uint8_t entry[sizeof(hdr) + 255];
+    char text[512];
+
+    memcpy(entry, &hdr, sizeof(hdr));
+    memcpy(entry + sizeof(hdr), args, argLen);
+
+    size_t len = Messaging::LogCodec::format(entry, sizeof(hdr) + argLen,
+        text, sizeof(text));
+
+    bool ok = (expect == nullptr) ? (len == 0) :
+        (strcmp(text, expect) == 0);
+
+    printf("%s: %s \"%s\"\n", ok ? "pass" : "FAIL", name, text);
+    return ok;
+}
+
+// Requires no params. Decodes well formed and malformed entries, as from a
+// corrupt capture or journal, verifying that malformed arguments render as
+// missing rather than overrunning. Returns exit status.
+int check() {
+    using Messaging::LogArg;
+    using Messaging::LogFmt;
+    const uint8_t str = static_cast<uint8_t>(LogArg::STR);
+    bool ok = true;
+
+    uint8_t args[255] = {str, 7, 'T', 'e', 'm', 'p', 'H', 'u', 'm'};
+    ok &= checkEntry("string", LogFmt::SENS_READ_ERR, args, 9, 9,
+        "TempHum read err");
+
+    // String length exceeding LOG_BIN_STR_MAX, within the argument bytes.
+    memset(args, 'A', sizeof(args));
+    args[0] = str;
+    args[1] = 150;
+    ok &= checkEntry("string over max", LogFmt::SENS_READ_ERR, args, 152, 152,
+        "<?> read err");
+
+    args[1] = LOG_BIN_STR_MAX + 1;
+    ok &= checkEntry("string max + 1", LogFmt::SENS_READ_ERR, args,
+        LOG_BIN_STR_MAX + 3, LOG_BIN_STR_MAX + 3, "<?> read err");
+
+    // String length exceeding the argument bytes.
+    args[1] = 10;
+    ok &= checkEntry("string truncated", LogFmt::SENS_READ_ERR, args, 5, 5,
+        "<?> read err");
+
+    // Argument bytes exceeding the entry.
+    ok &= checkEntry("args truncated", LogFmt::SENS_READ_ERR, args, 5, 200,
+        nullptr);
+
+    args[0] = 0xEE; // Unknown argument tag.
+    ok &= checkEntry("bad tag", LogFmt::SENS_READ_ERR, args, 5, 5,
+        "<?> read err");
+
+    return ok ? 0 : 1;
+}
+
+void usage() {
+    printf("usage: ghs_logdecode --listen [port] [--save FILE]\n"
+           "       ghs_logdecode FILE\n"
+           "       ghs_logdecode --check\n"
+           "Decodes the GHS UDP log stream, default port %d.\n", 
+           LOG_UDP_PORT);
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    if (strcmp(argv[1], "--check") == 0) return check();
+
+    if (strcmp(argv[1], "--listen") != 0) {
+        if (argv[1][0] == '-') {
+            usage();
+            return (strcmp(argv[1], "--help") == 0) ? 0 : 1;
+        }
+
+        return readCapture(argv[1]);
+    }
+
+    uint16_t port = LOG_UDP_PORT;
+    const char* savePath = nullptr;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--save") == 0 && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (argv[i][0] != '-') {
+            port = static_cast<uint16_t>(atoi(argv[i]));
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    return listen(port, savePath);
+}
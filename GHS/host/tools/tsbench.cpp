@@ -0,0 +1,211 @@
+// Host benchmark of the compressed sensor history, see
+// include/Peripherals/TSCodec.hpp. Synthesizes per-minute readings of every
+// channel, diurnal with passing clouds and sensor noise, appends them to a
+// TSHistory as the firmware does upon each closed minute, and reports the
+// encode and decode rates, bits per sample, and days of minutes held in
+// TS_HIST_BLOCKS blocks.
+// Every row held is decoded and verified within the tolerance of its
+// channel, see TSCodec::tolerance().
+//
+//   ghs_tsbench [--days N] [--seed N] [--gap]
+//
+// --gap drops every 97th minute and a 3 hour outage per day, exercising the
+// minute delta of delta.
+
+#include "Peripherals/TSCodec.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace Peripheral;
+using Clock = std::chrono::steady_clock;
+
+#define BENCH_DAYS 10 // Exceeds the history, evicting the oldest blocks.
+#define BENCH_MIN_DAY 1440
+
+struct Row {
+    uint32_t minute;
+    uint16_t codes[TS_CHANNELS];
+};
+
+// Requires the minute, generator, and row. Sets the codes of the minute as
+// the firmware appends them, the quantized mean of the readings within the
+// minute. Noise is of a single reading, reduced by the root of the readings
+// per minute, 60 SHT and soil, 20 light, see SHT_FRQ and LIGHT_FRQ.
+void synth(uint32_t minute, std::mt19937 &gen, Row &row) {
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const float pi = 3.14159265f;
+    float phase = 2.0f * pi * (minute % BENCH_MIN_DAY) / BENCH_MIN_DAY;
+    float sun = sinf(phase - pi / 2.0f); // Noon peak, -1 at midnight.
+    float day = sun > 0.0f ? sun : 0.0f;
+
+    row.minute = minute;
+
+    const float shtMean = 1.0f / sqrtf(60.0f);
+    const float lightMean = 1.0f / sqrtf(20.0f);
+
+    // SHT repeatability, about 0.04 C and 0.2 %.
+    float temp = 21.0f + 6.0f * sun + 0.04f * shtMean * noise(gen);
+    float hum = 62.0f - 14.0f * sun + 0.2f * shtMean * noise(gen);
+    row.codes[0] = TSCodec::encode(0, temp);
+    row.codes[1] = TSCodec::encode(1, hum);
+
+    // Passing cloud, dimming all light by up to 40 %, changing over about
+    // half an hour.
+    static float cloud = 0.0f;
+    cloud = 0.97f * cloud + 0.03f * noise(gen) * 2.0f;
+    float sky = 1.0f - 0.4f * fminf(fabsf(cloud), 1.0f);
+
+    // AS7341 counts, 0 at night, shot noise of about sqrt(counts).
+    static const float peak[] = {9000, 700, 1100, 1500, 2200, 2600, 2500,
+        2400, 1900, 3200};
+
+    for (size_t c = 0; c < 10; c++) {
+        float counts = peak[c] * day * day * sky;
+        counts += sqrtf(counts) * lightMean * noise(gen);
+        row.codes[2 + c] = TSCodec::encode(2 + c, counts);
+    }
+
+    // Photoresistor ADC, floored to PHOTO_NOISE by the firmware.
+    float photo = 3600.0f * day * sky + 3.0f * lightMean * noise(gen);
+    row.codes[12] = TSCodec::encode(12, photo);
+
+    // Soil ADC, drying over 2 days then watered, floored to SOIL_NOISE.
+    for (size_t s = 0; s < 4; s++) {
+        uint32_t cycle = 2 * BENCH_MIN_DAY + s * 180;
+        float dry = static_cast<float>((minute + s * 500) % cycle) / cycle;
+        float soil = 2800.0f - 1400.0f * dry + 6.0f * shtMean * noise(gen);
+        row.codes[13 + s] = TSCodec::encode(13 + s, soil);
+    }
+}
+
+// Requires the minute. Returns true if the minute is dropped by --gap.
+bool dropped(uint32_t minute) {
+    uint32_t ofDay = minute % BENCH_MIN_DAY;
+    return (minute % 97 == 0) || (ofDay >= 120 && ofDay < 300);
+}
+
+void usage() {
+    printf("usage: ghs_tsbench [--days N] [--seed N] [--gap]\n");
+}
+
+}
+
+int main(int argc, char** argv) {
+    uint32_t days = BENCH_DAYS;
+    uint32_t seed = 1;
+    bool gap = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--days") == 0 && i + 1 < argc) {
+            days = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--gap") == 0) {
+            gap = true;
+        } else {
+            usage();
+            return (strcmp(argv[i], "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    std::mt19937 gen(seed);
+    std::vector<Row> rows;
+
+    for (uint32_t m = 0; m < days * BENCH_MIN_DAY; m++) {
+        if (gap && dropped(m)) continue;
+        rows.emplace_back();
+        synth(m, gen, rows.back());
+    }
+
+    static TSHistory hist; // 16 KB.
+    const uint32_t all = (1u << TS_CHANNELS) - 1;
+
+    auto t0 = Clock::now();
+    for (const Row &r : rows) hist.append(r.minute, r.codes, all);
+    auto t1 = Clock::now();
+
+    // Decodes every block held, verifying each row against its input.
+    static uint8_t block[TS_BLOCK_SIZE];
+    size_t decoded{0}, bytes{0}, errors{0}, idx{0};
+    uint32_t firstMin{0}, lastMin{0};
+    double decodeNs{0};
+
+    for (uint32_t seq = hist.getFirstSeq(); seq < hist.getNextSeq(); seq++) {
+        size_t len = hist.getBlock(seq, block, sizeof(block));
+        if (len == 0) {
+            printf("block %u unreadable\n", seq);
+            return 1;
+        }
+
+        bytes += len;
+        uint32_t minute{0};
+        uint16_t codes[TS_CHANNELS];
+        std::vector<Row> out;
+
+        auto d0 = Clock::now();
+        TSBlockReader rd(block, len);
+        while (rd.next(minute, codes)) {
+            out.emplace_back();
+            out.back().minute = minute;
+            memcpy(out.back().codes, codes, sizeof(codes));
+        }
+        decodeNs += std::chrono::duration<double, std::nano>(
+            Clock::now() - d0).count();
+
+        if (out.size() != rd.getHdr().rows) {
+            printf("block %u decoded %zu of %u rows\n", seq, out.size(),
+                rd.getHdr().rows);
+            return 1;
+        }
+
+        if (seq == hist.getFirstSeq() && !out.empty()) {
+            firstMin = out.front().minute;
+            while (idx < rows.size() && rows[idx].minute < firstMin) idx++;
+        }
+
+        for (const Row &r : out) {
+            if (idx >= rows.size() || rows[idx].minute != r.minute) {
+                printf("minute %u out of order\n", r.minute);
+                return 1;
+            }
+
+            for (size_t c = 0; c < TS_CHANNELS; c++) {
+                int32_t drift = abs(static_cast<int32_t>(r.codes[c]) -
+                    rows[idx].codes[c]);
+
+                if (drift > TSCodec::tolerance(c, r.codes[c])) errors++;
+            }
+
+            lastMin = r.minute;
+            idx++;
+            decoded++;
+        }
+    }
+
+    double encNs = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    double held = static_cast<double>(lastMin - firstMin + 1) / BENCH_MIN_DAY;
+    double bits = bytes * 8.0 / (decoded * TS_CHANNELS);
+
+    printf("rows appended     %zu (%u days%s)\n", rows.size(), days,
+        gap ? ", gaps" : "");
+    printf("blocks held       %u of %u, %zu bytes\n",
+        hist.getNextSeq() - hist.getFirstSeq(), TS_HIST_BLOCKS, bytes);
+    printf("rows held         %zu, %.2f days\n", decoded, held);
+    printf("rows per block    %.1f\n",
+        static_cast<double>(decoded) / (hist.getNextSeq() -
+        hist.getFirstSeq()));
+    printf("bits per sample   %.3f (raw 16, %.1fx)\n", bits, 16.0 / bits);
+    printf("encode            %.1f ns/row\n", encNs / rows.size());
+    printf("decode            %.1f ns/row\n", decodeNs / decoded);
+    printf("out of tolerance  %zu\n", errors);
+
+    return errors == 0 ? 0 : 1;
+}
@@ -45,6 +45,8 @@ extern char confLog[128]; // Reusable log for config src.
 #define LIGHT_STACK 4096
 #define SOIL_STACK 4096
 #define ROUTINE_STACK 4096
+#define LOG_STACK 4096
+#define SKT_STACK 8192 // Runs socket commands, previously on the httpd task.
 
 // OLED displays
 #define OLED_COMPANY_NAME "SSTech 2024"
@@ -64,7 +66,7 @@ extern char confLog[128]; // Reusable log for config src.
 // Uncomment whichever WEBURL you are using
 // #define WEBURL "https://major-absolutely-bluejay.ngrok-free.app"
 #define WEBURL "http://ghmain.local:51001"
-#define UDP_URL "ghmain.local" // mDNS of the primary node exp server.
+#define UDP_HOST "ghmain" // mDNS hostname of the primary node, excl .local
 #define WEB_TIMEOUT_MS 3000 // timeout when in client mode in milliseconds.
 
 // White list domains used in STAOTAHandler.cpp
@@ -98,6 +100,11 @@ extern const char* whiteListDomains[3]; // WEBURL, LOCAL_IP and MDNS_ACTUAL
 #define MSG_CLEAR_SECS 5 // clears OLED error messages after n seconds.
 #define CONSECUTIVE_ENTRIES 2 // Prevents a repeat log entry.
 #define CONSECUTIVE_ENTRY_TIMEOUT 300 // Seconds that will allow repeat entries.
+#define LOG_DEDUPE_SLOTS 48 // Repeat signatures tracked, 32 to 64.
+#define LOG_DEDUPE_REPORT 60 // Seconds between "xN" summaries of repeats.
+#define LOG_BINARY true // Log handleFmt() entries in binary, see LogFormats.hpp
+#define LOG_MIN_LEVEL (DEVmode ? 0 : 1) // Lower levels compile away. 0 DEBUG.
+#define LOG_DEF_LEVEL 0 // Runtime level of each log tag on boot. 0 DEBUG.
 
 // Used in functions to init object. 
 #define TOTAL_RELAYS 4 
@@ -110,6 +117,8 @@ extern const char* whiteListDomains[3]; // WEBURL, LOCAL_IP and MDNS_ACTUAL
 #define LIGHT_FRQ 3000 // Overruns at 2000 for polling, use 3000 min.
 #define SOIL_FRQ 1000
 #define ROUTINE_FRQ 1000 // Keep 1000 due to OLED messages and hearbeat.
+#define LOG_FRQ 250 // Max wait for log records, also bounds UDP flush delay.
+#define SKT_FRQ 1000 // Max wait for socket commands, checks in heartbeat.
 
 // Autosave frequency in seconds, once per n seconds.
 #define AUTO_SAVE_FRQ 60
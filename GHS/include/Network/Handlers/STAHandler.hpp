@@ -11,6 +11,9 @@ namespace Comms {
 
 #define OTA_URL_SIZE 100 // max size of url
 #define OTA_CHECKNEW_BUFFER_SIZE 300 // json data with some padding, est 200.
+#define LOG_CHUNK_SIZE 1024 // Bytes of log rendered per http chunk.
+#define LOG_QUERY_SIZE 32 // Query of the log request, since=<seq>.
+#define LOG_SEQ_HDR_SIZE 12 // Sequence number header value, uint32_t.
 
 // Src file STAHandler.cpp
 esp_err_t STAIndexHandler(httpd_req_t* req);
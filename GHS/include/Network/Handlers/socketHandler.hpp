@@ -1,12 +1,18 @@
 #ifndef SOCKETHANDLER_HPP
 #define SOCKETHANDLER_HPP
 
+#include <atomic>
 #include "esp_http_server.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "Network/NetSTA.hpp"
 #include "Threads/Mutex.hpp"
 #include "Peripherals/Relay.hpp"
 #include "Peripherals/TempHum.hpp"
 #include "Peripherals/Light.hpp"
+#include "Peripherals/Soil.hpp"
+#include "Common/Timing.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "Network/Handlers/MasterHandler.hpp"
 
@@ -16,21 +22,51 @@ namespace Comms {
 // the will not be part of the thread task stack.
 
 #define SKT_BUF_SIZE 2048 // Large to accomodate the get all call
-#define SKT_MAX_RESP_ARGS 10 // Max response arguments / clients args at once.
 #define SKT_REPLY_SIZE 128 // Basic replies
+#define SKT_SMALL_ARGS 8 // Args of basic replies, SKT_REPLY_SIZE buffer.
+#define SKT_LARGE_ARGS 4 // Args of large replies and pushes, SKT_BUF_SIZE.
+#define SKT_SMALL_RESERVE 1 // Small args reserved for busy replies.
+#define SKT_LARGE_RESERVE 2 // Large args reserved for replies that must fit.
+#define SKT_MAX_RESP_ARGS (SKT_SMALL_ARGS + SKT_LARGE_ARGS) // Max 32.
 #define SKT_RANGE_EXC -999 // Default range value for exceptions.
+#define SKT_LOG_CHUNK 768 // Log rendered per reply, x2 if fully escaped.
 #define POOL_SIG 0xBEEFFEED // Used to sign argument while active.
+#define SKT_MAX_SUBS 4 // Max subscribed sockets receiving pushed GET_ALL.
+#define SKT_PUSH_ID 256 // Reply id of pushes, outside client ids 0 - 255.
+#define SKT_PUSH_MAX_S 60 // Max seconds between pushes a client can request.
+#define SKT_DELTA_FIELDS 128 // Max fields of the GET_ALL reply versioned.
+#define SKT_FMT_BIN 0x100 // Supp flag, binary GET_ALL/GET_TRENDS, see Wire.
+#define SKT_TREND_QTY 0xFF // Supp bits of the GET_TRENDS hours or buckets.
+#define SKT_TREND_RES_SHIFT 12 // Supp shift of the GET_TRENDS resolution.
+#define SKT_BATCH_MAX 16 // Max commands of a BATCH frame.
+#define SKT_MAX_SESS 8 // Max sessions tracked, exceeds max_open_sockets.
+#define SKT_PING_S 15 // Seconds between keepalive pings.
+#define SKT_PING_MISS 3 // Unanswered pings before the session is reaped.
+#define SKT_CTRL_MAX 125 // Max payload of a control frame, RFC 6455.
+#define SKT_RATE_CMDS 10 // Frames per second refilled to each session.
+#define SKT_RATE_BURST 20 // Frames a session may send at once.
+#define SKT_BUSY_RETRY_MS 250 // Retry after of a busy reply, pool or lane full.
 #define SKT_TAG "(SOCKHAND)"
 #define POOL_TAG "(ARGPOOL)"
+#define SUB_TAG "(SKTSUBS)"
+#define DELTA_TAG "(SKTDELTA)"
+#define CACHE_TAG "(SKTCACHE)"
+#define EXEC_TAG "(SKTEXEC)"
+#define SESS_TAG "(SKTSESS)"
+#define LIMIT_TAG "(SKTLIMIT)"
+#define SKT_EXEC_DEPTH (SKT_MAX_RESP_ARGS + 1) // Jobs per lane, args and push.
 
 // All commands sent by the client. Starts at index 1. When client passes
 // numerical command, it corresponds to this enum, and will execute 
-// appropriately.
+// appropriately. ATTENTION. Must match the CMDS arrays of the clients, in
+// webPages.hpp and GHSsrvr socketCmds.js. Append only.
 enum class CMDS : uint8_t {
     GET_ALL = 1, CALIBRATE_TIME, NEW_LOG_RCVD, 
     RELAY_CTRL, RELAY_TIMER, RELAY_TIMER_DAY, ATTACH_RELAYS, 
     SET_TEMPHUM, SET_SOIL, SET_LIGHT, SET_SPEC_INTEGRATION_TIME, SET_SPEC_GAIN, 
-    CLEAR_AVERAGES, SAVE_AND_RESTART, GET_TRENDS
+    CLEAR_AVERAGES, CLEAR_AVG_SET_TIME, SAVE_AND_RESTART, GET_TRENDS,
+    GET_LOG_SINCE, SET_LOG_LEVEL, SUBSCRIBE, GET_DELTA, BATCH, GET_SESSIONS,
+    GET_LOAD, GET_HISTORY, GET_STATS
 };
 
 struct cmdData { // Command Data
@@ -44,22 +80,142 @@ struct async_resp_arg { // Socket response argument struct.
     int fd; // file descriptior
     cmdData data; // Command data.
     uint32_t signature; // Used only while argument is valid and in use.
-    uint8_t Buf[SKT_BUF_SIZE]; // Data buffer.
+    int64_t rcvd; // Micros the frame was received, measures latency.
+    uint32_t retryMs; // Replies busy with this retry after, 0 if not busy.
+    uint8_t* Buf; // Data buffer, static storage of the pool.
+    size_t bufSize; // SKT_REPLY_SIZE or SKT_BUF_SIZE.
 };
 
+// ATTENTION. Subscribed sockets are pushed the GET_ALL reply, with the id
+// SKT_PUSH_ID, once a peripheral completes a read cycle, no more often than
+// each subscriber's period. The reply is compiled once per push and sent to
+// every subscriber that is due, replacing a GET_ALL poll per client. The net
+// task queues pushes, which are compiled and sent on the socket task.
+struct sktSub { // Socket subscriber.
+    bool active; // Slot is in use.
+    int fd; // file descriptor.
+    uint32_t periodMs; // Min time between pushes.
+    int64_t lastPush; // Millis of the latest push.
+    uint32_t sentUpdate; // Update count of the latest push.
+    uint32_t deltaVer; // Delta version of the latest push, 0 if none.
+};
+
+// ATTENTION. Each websocket session is pinged every SKT_PING_S by the socket
+// task. Any frame received, including the pong, marks the session alive.
+// Sessions missing SKT_PING_MISS pings in a row are closed, releasing the
+// httpd socket held by clients that went to sleep or lost the network. The
+// counters are returned by GET_SESSIONS, used to size max_open_sockets and
+// the arg pool.
+struct sktSess { // Websocket session.
+    bool active; // Slot is in use.
+    httpd_handle_t hd; // handle
+    int fd; // file descriptor.
+    uint8_t missed; // Consecutive pings unanswered.
+    uint32_t cmds; // Commands received.
+    uint32_t replies; // Replies sent, latency measured.
+    uint32_t bytesIn; // Payload bytes received.
+    uint32_t bytesOut; // Reply bytes sent, excluding preceding fragments.
+    uint64_t latencyUs; // Sum of receipt to reply micros.
+    int64_t opened; // Millis of the handshake.
+    int64_t lastActive; // Millis of the latest frame received.
+    uint32_t tokens; // Frames allowed, in thousandths, see SKT_RATE_CMDS.
+    int64_t refilled; // Millis tokens were last refilled.
+    uint32_t limited; // Frames refused by the rate limit.
+};
+
+// ATTENTION. Each field of the GET_ALL reply carries the delta version at
+// which its value last changed. Versions are stamped from a single counter,
+// incremented upon each compile that changes any field, so that the client
+// passes only its latest version to GET_DELTA, and is returned the fields
+// changed since. Changes are detected by hashing each field as formatted,
+// so every change is caught, including configuration set by any client.
+// The counter begins at a random base each boot, a version outside of the
+// current boot range returns all fields.
+struct deltaField { // Field of the GET_ALL reply.
+    uint32_t keyHash; // Hash of the key, verifies the field order.
+    uint32_t valHash; // Hash of the value as formatted.
+    uint32_t ver; // Version at which the value last changed.
+};
+
+// Snapshot of the GET_ALL data, gathered once and written as JSON, or as the
+// binary WireAll.
+struct allSnap {
+    bool newLog; // New log entry available.
+    uint8_t net; // Network type.
+    Clock::TIME dtg; // Date time group.
+    bool isCal; // Time is calibrated.
+    Peripheral::RESTATE reState[TOTAL_RELAYS];
+    Peripheral::Timer reTimer[TOTAL_RELAYS];
+    uint8_t reQty[TOTAL_RELAYS]; // Controlling clients per relay.
+    bool reMan[TOTAL_RELAYS]; // Manual control per relay.
+    float temp, hum; // Temp in celcius.
+    Peripheral::TH_TRIP_CONFIG tempConf, humConf;
+    float thHlth; // Temp hum sensor health.
+    bool thRdOK; // Temp hum read OK.
+    Peripheral::TH_Averages thAvg;
+    Peripheral::SoilReadings soReadings[SOIL_SENSORS];
+    Peripheral::AlertConfigSo soConf[SOIL_SENSORS];
+    AS7341_DRVR::COLOR spec; // Spectral counts.
+    Peripheral::Light_Averages ltAv;
+    Peripheral::LightHealth ltH;
+    int photoVal; // Photoresistor value.
+    Peripheral::RelayConfigLight ltConf;
+    Peripheral::Spec_Conf specConf;
+    uint32_t ltDur; // Light duration in seconds.
+};
+
+// ATTENTION. The GET_ALL reply is rendered once per epoch, and shared by every
+// GET_ALL, GET_DELTA and push within it, with only the id patched in. The
+// epoch ends upon a completed read cycle, a command that may change the data,
+// or the next system second, so a reply is never older than one second.
+struct allCache { // Snapshot of the GET_ALL reply.
+    char json[SKT_BUF_SIZE]; // Reply rendered with id 0.
+    int len; // Length of json, 0 if none.
+    size_t idPos; // Position of the id value within json.
+    uint32_t update; // Read cycle count of the epoch.
+    uint32_t gen; // Data change count of the epoch.
+    uint32_t sec; // System second of the epoch.
+};
+
+// ATTENTION. Commands are executed by the socket task, off of the httpd task,
+// in two lanes. Read only commands and pushes use the fast lane. Commands
+// that may change data, which can block on I2C or NVS, use the slow lane. The
+// fast lane is drained before each slow command, so reads are not held behind
+// writes, and the httpd task is never blocked by either. Replies, fragments,
+// and pushes are all sent by the socket task, keeping frames to a socket in
+// order.
+struct sktJob { // Job queued for the socket task.
+    void (*work)(void* arg); // ws_async_send or ws_push_send.
+    async_resp_arg* arg; // Released by work.
+};
+
+// ATTENTION. The pool holds two size classes, about 9 KB, half of the prior
+// uniform pool. Small args receive every frame and reply with the basic
+// status, large args are reserved for the replies that exceed SKT_REPLY_SIZE,
+// see largeReply(), streamed replies falling back to small args once the
+// unreserved large args are exhausted, see streamed(). The large args cover
+// the four must fit replies of a page load, GET_ALL, GET_LOG_SINCE, GET_DELTA
+// and GET_HISTORY, in flight at once. Free args are tracked by a
+// single atomic bitmap, bit i set if pool[i] is free, so getArg and releaseArg
+// never block, and may be called from any task. The last SKT_SMALL_RESERVE
+// small args are only used to reply busy, once the rest are exhausted, and
+// the last SKT_LARGE_RESERVE large args only by replies that must fit.
 class argPool { 
 
     // Want static allocation of the argument pool to avoid using the HEAP
     // which can lead to memory fragmentation.
     private:
-    async_resp_arg pool[SKT_MAX_RESP_ARGS]; // Pool of arguemnts
-    bool inUse[SKT_MAX_RESP_ARGS]; // flag to show which pool is in use.
-    Threads::Mutex mtx;
+    async_resp_arg pool[SKT_MAX_RESP_ARGS]; // Small args, then large args.
+    uint8_t smallBuf[SKT_SMALL_ARGS][SKT_REPLY_SIZE]; // Small arg buffers.
+    uint8_t largeBuf[SKT_LARGE_ARGS][SKT_BUF_SIZE]; // Large arg buffers.
+    std::atomic<uint32_t> freeMap; // Bit set if the arg is free.
+    std::atomic<uint32_t> peak[2]; // Most args in use, small and large.
 
     public:
     argPool();
-    async_resp_arg* getArg();
+    async_resp_arg* getArg(bool large = false, bool reserve = false);
     void releaseArg(async_resp_arg* arg);
+    void usage(bool large, uint32_t &used, uint32_t &peakUsed);
 };
 
 // NOTE: All static variables and functions due to requirements of the URI
@@ -71,11 +227,92 @@ class SOCKHAND : public MASTERHAND {
     static Peripheral::Relay* Relays; // Pointer to relays, init from main.cpp
     static bool isInit; // Shows if the handler is initialized.
     static argPool pool; // argument pool object.
+    static sktSub subs[SKT_MAX_SUBS]; // Subscribed sockets.
+    static httpd_handle_t pushHd; // Server handle of the subscribers.
+    static std::atomic<uint32_t> updates; // Read cycles completed.
+    static std::atomic<bool> pushQueued; // Push awaiting the socket task.
+    static Threads::Mutex subMtx; // Guards subs and pushHd.
+    static deltaField fields[SKT_DELTA_FIELDS]; // Versions of GET_ALL fields.
+    static size_t fieldQty; // Fields of the latest compile.
+    static uint32_t deltaBase; // Version prior to the first of this boot.
+    static uint32_t deltaVer; // Latest version stamped.
+    static char deltaAll[SKT_BUF_SIZE]; // GET_ALL reply used to compile deltas.
+    static Threads::Mutex deltaMtx; // Guards the delta fields and deltaAll.
+    static allCache cache; // GET_ALL reply of the current epoch.
+    static std::atomic<uint32_t> allGen; // Commands that changed data.
+    static Threads::Mutex cacheMtx; // Guards cache.
+    static QueueHandle_t fastQ; // Read only commands and pushes.
+    static QueueHandle_t slowQ; // Commands that may change data.
+    static SemaphoreHandle_t execSig; // Given upon each queued job.
+    static sktSess sessions[SKT_MAX_SESS]; // Open websocket sessions.
+    static uint32_t sessPeak; // Most sessions open at once.
+    static uint32_t sessReaped; // Sessions closed for missed pings.
+    static uint32_t sessDropped; // Sessions untracked, table full.
+    static int64_t lastPing; // Millis of the latest ping sweep.
+    static Threads::Mutex sessMtx; // Guards the sessions and counters.
+    static std::atomic<uint32_t> lanePeak[2]; // Most jobs queued, fast, slow.
+    static std::atomic<uint32_t> laneFull; // Jobs refused, lane full.
+    static std::atomic<uint32_t> busySent; // Busy replies queued.
+    static std::atomic<uint32_t> busyDropped; // Frames dropped, no reply.
     static esp_err_t trigger_async_send(httpd_handle_t handle, httpd_req_t* req, 
         async_resp_arg* arg);
 
     static void ws_async_send(void* arg);
-    static void compileData(cmdData &data, char* buffer, size_t size);
+    static void ws_push_send(void* arg);
+    static size_t compileData(cmdData &data, char* buffer, size_t size,
+        httpd_handle_t hd = nullptr, int fd = -1, 
+        httpd_ws_type_t* type = nullptr);
+
+    static void gatherAll(allSnap &snap);
+    static int renderAll(uint16_t idNum, char* buffer, size_t size);
+    static int compileAll(uint16_t idNum, char* buffer, size_t size);
+    static bool batchable(CMDS cmd);
+    static int compileSeries(uint16_t idNum, int res, int qty, char* buffer,
+        size_t size, httpd_handle_t hd, int fd, bool &fragmented);
+
+    static int compileBatch(cmdData &data, char* buffer, size_t size,
+        httpd_handle_t hd, int fd, bool &fragmented);
+
+    static bool initExec();
+    static bool readOnly(CMDS cmd);
+    static bool largeReply(CMDS cmd);
+    static bool streamed(CMDS cmd, int supp);
+    static bool queueJob(void (*work)(void* arg), async_resp_arg* arg, 
+        bool slow);
+    static int wireAll(uint16_t idNum, uint8_t* buffer, size_t size);
+    static int wireTrends(uint16_t idNum, int hours, uint8_t* buffer, 
+        size_t size);
+
+    static int wireHistory(uint16_t idNum, int seq, uint8_t* buffer,
+        size_t size);
+
+    static const char* nextField(const char* pos, const char* &pair, 
+        size_t &pairLen, size_t &keyLen);
+
+    static bool updateDelta();
+    static int renderDelta(uint32_t since, uint16_t idNum, char* buffer, 
+        size_t size);
+
+    static void sessOpen(httpd_handle_t hd, int fd);
+    static void sessClose(int fd);
+    static void sessRecv(httpd_handle_t hd, int fd, size_t len, bool isCmd);
+    static void sessReply(int fd, size_t len, int64_t rcvd);
+    static void wsControl(httpd_req_t* req, httpd_ws_frame_t &wsPkt);
+    static bool admit(int fd, uint32_t &retryMs);
+    static void queueBusy(httpd_req_t* req, async_resp_arg* arg);
+    static bool recvRefused(httpd_req_t* req, httpd_ws_frame_t &wsPkt,
+        async_resp_arg* arg);
+
+    static int compileLoad(uint16_t idNum, char* buffer, size_t size);
+    static int compileSessions(uint16_t idNum, char* buffer, size_t size,
+        httpd_handle_t hd, int fd, bool &fragmented);
+
+    static int compileStats(uint16_t idNum, int mask, char* buffer,
+        size_t size, httpd_handle_t hd, int fd, bool &fragmented);
+
+    static bool subscribe(httpd_handle_t hd, int fd, uint32_t periodS);
+    static bool unsubscribe(int fd);
+    static bool pushDue(const sktSub &sub, uint32_t update, int64_t now);
     static bool inRange(int lower, int upper, int value, 
         int exception = SKT_RANGE_EXC, int multiplier = 1);
         
@@ -83,12 +320,16 @@ class SOCKHAND : public MASTERHAND {
         const char* reply, uint16_t idNum);
     
     static bool initCheck(httpd_req_t* req);
-    static void Trends(void* arr, char type, char*buf, size_t bufSize, 
-        int iter); 
+
+    static size_t escapeJSON(const char* src, char* dst, size_t size);
     
     public:
     static bool init(Peripheral::Relay* relays);
     static esp_err_t wsHandler(httpd_req_t* req); // Entrance point.
+    static void notify();
+    static void push();
+    static void execute(TickType_t wait);
+    static void keepAlive();
     static void attachRelayTH(uint8_t relayNum, 
         Peripheral::TH_TRIP_CONFIG* conf, const char* caller);
 
@@ -0,0 +1,70 @@
+#ifndef SOCKETJSON_HPP
+#define SOCKETJSON_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_http_server.h"
+#include "Peripherals/RingSeries.hpp"
+
+namespace Comms {
+
+#define JSON_NUM_MAX 24 // Max chars of a formatted number.
+#define JSON_TAG "(SKTJSON)"
+
+// ATTENTION. Writes JSON directly into the socket buffer. When the buffer
+// fills, the written portion is sent to the socket as a fragmented websocket
+// frame, and writing resumes at the start of the buffer, so replies are not
+// limited by the buffer size. The caller sends the remainder, see finish().
+// Without a socket, a reply exceeding the buffer is truncated and reported.
+class JsonStream {
+    private:
+    char* buf; // Output buffer.
+    size_t size; // Buffer size.
+    size_t len; // Bytes written into the buffer, not yet sent.
+    httpd_handle_t hd; // Socket of fragments, nullptr if none.
+    int fd; // file descriptor.
+    bool comma; // Next value is preceded by a comma.
+    bool sent; // A fragment has been sent.
+    bool err; // Truncated, or a fragment failed to send.
+    bool flush();
+    bool reserve(size_t bytes);
+    void sep();
+    void elem(float val, uint8_t dec);
+    void elem(uint16_t val, uint8_t dec);
+    void elem(int16_t val, uint8_t dec);
+
+    public:
+    JsonStream(char* buf, size_t size, httpd_handle_t hd = nullptr,
+        int fd = -1);
+
+    void raw(const char* str);
+    void key(const char* key);
+    void open(char bracket);
+    void close(char bracket);
+    void json(const char* val);
+    void num(int32_t val);
+    void num(uint32_t val);
+    void num(float val, uint8_t decimals);
+
+    // Requires the key, series, quantity, and decimal places of floats.
+    // Writes "key":[values] of the newest qty values, newest first, read
+    // directly from the series without copying.
+    template<typename T, size_t N>
+    void arr(const char* key, const Peripheral::RingSeries<T, N> &vals,
+        size_t qty, uint8_t dec = 0) {
+
+        this->key(key);
+        this->open('[');
+        for (auto it = vals.begin(); it != vals.end(qty); ++it) {
+            this->elem(*it, dec);
+        }
+
+        this->close(']');
+    }
+
+    int finish(bool &fragmented);
+};
+
+}
+
+#endif // SOCKETJSON_HPP
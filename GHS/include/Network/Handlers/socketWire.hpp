@@ -0,0 +1,108 @@
+#ifndef SOCKETWIRE_HPP
+#define SOCKETWIRE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Comms {
+
+// ATTENTION. Binary replies of GET_ALL and GET_TRENDS, requested by setting
+// SKT_FMT_BIN within the supp data, and of GET_HISTORY, always binary, sent
+// as binary websocket frames. Each
+// reply is a WireHdr followed by its payload, written as little endian, the
+// native order of the esp32. Fields follow the order of the JSON replies, and
+// are decoded to the same keys by the GHSsrvr, see Common/sktWire.js. Any
+// layout change must increment SKT_WIRE_VERSION and be matched by the decoder.
+
+#define SKT_WIRE_VERSION 1 // Layout version of the binary replies.
+#define SKT_WIRE_FIRMV 12 // Bytes of the firmware version, null padded.
+#define SKT_WIRE_COLORS 10 // Spectral channels, violet - nir, then clear.
+
+enum class WireType : uint8_t {ALL = 1, TRENDS, HISTORY};
+
+struct WireHdr {
+    uint8_t version; // SKT_WIRE_VERSION.
+    WireType type; // Reply type.
+    uint16_t id; // Reply id, as the JSON "id".
+    uint16_t len; // Payload bytes following the header.
+} __attribute__((packed));
+
+struct WireRelay {
+    uint8_t state; // RESTATE.
+    uint8_t timerEn; // Timer isReady.
+    uint32_t onTime; // Seconds past midnight.
+    uint32_t offTime; // Seconds past midnight.
+    uint8_t days; // Bitwise days the timer is enabled.
+    uint8_t qty; // Controlling clients.
+    uint8_t man; // Manual control.
+} __attribute__((packed));
+
+struct WireTrip { // Temperature or humidity with its trip configuration.
+    float val; // Current reading.
+    uint8_t reNum; // Relay index attached.
+    uint8_t reCond; // RECOND.
+    int32_t reVal; // Relay trip value.
+    uint8_t altCond; // ALTCOND.
+    int32_t altVal; // Alert trip value.
+} __attribute__((packed));
+
+struct WireSoil {
+    int16_t val; // Read value.
+    uint8_t altCond; // ALTCOND.
+    int32_t altVal; // Alert trip value.
+    float health; // Sensor health.
+    uint8_t rdOK; // Negated read error.
+} __attribute__((packed));
+
+struct WireAll { // Payload of the GET_ALL reply.
+    char firmv[SKT_WIRE_FIRMV];
+    uint8_t newLog;
+    uint8_t netMode;
+    uint32_t sysTime; // Raw seconds past midnight.
+    uint8_t hour, minute, second;
+    uint8_t day;
+    uint8_t timeCalib;
+    WireRelay relays[4];
+    WireTrip temp;
+    WireTrip hum;
+    float shtHealth;
+    uint8_t shtRdOK;
+    float tempAvg, humAvg, tempAvgPrev, humAvgPrev;
+    WireSoil soil[4];
+    uint16_t colors[SKT_WIRE_COLORS]; // Order of the JSON keys.
+    int32_t photo;
+    float colorAvg[SKT_WIRE_COLORS];
+    float photoAvg;
+    float colorAvgPrev[SKT_WIRE_COLORS];
+    float photoAvgPrev;
+    uint8_t photoRdOK, specRdOK;
+    float photoHealth, specHealth;
+    uint8_t lightRe; // Relay index attached.
+    uint8_t lightReCond; // RECOND.
+    uint16_t lightReVal;
+    uint32_t lightDur;
+    uint16_t darkVal;
+    uint8_t atime;
+    uint16_t astep;
+    uint8_t again;
+} __attribute__((packed));
+
+// Payload of the GET_TRENDS reply is the uint8_t hour count n, followed by
+// the arrays, each of n entries: float temp, float hum, uint16_t colors in
+// the JSON order clear, violet, indigo, blue, cyan, green, yellow, orange,
+// red, nir, then int16_t photo, and int16_t soil_0 through soil_3.
+
+struct WireHistory { // Payload of the GET_HISTORY reply, precedes the blocks.
+    uint32_t firstSeq; // Sequence of the oldest block held.
+    uint32_t nextSeq; // Sequence following the newest block, which is open.
+    uint8_t qty; // Blocks following.
+} __attribute__((packed));
+
+struct WireHistBlock { // Precedes each block of the GET_HISTORY reply.
+    uint32_t seq; // Block sequence.
+    uint16_t len; // Bytes of the block, TSBlockHdr and bitstream.
+} __attribute__((packed));
+
+}
+
+#endif // SOCKETWIRE_HPP
@@ -0,0 +1,79 @@
+#ifndef UDPSENDER_HPP
+#define UDPSENDER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include "Threads/Mutex.hpp"
+#include "UI/LogRing.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+// ATTENTION. Single long lived UDP sender for the log entries and heartbeat
+// sent to the primary node. Log entries are batched into datagrams of up to
+// UDP_DGRAM_SIZE, which are sent once full or once the oldest entry has
+// waited UDP_FLUSH_MS. The heartbeat shares the socket and flush, but is sent
+// to its own port since the server listens on separate ports. Resolution of
+// the primary node occurs only in flush(), which must be called by the log
+// task, since the mDNS query blocks up to UDP_RESOLVE_TIMEOUT. Sending never
+// logs, since every log entry is sent by UDP.
+
+// Log datagram formats, by LOG_BINARY in config.hpp:
+// Text: legacy JSON objects, one per entry, separated by '\n'.
+// Binary: LOG_BIN_MAGIC, LOG_BIN_VERSION, mDNS length, mDNS, then records of
+// a LogKind byte, length as a little endian uint16, and the entry. Text
+// records are rendered entries, binary records are LogCodec entries.
+
+namespace Comms {
+
+#define UDP_TAG "(UDPSEND)"
+#define UDP_DGRAM_SIZE 1400 // Max datagram, below 1472 of a 1500 MTU.
+#define UDP_HDR_SIZE 72 // Room for the binary datagram header with mDNS.
+#define UDP_REC_HDR_SIZE 3 // Binary record kind and length.
+#define UDP_FLUSH_MS 250 // Max time an entry waits before sending.
+#define UDP_HB_SIZE 192 // Heartbeat message.
+#define UDP_RESOLVE_TIMEOUT 1000 // ms, mDNS query of the primary node.
+#define UDP_RESOLVE_RETRY_MS 5000 // Min time between failed resolutions.
+#define UDP_RESOLVE_REFRESH_MS 300000 // Re-resolves, address may change.
+
+struct UDPStats {
+    uint32_t datagrams; // Datagrams sent, logs and heartbeats.
+    uint32_t entries; // Log entries sent.
+    uint32_t dropped; // Log entries dropped, unsent or failed.
+    uint32_t sendFails; // Datagrams that failed to send.
+    uint32_t resolves; // Successful resolutions of the primary node.
+};
+
+class UDPSender {
+    private:
+    const char* tag;
+    char log[LOG_MAX_ENTRY]; // Resolution logging only.
+    int sock; // Persistent socket, -1 if not open.
+    std::atomic<uint32_t> addr; // Primary node IPv4, network order, 0 if not.
+    int64_t resolvedAt; // Millis of the last resolution attempt.
+    bool resolveErr; // Last resolution failed, logs once per streak.
+    uint8_t batch[UDP_DGRAM_SIZE - UDP_HDR_SIZE]; // Batched log entries.
+    size_t batchLen; // Bytes batched.
+    size_t batchEntries; // Entries batched.
+    int64_t batchSince; // Millis when the oldest batched entry was added.
+    char hb[UDP_HB_SIZE]; // Latest heartbeat, replaces unsent.
+    bool hbPending; // Heartbeat awaiting send.
+    std::atomic<uint32_t> datagrams, entries, dropped, sendFails, resolves;
+    static Threads::Mutex mtx;
+    UDPSender();
+    UDPSender(const UDPSender&) = delete; // prevent copying
+    UDPSender &operator=(const UDPSender&) = delete; // prevent assignment
+    void resolve();
+    bool sendTo(const void* data, size_t len, uint16_t port);
+    void sendBatch();
+
+    public:
+    static UDPSender* get();
+    void addLog(const void* data, size_t len, Messaging::LogKind kind);
+    void setHeartbeat(const char* msg);
+    void flush();
+    void getStats(UDPStats &stats);
+};
+
+}
+
+#endif // UDPSENDER_HPP
@@ -421,6 +421,8 @@ const char MAINpage[] = R"rawliteral(
     
     // Intervals (millis)
     const POLL_INTV = 1000; // Poll interval (ms) to run GET_ALL.
+    const PUSH_INTV = 1; // Seconds between pushed GET_ALL when subscribed.
+    const PUSH_ID = 256; // Response id of pushed GET_ALL, SKT_PUSH_ID.
     const CHK_OTA_INTV = 86400000; // OTA check run.
     const CLEAR_REQ_INTV_MS = 10000; // Clear exp skt req if non-response.
     const FW_CHECK_INTV = 12 * 60 * 60 * 1000; // Check for new firmware.
@@ -434,6 +436,7 @@ const char MAINpage[] = R"rawliteral(
     const maxID = 255; // Used to reset ID num to 0 when this value is reached.
     const NO_CALIB_RAD = 10; // Prevents calib from radius from midnight.
     const logDelim = ';'; // Delimiter used in logging from the server.
+    const LOG_KEEP = 1000; // Max log entries kept by the page.
     const RE_OFF = 255; // Signals relay is not attached.
     let isCelcius = false;
     const sensHlthErr = 5.0; // Must equal value in config.hpp HEALTH_ERR_BAD
@@ -453,13 +456,15 @@ const char MAINpage[] = R"rawliteral(
         "RELAY_TIMER", "RELAY_TIMER_DAY", "ATTACH_RELAYS", "SET_TEMPHUM", 
         "SET_SOIL", "SET_LIGHT", "SET_SPEC_INTEGRATION_TIME", "SET_SPEC_GAIN", 
         "CLEAR_AVERAGES", "CLEAR_AVG_SET_TIME", "SAVE_AND_RESTART", 
-        "GET_TRENDS"];
+        "GET_TRENDS", "GET_LOG_SINCE", "SET_LOG_LEVEL", 
+        "SUBSCRIBE", "GET_DELTA", "BATCH", "GET_SESSIONS", "GET_LOAD",
+        "GET_HISTORY", "GET_STATS"];
 
     // Declare all vars here, to save space. idNum is used to keep track of
     // socket commands, allData contains all sensor data, and log contains
-    // all log entries.
-    let socket, poll, clearReqID, requestIDs = {}, idNum = 0,
-        allData = {}, log = [], Expansions = {}, Markers = {};
+    // all log entries, newest first, through logHead, the newest sequence.
+    let socket, poll, clearReqID, requestIDs = {}, idNum = 0, deltaVer = 0,
+        allData = {}, log = [], logHead = 0, Expansions = {}, Markers = {};
 
     // START CONTAINER BUILDING ================================================
 
@@ -1651,17 +1656,28 @@ const char MAINpage[] = R"rawliteral(
         socket.onmessage = socketMsg;
     }
 
-    const socketOpen = () => { // Open socket handler and start polling.
+    // Open socket handler. Subscribes to pushed data, polling only if the
+    // subscription is refused.
+    const socketOpen = () => {
         console.log("Connected to server");
         Flags.SKTconn = true;
-        poll = setInterval(pollServer, POLL_INTV); // Set intervals
+        socket.send(`${convert("SUBSCRIBE")}/${PUSH_INTV}/${getID(subResp)}/`);
         clearReqID = setInterval(clearOldRequests, CLEAR_REQ_INTV_MS); 
     }
 
+    // Requires the SUBSCRIBE response. Falls back to polling if refused.
+    const subResp = (response) => {
+        if (response.status !== 1 && poll === undefined) {
+            poll = setInterval(pollServer, POLL_INTV);
+        }
+    }
+
     const socketClose = () => { // Close socket handler
         console.log("Disconnected from server");
         Flags.SKTconn = false;
         clearInterval(poll); // Clear intervals.
+        poll = undefined;
+        deltaVer = 0; // Next data includes all fields.
         clearInterval(clearReqID);
         setTimeout(initWebSocket, 2000); // Attempt reconnect after 2 sec.
     }
@@ -1670,10 +1686,12 @@ const char MAINpage[] = R"rawliteral(
     // assigned function to handle that response.
     const socketMsg = (event) => {handleResponse(JSON.parse(event.data));}
 
-    // Polls the server at a set interval requesting all data.
+    // Polls the server at a set interval requesting data changed since the
+    // previous poll.
     const pollServer = () => {
         if (isSocketOpen()) {
-            socket.send(`${convert("GET_ALL")}/${0x00}/${getID(getAll)}/`);
+            const id = getID(getDelta);
+            socket.send(`${convert("GET_DELTA")}/${deltaVer}/${id}/`);
         }
     }
 
@@ -1698,6 +1716,13 @@ const char MAINpage[] = R"rawliteral(
     // runs if exists. Deletes the request ID upon receiving response. 
     const handleResponse = (response) => {
         response.id = Number(response.id); // Explicity convert to number.
+
+        // Pushed data is unrequested, and handled as a GET_DELTA response.
+        if (response.id === PUSH_ID) {
+            getDelta(response);
+            return;
+        }
+
         const func = requestIDs[response.id][0] ? // Set to null if non-exist.
             requestIDs[response.id][0] : null;
     
@@ -1713,6 +1738,15 @@ const char MAINpage[] = R"rawliteral(
         delete requestIDs[response.id]; // Delete corresponding ID.
     }
 
+    // Requires the GET_DELTA response, holding only the fields changed since
+    // deltaVer, or all fields if full. Merges the fields into allData.
+    let getDelta = (data) => {
+        if (data.full === 1) allData = {};
+        deltaVer = data.ver;
+        ["id", "ver", "full"].forEach(key => delete data[key]);
+        getAll(Object.assign(allData, data));
+    }
+
     // This is called after polling, and responds to all rcvd data.
     let getAll = (data) => { 
         allData = data; // Allows use between poll interval waits by copying.
@@ -2237,22 +2271,28 @@ const char MAINpage[] = R"rawliteral(
         });
     }
 
-    // Gets the log, separates it into a non-delimited array, to be used
-    // for diplay at the page bottom, which is opened by openLog.
+    // Gets the log entries newer than logHead, separates them into a 
+    // non-delimited array, and adds them to the log to be used for display 
+    // at the page bottom, which is opened by openLog.
     let getLog = () => { // HTTP call
         const button = document.getElementById("logBut");
-        fetch(logURL)
+        fetch(`${logURL}?since=${logHead}`)
         .then(response => {
             if (!response.ok) {
                 throw new Error(`HTTP error status: ${response.status}`);
             }
-            return response.text(); // If no err, proceed.
+
+            const head = Number(response.headers.get("X-Log-Head"));
+            return response.text().then(text => ({text, head}));
         })
-        .then(text => { // Now in text form.
-            if (text.length <= 0 && !Devmode) throw new Error("No Log Data"); 
+        .then(({text, head}) => { // Now in text form.
+            if (head < logHead) log = []; // Device restarted, all resent.
+            logHead = head;
 
             // Split by delim into array and reverse for current first.
-            log = text.split(logDelim).reverse(); 
+            const entries = text.split(logDelim).filter(e => e.length > 0);
+            log = entries.reverse().concat(log).slice(0, LOG_KEEP);
+            if (log.length <= 0 && !Devmode) throw new Error("No Log Data"); 
             button.classList.add("good"); // Shows new log.
         
             // Is a receipt only, Allows server to remove flag.
@@ -0,0 +1,126 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "esp_partition.h"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+#include "Peripherals/TempHum.hpp"
+#include "Peripherals/Light.hpp"
+#include "Peripherals/Soil.hpp"
+
+// ATTENTION. Flash backed checkpoint of the sensor averages, hourly trends,
+// and light duration, surviving restarts. The routine task writes a snapshot
+// every CKPT_PERIOD_S, and saveAndRestart() writes one before restarting.
+// begin() loads the newest valid snapshot at boot, which each sensor copies
+// upon creation in its get(), so recovery is a single partition scan.
+
+// Partition layout: a ring of CKPT_SLOT sized slots, each holding a
+// CheckpointHdr and the CheckpointData. CKPT_SLOT is derived from the
+// snapshot size, a power of two dividing the sector, or whole sectors once
+// the snapshot exceeds one. Snapshots are appended to the slot following the
+// newest, erasing CKPT_ERASE bytes as a slot begins an erase unit, so each
+// sector is erased once per lap of the ring, or once per slotQty snapshots.
+// The newest slot passing its CRC is loaded, a torn write leaves the
+// previous snapshot in place.
+
+namespace Peripheral {
+
+#define CKPT_TAG "(CKPT)"
+#define CKPT_LABEL "ckpt" // Partition label, see partitions_custom.csv.
+#define CKPT_SECTOR 4096 // Flash erase size.
+#define CKPT_RING 3 // Erase units of the ring, min 2, see CKPT_PART_SIZE.
+#define CKPT_MAGIC 0x4B534847 // "GHSK"
+#define CKPT_PERIOD_S 600 // Seconds between periodic snapshots.
+#define CKPT_ERASED 0xFFFFFFFF // Magic of an erased slot.
+
+// Light duration, resumed if light continues past the restart.
+struct CheckpointLight {
+    uint32_t duration; // Seconds of light in the current or last period.
+    bool lightOn; // Light period in progress.
+};
+
+// Snapshot of every sensor state restored upon boot.
+struct CheckpointData {
+    TH_Averages thAvg;
+    TH_Trends thTrends;
+    Light_Averages lightAvg;
+    Light_Trends lightTrends;
+    CheckpointLight light;
+    Soil_Trends soilTrends[SOIL_SENSORS];
+};
+
+struct CheckpointHdr {
+    uint32_t magic; // CKPT_MAGIC when the slot is written.
+    uint32_t seq; // Increments per snapshot, the newest is loaded.
+    uint16_t len; // Bytes of CheckpointData, rejects a changed layout.
+    uint16_t boot; // Boot number the snapshot was written in.
+    uint32_t crc; // CRC32 of the header up to crc, and the data.
+} __attribute__((packed));
+
+// Requires the snapshot bytes, header included. Returns the smallest power
+// of two holding it if within a sector, otherwise the whole sectors.
+constexpr size_t ckptSlot(size_t bytes) {
+    if (bytes > CKPT_SECTOR) {
+        return (bytes + CKPT_SECTOR - 1) / CKPT_SECTOR * CKPT_SECTOR;
+    }
+
+    size_t slot = 1;
+    while (slot < bytes) slot <<= 1;
+    return slot;
+}
+
+// Bytes per snapshot slot, header included.
+constexpr size_t CKPT_SLOT =
+    ckptSlot(sizeof(CheckpointHdr) + sizeof(CheckpointData));
+
+// Bytes erased at once, the sector or the slot spanning several.
+constexpr size_t CKPT_ERASE =
+    (CKPT_SLOT > CKPT_SECTOR) ? CKPT_SLOT : CKPT_SECTOR;
+
+constexpr size_t CKPT_SLOTS_ERASE = CKPT_ERASE / CKPT_SLOT;
+
+// ATTENTION. Size of the ckpt partition. Update partitions_custom.csv if
+// changing CKPT_RING or if the snapshot outgrows its slot, begin() logs the
+// size required if the partition is too small.
+constexpr size_t CKPT_PART_SIZE = CKPT_RING * CKPT_ERASE;
+
+static_assert(CKPT_RING >= 2, "CKPT_RING requires 2 erase units");
+static_assert(sizeof(CheckpointData) <= UINT16_MAX,
+    "CheckpointData exceeds CheckpointHdr len");
+
+class Checkpoint {
+    private:
+    const char* tag;
+    char log[LOG_MAX_ENTRY];
+    const esp_partition_t* part; // nullptr if unavailable.
+    size_t slotQty; // Slots of the partition.
+    size_t nextSlot; // Slot written by the next snapshot.
+    uint32_t nextSeq; // Assigned to the next snapshot.
+    uint32_t lastSave; // Runtime seconds of the previous snapshot.
+    uint16_t boot; // Current boot number.
+    CheckpointData data; // Loaded snapshot, then the one being written.
+    bool loaded; // data holds a valid snapshot from flash.
+    bool writeErr; // Last write failed, logs once per streak.
+    static Threads::Mutex mtx;
+    Checkpoint();
+    Checkpoint(const Checkpoint&) = delete; // prevent copying
+    Checkpoint &operator=(const Checkpoint&) = delete; // prevent assignment
+    bool readSlot(size_t slot, CheckpointHdr &hdr, CheckpointData* out);
+    bool writeSlot();
+
+    public:
+    static Checkpoint* get();
+    bool begin(uint16_t boot);
+    bool restoreTH(TH_Averages &avg, TH_Trends &trends);
+    bool restoreLight(Light_Averages &avg, Light_Trends &trends,
+        CheckpointLight &light);
+
+    bool restoreSoil(Soil_Trends* trends);
+    bool save(bool force = false);
+};
+
+}
+
+#endif // CHECKPOINT_HPP
@@ -3,6 +3,7 @@
 
 #include "Drivers/AS7341/AS7341_Library.hpp"
 #include "Peripherals/Relay.hpp"
+#include "Peripherals/RingSeries.hpp"
 #include "Threads/Mutex.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "Common/FlagReg.hpp"
@@ -50,26 +51,26 @@ struct Color_Averages {
 };
 
 struct Light_Trends { // Prevous n hours of light values, on the hour.
-    uint16_t clear[TREND_HOURS];
-    uint16_t violet[TREND_HOURS];
-    uint16_t indigo[TREND_HOURS];
-    uint16_t blue[TREND_HOURS];
-    uint16_t cyan[TREND_HOURS];
-    uint16_t green[TREND_HOURS];
-    uint16_t yellow[TREND_HOURS];
-    uint16_t orange[TREND_HOURS];
-    uint16_t red[TREND_HOURS];
-    uint16_t nir[TREND_HOURS];
-    int16_t photo[TREND_HOURS];
+    RingSeries<uint16_t, TREND_HOURS> clear;
+    RingSeries<uint16_t, TREND_HOURS> violet;
+    RingSeries<uint16_t, TREND_HOURS> indigo;
+    RingSeries<uint16_t, TREND_HOURS> blue;
+    RingSeries<uint16_t, TREND_HOURS> cyan;
+    RingSeries<uint16_t, TREND_HOURS> green;
+    RingSeries<uint16_t, TREND_HOURS> yellow;
+    RingSeries<uint16_t, TREND_HOURS> orange;
+    RingSeries<uint16_t, TREND_HOURS> red;
+    RingSeries<uint16_t, TREND_HOURS> nir;
+    RingSeries<int16_t, TREND_HOURS> photo;
 };
 
 struct Light_Averages {
-    Color_Averages color; // Current color count averages.
+    Color_Averages color; // Rolling 24 hour color count means, see Stats.
     Color_Averages prevColor; // Previous color count averages.
-    float photoResistor; // Current photoresistor average.
+    float photoResistor; // Rolling 24 hour photoresistor mean.
     float prevPhotoResistor; // Previous photoresistor average.
-    size_t pollCtClr; // Poll counts for color/AS7341.
-    size_t pollCtPho; // Poll counts for photoresistor.
+    size_t pollCtClr; // Color/AS7341 readings within the rolling 24 hours.
+    size_t pollCtPho; // Photoresistor readings within the rolling 24 hours.
 };
 
 // This isn't necessary and a redundancy. This is populated upon creation of 
@@ -101,6 +102,8 @@ class Light {
     Light_Averages averages; 
     RelayConfigLight conf;
     uint32_t lightDuration;
+    uint32_t lightStart; // Runtime seconds the light period began.
+    bool lightOn; // Light period in progress.
     int16_t photoVal;
     static Threads::Mutex mtx;
     LightParams &params;
@@ -114,6 +117,7 @@ class Light {
     static void sendErr(const char* msg, Messaging::Levels lvl = 
             Messaging::Levels::ERROR);
     void median5(int16_t &val);
+    bool restore();
 
     public:
     static Light* get(LightParams* parameter = nullptr);
@@ -126,9 +130,12 @@ class Light {
     RelayConfigLight* getConf(RelayConfigLight* data = nullptr);
     Spec_Conf* getSpecConf(Spec_Conf* data = nullptr);
     Light_Averages* getAverages(Light_Averages* data = nullptr);
-    Light_Trends* getTrends(Light_Trends * data = nullptr);
-    void clearAverages();
+    Light_Trends* getTrends(Light_Trends * data = nullptr,
+        size_t hours = TREND_HOURS);
+
+    void clearAverages(bool reset = true);
     uint32_t getDuration(uint32_t* data = nullptr);
+    bool getLightOn(bool* data = nullptr);
     bool setATIME(uint8_t val);
     bool setASTEP(uint16_t val);
     bool setAGAIN(AS7341_DRVR::AGAIN val);
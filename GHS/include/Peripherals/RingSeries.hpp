@@ -0,0 +1,112 @@
+#ifndef RINGSERIES_HPP
+#define RINGSERIES_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "string.h"
+
+namespace Peripheral {
+
+// Fixed capacity series of the previous N values, newest first. Values are
+// stored in descending order from the head, which moves back one slot per
+// push, so a push is O(1) regardless of N, and the newest n values are read
+// out in at most 2 contiguous copies. Slots never pushed read as 0, matching
+// a cleared array. Trivially copyable, a copy is a snapshot.
+// WARNING. This class is not thread safe, and relies on the owner to
+// serialize access.
+template<typename T, size_t N>
+class RingSeries {
+    static_assert(N > 0, "RingSeries requires a capacity");
+
+    private:
+    T vals[N]; // Storage, vals[head] is the newest.
+    size_t head; // Index of the newest value.
+    size_t count; // Values pushed, up to N.
+
+    public:
+    // Iterates from the newest value to the oldest.
+    class const_iterator {
+        private:
+        const RingSeries* ring;
+        size_t age; // 0 is the newest.
+
+        public:
+        const_iterator(const RingSeries* ring, size_t age) :
+            ring(ring), age(age) {}
+
+        T operator*() const {return (*this->ring)[this->age];}
+
+        const_iterator &operator++() {
+            this->age++;
+            return *this;
+        }
+
+        bool operator!=(const const_iterator &other) const {
+            return this->age != other.age;
+        }
+    };
+
+    RingSeries() : vals{}, head(0), count(0) {}
+
+    // Requires the value. Inserts it as the newest, overwriting the oldest
+    // once full.
+    void push(T val) {
+        this->head = (this->head == 0) ? N - 1 : this->head - 1;
+        this->vals[this->head] = val;
+        if (this->count < N) this->count++;
+    }
+
+    // Requires the age, 0 being the newest. Returns the value, or 0 if the
+    // age exceeds the capacity.
+    T operator[](size_t age) const {
+        if (age >= N) return T{};
+        size_t idx = this->head + age;
+        return this->vals[(idx >= N) ? idx - N : idx];
+    }
+
+    // Requires the output, and quantity of values. Copies the newest qty
+    // values into the output, newest first. Output may be unaligned, such as
+    // a wire buffer. Returns the quantity copied, clamped to N.
+    size_t read(void* out, size_t qty) const {
+        if (qty > N) qty = N;
+        size_t first = N - this->head; // Values before the wrap.
+        if (first > qty) first = qty;
+
+        uint8_t* dst = static_cast<uint8_t*>(out);
+        memcpy(dst, &this->vals[this->head], first * sizeof(T));
+        memcpy(dst + first * sizeof(T), this->vals, (qty - first) * sizeof(T));
+        return qty;
+    }
+
+    // Requires the source series, and quantity of values. Replaces this
+    // series with the newest qty values of the source, the remainder reads
+    // as 0. Used to snapshot only the hours requested.
+    void copyFrom(const RingSeries &src, size_t qty) {
+        if (qty > N) qty = N;
+        src.read(this->vals, qty);
+        memset(&this->vals[qty], 0, (N - qty) * sizeof(T));
+        this->head = 0;
+        this->count = (src.count < qty) ? src.count : qty;
+    }
+
+    // Requires no params. Clears all values.
+    void clear() {
+        memset(this->vals, 0, sizeof(this->vals));
+        this->head = 0;
+        this->count = 0;
+    }
+
+    size_t size() const {return this->count;} // Values pushed, up to N.
+    static constexpr size_t capacity() {return N;}
+    const_iterator begin() const {return const_iterator(this, 0);}
+    const_iterator end() const {return const_iterator(this, N);}
+
+    // Requires the quantity. Returns the end of the newest qty values.
+    const_iterator end(size_t qty) const {
+        return const_iterator(this, (qty > N) ? N : qty);
+    }
+};
+
+}
+
+#endif // RINGSERIES_HPP
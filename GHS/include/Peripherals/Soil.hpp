@@ -2,6 +2,7 @@
 #define SOIL_HPP
 
 #include "Peripherals/Alert.hpp"
+#include "Peripherals/RingSeries.hpp"
 #include "Threads/Mutex.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "Drivers/ADC.hpp"
@@ -47,12 +48,15 @@ struct SoilReadings {
     bool readErr; // Used to show if there was a read err to block analysis
 };
 
+// Previous n hours of a soil sensor, on the hour, newest first.
+using Soil_Trends = RingSeries<int16_t, TREND_HOURS>;
+
 class Soil {
     private:
     static const char* tag;
     static char log[LOG_MAX_ENTRY];
     SoilReadings data[SOIL_SENSORS];
-    int16_t trends[SOIL_SENSORS][TREND_HOURS]; // Trends of each soil sensor.
+    Soil_Trends trends[SOIL_SENSORS]; // Trends of each soil sensor.
     static Threads::Mutex mtx;
     AlertConfigSo conf[SOIL_SENSORS];
     SoilParams &params;
@@ -77,8 +81,12 @@ class Soil {
     SoilReadings* getReadings(uint8_t indexNum, SoilReadings* data = nullptr);
     SoilReadings* getAllReadings(SoilReadings* data = nullptr);
     void checkBounds();
-    int16_t* getTrends(uint8_t indexNum, int16_t* data = nullptr);
-    int16_t* getAllTrends(int16_t* data = nullptr);
+    Soil_Trends* getTrends(uint8_t indexNum, Soil_Trends* data = nullptr,
+        size_t hours = TREND_HOURS);
+
+    Soil_Trends* getAllTrends(Soil_Trends* data = nullptr,
+        size_t hours = TREND_HOURS);
+
     // void test(int val, int sensorIdx); // Comment out for production
 };
 
@@ -0,0 +1,119 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "Peripherals/TSCodec.hpp"
+#include "Threads/Mutex.hpp"
+
+namespace Peripheral {
+
+#define STATS_TAG "(STATS)"
+#define STATS_SHORT_BUCKETS 5 // Buckets of the short window.
+#define STATS_SHORT_MS 60000 // 1 minute buckets, 5 minute window.
+#define STATS_HOUR_BUCKETS 12 // Buckets of the hour window.
+#define STATS_HOUR_MS 300000 // 5 minute buckets, 1 hour window.
+#define STATS_DAY_BUCKETS 24 // Buckets of the day window.
+#define STATS_DAY_MS 3600000 // 1 hour buckets, 24 hour window.
+#define STATS_MAX_BYTES 20480 // Static RAM budget of the instance.
+#define STATS_RING (STATS_SHORT_BUCKETS + STATS_HOUR_BUCKETS + \
+    STATS_DAY_BUCKETS - STATS_WINDOWS) // Closed buckets held per channel,
+    // every window, each less its open bucket.
+
+// Rolling windows of each channel, see the STATS_ bucket defines.
+enum class StatsWin : uint8_t {SHORT, HOUR, DAY};
+#define STATS_WINDOWS 3
+
+// Welford accumulator of the readings of a bucket.
+struct StatsBucket {
+    float mean;
+    float m2; // Sum of squared differences from the mean.
+    float min;
+    float max;
+    uint32_t count; // Readings accumulated, 0 if none.
+};
+
+// Figures of a channel over a window, the closed buckets and the open one.
+struct StatsFigures {
+    uint32_t count; // Readings within the window.
+    float mean;
+    float stdev; // Sample standard deviation, 0 below 2 readings.
+    float min;
+    float max;
+    float ema; // Exponential moving average, time constant of the window.
+};
+
+// State of a window of a channel. The closed buckets are held in the ring of
+// the channel, from the offset of the window, see StatsChan. The monotonic
+// deques hold the ring slots of the closed buckets in order of age, the min
+// deque with ascending mins, the max deque with descending maxes, so the
+// front is the extreme of the window.
+struct StatsTier {
+    StatsBucket open; // Bucket receiving readings.
+    uint32_t openIdx; // Runtime millis / bucket millis of the open bucket.
+    uint32_t closed; // Buckets closed, the sequence of the next.
+    uint8_t held; // Closed buckets held, up to the window buckets.
+    uint8_t minHead, minQty; // Min deque.
+    uint8_t maxHead, maxQty; // Max deque.
+    uint32_t aggCount; // Readings of the closed buckets held.
+    double aggMean; // Mean of the closed buckets held.
+    double aggM2; // Sum of squared differences of the closed buckets held.
+    float ema;
+    int64_t emaAt; // Runtime millis of the newest reading, -1 if none.
+    uint32_t seedCount; // Readings of the restored average, 0 if none.
+    float seedMean; // Restored average, see Stats::seed.
+    uint32_t seedAt; // Buckets closed as seeded, tapers as more close.
+};
+
+struct StatsChan { // Windows of a channel.
+    StatsTier tier[STATS_WINDOWS];
+    StatsBucket ring[STATS_RING]; // Closed buckets of every window.
+    uint8_t minQ[STATS_RING]; // Min deques of every window, ring slots.
+    uint8_t maxQ[STATS_RING]; // Max deques of every window, ring slots.
+};
+
+// ATTENTION. Streaming statistics of every channel over rolling windows of
+// 5 minutes, 1 hour, and 24 hours, about 18 KB with the default buckets,
+// held statically and bounded by STATS_MAX_BYTES. Each reading is added to
+// the open bucket of each window by Welford's method, and to the
+// exponential moving average of each window, O(1) per reading. As a bucket
+// closes it is merged into the aggregate of its window and the oldest is
+// removed, by the parallel form of Welford's method, and the monotonic
+// deques give the min and max, so closing is O(1) amortized.
+// Windows roll by bucket, the oldest bucket leaving the window as a new one
+// opens, and are aligned to the runtime of the device. A window holds the
+// readings of its closed buckets and the open one, between the window less
+// one bucket and the full window. A day average restored upon boot stands
+// in for the part of the day window not yet covered by closed buckets,
+// weighing in the count and mean, but not the stdev, min, or max. Channels
+// are those of TSChan.
+class Stats {
+    private:
+    static Threads::Mutex mtx;
+    StatsChan chans[TS_CHANNELS];
+    Stats();
+    Stats(const Stats&) = delete; // prevent copying
+    Stats &operator=(const Stats&) = delete; // prevent assignment
+    void roll(StatsChan &ch, uint8_t win, uint32_t idx);
+    void push(StatsChan &ch, uint8_t win, const StatsBucket &bkt);
+    void evict(StatsChan &ch, uint8_t win);
+    static void resetTier(StatsTier &tier);
+    static void resetBucket(StatsBucket &bkt);
+    static void merge(uint32_t &count, double &mean, double &m2,
+        const StatsBucket &bkt, bool remove = false);
+
+    static uint32_t seedLeft(const StatsTier &tier, uint8_t win);
+
+    public:
+    static Stats* get();
+    void add(TSChan first, const float* vals, size_t qty);
+    void add(TSChan chan, float val);
+    bool getFigures(TSChan chan, StatsWin win, StatsFigures &out);
+    void clear(TSChan first, size_t qty);
+    void seed(TSChan chan, uint32_t count, float mean);
+    static uint32_t windowSecs(StatsWin win);
+};
+
+}
+
+#endif // STATS_HPP
@@ -0,0 +1,177 @@
+#ifndef TSCODEC_HPP
+#define TSCODEC_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Peripheral {
+
+#define TS_CHANNELS 17 // Temp, hum, 10 AS7341 channels, photo, 4 soil.
+#define TS_CODE_MAX 0xFFFF // Max quantized value, see TSChanInfo.
+#define TS_CODEC_VERSION 1 // Bitstream layout, see TSBlockWriter.
+#define TS_BLOCK_SIZE 1024 // Bytes of a compressed block, header included.
+#define TS_HIST_BLOCKS 16 // Compressed blocks held in RAM, 16 KB.
+#define TS_CHAN_BITS 5 // Channel index of a code differing from prediction.
+
+// Channels recorded, in the order of the JSON GET_TRENDS reply. The AS7341
+// channels are consecutive, allowing a single record of all 10.
+enum class TSChan : uint8_t {TEMP, HUM, CLEAR, VIOLET, INDIGO, BLUE, CYAN,
+    GREEN, YELLOW, ORANGE, RED, NIR, PHOTO, SOIL0, SOIL1, SOIL2, SOIL3};
+
+// Name, and quantization of a channel. Values are stored as
+// (val - offset) * scale, clamped to 0 - TS_CODE_MAX, and read as
+// code / scale + offset.
+struct TSChanInfo {
+    const char* name; // Key of the JSON reply.
+    float offset; // Lowest value stored.
+    float scale; // Codes per unit.
+    uint8_t dec; // Decimal places of the JSON reply.
+    uint16_t band; // Codes a history value may differ from its prediction.
+    uint8_t rel; // 256ths of the prediction added to band.
+};
+
+// Header of a compressed block, followed by its bitstream.
+struct TSBlockHdr {
+    uint8_t version; // TS_CODEC_VERSION.
+    uint8_t chans; // Codes per row, TS_CHANNELS.
+    uint16_t boot; // Boot number the rows were recorded in.
+    uint32_t startMin; // Runtime minute of the first row.
+    uint16_t rows; // Rows encoded.
+    uint16_t bits; // Bits of the bitstream.
+} __attribute__((packed));
+
+// Prediction of a channel, tracked identically by the encoder and decoder.
+// The slope is that between the 2 most recent rows differing from their
+// prediction, the anchors, so it averages the noise of the rows between.
+struct TSTrend {
+    int32_t pos; // Code of the previous row, 16ths.
+    int32_t slope; // 16ths of a code per row.
+    uint16_t anchor; // Code of the newest anchor.
+    uint16_t since; // Rows since the anchor.
+};
+
+static_assert(TS_CHANNELS <= (1 << TS_CHAN_BITS), "TS_CHAN_BITS too few");
+
+// Channel table, quantization, and the integer transforms of the codec.
+class TSCodec {
+    public:
+    static const TSChanInfo info[TS_CHANNELS];
+    static uint16_t encode(uint8_t chan, float val);
+    static float decode(uint8_t chan, uint16_t code);
+    static uint32_t zigzag(int32_t val);
+    static int32_t unzigzag(uint32_t val);
+    static int32_t tolerance(uint8_t chan, uint16_t ref);
+    static void trendStart(TSTrend &trend, uint16_t code);
+    static uint16_t trendPredict(const TSTrend &trend);
+    static void trendUpdate(TSTrend &trend, uint16_t code);
+    static uint16_t predict(const TSTrend* trends, uint8_t chan,
+        const uint16_t* row);
+};
+
+// Writes values MSB first into a byte buffer.
+class TSBitWriter {
+    private:
+    uint8_t* buf;
+    size_t capBits; // Bits available.
+    size_t pos; // Bits written.
+
+    public:
+    TSBitWriter();
+    void begin(uint8_t* buf, size_t size, size_t pos = 0);
+    bool put(uint32_t val, uint8_t bits);
+    size_t getPos() const;
+    void rewind(size_t pos);
+};
+
+// Reads values MSB first from a byte buffer.
+class TSBitReader {
+    private:
+    const uint8_t* buf;
+    size_t lenBits; // Bits readable.
+    size_t pos; // Bits read.
+
+    public:
+    TSBitReader(const uint8_t* buf, size_t lenBits);
+    bool get(uint8_t bits, uint32_t &val);
+};
+
+// ATTENTION. Gorilla style encoder of rows of TS_CHANNELS codes, each row
+// stamped with its runtime minute. The first row is stored raw, 16 bits per
+// code. Following rows store the delta of delta of the minute, then each
+// code differing from its prediction as a 1 bit, its 5 bit channel index,
+// and the zig-zag of the difference prefixed by its width, the row ending
+// with a 0 bit. Codes are predicted to continue their slope, see TSTrend,
+// so the difference is their delta of delta, and the AS7341 channels and
+// photo are scaled by the difference of CLEAR, following passing clouds.
+// A regular minute of predicted codes costs 2 bits.
+// Minute delta of delta: 0 | 10 + 7 | 110 + 9 | 1110 + 12 | 1111 + 32.
+// Code difference: 0 + 4 | 10 + 8 | 11 + 17.
+class TSBlockWriter {
+    private:
+    uint8_t* block; // TS_BLOCK_SIZE, nullptr if not begun.
+    TSBitWriter bits;
+    TSBlockHdr hdr;
+    uint32_t prevMin;
+    int32_t prevDelta;
+    TSTrend trend[TS_CHANNELS];
+
+    public:
+    TSBlockWriter();
+    void begin(uint8_t* block, uint16_t boot);
+    bool append(uint32_t minute, const uint16_t* codes);
+    void end();
+    bool isOpen() const;
+    uint16_t getRows() const;
+    uint16_t predict(uint8_t chan, const uint16_t* row) const;
+};
+
+// Decodes a block written by TSBlockWriter, one row at a time.
+class TSBlockReader {
+    private:
+    TSBlockHdr hdr;
+    TSBitReader bits;
+    uint16_t row; // Rows read.
+    uint32_t prevMin;
+    int32_t prevDelta;
+    TSTrend trend[TS_CHANNELS];
+    bool valid;
+
+    public:
+    TSBlockReader(const uint8_t* block, size_t len);
+    bool next(uint32_t &minute, uint16_t* codes);
+    const TSBlockHdr &getHdr() const;
+};
+
+// ATTENTION. Ring of TS_HIST_BLOCKS compressed blocks, appended one row per
+// minute, the oldest block evicted once full. Each block started receives
+// the next sequence number, allowing it to be read in pieces, see
+// getBlock(). A code within the tolerance of its channel of its prediction
+// is stored as predicted, see TSCodec::tolerance(), so steady trends and
+// noise cost nothing beyond the row. Absent channels hold their previous code.
+// WARNING. This class is not thread safe, and relies on the owner to
+// serialize access.
+class TSHistory {
+    private:
+    uint8_t blocks[TS_HIST_BLOCKS][TS_BLOCK_SIZE];
+    uint32_t firstSeq; // Sequence of the oldest block held.
+    uint32_t nextSeq; // Sequence of the next block started.
+    TSBlockWriter writer; // Writes the newest block, seq nextSeq - 1.
+    uint16_t last[TS_CHANNELS]; // Codes of the previous row.
+    uint16_t boot; // Boot number stamped on the blocks started.
+    bool hasLast;
+    bool start();
+
+    public:
+    TSHistory();
+    void setBoot(uint16_t boot);
+    bool append(uint32_t minute, const uint16_t* codes, uint32_t present);
+    bool load(const uint8_t* block, size_t len);
+    size_t getBlock(uint32_t seq, uint8_t* out, size_t size) const;
+    uint32_t getFirstSeq() const;
+    uint32_t getNextSeq() const;
+    uint32_t getSealedEnd() const;
+};
+
+}
+
+#endif // TSCODEC_HPP
@@ -5,6 +5,7 @@
 #include "Drivers/SHT_Library.hpp"
 #include "Peripherals/Relay.hpp"
 #include "Peripherals/Alert.hpp"
+#include "Peripherals/RingSeries.hpp"
 #include "Threads/Mutex.hpp"
 #include "Common/FlagReg.hpp"
 #include "UI/MsgLogHandler.hpp"
@@ -55,16 +56,16 @@ struct TH_TRIP_CONFIG {
 
 // Temperature and humidity averages. 
 struct TH_Averages {
-    size_t pollCt; // How many times has sensor been polled
-    float temp; // temp accum / pollCt
-    float hum; // hum accum / pollCt
+    size_t pollCt; // Readings within the rolling 24 hours.
+    float temp; // Rolling 24 hour mean, see Stats.
+    float hum; // Rolling 24 hour mean, see Stats.
     float prevTemp; // Previous values copied when cleared.
     float prevHum; // Previous values copied when cleared.
 };
 
-struct TH_Trends {
-    float temp[TREND_HOURS];
-    float hum[TREND_HOURS];
+struct TH_Trends { // Previous n hours, on the hour, newest first.
+    RingSeries<float, TREND_HOURS> temp;
+    RingSeries<float, TREND_HOURS> hum;
 };
 
 // temperature and humidity parameters required for init.
@@ -99,6 +100,7 @@ class TempHum {
     void computeAvgs();
     void computeTrends();
     void median3(SHT_DRVR::SHT_VALS &vals);
+    bool restore();
     static void sendErr(const char* msg, Messaging::Levels lvl = 
         Messaging::Levels::ERROR);
 
@@ -112,8 +114,10 @@ class TempHum {
     bool checkBounds();
     float getHealth(float* data = nullptr);
     TH_Averages* getAverages(TH_Averages* data = nullptr);
-    TH_Trends* getTrends(TH_Trends* data = nullptr);
-    void clearAverages();
+    TH_Trends* getTrends(TH_Trends* data = nullptr,
+        size_t hours = TREND_HOURS);
+
+    void clearAverages(bool reset = true);
     bool getReadOK(bool* data = nullptr);
     // void test(bool isTemp, float val); // Uncomment out when testing.
 };
@@ -0,0 +1,111 @@
+#ifndef TIMESERIES_HPP
+#define TIMESERIES_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "Peripherals/RingSeries.hpp"
+#include "Peripherals/TSCodec.hpp"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Peripheral {
+
+#define TS_TAG "(TSERIES)"
+#define TS_MIN_BUCKETS 15 // 1 minute buckets, a quarter, see TSHistory.
+#define TS_QTR_BUCKETS 32 // 15 minute buckets, 8 hours.
+#define TS_HOUR_BUCKETS 48 // Hourly buckets, 2 days.
+#define TS_DAY_BUCKETS 14 // Daily buckets, 2 weeks.
+#define TS_FILE "/spiffs/tshist.bin" // Persisted history blocks.
+#define TS_FILE_BLOCKS 8 // Slots of the file, the newest sealed blocks.
+#define TS_FILE_MAGIC 0x53544847 // "GHTS"
+
+// Resolution of each tier. Each tier rolls up into the next as its buckets
+// close.
+enum class TSRes : uint8_t {MINUTE, QUARTER, HOUR, DAY};
+#define TS_RES_QTY 4
+
+// Aggregate of a channel over a closed bucket, quantized. A count of 0
+// shows no readings within the bucket, the remaining values are then 0.
+struct TSBucket {
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint32_t count; // Readings aggregated.
+} __attribute__((packed));
+
+struct TSRow { // All channels of a closed bucket.
+    TSBucket ch[TS_CHANNELS];
+};
+
+// Aggregate of a channel over the open bucket of a tier.
+struct TSAccum {
+    float sum;
+    float min;
+    float max;
+    uint32_t count;
+};
+
+// Slot of TS_FILE, holding a sealed history block. Slots are written in
+// turn, the slot being saveNum % TS_FILE_BLOCKS.
+struct TSFileSlot {
+    uint32_t magic; // TS_FILE_MAGIC when written.
+    uint32_t saveNum; // Increments per block saved, orders the slots.
+    uint32_t crc; // CRC32 of the block.
+    uint8_t block[TS_BLOCK_SIZE];
+} __attribute__((packed));
+
+// ATTENTION. Fixed memory store of min/max/mean/count per bucket for every
+// channel, at 1 minute, 15 minute, hourly, and daily resolution, about
+// 18 KB with the default bucket quantities. Readings are aggregated into
+// the open minute bucket. When it closes, it is pushed into the minute tier
+// and merged into the open 15 minute bucket, which is pushed and merged into
+// the open hourly bucket once 15 minutes close, and so on. Buckets are
+// aligned to the runtime of the device, not the calibrated clock, see
+// getNewest. The minute tier spans a quarter only, older minute means are
+// held by the compressed history.
+// The mean of each closed minute is also appended to the compressed history,
+// TS_HIST_BLOCKS KB holding days of minutes, see TSHistory. Sealed blocks
+// are saved to TS_FILE by persist(), and restored upon boot by restore().
+class TimeSeries {
+    private:
+    static Threads::Mutex mtx;
+    static const uint32_t minutes[TS_RES_QTY]; // Minutes per bucket.
+    RingSeries<TSRow, TS_MIN_BUCKETS> minTier;
+    RingSeries<TSRow, TS_QTR_BUCKETS> qtrTier;
+    RingSeries<TSRow, TS_HOUR_BUCKETS> hourTier;
+    RingSeries<TSRow, TS_DAY_BUCKETS> dayTier;
+    TSAccum open[TS_RES_QTY][TS_CHANNELS]; // Open bucket of each tier.
+    uint32_t closed[TS_RES_QTY]; // Buckets closed per tier, the sequence.
+    uint32_t openMin; // Runtime minute of the open minute bucket.
+    int64_t closedAt[TS_RES_QTY]; // Runtime millis the newest bucket closed.
+    TSHistory hist; // Compressed minute means.
+    uint32_t savedSeq; // History blocks prior to this sequence are saved.
+    uint32_t saveNum; // Assigned to the next block saved, see TSFileSlot.
+    TSFileSlot slot; // Persistence buffer, used by a single task.
+    char log[LOG_MAX_ENTRY];
+    bool fileErr; // Last save failed, logs once per streak.
+    TimeSeries();
+    TimeSeries(const TimeSeries&) = delete; // prevent copying
+    TimeSeries &operator=(const TimeSeries&) = delete; // prevent assignment
+    void roll(int64_t now);
+    void close(TSRes res, int64_t now);
+    static void resetAccum(TSAccum &acc);
+
+    public:
+    static TimeSeries* get();
+    void record(TSChan first, const float* vals, size_t qty);
+    void record(TSChan chan, float val);
+    uint32_t getNewest(TSRes res, uint32_t &ageMs);
+    bool getRow(TSRes res, uint32_t seq, TSRow &row);
+    static size_t capacity(TSRes res);
+    static uint32_t bucketSecs(TSRes res);
+    size_t getHistBlock(uint32_t seq, uint8_t* out, size_t size,
+        uint32_t &firstSeq, uint32_t &nextSeq);
+
+    void restore(uint16_t boot);
+    void persist();
+};
+
+}
+
+#endif // TIMESERIES_HPP
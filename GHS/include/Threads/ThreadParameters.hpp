@@ -56,6 +56,18 @@ struct routineThreadParams {
         size_t relayQty);
 };
 
+struct logThreadParams {
+    uint32_t delay;
+
+    logThreadParams(uint32_t delay);
+};
+
+struct sktThreadParams {
+    uint32_t delay;
+
+    sktThreadParams(uint32_t delay);
+};
+
 }
 
 #endif // THREADPARAMETERS_HPP
\ No newline at end of file
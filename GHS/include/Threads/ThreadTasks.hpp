@@ -16,6 +16,8 @@ namespace ThreadTask {
 #define LIGHT_HEARTBEAT 5
 #define SOIL_HEARTBEAT 3
 #define ROUTINE_HEATBEAT 3
+#define LOG_HEARTBEAT 3
+#define SKT_HEARTBEAT 3
 
 #define HB_DELAY 10 // Populates the heartbeat with this val upon registration.
 
@@ -32,6 +34,8 @@ void SHTTask(void* parameter);
 void LightTask(void* parameter);
 void soilTask(void* parameter);
 void routineTask(void* parameter);
+void logTask(void* parameter);
+void sktTask(void* parameter);
 
 }
 
@@ -0,0 +1,92 @@
+#ifndef LOGCODEC_HPP
+#define LOGCODEC_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "UI/LogFormats.hpp"
+
+namespace Messaging {
+
+#define LOG_BIN_ARGS_SIZE 64 // Bytes of packed arguments per binary entry.
+#define LOG_BIN_STR_MAX 24 // Max bytes copied per string argument.
+#define LOG_BIN_MAGIC "GHSB" // Leads each binary UDP datagram.
+#define LOG_BIN_MAGIC_LEN 4
+#define LOG_BIN_VERSION 2 // Binary UDP datagram version, 2 batches entries.
+
+// Type tag preceding each packed argument.
+enum class LogArg : uint8_t {I32, U32, I64, U64, F32, STR};
+
+// Header of a binary log entry, followed by argBytes of packed arguments. Each
+// argument is a LogArg tag followed by its raw value. Strings are a length
+// byte followed by the characters, not null terminated.
+struct LogBinHdr {
+    uint8_t level; // Levels.
+    uint32_t seconds; // System seconds when logged.
+    uint16_t fmt; // LogFmt.
+    uint8_t argBytes; // Bytes of packed arguments following the header.
+} __attribute__((packed));
+
+// Raw arguments of a binary log entry, packed at the call site. Packing is a
+// copy per argument, the formatting is deferred until the entry is read.
+class LogArgs {
+    private:
+    uint8_t data[LOG_BIN_ARGS_SIZE];
+    uint8_t len;
+    void put(LogArg type, const void* val, size_t size);
+    void putStr(const char* str);
+
+    public:
+    LogArgs();
+
+    template<typename T>
+    void add(T val) {
+        if constexpr (std::is_same_v<T, const char*> ||
+            std::is_same_v<T, char*>) {
+            this->putStr(val);
+        } else if constexpr (std::is_enum_v<T>) {
+            this->add(static_cast<std::underlying_type_t<T>>(val));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            float f = static_cast<float>(val);
+            this->put(LogArg::F32, &f, sizeof(f));
+        } else if constexpr (std::is_signed_v<T>) {
+            if constexpr (sizeof(T) > sizeof(int32_t)) {
+                int64_t i = val;
+                this->put(LogArg::I64, &i, sizeof(i));
+            } else {
+                int32_t i = val;
+                this->put(LogArg::I32, &i, sizeof(i));
+            }
+        } else {
+            static_assert(std::is_unsigned_v<T>, "Unsupported log argument");
+            if constexpr (sizeof(T) > sizeof(uint32_t)) {
+                uint64_t u = val;
+                this->put(LogArg::U64, &u, sizeof(u));
+            } else {
+                uint32_t u = val;
+                this->put(LogArg::U32, &u, sizeof(u));
+            }
+        }
+    }
+
+    template<typename... Args>
+    void addAll(Args... args) {(this->add(args), ...);}
+
+    const uint8_t* getData() const;
+    uint8_t getLen() const;
+};
+
+namespace LogCodec {
+
+size_t encode(uint8_t* out, size_t size, uint8_t level, uint32_t seconds,
+    LogFmt fmt, const LogArgs &args);
+
+size_t format(const uint8_t* entry, size_t len, char* out, size_t size);
+size_t render(const uint8_t* entry, size_t len, char* out, size_t size);
+bool header(const uint8_t* entry, size_t len, LogBinHdr &hdr);
+
+}
+
+}
+
+#endif // LOGCODEC_HPP
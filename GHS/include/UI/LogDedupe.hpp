@@ -0,0 +1,68 @@
+#ifndef LOGDEDUPE_HPP
+#define LOGDEDUPE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "Config/config.hpp"
+#include "UI/LogCodec.hpp"
+#include "UI/LogRing.hpp"
+
+namespace Messaging {
+
+#define DEDUPE_PROBE 8 // Slots searched per signature, from its hash slot.
+#define DEDUPE_TEXT 48 // Message prefix kept for the summary.
+#define DEDUPE_KEY (sizeof(uint16_t) + LOG_BIN_ARGS_SIZE) // Fmt ID and args.
+#define DEDUPE_SIG (DEDUPE_KEY > DEDUPE_TEXT ? DEDUPE_KEY : DEDUPE_TEXT)
+#define DEDUPE_EMPTY 0 // Hash of an unused slot.
+
+static_assert(LOG_DEDUPE_SLOTS >= 32 && LOG_DEDUPE_SLOTS <= 64,
+    "LOG_DEDUPE_SLOTS must be 32 to 64");
+
+// Signature of a recently logged message.
+struct DedupeSlot {
+    uint32_t hash; // FNV-1a of the signature, DEDUPE_EMPTY if unused.
+    uint32_t resetTime; // Seconds when a repeat is allowed once more.
+    uint32_t lastSeen; // Seconds of the latest occurrence, for eviction.
+    uint32_t reportedAt; // Seconds of the latest summary, or creation.
+    uint32_t suppressed; // Repeats blocked since the latest summary.
+    uint16_t count; // Consecutive repeats, allowed to CONSECUTIVE_ENTRIES.
+    LogKind kind; // TEXT, or BIN rendered only for the summary.
+    uint8_t len; // Bytes of sig.
+    uint8_t sig[DEDUPE_SIG]; // Message prefix, or the format ID and args.
+};
+
+// Fixed table of message signatures, suppressing repeat entries so that a
+// recurring fault, such as a disconnected sensor wire, does not flood the
+// log. Each message is hashed, and its signature is found by probing up to
+// DEDUPE_PROBE slots from its hash slot. New signatures replace an unused
+// slot, or the least recently seen within the probe, preferring those 
+// without unreported repeats. Per signature, the first CONSECUTIVE_ENTRIES
+// repeats are allowed, then one per CONSECUTIVE_ENTRY_TIMEOUT. Blocked 
+// repeats are counted and reported as "xN" summaries by summarize(). Binary
+// entries are signed by their format ID and raw arguments, and are only
+// rendered if summarized, never per check.
+// WARNING. This class is not thread safe, and relies on the owner to
+// serialize access.
+class LogDedupe {
+    private:
+    DedupeSlot slots[LOG_DEDUPE_SLOTS];
+    uint32_t evicted; // Unreported repeats lost to eviction.
+    static uint32_t hash(LogKind kind, const uint8_t* sig, size_t len);
+    DedupeSlot* find(uint32_t hash, LogKind kind, const uint8_t* sig,
+        size_t len);
+
+    bool admit(uint32_t h, LogKind kind, const uint8_t* sig, size_t len,
+        uint32_t time);
+
+    static void render(const DedupeSlot &slot, char* data, size_t size);
+
+    public:
+    LogDedupe();
+    bool check(const char* message, uint32_t time);
+    bool check(const uint8_t* entry, size_t len, uint32_t time);
+    bool summarize(uint32_t time, char* data, size_t size);
+};
+
+}
+
+#endif // LOGDEDUPE_HPP
@@ -0,0 +1,45 @@
+#ifndef LOGFORMATS_HPP
+#define LOGFORMATS_HPP
+
+#include <cstdint>
+
+namespace Messaging {
+
+// Format strings of the binary log entries. Each entry records only its format
+// ID and raw arguments, and is rendered from this table when read, by /getLog
+// or by the host decoder reading UDP captures.
+// WARNING. IDs are the position within this list. Append new formats to the
+// end and never remove or reorder, otherwise previously captured entries will
+// decode with the wrong format. The host decoder must be built from the same
+// table as the firmware that produced the capture.
+#define LOG_FORMATS(X) \
+    X(THREAD_OVERRUN, "%s overrun: Work (%lu)ms exceeds period (%lu)ms") \
+    X(THREAD_HWM, "%s Thread High Water Mark @ %u words") \
+    X(I2C_BUS_HANG, "%s bus hang Δ=%.2fms (SCL=%d SDA=%d) -> recovering") \
+    X(I2C_DEV_UNRESP, "%s device @ addr %#x unresponsive @ %0.2f / %0.2f") \
+    X(I2C_DEV_FAILING, "%s device @ addr %#x failing @ %0.2f / %0.2f") \
+    X(SENS_READ_ERR, "%s read err") \
+    X(SENS_ERR_FIXED, "%s err fixed") \
+    X(SOIL_READ_ERR, "%s snsr %d read err") \
+    X(SOIL_ERR_FIXED, "%s snsr %d err fixed") \
+    X(LIGHT_SPEC_READ_ERR, "%s spec read err") \
+    X(LIGHT_SPEC_ERR_FIXED, "%s spec err fixed") \
+    X(LIGHT_PHOTO_READ_ERR, "%s photo read err") \
+    X(LIGHT_PHOTO_ERR_FIXED, "%s photo err fixed")
+
+#define LOG_FMT_ENUM(id, fmt) id,
+
+enum class LogFmt : uint16_t {
+    LOG_FORMATS(LOG_FMT_ENUM)
+    COUNT // Total formats, not a format.
+};
+
+#undef LOG_FMT_ENUM
+
+extern const char* const LogFmtTable[]; // Indexed by LogFmt.
+
+const char* logFmtString(uint16_t fmtID);
+
+}
+
+#endif // LOGFORMATS_HPP
@@ -0,0 +1,109 @@
+#ifndef LOGJOURNAL_HPP
+#define LOGJOURNAL_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include "esp_partition.h"
+#include "Threads/Mutex.hpp"
+#include "UI/LogRing.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+// ATTENTION. Flash backed journal of the log, surviving restarts and crashes.
+// Each entry appended to the log ring is copied to a RAM batch, which the log
+// task writes to the journal partition with a single flash write, once
+// JOURNAL_FLUSH_MS elapses, once half full, or immediately after a CRITICAL
+// entry, or by the appending task if a burst fills it. No flash writes occur
+// per entry. The partition is a ring of erase
+// sectors, each erased only once the journal wraps to it, evenly wearing
+// every sector. Entries since the last flush are lost upon a crash, not upon
+// a restart through sync().
+
+// Sector layout: JournalSectorHdr, then JournalRecHdr framed records until
+// the erased remainder, read as 0xFF. Each record holds the boot number, the
+// log ring sequence number, and the entry as stored in the ring, with a CRC32
+// of the header and entry. A record failing the CRC marks a torn write, and
+// ends its sector.
+
+namespace Messaging {
+
+#define JOURNAL_TAG "(JOURNAL)"
+#define JOURNAL_LABEL "logjrnl" // Partition label, see partitions_custom.csv.
+#define JOURNAL_SECTOR 4096 // Flash erase size.
+#define JOURNAL_MAX_SECTORS 32 // Up to 128 KB partition.
+#define JOURNAL_MAGIC 0x4A534847 // "GHSJ"
+#define JOURNAL_BUF_SIZE 2048 // RAM batch, flushed once half full.
+#define JOURNAL_FLUSH_MS 30000 // Max time an entry waits in RAM.
+#define JOURNAL_REC_MAX 560 // Max entry, BIGLOG_MAX_ENTRY and padding.
+#define JOURNAL_ERASED 0xFFFF // Record length of erased flash.
+#define JOURNAL_BOOT_NONE 0 // Boot numbers begin at 1.
+
+struct JournalSectorHdr {
+    uint32_t magic; // JOURNAL_MAGIC when the sector is in use.
+    uint32_t sectorSeq; // Increments per sector started, orders the ring.
+} __attribute__((packed));
+
+struct JournalRecHdr {
+    uint16_t len; // Entry bytes following the header.
+    LogKind kind; // Text or binary entry.
+    uint16_t boot; // Boot number, increments each boot.
+    uint32_t seq; // Log ring sequence number within the boot.
+    uint32_t crc; // CRC32 of the header up to crc, and the entry.
+} __attribute__((packed));
+
+struct JournalSector { // RAM index of a sector.
+    uint32_t sectorSeq; // 0 if unused.
+    uint16_t firstBoot; // Boot of the first record, if hasFirst.
+    uint32_t firstSeq; // Sequence of the first record, if hasFirst.
+    bool hasFirst; // Sector holds a record.
+};
+
+class LogJournal {
+    private:
+    const char* tag;
+    char log[LOG_MAX_ENTRY]; // Init and write error logging only.
+    const esp_partition_t* part; // nullptr if unavailable.
+    JournalSector sectors[JOURNAL_MAX_SECTORS];
+    size_t sectorQty; // Sectors of the partition.
+    size_t active; // Sector being written.
+    size_t offset; // Write offset within the active sector.
+    uint32_t nextSectorSeq; // Assigned to the next sector started.
+    uint16_t boot; // Current boot number.
+    uint8_t buf[JOURNAL_BUF_SIZE]; // RAM batch of framed records.
+    uint8_t scratch[JOURNAL_REC_MAX]; // Record read from flash.
+    size_t bufLen; // Bytes batched.
+    int64_t bufSince; // Millis when the oldest batched record was added.
+    bool urgent; // CRITICAL entry batched, flush upon the next call.
+    bool init; // Partition scanned and boot number set.
+    bool writeErr; // Last write failed, logs once per streak.
+    std::atomic<uint32_t> dropped; // Records dropped, batch full or locked.
+    std::atomic<uint32_t> writes; // Flash writes.
+    static Threads::Mutex mtx;
+    LogJournal();
+    LogJournal(const LogJournal&) = delete; // prevent copying
+    LogJournal &operator=(const LogJournal&) = delete; // prevent assignment
+    bool readRecord(size_t sector, size_t offset, JournalRecHdr &hdr);
+    size_t scanSector(size_t idx, uint16_t &lastBoot);
+    bool startSector();
+    bool writeRecords(size_t len);
+    void writeBatch();
+    size_t order(size_t pos) const;
+    bool skipSector(size_t pos, uint16_t boot, uint32_t seq) const;
+
+    public:
+    static LogJournal* get();
+    bool begin();
+    void append(const void* data, size_t len, LogKind kind, uint32_t seq,
+        bool critical);
+
+    void flush(bool force = false);
+    size_t render(uint16_t boot, char* data, size_t size, uint32_t &seq);
+    uint16_t getBoot() const;
+    uint16_t getOldestBoot();
+    uint32_t getDropped() const;
+    uint32_t getWrites() const;
+};
+
+}
+
+#endif // LOGJOURNAL_HPP
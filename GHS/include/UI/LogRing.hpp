@@ -0,0 +1,65 @@
+#ifndef LOGRING_HPP
+#define LOGRING_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Messaging {
+
+#define LOG_SIZE 16384 // bytes of log record storage. 16 KB.
+#define LOGRING_WRAP 0xFFFF // Record length marking the wrap to offset 0.
+#define LOGRING_SEQ_START 1 // First sequence number, 0 reads from oldest.
+#define LOGRING_RENDER_MAX 192 // Max rendered chars of a binary record.
+#define LOGRING_SEQ_END UINT32_MAX // Render without an end bound.
+
+// Record kinds. Text records are stored as rendered, binary records are 
+// stored as encoded by LogCodec and rendered when read.
+enum class LogKind : uint8_t {TEXT, BIN};
+
+// Header preceding each record in the ring. The data follows the header and
+// is not null terminated, its length is len.
+struct LogRecordHdr {
+    uint32_t seq; // Monotonic sequence number of the record.
+    uint16_t len; // Bytes of data following the header.
+    LogKind kind; // Text or binary data.
+} __attribute__((packed));
+
+// Fixed capacity ring of length prefixed log records. Records are stored
+// contiguously, a record that does not fit before the end of the buffer
+// wraps to offset 0, leaving a wrap marker behind. Appends are O(1), and
+// evict whole records from the head, oldest first, until the new record
+// fits. Each record is stamped with a sequence number which never repeats,
+// allowing readers to resume from where they left off.
+// WARNING. This class is not thread safe, and relies on the owner to
+// serialize access.
+class LogRing {
+    private:
+    char buf[LOG_SIZE]; // Record storage.
+    size_t head; // Offset of the oldest record.
+    size_t tail; // Offset the next record will be written to.
+    size_t count; // Records currently stored.
+    uint32_t firstSeq; // Sequence number of the oldest record.
+    uint32_t nextSeq; // Sequence number of the next record appended.
+    size_t normalize(size_t offset) const;
+    void readHdr(size_t offset, LogRecordHdr &hdr) const;
+    void evict();
+    size_t recordText(size_t offset, const LogRecordHdr &hdr, char* scratch,
+        size_t size, const char* &text) const;
+
+    public:
+    LogRing();
+    uint32_t append(const void* data, size_t len, 
+        LogKind kind = LogKind::TEXT);
+
+    size_t render(char* data, size_t size, uint32_t &seq, 
+        uint32_t end = LOGRING_SEQ_END) const;
+
+    size_t renderTail(char* data, size_t size) const;
+    size_t getCount() const;
+    uint32_t getFirstSeq() const;
+    uint32_t getNextSeq() const;
+};
+
+}
+
+#endif // LOGRING_HPP
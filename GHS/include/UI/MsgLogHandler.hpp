@@ -2,21 +2,29 @@
 #define MSGLOGHANDLER_HPP
 
 #include <cstdint>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
 #include "UI/IDisplay.hpp"
 #include "Threads/Mutex.hpp"
+#include "UI/LogRing.hpp"
+#include "UI/LogCodec.hpp"
+#include "UI/LogDedupe.hpp"
+#include "Config/config.hpp"
 
 namespace Messaging {
 
-#define LOG_SIZE 16384 // bytes of log information. 16 KB.
 #define BIGLOG_MAX_ENTRY 512 // bytes for logging large text data.
 #define LOG_MAX_ENTRY 128 // max entry size per log.
 #define LOG_MAX_ENTRY_PAD 40 // Used to add time and loc data to log entry.
-#define LOG_PREV_MSGS 5 // Used in comparison to current message to avoid repeat
 #define MLH_DELIM ';' // delimiter used in log entries
 #define MLH_DELIM_REP ':' // Replaces delimiter with : if contained in msg.
 #define OLED_QUEUE_QTY 5 // Quantity of messages in queue
 #define OLED_MSG_EXPIRATION_SECONDS 2 // Will stop or display next message then
 #define MLH_TAG "(MSGLOGERR)"
+#define MLH_DRAIN_TAG "(MSGLOGDRAIN)"
+#define LOG_QUEUE_DEPTH 32 // Records held for the log task before dropping.
+#define LOG_DRAIN_MAX LOG_QUEUE_DEPTH // Max records drained per drain call.
 
 
 // COLOR CODING escape chars, these can be interjected anywhere.
@@ -73,6 +81,54 @@ enum class Method : uint8_t {
 extern const char LevelsMap[5][11]; // used for verbosity with enum Levels
 extern const char LevelsColors[5][10]; // Used for serial colors
 
+// Subsystems that log, each with a runtime level, below which its entries
+// are discarded before formatting. Set with the SET_LOG_LEVEL socket 
+// command, which passes the index. ATTENTION. Append only.
+#define LOG_TAGS(X) \
+    X(GENERAL) X(NET) X(CREDS) X(HTTP) X(RELAY) X(ALERT) X(TEMPHUM) X(SOIL) \
+    X(LIGHT) X(SETTINGS) X(FWVAL) X(OTA) X(I2C) X(NVS) X(OLED) X(ADC) \
+    X(AS7341) X(SHT) X(THREAD)
+
+#define LOG_TAG_ENUM(name) name,
+enum class LogTag : uint8_t {LOG_TAGS(LOG_TAG_ENUM) COUNT};
+#undef LOG_TAG_ENUM
+
+#define LOG_TAG_QTY static_cast<size_t>(Messaging::LogTag::COUNT)
+extern const char* const LogTagMap[LOG_TAG_QTY]; // Tag names, by index.
+
+// Requires level. Returns true if the level is at or above LOG_MIN_LEVEL.
+// Evaluated at compile time by LOG_IF().
+constexpr bool logCompiled(Levels level) {
+    return static_cast<uint8_t>(level) >= LOG_MIN_LEVEL;
+}
+
+// Requires the tag and a constant level, each fully qualified. Guards the 
+// formatting and logging of an entry, placed before its block, such as
+// LOG_IF(Messaging::LogTag::RELAY, Messaging::Levels::INFO) {snprintf(...);
+// sendErr(...);}. A level below LOG_MIN_LEVEL discards the block at compile
+// time, otherwise it runs only if logOn() for the tag. A level that is not
+// a constant fails to compile. WARNING. Always brace the block, and the if
+// statement enclosing the macro, the macro ends in an if.
+#define LOG_IF(tag, level) \
+    if constexpr (!Messaging::logCompiled(level)) {} else \
+    if (Messaging::MsgLogHandler::get()->logOn(tag, level))
+
+// ATTENTION. Once the log task is running, handle() copies each message into
+// a bounded queue and returns immediately. The log task drains the queue and
+// fans out to serial, the log, OLED, and UDP. If the queue is full, the
+// message is dropped and counted, and the count is logged by the log task.
+// Until the log task is running, and for big log entries that exceed the 
+// record size, handle() processes the message inline on the caller.
+struct LogRecord {
+    Levels level;
+    Method method;
+    bool ignoreRepeat;
+    uint32_t seconds; // System seconds when handle() was called.
+    LogKind kind; // Text message, or binary entry encoded by LogCodec.
+    uint8_t len; // Bytes of a binary entry.
+    char msg[LOG_MAX_ENTRY];
+};
+
 // Total size of the max entry and pad, is below 200 chars which is the limit
 // of the OLED per the datasheet. Set to micros to prevent issues with
 // concurrent messaging.
@@ -90,23 +146,43 @@ class MsgLogHandler {
     Queue OLEDqueue[OLED_QUEUE_QTY]; // queue used to send messages to OLED.
     UI::IDisplay* OLED; // Needs to be added, default to nullptr.
     bool serialOn; // Enables serial printing.
-    char log[LOG_SIZE]; // Main log, very large.
+    LogRing log; // Main log, very large.
+    LogDedupe dedupe; // Repeat entry suppression.
     bool newLogEntry; // New log message available to client.
+    uint32_t summarizedAt; // Seconds of the latest repeat summary sweep.
+    QueueHandle_t queue; // Bounded queue of records for the log task.
+    StaticQueue_t queueBuf; // Static queue control block.
+    uint8_t queueStorage[LOG_QUEUE_DEPTH * sizeof(LogRecord)];
+    std::atomic<uint8_t> tagLevels[LOG_TAG_QTY]; // Runtime min, per tag.
+    std::atomic<bool> async; // Log task is running and draining the queue.
+    std::atomic<uint32_t> dropped; // Records dropped due to a full queue.
+    uint32_t droppedReported; // Dropped count at the last drop log entry.
     static Threads::Mutex mtx; // mutex
+    static Threads::Mutex drainMtx; // Serializes draining, see sync().
     MsgLogHandler(); 
     MsgLogHandler(const MsgLogHandler&) = delete; // prevent copying
     MsgLogHandler &operator=(const MsgLogHandler&) = delete; // prevent assgnmt
     void writeSerial(Levels level, const char* message, uint32_t seconds);
     bool writeOLED(Levels level, const char* message, uint32_t seconds);
     void writeLog(Levels level, const char* message, uint32_t seconds, 
-        bool ignoreRepeat, bool bigLog); 
+        bool ignoreRepeat, bool bigLog, const uint8_t* bin = nullptr,
+        size_t binLen = 0); 
 
-    size_t stripLogMsg(size_t newMsgLen);
-    bool analyzeLogEntry(const char* message, uint32_t seconds);
     bool OLEDcheck();
     bool OLEDQueueSend();
     bool OLEDQueueRemove();
-    void sendUDPLog(Levels level, const char* msg, uint32_t seconds);
+    void sendUDPLog(Levels level, const char* msg, uint32_t seconds,
+        const uint8_t* bin = nullptr, size_t binLen = 0);
+
+    void dispatch(Levels level, const char* message, Method method,
+        uint32_t seconds, bool ignoreRepeat, bool bigLog, 
+        const uint8_t* bin = nullptr, size_t binLen = 0);
+
+    void dispatchBin(const uint8_t* bin, size_t binLen, Method method);
+
+    void reportDrops();
+    void reportRepeats();
+    size_t process(TickType_t wait);
    
     public:
     static MsgLogHandler* get();
@@ -114,9 +190,56 @@ class MsgLogHandler {
     void handle(Levels level, const char* message, Method method, 
         bool ignoreRepeat = false, bool bigLog = false);
 
+    // Requires the tag, then the params of handle(). Logs only if enabled
+    // for the tag, see logOn(). The message is formatted by the caller, 
+    // gate frequent entries with LOG_IF().
+    void handle(LogTag tag, Levels level, const char* message, Method method,
+        bool ignoreRepeat = false, bool bigLog = false) {
+
+        if (!this->logOn(tag, level)) return;
+        this->handle(level, message, method, ignoreRepeat, bigLog);
+    }
+
+    void handleBin(Levels level, Method method, LogFmt fmt, 
+        const LogArgs &args);
+
+    // Requires the tag, level, sending method, format ID from 
+    // LogFormats.hpp, and the arguments of the format. Logs without 
+    // formatting on the caller, recording the format ID and raw arguments,
+    // which are rendered when read. Use on hot paths in place of snprintf()
+    // and handle(). Discarded before packing if not enabled for the tag.
+    template<typename... Args>
+    void handleFmt(LogTag tag, Levels level, Method method, LogFmt fmt, 
+        Args... args) {
+
+        if (!this->logOn(tag, level)) return;
+        LogArgs packed;
+        packed.addAll(args...);
+        this->handleBin(level, method, fmt, packed);
+    }
+
+    // Requires the tag and level. Returns true if an entry of the level is
+    // compiled in, and at or above the runtime level of the tag. Used by
+    // LOG_IF(), which gates the formatting of frequent entries.
+    bool logOn(LogTag tag, Levels level) const {
+        return logCompiled(level) && static_cast<uint8_t>(level) >= 
+            this->tagLevels[static_cast<size_t>(tag)].load(
+                std::memory_order_relaxed);
+    }
+
+    bool setTagLevel(LogTag tag, Levels level);
+    Levels getTagLevel(LogTag tag) const;
+
+    size_t drain(TickType_t wait);
+    void sync();
+    uint32_t getDropped();
     bool newLogAvail();
     void resetNewLogFlag();
-    const char* getLog(char* data = nullptr);
+    size_t getLog(char* data, size_t size, uint32_t &seq, 
+        uint32_t end = LOGRING_SEQ_END);
+
+    bool getLogSeq(uint32_t &first, uint32_t &next);
+    size_t getLogTail(char* data, size_t size);
     bool addOLED(UI::IDisplay &OLED);
 };
 
@@ -3,10 +3,8 @@
 #include "string.h"
 #include "Peripherals/saveSettings.hpp"
 #include "Network/NetSTA.hpp"
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include "Network/NetManager.hpp"
+#include "Network/UDPSender.hpp"
 
 // ATTENTION. Avoid logging any heartbeat suspensions and releases. This is 
 // because it has the potential to be called frequently and we do not want to
@@ -141,25 +139,20 @@ void Heartbeat::pingServer(Comms::STAdetails &details) {
 
     if (!Comms::NetManager::onLAN()) return; // Block if not conn to LAN.
 
-    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP); // Create socket.
-
-    if (sock < 0) return;
+    Comms::UDPStats stats;
+    Comms::UDPSender::get()->getStats(stats);
 
     // Prep JSON message to send UDP server with details about the current
-    // connection status.
-    char msg[128] = {0};
+    // connection status, and the UDP sender counts.
+    char msg[UDP_HB_SIZE] = {0};
     snprintf(msg, sizeof(msg), 
-        "{\"mdns\": \"%s\", \"rssi\": \"%s\", \"mem\": \"%s\"}", 
-        details.mdns, details.signalStrength, details.heap);  
-
-    struct sockaddr_in dest; 
-    dest.sin_family = AF_INET;
-    dest.sin_port = htons(HEARTBEAT_UDP_PORT);
-    dest.sin_addr.s_addr = inet_addr(UDP_URL);
-
-    sendto(sock, msg, strlen(msg), 0, (struct sockaddr *)&dest, sizeof(dest));
+        "{\"mdns\": \"%s\", \"rssi\": \"%s\", \"mem\": \"%s\", "
+        "\"udpSent\": %lu, \"udpDrop\": %lu}", 
+        details.mdns, details.signalStrength, details.heap, 
+        (unsigned long)stats.datagrams, (unsigned long)stats.dropped);  
 
-    close(sock);
+    // Sent by the log task on the next flush.
+    Comms::UDPSender::get()->setHeartbeat(msg);
 }
 
 // Iterates the register array. Checks if the value is equal to 0, if so, it 
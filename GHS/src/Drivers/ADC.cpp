@@ -151,7 +151,8 @@ bool ADC::isConverting() {
 
 // Requires message and messaging level, which is default to ERROR.
 void ADC::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, ADC_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::ADC,
+        lvl, msg, ADC_LOG_METHOD);
 }
 
 ADC::ADC() : tag(ADC_TAG), log(0), initFlag(ADC_TAG), i2c(ADC_I2C_TIMEOUT) {
@@ -217,16 +218,22 @@ void ADC::read(int16_t &readVar, uint8_t pin, bool refreshConf) {
         static_cast<uint8_t>(ADC_INIT::INIT));
 
     if (!isInit) { // Ensures the device has been init before reading.
-        snprintf(this->log, sizeof(this->log), "%s Not init", this->tag);
-        this->sendErr(this->log);
+        LOG_IF(Messaging::LogTag::ADC, Messaging::Levels::ERROR) {
+            snprintf(this->log, sizeof(this->log), "%s Not init", this->tag);
+            this->sendErr(this->log);
+        }
+
         return; // Block
     }
 
     if (pin > 3) {
-        snprintf(this->log, sizeof(this->log), "%s pin must be between 0 - 3", 
-            this->tag);
+        LOG_IF(Messaging::LogTag::ADC, Messaging::Levels::ERROR) {
+            snprintf(this->log, sizeof(this->log), 
+                "%s pin must be between 0 - 3", this->tag);
+
+            this->sendErr(this->log);
+        }
 
-        this->sendErr(this->log);
         return; // Block
     }
 
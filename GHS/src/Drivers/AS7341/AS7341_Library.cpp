@@ -152,8 +152,8 @@ void AS7341basic::setup_F5F8_Clear_NIR() {
 void AS7341basic::sendErr(const char* msg, Messaging::Levels lvl, 
     bool ignoreRepeat) {
 
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, AS7341_LOG_METH, 
-        ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::AS7341,
+        lvl, msg, AS7341_LOG_METH, ignoreRepeat);
 }
 
 AS7341basic::AS7341basic(CONFIG &conf) : tag(AS7341_TAG), i2c(AS7341_TIMEOUT),
@@ -265,8 +265,10 @@ uint16_t AS7341basic::readChannel(CHANNEL chnl, bool &dataSafe, bool delayEn) {
     } else { // Not ready, timed out.
 
         dataSafe = false;
-        snprintf(this->log, sizeof(this->log), "%s Timed out", this->tag);
-        this->sendErr(this->log);
+        LOG_IF(Messaging::LogTag::AS7341, Messaging::Levels::ERROR) {
+            snprintf(this->log, sizeof(this->log), "%s Timed out", this->tag);
+            this->sendErr(this->log);
+        }
 
         return 0;
     }
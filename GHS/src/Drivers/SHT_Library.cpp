@@ -155,8 +155,8 @@ SHT_RET SHT::computeTemps(SHT_VALS &carrier) {
 // Requires message, message level, and if repeating log analysis should be 
 // ignored. Messaging default to ERROR, ignoreRepeat default to false.
 void SHT::sendErr(const char* msg, Messaging::Levels lvl, bool ignoreRepeat) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, SHT_LOG_METHOD, 
-        ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::SHT,
+        lvl, msg, SHT_LOG_METHOD, ignoreRepeat);
 }
 
 SHT::SHT() : tag(SHT_TAG), i2c(SHT_READ_TIMEOUT), initFlag(SHT_TAG) {
@@ -228,8 +228,13 @@ SHT_RET SHT::readAll(START_CMD cmd, SHT_VALS &carrier) {
     if (this->packet.readBuffer[2] != crcTemp || 
         this->packet.readBuffer[5] != crcHum) {
 
-        snprintf(this->log, sizeof(this->log), "%s checksum Err", this->tag);
-        this->sendErr(this->log);
+        LOG_IF(Messaging::LogTag::SHT, Messaging::Levels::ERROR) {
+            snprintf(this->log, sizeof(this->log), "%s checksum Err", 
+                this->tag);
+
+            this->sendErr(this->log);
+        }
+
         return SHT_RET::READ_FAIL_CHECKSUM;
     }
 
@@ -271,8 +271,8 @@ val_ret_t FWVal::verifySig(const uint8_t* firmwareHash,
 // Requires message, message level, and if repeating log analysis should be 
 // ignored. Messaging default to WARNING, ignoreRepeat default to false.
 void FWVal::sendErr(const char* msg, Messaging::Levels lvl, bool ignoreRepeat) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, FW_LOG_METHOD, 
-        ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::FWVAL,
+        lvl, msg, FW_LOG_METHOD, ignoreRepeat);
 }
 
 FWVal* FWVal::get() {
@@ -58,8 +58,8 @@ I2C::I2C() : tag(I2C_TAG), masterInit(false), devNum(0),
 // Requires message, message level, and if repeating log analysis should be 
 // ignored. Messaging default to CRITICAL, ignoreRepeat default to false.
 void I2C::sendErr(const char* msg, Messaging::Levels lvl, bool ignoreRepeat) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, I2C_LOG_METHOD, 
-        ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::I2C,
+        lvl, msg, I2C_LOG_METHOD, ignoreRepeat);
 }
 
 // Requires no params. Removes master bus and returns true or false depending
@@ -189,11 +189,10 @@ void I2C::checkHang(I2CPacket &pkt) {
 
     if (SCL_Low || SDA_Low) { // If low, log problem.
 
-        snprintf(this->log, sizeof(this->log),
-            "%s bus hang Δ=%.2fms (SCL=%d SDA=%d) -> recovering",
-            this->tag, pkt.delta_ms, SCL_Low, SDA_Low);
-
-        this->sendErr(this->log, Messaging::Levels::WARNING);
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::I2C, Messaging::Levels::WARNING, I2C_LOG_METHOD,
+            Messaging::LogFmt::I2C_BUS_HANG, this->tag, pkt.delta_ms, SCL_Low,
+            SDA_Low);
     }
 }
 
@@ -311,22 +310,20 @@ bool I2C::monitor(I2CPacket &pkt) {
     // bus. 
     if ((pkt.errScore > HEALTH_ERR_BAD) && (pkt.arrayIdx < I2C_MAX_DEV)) { 
 
-        snprintf(this->log, sizeof(this->log), 
-            "%s device @ addr %#x unresponsive @ %0.2f / %0.2f", this->tag,
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::I2C, Messaging::Levels::CRITICAL, I2C_LOG_METHOD,
+            Messaging::LogFmt::I2C_DEV_UNRESP, this->tag,
             pkt.config.device_address, pkt.errScore, HEALTH_ERR_BAD);
 
-        this->sendErr(this->log);
-
         this->hardResetBus(pkt); // Attempt bus reset. Temp Block
         return false;
 
     } else if (pkt.errScore >= HEALTH_ERR_BAD / 2.0f) { // BECMG unresponsive
 
-        snprintf(this->log, sizeof(this->log), 
-            "%s device @ addr %#x failing @ %0.2f / %0.2f", this->tag,
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::I2C, Messaging::Levels::WARNING, I2C_LOG_METHOD,
+            Messaging::LogFmt::I2C_DEV_FAILING, this->tag,
             pkt.config.device_address, pkt.errScore, HEALTH_ERR_BAD);
-
-        this->sendErr(this->log, Messaging::Levels::WARNING);
     } 
 
     return true; // Indicates that device is within params.
@@ -548,11 +545,14 @@ bool I2C::TX(I2CPacket &pkt, const uint8_t* writeBuf, size_t bufSize) {
             pkt.errScore += HEALTH_ERR_UNIT; // Accumulate if error.
             if (pkt.errScore > HEALTH_ERR_MAX) pkt.errScore = HEALTH_ERR_MAX;
 
-            snprintf(this->log, sizeof(this->log), "%s tx err @ addr %#x: %s", 
-                this->tag, pkt.config.device_address, 
-                esp_err_to_name(pkt.response));
+            LOG_IF(Messaging::LogTag::I2C, Messaging::Levels::CRITICAL) {
+                snprintf(this->log, sizeof(this->log), 
+                    "%s tx err @ addr %#x: %s", 
+                    this->tag, pkt.config.device_address, 
+                    esp_err_to_name(pkt.response));
 
-            this->sendErr(this->log);
+                this->sendErr(this->log);
+            }
 
             this->monitor(pkt);
             
@@ -592,11 +592,14 @@ bool I2C::RX(I2CPacket &pkt, uint8_t* readBuf, size_t bufSize) {
             pkt.errScore += HEALTH_ERR_UNIT; // Accumulate if error
             if (pkt.errScore > HEALTH_ERR_MAX) pkt.errScore = HEALTH_ERR_MAX;
 
-            snprintf(this->log, sizeof(this->log), "%s rx err @ addr %#x: %s", 
-                this->tag, pkt.config.device_address,
-                esp_err_to_name(pkt.response));
+            LOG_IF(Messaging::LogTag::I2C, Messaging::Levels::CRITICAL) {
+                snprintf(this->log, sizeof(this->log), 
+                    "%s rx err @ addr %#x: %s", 
+                    this->tag, pkt.config.device_address,
+                    esp_err_to_name(pkt.response));
 
-            this->sendErr(this->log);
+                this->sendErr(this->log);
+            }
 
             this->monitor(pkt);
             
@@ -638,11 +641,14 @@ bool I2C::TXRX(I2CPacket &pkt, const uint8_t* writeBuf, size_t writeBufSize,
             pkt.errScore += HEALTH_ERR_UNIT; // Accumulate if error
             if (pkt.errScore > HEALTH_ERR_MAX) pkt.errScore = HEALTH_ERR_MAX;
 
-            snprintf(this->log, sizeof(this->log), "%s txrx err @ addr %#x: %s", 
-                this->tag, pkt.config.device_address,
-                esp_err_to_name(pkt.response));
+            LOG_IF(Messaging::LogTag::I2C, Messaging::Levels::CRITICAL) {
+                snprintf(this->log, sizeof(this->log), 
+                    "%s txrx err @ addr %#x: %s", 
+                    this->tag, pkt.config.device_address,
+                    esp_err_to_name(pkt.response));
 
-            this->sendErr(this->log);
+                this->sendErr(this->log);
+            }
 
             this->monitor(pkt);
      
@@ -6,6 +6,8 @@
 #include "Network/webPages.hpp"
 #include "Config/config.hpp"
 #include "UI/MsgLogHandler.hpp"
+#include "UI/LogJournal.hpp"
+#include <cstdlib>
 
 namespace Comms {
 
@@ -16,11 +18,108 @@ esp_err_t STAIndexHandler(httpd_req_t* req) {
     return ESP_OK;
 }
 
-// Serves the log entry.
+// Requires request and the query key. Returns the value of the query 
+// key=<val>, such as since=<seq>, or 0 if not passed.
+static uint32_t logQuery(httpd_req_t* req, const char* key) {
+    char query[LOG_QUERY_SIZE]{0};
+    char val[LOG_SEQ_HDR_SIZE]{0};
+
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK) {
+        return 0;
+    }
+
+    if (httpd_query_key_value(query, key, val, sizeof(val)) != ESP_OK) {
+        return 0;
+    }
+
+    return strtoul(val, nullptr, 10);
+}
+
+// Requires request, the boot number, and the sequence number to serve 
+// after. Serves the entries of a previous boot from the flash journal, in
+// chunks as the log ring is served. Returns ESP_OK if sent, or ESP_FAIL.
+static esp_err_t logJournal(httpd_req_t* req, uint16_t boot, uint32_t since) {
+    char chunk[LOG_CHUNK_SIZE];
+    uint32_t seq = since + 1;
+
+    while (true) {
+        size_t len = Messaging::LogJournal::get()->render(boot, chunk, 
+            sizeof(chunk), seq);
+
+        if (len == 0) break; // Complete.
+
+        if (httpd_resp_send_chunk(req, chunk, len) != ESP_OK) {
+            return ESP_FAIL; // Client gone, abort the response.
+        }
+    }
+
+    return httpd_resp_send_chunk(req, nullptr, 0); // Terminates response.
+}
+
+// Serves the log entries. Clients pass /getLog?since=<seq>, seq being the 
+// X-Log-Head of their previous request, to receive only newer entries, or 
+// no query to receive the full log. Headers X-Log-First and X-Log-Head are
+// the oldest entry held and the newest entry served. If X-Log-First exceeds 
+// since + 1, entries were overwritten before retrieval. If since exceeds the
+// head, the device restarted and the full log is served. The log is rendered
+// in chunks from the log ring, resuming by sequence number, so that the log 
+// mutex is only held while each chunk is rendered and never while sending.
+// Headers X-Log-Boot and X-Log-Oldest-Boot are the current boot number and
+// the oldest held by the flash journal. Clients pass /getLog?boot=<n> to
+// receive the journaled entries of a previous boot, optionally with since,
+// the sequence number of the last entry received from that boot.
 esp_err_t STALogHandler(httpd_req_t* req) {
     httpd_resp_set_type(req, MHAND_RESP_TYPE_TEXTHTML);
-    httpd_resp_sendstr(req, Messaging::MsgLogHandler::get()->getLog());
-    return ESP_OK;
+
+    Messaging::LogJournal* journal = Messaging::LogJournal::get();
+    uint16_t boot = journal->getBoot();
+    char bootHdr[LOG_SEQ_HDR_SIZE]{0};
+    char oldestHdr[LOG_SEQ_HDR_SIZE]{0};
+    snprintf(bootHdr, sizeof(bootHdr), "%u", boot);
+    snprintf(oldestHdr, sizeof(oldestHdr), "%u", journal->getOldestBoot());
+    httpd_resp_set_hdr(req, "X-Log-Boot", bootHdr);
+    httpd_resp_set_hdr(req, "X-Log-Oldest-Boot", oldestHdr);
+
+    uint32_t reqBoot = logQuery(req, "boot");
+    if (reqBoot != 0 && reqBoot != boot) { // Previous boot, from flash.
+        return logJournal(req, static_cast<uint16_t>(reqBoot), 
+            logQuery(req, "since"));
+    }
+
+    uint32_t first{0}, next{0};
+    if (!Messaging::MsgLogHandler::get()->getLogSeq(first, next)) {
+        return httpd_resp_sendstr(req, ""); // Mutex locked, no entries.
+    }
+
+    uint32_t since = logQuery(req, "since");
+    if (since >= next) since = 0; // Sequence restarted, serve all.
+
+    // Headers must remain valid until sent with the first chunk.
+    char firstHdr[LOG_SEQ_HDR_SIZE]{0};
+    char headHdr[LOG_SEQ_HDR_SIZE]{0};
+    snprintf(firstHdr, sizeof(firstHdr), "%lu", (unsigned long)first);
+    snprintf(headHdr, sizeof(headHdr), "%lu", (unsigned long)(next - 1));
+    httpd_resp_set_hdr(req, "X-Log-First", firstHdr);
+    httpd_resp_set_hdr(req, "X-Log-Head", headHdr);
+
+    char chunk[LOG_CHUNK_SIZE];
+    uint32_t seq = since + 1; // Begin after the client cursor.
+
+    while (true) {
+
+        // Bounded by next, so that entries logged while sending are left 
+        // for the following request rather than served twice.
+        size_t len = Messaging::MsgLogHandler::get()->getLog(chunk, 
+            sizeof(chunk), seq, next);
+
+        if (len == 0) break; // Complete.
+
+        if (httpd_resp_send_chunk(req, chunk, len) != ESP_OK) {
+            return ESP_FAIL; // Client gone, abort the response.
+        }
+    }
+
+    return httpd_resp_send_chunk(req, nullptr, 0); // Terminates response.
 }
 
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "Network/Handlers/socketJson.hpp"
+
+namespace Comms {
+
+// Requires the position within the frame, and reference to the value. Parses
+// the integer, followed by a '/' or the end of the frame. Returns the position
+// following the '/', or nullptr if malformed.
+static const char* nextInt(const char* pos, int &val) {
+    char* end = nullptr;
+    long parsed = strtol(pos, &end, 10);
+
+    if (end == pos || (*end != '/' && *end != '\0')) return nullptr;
+
+    val = static_cast<int>(parsed);
+    return (*end == '/') ? end + 1 : end;
+}
+
+// Requires the command. Returns true if the command may be sent within a
+// BATCH, false if not. Excludes replies exceeding SKT_REPLY_SIZE, commands
+// without a reply, and BATCH itself. GET_LOAD is included, its reply is
+// fixed in form and at most 112 bytes, see compileLoad().
+bool SOCKHAND::batchable(CMDS cmd) {
+    switch (cmd) {
+        case CMDS::CALIBRATE_TIME: case CMDS::NEW_LOG_RCVD:
+        case CMDS::RELAY_CTRL: case CMDS::RELAY_TIMER:
+        case CMDS::RELAY_TIMER_DAY: case CMDS::ATTACH_RELAYS:
+        case CMDS::SET_TEMPHUM: case CMDS::SET_SOIL: case CMDS::SET_LIGHT:
+        case CMDS::SET_SPEC_INTEGRATION_TIME: case CMDS::SET_SPEC_GAIN:
+        case CMDS::CLEAR_AVERAGES: case CMDS::CLEAR_AVG_SET_TIME:
+        case CMDS::SET_LOG_LEVEL: case CMDS::SUBSCRIBE: case CMDS::GET_LOAD:
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+// Requires the BATCH command data, the buffer holding the received frame,
+// buffer size, handle and file descriptor of the socket, and reference to
+// fragmented. Parses the supp quantity of commands following the header,
+// cmd/supp/id/ each, and executes them in order, each as if sent alone.
+// Writes {"id":id,"batch":[reply,...]} over the frame, sent as fragments if
+// exceeding the buffer, see JsonStream. Returns the reply length as
+// snprintf, or -1 if the frame is malformed, nothing is executed.
+int SOCKHAND::compileBatch(cmdData &data, char* buffer, size_t size,
+    httpd_handle_t hd, int fd, bool &fragmented) {
+
+    fragmented = false;
+    int qty = data.suppData;
+    if (!SOCKHAND::inRange(1, SKT_BATCH_MAX, qty)) return -1;
+
+    cmdData cmds[SKT_BATCH_MAX];
+    const char* pos = buffer;
+    int cmd{0}, supp{0}, id{0};
+
+    // Skips the header, parsed by trigger_async_send.
+    for (int i = 0; i < 3 && pos != nullptr; i++) pos = nextInt(pos, cmd);
+
+    // Parsed completely before executing, the frame is overwritten by the
+    // reply.
+    for (int i = 0; i < qty; i++) {
+        if (pos != nullptr) pos = nextInt(pos, cmd);
+        if (pos != nullptr) pos = nextInt(pos, supp);
+        if (pos != nullptr) pos = nextInt(pos, id);
+        if (pos == nullptr) return -1;
+
+        cmds[i].cmd = static_cast<CMDS>(cmd);
+        cmds[i].suppData = supp;
+        cmds[i].idNum = id;
+    }
+
+    char entry[SKT_REPLY_SIZE]; // Reply of each command.
+
+    JsonStream js(buffer, size, hd, fd);
+    js.open('{');
+    js.key("id"); js.num((uint32_t)data.idNum);
+    js.key("batch");
+    js.open('[');
+
+    for (int i = 0; i < qty; i++) {
+        memset(entry, 0, sizeof(entry));
+        size_t len = 0;
+
+        if (SOCKHAND::batchable(cmds[i].cmd)) {
+            len = SOCKHAND::compileData(cmds[i], entry, sizeof(entry), hd, fd);
+        }
+
+        if (len == 0) {
+            snprintf(entry, sizeof(entry), "{\"status\":0,\"msg\":\"%s\","
+                "\"supp\":0,\"id\":%u}", "Not batchable", cmds[i].idNum);
+        }
+
+        js.json(entry);
+    }
+
+    js.close(']');
+    js.close('}');
+
+    return js.finish(fragmented);
+}
+
+}
@@ -0,0 +1,62 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "Common/Timing.hpp"
+#include "Threads/Mutex.hpp"
+
+namespace Comms {
+
+// Static Setup
+allCache SOCKHAND::cache{};
+std::atomic<uint32_t> SOCKHAND::allGen{0};
+Threads::Mutex SOCKHAND::cacheMtx(CACHE_TAG);
+
+// Requires the reply id, buffer, and buffer size. Writes the GET_ALL JSON to
+// the buffer, from the snapshot of the current epoch, rendering it first if
+// the epoch has ended. Shared by GET_ALL, GET_DELTA, and subscriber pushes.
+// Returns the length of the reply, or the length required if it exceeds the
+// buffer, as snprintf().
+int SOCKHAND::compileAll(uint16_t idNum, char* buffer, size_t size) {
+    Clock::TIME dtg;
+    Clock::DateTime::get()->getTime(&dtg);
+
+    uint32_t update = SOCKHAND::updates.load();
+    uint32_t gen = SOCKHAND::allGen.load();
+
+    Threads::MutexLock guard(SOCKHAND::cacheMtx);
+    if (!guard.LOCK()) return SOCKHAND::renderAll(idNum, buffer, size);
+
+    allCache &c = SOCKHAND::cache;
+    bool expired = (c.len <= 0 || c.update != update || c.gen != gen ||
+        c.sec != dtg.raw);
+
+    if (expired) {
+        c.len = SOCKHAND::renderAll(0, c.json, sizeof(c.json));
+        const char* id = strstr(c.json, "\"id\":0");
+
+        if (c.len <= 0 || c.len >= (int)sizeof(c.json) || id == nullptr) {
+            c.len = 0; // Not cached, retries on the next request.
+            return SOCKHAND::renderAll(idNum, buffer, size);
+        }
+
+        c.idPos = (id - c.json) + 5; // Position of the 0.
+        c.update = update;
+        c.gen = gen;
+        c.sec = dtg.raw;
+    }
+
+    // Patch the id into the snapshot, replacing the 0.
+    char idStr[8]{0};
+    int idLen = snprintf(idStr, sizeof(idStr), "%u", idNum);
+    size_t tail = c.len - c.idPos - 1;
+    int total = c.idPos + idLen + tail;
+
+    if (total >= (int)size) return total; // Truncated, as snprintf.
+
+    memcpy(buffer, c.json, c.idPos);
+    memcpy(buffer + c.idPos, idStr, idLen);
+    memcpy(buffer + c.idPos + idLen, c.json + c.idPos + 1, tail);
+    buffer[total] = '\0';
+    return total;
+}
+
+}
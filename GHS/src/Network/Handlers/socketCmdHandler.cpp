@@ -14,6 +14,7 @@
 #include "UI/MsgLogHandler.hpp" 
 #include "Peripherals/saveSettings.hpp" 
 #include "Network/Handlers/MasterHandler.hpp"
+#include "Network/Handlers/socketJson.hpp"
 
 // NOTE. Some of these functionalities are for station mode only. These commands
 // have a built in check to ensure requirements are met.
@@ -28,12 +29,181 @@
 
 namespace Comms {
 
-// Requires command data, buffer, and buffer size. Executes the command passed,
-// and compiles response into json and replies. Temperature will be passed as
-// an int which is a float * 100 (10.2 is 1020).
-void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
+// Requires the snapshot. Gets all sensor and some system data of the GET_ALL
+// reply, in any format. Most of these functions are protected by mtx, and 
+// when there are several back to back calls, it introduces complexity. Get 
+// values outside of formatting.
+void SOCKHAND::gatherAll(allSnap &snap) {
+    snap.newLog = Messaging::MsgLogHandler::get()->newLogAvail();
+    snap.net = static_cast<uint8_t>(NetMain::getNetType());
+
+    // Date and time.
+    Clock::DateTime* dt = Clock::DateTime::get();
+    dt->getTime(&snap.dtg);
+    dt->isCalibrated(&snap.isCal);
+
+    // Relays. Pass by ptr to ensure mtx protection. No mtx required for 
+    // isManual(); Direct set.
+    for (size_t i = 0; i < TOTAL_RELAYS; i++) {
+        SOCKHAND::Relays[i].getState(&snap.reState[i]);
+        SOCKHAND::Relays[i].getTimer(&snap.reTimer[i]);
+        SOCKHAND::Relays[i].getQty(&snap.reQty[i]);
+        snap.reMan[i] = SOCKHAND::Relays[i].isManual();
+    }
+
+    // Temperature and humidity
+    Peripheral::TempHum* th = Peripheral::TempHum::get();
+    th->getTemp('C', &snap.temp);
+    th->getHum(&snap.hum);
+    th->getTempConf(&snap.tempConf);
+    th->getHumConf(&snap.humConf);
+    th->getHealth(&snap.thHlth);
+    th->getReadOK(&snap.thRdOK);
+    th->getAverages(&snap.thAvg);
+
+    // Soil. ATTENTION. Ensure for ALL readings/conf you include each sensor 
+    // in arr size.
+    Peripheral::Soil* soil = Peripheral::Soil::get();
+    soil->getAllReadings(snap.soReadings);
+    soil->getAllConfig(snap.soConf);
+
+    // Light. 
+    Peripheral::Light* light = Peripheral::Light::get();
+    light->getSpectrum(&snap.spec);
+    light->getAverages(&snap.ltAv); 
+    light->getHealth(&snap.ltH);
+    light->getPhoto(&snap.photoVal);
+    light->getConf(&snap.ltConf);
+    light->getSpecConf(&snap.specConf);
+    light->getDuration(&snap.ltDur);
+}
+
+// Requires the reply id, buffer, and buffer size. Writes the GET_ALL JSON to
+// the buffer. Returns the snprintf() result. Renders the snapshot of 
+// compileAll(), use that instead.
+int SOCKHAND::renderAll(uint16_t idNum, char* buffer, size_t size) {
+    allSnap snap;
+    SOCKHAND::gatherAll(snap);
+
+    // Primary JSON response object. Populates every setting and value that
+    // is critical to the operation of this device, and returns it to the
+    // client. Ensure client uses same JSON and same commands.
+
+    return snprintf(buffer, size,  
+    "{\"firmv\":\"%s\",\"id\":%u,\"newLog\":%d,\"netMode\":%u,"
+    "\"sysTime\":%lu,\"hhmmss\":\"%d:%d:%d\",\"day\":%u,\"timeCalib\":%d,"
+    "\"re0\":%d,\"re0TimerEn\":%d,\"re0TimerOn\":%zu,\"re0TimerOff\":%zu,"
+    "\"re1\":%d,\"re1TimerEn\":%d,\"re1TimerOn\":%zu,\"re1TimerOff\":%zu,"
+    "\"re2\":%d,\"re2TimerEn\":%d,\"re2TimerOn\":%zu,\"re2TimerOff\":%zu,"
+    "\"re3\":%d,\"re3TimerEn\":%d,\"re3TimerOn\":%zu,\"re3TimerOff\":%zu,"
+    "\"re0Days\":%u,\"re1Days\":%u,\"re2Days\":%u,\"re3Days\":%u,"
+    "\"re0Qty\":%u,\"re1Qty\":%u,\"re2Qty\":%u,\"re3Qty\":%u,"
+    "\"re0Man\":%u,\"re1Man\":%u,\"re2Man\":%u,\"re3Man\":%u,"
+    "\"temp\":%.2f,\"tempRe\":%d,\"tempReCond\":%u,\"tempReVal\":%d,"
+    "\"tempAltCond\":%u,\"tempAltVal\":%d,"
+    "\"hum\":%.2f,\"humRe\":%d,\"humReCond\":%u,\"humReVal\":%d,"
+    "\"humAltCond\":%u,\"humAltVal\":%d,"
+    "\"SHTH\":%.2f,\"SHTRdOK\":%d,\"tempAvg\":%0.1f,\"humAvg\":%0.1f,"
+    "\"tempAvgPrev\":%0.1f,\"humAvgPrev\":%0.1f,"
+    "\"soil0\":%d,\"soil0AltCond\":%u,\"soil0AltVal\":%d,\"soil0H\":%0.2f,"
+    "\"soil1\":%d,\"soil1AltCond\":%u,\"soil1AltVal\":%d,\"soil1H\":%0.2f,"
+    "\"soil2\":%d,\"soil2AltCond\":%u,\"soil2AltVal\":%d,\"soil2H\":%0.2f,"
+    "\"soil3\":%d,\"soil3AltCond\":%u,\"soil3AltVal\":%d,\"soil3H\":%0.2f,"
+    "\"soil0RdOK\":%d,\"soil1RdOK\":%d,\"soil2RdOK\":%d,\"soil3RdOK\":%d,"
+    "\"violet\":%u,\"indigo\":%u,\"blue\":%u,\"cyan\":%u,\"green\":%u,"
+    "\"yellow\":%u,\"orange\":%u,\"red\":%u,\"nir\":%u,\"clear\":%u,"
+    "\"photo\":%d,"
+    "\"violetAvg\":%0.1f,\"indigoAvg\":%0.1f,\"blueAvg\":%0.1f,"
+    "\"cyanAvg\":%0.1f,\"greenAvg\":%0.1f,\"yellowAvg\":%0.1f,"
+    "\"orangeAvg\":%0.1f,\"redAvg\":%0.1f,\"nirAvg\":%0.1f,"
+    "\"clearAvg\":%0.1f,\"photoAvg\":%0.1f,"
+    "\"violetAvgPrev\":%0.1f,\"indigoAvgPrev\":%0.1f,\"blueAvgPrev\":%0.1f,"
+    "\"cyanAvgPrev\":%0.1f,\"greenAvgPrev\":%0.1f,\"yellowAvgPrev\":%0.1f,"
+    "\"orangeAvgPrev\":%0.1f,\"redAvgPrev\":%0.1f,\"nirAvgPrev\":%0.1f,"
+    "\"clearAvgPrev\":%0.1f,\"photoAvgPrev\":%0.1f,"
+    "\"photoRdOK\":%d,\"specRdOK\":%d,\"photoH\":%0.2f,\"specH\":%0.2f,"
+    "\"lightRe\":%d,\"lightReCond\":%u,\"lightReVal\":%u,"
+    "\"lightDur\":%lu,\"darkVal\":%u,"
+    "\"atime\":%u,\"astep\":%u,\"again\":%u}",
+
+    FIRMWARE_VERSION, idNum, snap.newLog, snap.net, snap.dtg.raw, snap.dtg.hour,
+    snap.dtg.minute, snap.dtg.second, snap.dtg.day, snap.isCal,
+
+    static_cast<uint8_t>(snap.reState[0]), snap.reTimer[0].isReady,
+    (size_t)snap.reTimer[0].onTime, (size_t)snap.reTimer[0].offTime,
+    static_cast<uint8_t>(snap.reState[1]), snap.reTimer[1].isReady,
+    (size_t)snap.reTimer[1].onTime, (size_t)snap.reTimer[1].offTime,
+    static_cast<uint8_t>(snap.reState[2]), snap.reTimer[2].isReady,
+    (size_t)snap.reTimer[2].onTime, (size_t)snap.reTimer[2].offTime,
+    static_cast<uint8_t>(snap.reState[3]), snap.reTimer[3].isReady,
+    (size_t)snap.reTimer[3].onTime, (size_t)snap.reTimer[3].offTime,
+    snap.reTimer[0].days, snap.reTimer[1].days, snap.reTimer[2].days,
+    snap.reTimer[3].days, snap.reQty[0], snap.reQty[1], snap.reQty[2],
+    snap.reQty[3], snap.reMan[0], snap.reMan[1], snap.reMan[2], snap.reMan[3],
+
+    snap.temp, snap.tempConf.relay.num,
+    static_cast<uint8_t>(snap.tempConf.relay.condition),
+    snap.tempConf.relay.tripVal,
+    static_cast<uint8_t>(snap.tempConf.alt.condition),
+    snap.tempConf.alt.tripVal, snap.hum, snap.humConf.relay.num,
+    static_cast<uint8_t>(snap.humConf.relay.condition),
+    snap.humConf.relay.tripVal,
+    static_cast<uint8_t>(snap.humConf.alt.condition), snap.humConf.alt.tripVal,
+    snap.thHlth, snap.thRdOK, snap.thAvg.temp, snap.thAvg.hum,
+    snap.thAvg.prevTemp, snap.thAvg.prevHum,
+
+    snap.soReadings[0].val, static_cast<uint8_t>(snap.soConf[0].condition),
+    snap.soConf[0].tripVal, snap.soReadings[0].sensHealth,
+    snap.soReadings[1].val, static_cast<uint8_t>(snap.soConf[1].condition),
+    snap.soConf[1].tripVal, snap.soReadings[1].sensHealth,
+    snap.soReadings[2].val, static_cast<uint8_t>(snap.soConf[2].condition),
+    snap.soConf[2].tripVal, snap.soReadings[2].sensHealth,
+    snap.soReadings[3].val, static_cast<uint8_t>(snap.soConf[3].condition),
+    snap.soConf[3].tripVal, snap.soReadings[3].sensHealth,
+
+    // Negate the soil readings, to show read OK if set to false.
+    !snap.soReadings[0].readErr, !snap.soReadings[1].readErr,
+    !snap.soReadings[2].readErr, !snap.soReadings[3].readErr,
+
+    snap.spec.F1_415nm_Violet, snap.spec.F2_445nm_Indigo,
+    snap.spec.F3_480nm_Blue, snap.spec.F4_515nm_Cyan, snap.spec.F5_555nm_Green,
+    snap.spec.F6_590nm_Yellow, snap.spec.F7_630nm_Orange,
+    snap.spec.F8_680nm_Red, snap.spec.NIR, snap.spec.Clear,
+
+    snap.photoVal, snap.ltAv.color.violet, snap.ltAv.color.indigo,
+    snap.ltAv.color.blue, snap.ltAv.color.cyan, snap.ltAv.color.green,
+    snap.ltAv.color.yellow, snap.ltAv.color.orange, snap.ltAv.color.red,
+    snap.ltAv.color.nir, snap.ltAv.color.clear, snap.ltAv.photoResistor,
+    snap.ltAv.prevColor.violet, snap.ltAv.prevColor.indigo,
+    snap.ltAv.prevColor.blue, snap.ltAv.prevColor.cyan,
+    snap.ltAv.prevColor.green, snap.ltAv.prevColor.yellow,
+    snap.ltAv.prevColor.orange, snap.ltAv.prevColor.red,
+    snap.ltAv.prevColor.nir, snap.ltAv.prevColor.clear,
+    snap.ltAv.prevPhotoResistor,
+
+    // negate the read errors to show OK if set to false.
+    !snap.ltH.photoReadErr, !snap.ltH.specReadErr,
+
+    snap.ltH.photo, snap.ltH.spec, snap.ltConf.num,
+    static_cast<uint8_t>(snap.ltConf.condition), snap.ltConf.tripVal,
+    snap.ltDur, snap.ltConf.darkVal, snap.specConf.ATIME, snap.specConf.ASTEP,
+    static_cast<uint8_t>(snap.specConf.AGAIN)
+    );
+}
+
+// Requires command data, buffer, and buffer size. Optional socket handle and
+// file descriptor, and the frame type, set to HTTPD_WS_TYPE_BINARY if the
+// reply is binary, or HTTPD_WS_TYPE_CONTINUE if the reply was partly sent as
+// fragments and the buffer holds the final fragment. Executes the command 
+// passed, and compiles response into json and replies. Temperature will be 
+// passed as an int which is a float * 100 (10.2 is 1020). Returns the reply
+// length.
+size_t SOCKHAND::compileData(cmdData &data, char* buffer, size_t size,
+    httpd_handle_t hd, int fd, httpd_ws_type_t* type) {
     int written{-1}; // Ensures the snprintf is working by checking write size.
     bool writeLog = true; // Set to false by functions not meant to log.
+    bool isBin = false; // Set true by binary replies.
+    bool isFrag = false; // Set true by replies sent partly as fragments.
 
     // reply is the typical reply to a request, with the exception of the
     // GET_ALL request. Used throughout the function.
@@ -45,211 +215,16 @@ void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
 
         // Gets all sensor and some system data and sends JSON back to client.
         // This is the reason the buffer is large, due to the large amount
-        // of data required to pass to the client.
-        case CMDS::GET_ALL: {
-        
+        // of data required to pass to the client. Supp SKT_FMT_BIN replies
+        // with the binary WireAll.
+        case CMDS::GET_ALL: 
         writeLog = false; // Commonly used command, do not want to log.
+        isBin = (data.suppData & SKT_FMT_BIN) != 0;
 
-        // Commonly used pointers in the scope of GET_ALL. Declared them here
-        // to avoid using verbose commands, as well as ease the mutex 
-        // calls. Most of these functions are protected by mtx, and when there
-        // are several back to back calls, it introduces complexity. Get values
-        // outside of function.
-        bool newLog = Messaging::MsgLogHandler::get()->newLogAvail();
-        uint8_t net = static_cast<uint8_t>(NetMain::getNetType());
-
-        // Date and time.
-        Clock::TIME dtg; bool isCal;
-
-        Clock::DateTime* dt = Clock::DateTime::get();
-        dt->getTime(&dtg);
-        dt->isCalibrated(&isCal);
-
-        // Relays. Pass by ptr to ensure mtx protection.
-        Peripheral::RESTATE re0st, re1st, re2st, re3st;
-        SOCKHAND::Relays[0].getState(&re0st);
-        SOCKHAND::Relays[1].getState(&re1st);
-        SOCKHAND::Relays[2].getState(&re2st);
-        SOCKHAND::Relays[3].getState(&re3st);
-
-        Peripheral::Timer re0Timer, re1Timer, re2Timer, re3Timer;
-
-        SOCKHAND::Relays[0].getTimer(&re0Timer);
-        SOCKHAND::Relays[1].getTimer(&re1Timer);
-        SOCKHAND::Relays[2].getTimer(&re2Timer);
-        SOCKHAND::Relays[3].getTimer(&re3Timer);
-
-        uint8_t re0Qty, re1Qty, re2Qty, re3Qty;
-
-        SOCKHAND::Relays[0].getQty(&re0Qty);
-        SOCKHAND::Relays[1].getQty(&re1Qty);
-        SOCKHAND::Relays[2].getQty(&re2Qty);
-        SOCKHAND::Relays[3].getQty(&re3Qty);
-
-        // No mtx required for isManual(); Direct set.
-        bool re0man = SOCKHAND::Relays[0].isManual();
-        bool re1man = SOCKHAND::Relays[1].isManual();
-        bool re2man = SOCKHAND::Relays[2].isManual();
-        bool re3man = SOCKHAND::Relays[3].isManual();
-
-        // Temperature and humidity
-        float temp, hum;
-        
-        Peripheral::TempHum* th = Peripheral::TempHum::get();
-        th->getTemp('C', &temp);
-        th->getHum(&hum);
-
-        Peripheral::TH_TRIP_CONFIG tempConf, humConf;
-        th->getTempConf(&tempConf);
-        th->getHumConf(&humConf);
-
-        float thHlth;
-        th->getHealth(&thHlth);
-
-        bool thRdOK;
-        th->getReadOK(&thRdOK);
-
-        Peripheral::TH_Averages thAvg;
-        th->getAverages(&thAvg);
-
-        // Soil
-
-        // ATTENTION. Ensure for ALL readings/conf you include each sensor in 
-        // arr size.
-
-        Peripheral::SoilReadings soReadings[SOIL_SENSORS]; 
-
-        Peripheral::Soil* soil = Peripheral::Soil::get();
-        soil->getAllReadings(soReadings);
-
-        Peripheral::AlertConfigSo soConf[SOIL_SENSORS];
-        soil->getAllConfig(soConf);
-
-        // Light. 
-        AS7341_DRVR::COLOR spec;
-
-        Peripheral::Light* light = Peripheral::Light::get();
-        light->getSpectrum(&spec);
-        
-        Peripheral::Light_Averages ltAv;
-        light->getAverages(&ltAv); 
-
-        Peripheral::LightHealth ltH;
-        light->getHealth(&ltH);
-
-        int photoVal;
-        light->getPhoto(&photoVal);
-   
-        Peripheral::RelayConfigLight ltConf;
-        light->getConf(&ltConf);
-
-        Peripheral::Spec_Conf specConf;
-        light->getSpecConf(&specConf);
-
-        uint32_t ltDur;
-        light->getDuration(&ltDur);
-
-        // Primary JSON response object. Populates every setting and value that
-        // is critical to the operation of this device, and returns it to the
-        // client. Ensure client uses same JSON and same commands.
-
-        written = snprintf(buffer, size,  
-        "{\"firmv\":\"%s\",\"id\":%u,\"newLog\":%d,\"netMode\":%u,"
-        "\"sysTime\":%lu,\"hhmmss\":\"%d:%d:%d\",\"day\":%u,\"timeCalib\":%d,"
-        "\"re0\":%d,\"re0TimerEn\":%d,\"re0TimerOn\":%zu,\"re0TimerOff\":%zu,"
-        "\"re1\":%d,\"re1TimerEn\":%d,\"re1TimerOn\":%zu,\"re1TimerOff\":%zu,"
-        "\"re2\":%d,\"re2TimerEn\":%d,\"re2TimerOn\":%zu,\"re2TimerOff\":%zu,"
-        "\"re3\":%d,\"re3TimerEn\":%d,\"re3TimerOn\":%zu,\"re3TimerOff\":%zu,"
-        "\"re0Days\":%u,\"re1Days\":%u,\"re2Days\":%u,\"re3Days\":%u,"
-        "\"re0Qty\":%u,\"re1Qty\":%u,\"re2Qty\":%u,\"re3Qty\":%u,"
-        "\"re0Man\":%u,\"re1Man\":%u,\"re2Man\":%u,\"re3Man\":%u,"
-        "\"temp\":%.2f,\"tempRe\":%d,\"tempReCond\":%u,\"tempReVal\":%d,"
-        "\"tempAltCond\":%u,\"tempAltVal\":%d,"
-        "\"hum\":%.2f,\"humRe\":%d,\"humReCond\":%u,\"humReVal\":%d,"
-        "\"humAltCond\":%u,\"humAltVal\":%d,"
-        "\"SHTH\":%.2f,\"SHTRdOK\":%d,\"tempAvg\":%0.1f,\"humAvg\":%0.1f,"
-        "\"tempAvgPrev\":%0.1f,\"humAvgPrev\":%0.1f,"
-        "\"soil0\":%d,\"soil0AltCond\":%u,\"soil0AltVal\":%d,\"soil0H\":%0.2f,"
-        "\"soil1\":%d,\"soil1AltCond\":%u,\"soil1AltVal\":%d,\"soil1H\":%0.2f,"
-        "\"soil2\":%d,\"soil2AltCond\":%u,\"soil2AltVal\":%d,\"soil2H\":%0.2f,"
-        "\"soil3\":%d,\"soil3AltCond\":%u,\"soil3AltVal\":%d,\"soil3H\":%0.2f,"
-        "\"soil0RdOK\":%d,\"soil1RdOK\":%d,\"soil2RdOK\":%d,\"soil3RdOK\":%d,"
-        "\"violet\":%u,\"indigo\":%u,\"blue\":%u,\"cyan\":%u,\"green\":%u,"
-        "\"yellow\":%u,\"orange\":%u,\"red\":%u,\"nir\":%u,\"clear\":%u,"
-        "\"photo\":%d,"
-        "\"violetAvg\":%0.1f,\"indigoAvg\":%0.1f,\"blueAvg\":%0.1f,"
-        "\"cyanAvg\":%0.1f,\"greenAvg\":%0.1f,\"yellowAvg\":%0.1f,"
-        "\"orangeAvg\":%0.1f,\"redAvg\":%0.1f,\"nirAvg\":%0.1f,"
-        "\"clearAvg\":%0.1f,\"photoAvg\":%0.1f,"
-        "\"violetAvgPrev\":%0.1f,\"indigoAvgPrev\":%0.1f,\"blueAvgPrev\":%0.1f,"
-        "\"cyanAvgPrev\":%0.1f,\"greenAvgPrev\":%0.1f,\"yellowAvgPrev\":%0.1f,"
-        "\"orangeAvgPrev\":%0.1f,\"redAvgPrev\":%0.1f,\"nirAvgPrev\":%0.1f,"
-        "\"clearAvgPrev\":%0.1f,\"photoAvgPrev\":%0.1f,"
-        "\"photoRdOK\":%d,\"specRdOK\":%d,\"photoH\":%0.2f,\"specH\":%0.2f,"
-        "\"lightRe\":%d,\"lightReCond\":%u,\"lightReVal\":%u,"
-        "\"lightDur\":%lu,\"darkVal\":%u,"
-        "\"atime\":%u,\"astep\":%u,\"again\":%u}",
-
-        FIRMWARE_VERSION, data.idNum, newLog, net,
-        dtg.raw, dtg.hour, dtg.minute, dtg.second, dtg.day, isCal,
-
-        static_cast<uint8_t>(re0st),
-        re0Timer.isReady, (size_t)re0Timer.onTime, (size_t)re0Timer.offTime,
-        static_cast<uint8_t>(re1st),
-        re1Timer.isReady, (size_t)re1Timer.onTime, (size_t)re1Timer.offTime,
-        static_cast<uint8_t>(re2st),
-        re2Timer.isReady, (size_t)re2Timer.onTime, (size_t)re2Timer.offTime,
-        static_cast<uint8_t>(re3st),
-        re3Timer.isReady, (size_t)re3Timer.onTime, (size_t)re3Timer.offTime,
-        re0Timer.days, re1Timer.days, re2Timer.days, re3Timer.days,
-        re0Qty, re1Qty, re2Qty, re3Qty, re0man, re1man, re2man, re3man,
-
-        temp, tempConf.relay.num,
-        static_cast<uint8_t>(tempConf.relay.condition), tempConf.relay.tripVal,
-        static_cast<uint8_t>(tempConf.alt.condition), tempConf.alt.tripVal,
-        hum, humConf.relay.num,
-        static_cast<uint8_t>(humConf.relay.condition), humConf.relay.tripVal, 
-        static_cast<uint8_t>(humConf.alt.condition), humConf.alt.tripVal,
-        thHlth, thRdOK,
-        thAvg.temp, thAvg.hum, thAvg.prevTemp, thAvg.prevHum,
-        
-        soReadings[0].val, static_cast<uint8_t>(soConf[0].condition),
-        soConf[0].tripVal, soReadings[0].sensHealth,
-        soReadings[1].val, static_cast<uint8_t>(soConf[1].condition),
-        soConf[1].tripVal, soReadings[1].sensHealth,
-        soReadings[2].val, static_cast<uint8_t>(soConf[2].condition),
-        soConf[2].tripVal, soReadings[2].sensHealth,
-        soReadings[3].val, static_cast<uint8_t>(soConf[3].condition),
-        soConf[3].tripVal, soReadings[3].sensHealth,
-
-        // Negate the soil readings, to show read OK if set to false.
-        !soReadings[0].readErr,
-        !soReadings[1].readErr,
-        !soReadings[2].readErr,
-        !soReadings[3].readErr,
-
-        spec.F1_415nm_Violet, spec.F2_445nm_Indigo, spec.F3_480nm_Blue,
-        spec.F4_515nm_Cyan, spec.F5_555nm_Green, spec.F6_590nm_Yellow,
-        spec.F7_630nm_Orange, spec.F8_680nm_Red, spec.NIR, spec.Clear,
-
-        photoVal,
-        ltAv.color.violet, ltAv.color.indigo, ltAv.color.blue,
-        ltAv.color.cyan, ltAv.color.green, ltAv.color.yellow,
-        ltAv.color.orange, ltAv.color.red, ltAv.color.nir,
-        ltAv.color.clear, ltAv.photoResistor, ltAv.prevColor.violet,
-        ltAv.prevColor.indigo, ltAv.prevColor.blue, ltAv.prevColor.cyan,
-        ltAv.prevColor.green, ltAv.prevColor.yellow, ltAv.prevColor.orange,
-        ltAv.prevColor.red, ltAv.prevColor.nir, ltAv.prevColor.clear,
-        ltAv.prevPhotoResistor,
-
-        // negate the read errors to show OK if set to false.
-        !ltH.photoReadErr,
-        !ltH.specReadErr,
-
-        ltH.photo, ltH.spec, ltConf.num, static_cast<uint8_t>(ltConf.condition),
-        ltConf.tripVal, ltDur, ltConf.darkVal, specConf.ATIME, specConf.ASTEP,
-        static_cast<uint8_t>(specConf.AGAIN)
-        );
+        if (isBin) {
+            written = SOCKHAND::wireAll(data.idNum, (uint8_t*)buffer, size);
+        } else {
+            written = SOCKHAND::compileAll(data.idNum, buffer, size);
         }
 
         break;
@@ -762,6 +737,14 @@ void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
 
         break;
 
+        // Sent by clients to set the time averages are cleared, which is no
+        // longer supported. Retained to keep command numbering aligned.
+        case CMDS::CLEAR_AVG_SET_TIME:
+        written = snprintf(buffer, size, reply, 0, "Unsupported", 0, 
+            data.idNum);
+
+        break;
+
         // When called, the device will save all configuration settings to the
         // NVS and restart the system.
         case CMDS::SAVE_AND_RESTART:
@@ -771,102 +754,331 @@ void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
         default:
         break;
 
+        // Replies with log entries newer than the client cursor, passed as
+        // the supplementary data, the "last" of the previous reply, 0 for
+        // all. Returns "first" the oldest entry held, "head" the newest, and
+        // "last" the newest included. If last is below head, the reply was
+        // full and the client repeats with the new cursor. If first exceeds
+        // the cursor + 1, entries were overwritten before retrieval. If the
+        // cursor exceeds head, the device restarted and all are returned.
+        // Entries are in the /getLog format, entry1;entry2;...;entryn;
+        case CMDS::GET_LOG_SINCE: {
+        writeLog = false; // Not req to log a log.
+        uint32_t first{0}, next{0};
+        auto* logger = Messaging::MsgLogHandler::get();
+
+        if (!logger->getLogSeq(first, next)) {
+            written = snprintf(buffer, size, reply, 0, "Log busy", 0, 
+                data.idNum);
+
+            break;
+        }
+
+        uint32_t since = (data.suppData > 0) ? data.suppData : 0;
+        if (since >= next) since = 0; // Sequence restarted, send all.
+
+        static char chunk[SKT_LOG_CHUNK]; // Static, large for the stack.
+        static char escaped[SKT_LOG_CHUNK * 2]; // Worst case, all escaped.
+        uint32_t seq = since + 1; // Begin after the client cursor.
+
+        logger->getLog(chunk, sizeof(chunk), seq, next);
+        SOCKHAND::escapeJSON(chunk, escaped, sizeof(escaped));
+
+        // seq follows the last entry rendered, or is unchanged if none.
+        written = snprintf(buffer, size, 
+            "{\"id\":%u,\"first\":%lu,\"head\":%lu,\"last\":%lu,"
+            "\"log\":\"%s\"}", data.idNum, (unsigned long)first, 
+            (unsigned long)(next - 1), (unsigned long)(seq - 1), escaped);
+
+        // Caught up, equivalent to acknowledging with NEW_LOG_RCVD.
+        if (seq == next) logger->resetNewLogFlag();
+        }
+
+        break;
+
         // When called, device will reply in json format, all trends of temp,
         // humidity, and spectral light, based on hourly readings. JSON return
-        // uses temp, hum, and each color captured, nir, and clear.
-        case CMDS::GET_TRENDS: 
-        if (!SOCKHAND::inRange(1, TREND_HOURS, data.suppData)) {
+        // uses temp, hum, and each color captured, nir, and clear. Supp 
+        // SKT_FMT_BIN | hours replies with the binary trends. Below is the
+        // 16-bit bitwise breakdown.
+        // 0RRR 000B NNNN NNNN
+        // R = resolution: 0 hourly readings, else the aggregates of the
+        // TSRes tier R - 1, 1 minute, 15 minute, hourly, or daily. JSON only.
+        // B = SKT_FMT_BIN, N = hours, or buckets of the tier, newest first.
+        case CMDS::GET_TRENDS: {
+        int iter = data.suppData & SKT_TREND_QTY; // Iterations or hours.
+        int res = data.suppData >> SKT_TREND_RES_SHIFT;
+
+        if (res > 0) {
+            writeLog = false; // Prevent large log of data
+            written = (data.suppData & SKT_FMT_BIN) ? -1 :
+                SOCKHAND::compileSeries(data.idNum, res - 1, iter, buffer,
+                size, hd, fd, isFrag);
+
+            if (written < 0) {
+                writeLog = true;
+                written = snprintf(buffer, size, reply, 0,
+                    "Trend res rangeErr", 0, data.idNum);
+            }
+
+        } else if (!SOCKHAND::inRange(1, TREND_HOURS, iter)) {
             written = snprintf(buffer, size, reply, 0, "Trend hour rangeErr", 0, 
                 data.idNum);
 
+        } else if (data.suppData & SKT_FMT_BIN) {
+            writeLog = false; // Prevent large log of data
+            isBin = true;
+            written = SOCKHAND::wireTrends(data.idNum, iter, (uint8_t*)buffer, 
+                size);
+
         } else { 
 
             writeLog = false; // Prevent large log of data
-            int iter = data.suppData; // Iterations or hours to compute.
 
+            // Snapshots of the requested hours only.
             static Peripheral::TH_Trends th;
-            Peripheral::TempHum::get()->getTrends(&th); 
-
-           // Create all float buffers to populate data into.
-            char tempBuf[SKT_REPLY_SIZE]{0};
-            char humBuf[SKT_REPLY_SIZE]{0};
-
-            // Populate buffers above with requested data.
-            SOCKHAND::Trends(th.temp, 'f', tempBuf, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(th.hum, 'f', humBuf, SKT_REPLY_SIZE, iter);
-
-            // Create all unit16_t buffers to populate data into.
-            char ltClr[SKT_REPLY_SIZE]{0}; char ltVio[SKT_REPLY_SIZE]{0}; 
-            char ltInd[SKT_REPLY_SIZE]{0}; char ltBlu[SKT_REPLY_SIZE]{0}; 
-            char ltCya[SKT_REPLY_SIZE]{0}; char ltGre[SKT_REPLY_SIZE]{0}; 
-            char ltYel[SKT_REPLY_SIZE]{0}; char ltOra[SKT_REPLY_SIZE]{0}; 
-            char ltRed[SKT_REPLY_SIZE]{0}; 
-            char ltNir[SKT_REPLY_SIZE]{0}; // Near infrared
-            char ltPho[SKT_REPLY_SIZE]{0}; // Photoresistor
-
-            // Populate buffers above with requested data.
-            Peripheral::Light_Trends lt;
-            Peripheral::Light::get()->getTrends(&lt);
-
-            SOCKHAND::Trends(lt.clear, 'u', ltClr, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.violet, 'u', ltVio, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.indigo, 'u', ltInd, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.blue, 'u', ltBlu, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.cyan, 'u', ltCya, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.green, 'u', ltGre, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.yellow, 'u', ltYel, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.orange, 'u', ltOra, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.red, 'u', ltRed, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.nir, 'u', ltNir, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(lt.photo, 'i', ltPho, SKT_REPLY_SIZE, iter);
-
-            // Create all int16_t buffers to populate soil data into.
-            char soil0[SKT_REPLY_SIZE]{0};
-            char soil1[SKT_REPLY_SIZE]{0};
-            char soil2[SKT_REPLY_SIZE]{0};
-            char soil3[SKT_REPLY_SIZE]{0};
-
-            // Populate buffers above with requested data.
-            int16_t soil[SOIL_SENSORS][TREND_HOURS] = {};
-            Peripheral::Soil::get()->getAllTrends(&soil[0][0]);
-
-            SOCKHAND::Trends(soil[0], 'i', soil0, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(soil[1], 'i', soil1, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(soil[2], 'i', soil2, SKT_REPLY_SIZE, iter);
-            SOCKHAND::Trends(soil[3], 'i', soil3, SKT_REPLY_SIZE, iter);
-
-            // Write JSON data back to client.
-            written = snprintf(buffer, size, 
-            "{\"id\":%u,\"temp\":[%s],\"hum\":[%s],"
-            "\"clear\":[%s],\"violet\":[%s],\"indigo\":[%s],\"blue\":[%s],"
-            "\"cyan\":[%s],\"green\":[%s],\"yellow\":[%s],\"orange\":[%s],"
-            "\"red\":[%s],\"nir\":[%s],\"photo\":[%s],"
-            "\"soil_0\":[%s],\"soil_1\":[%s],\"soil_2\":[%s],\"soil_3\":[%s]}",
-            data.idNum, tempBuf, humBuf, ltClr, ltVio, ltInd, ltBlu, ltCya,
-            ltGre, ltYel, ltOra, ltRed, ltNir, ltPho, soil0, soil1, soil2,
-            soil3);
+            Peripheral::TempHum::get()->getTrends(&th, iter); 
+
+            static Peripheral::Light_Trends lt;
+            Peripheral::Light::get()->getTrends(&lt, iter);
+
+            static Peripheral::Soil_Trends soil[SOIL_SENSORS];
+            Peripheral::Soil::get()->getAllTrends(soil, iter);
+
+            // Write JSON data back to client, directly into the buffer. 
+            // Sent in fragments if exceeding the buffer.
+            JsonStream js(buffer, size, hd, fd);
+            js.open('{');
+            js.key("id"); js.num((uint32_t)data.idNum);
+            js.arr("temp", th.temp, iter, 1);
+            js.arr("hum", th.hum, iter, 1);
+            js.arr("clear", lt.clear, iter);
+            js.arr("violet", lt.violet, iter);
+            js.arr("indigo", lt.indigo, iter);
+            js.arr("blue", lt.blue, iter);
+            js.arr("cyan", lt.cyan, iter);
+            js.arr("green", lt.green, iter);
+            js.arr("yellow", lt.yellow, iter);
+            js.arr("orange", lt.orange, iter);
+            js.arr("red", lt.red, iter);
+            js.arr("nir", lt.nir, iter);
+            js.arr("photo", lt.photo, iter);
+            js.arr("soil_0", soil[0], iter);
+            js.arr("soil_1", soil[1], iter);
+            js.arr("soil_2", soil[2], iter);
+            js.arr("soil_3", soil[3], iter);
+            js.close('}');
+
+            written = js.finish(isFrag);
+        }
+        }
+
+        break;
+
+        // Sets or queries the runtime log level of a log tag, see LOG_TAGS in
+        // MsgLogHandler.hpp. Entries below the level are discarded before 
+        // formatting. Below is the 12-bit bitwise breakdown.
+        // TTTT TTTT LLLL
+        // T = tag index, 0xFF = all tags.
+        // L = level: 0 DEBUG - 4 CRITICAL, 0xF = query only, no change.
+        // Replies with the tag and its level, supp is the level.
+        case CMDS::SET_LOG_LEVEL: {
+        uint8_t tagIdx = (data.suppData >> 4) & 0xFF;
+        uint8_t lvl = data.suppData & 0xF;
+        bool all = (tagIdx == 0xFF);
+        bool query = (lvl == 0xF);
+        auto* logger = Messaging::MsgLogHandler::get();
+
+        bool tagRange = all || SOCKHAND::inRange(0, LOG_TAG_QTY - 1, tagIdx);
+        bool lvlRange = query || SOCKHAND::inRange(0, 4, lvl);
+
+        if (!tagRange || !lvlRange || (all && query)) {
+            written = snprintf(buffer, size, reply, 0, "Log lvl rangeErr", 0, 
+                data.idNum);
+            break; // Break and block if range error.
+        }
+
+        auto level = static_cast<Messaging::Levels>(lvl);
+
+        if (all) {
+            for (size_t i = 0; i < LOG_TAG_QTY; i++) {
+                logger->setTagLevel(static_cast<Messaging::LogTag>(i), level);
+            }
+
+            char msg[32]{0};
+            snprintf(msg, sizeof(msg), "ALL level %s", 
+                Messaging::LevelsMap[lvl]);
+
+            written = snprintf(buffer, size, reply, 1, msg, lvl, data.idNum);
+            break;
+        }
+
+        auto tagID = static_cast<Messaging::LogTag>(tagIdx);
+        if (!query) logger->setTagLevel(tagID, level);
+        uint8_t current = static_cast<uint8_t>(logger->getTagLevel(tagID));
+
+        char msg[32]{0};
+        snprintf(msg, sizeof(msg), "%s level %s", 
+            Messaging::LogTagMap[tagIdx], Messaging::LevelsMap[current]);
+
+        written = snprintf(buffer, size, reply, 1, msg, current, data.idNum);
+        }
+
+        break;
+
+        // Subscribes the socket to pushed GET_ALL replies, sent with the id
+        // SKT_PUSH_ID once a peripheral completes a read cycle, replacing
+        // polling. supp = min seconds between pushes, 1 - SKT_PUSH_MAX_S, or 
+        // 0 to unsubscribe. Subscribers are removed once their socket closes.
+        case CMDS::SUBSCRIBE: 
+        if (!SOCKHAND::inRange(0, SKT_PUSH_MAX_S, data.suppData) || fd < 0) {
+            written = snprintf(buffer, size, reply, 0, "Sub rangeErr", 0, 
+                data.idNum);
+
+        } else if (data.suppData == 0) {
+            SOCKHAND::unsubscribe(fd);
+            written = snprintf(buffer, size, reply, 1, "Unsubscribed", 0, 
+                data.idNum);
+
+        } else if (SOCKHAND::subscribe(hd, fd, data.suppData)) {
+            written = snprintf(buffer, size, reply, 1, "Subscribed", 
+                data.suppData, data.idNum);
+
+        } else {
+            written = snprintf(buffer, size, reply, 0, "Subs full", 0, 
+                data.idNum);
+        }
+
+        break;
+
+        // Replies with the GET_ALL fields changed since the version passed,
+        // supp = the "ver" of the previous delta reply, 0 for all fields. 
+        // Format {"id":n,"ver":latest,"full":0|1,"key":value,...} with keys 
+        // of GET_ALL, full = 1 if every field is included, once the version
+        // is 0 or from a previous boot. The client merges fields into its 
+        // previous data. See deltaField in socketHandler.hpp.
+        case CMDS::GET_DELTA: {
+        writeLog = false; // Commonly used command, do not want to log.
+        uint32_t since = (data.suppData > 0) ? data.suppData : 0;
+
+        Threads::MutexLock guard(SOCKHAND::deltaMtx);
+        if (!guard.LOCK() || !SOCKHAND::updateDelta()) {
+            written = snprintf(buffer, size, reply, 0, "Delta busy", 0, 
+                data.idNum);
+            break;
+        }
+
+        written = SOCKHAND::renderDelta(since, data.idNum, buffer, size);
+        }
+
+        break;
+
+        // Executes up to SKT_BATCH_MAX commands in order, passed following
+        // the header as cmd/supp/id/ each, supp = the quantity. Format
+        // {"id":n,"batch":[reply,...]}, each reply as if sent alone. Allows
+        // a client to send its full configuration in a single round trip.
+        // Commands with large replies are refused, see batchable().
+        case CMDS::BATCH:
+        writeLog = false; // Each command logs its own reply.
+        written = SOCKHAND::compileBatch(data, buffer, size, hd, fd, isFrag);
+
+        if (written < 0) {
+            written = snprintf(buffer, size, reply, 0, "Batch fmt err", 0, 
+                data.idNum);
+        }
+
+        break;
+
+        // Replies with the websocket sessions and their counters, used to
+        // size max_open_sockets and the arg pool. Format {"id":n,"open":n,
+        // "peak":n,"reaped":n,"dropped":n,"sess":[{"fd","cmds","in","out",
+        // "latUs","idleMs","ageS","missed","limited"},...]}, latUs is the
+        // average receipt to reply latency. See sktSess.
+        case CMDS::GET_SESSIONS:
+        writeLog = false; // Polled by monitoring, do not want to log.
+        written = SOCKHAND::compileSessions(data.idNum, buffer, size, hd, fd,
+            isFrag);
+
+        if (written < 0) {
+            written = snprintf(buffer, size, reply, 0, "Sessions busy", 0, 
+                data.idNum);
+        }
+
+        break;
+
+        // Replies with the arg pool and lane usage, with the high water
+        // marks since boot, and the frames refused. Used by clients to adapt
+        // their request rate to the headroom of the device. Format {"id":n,
+        // "args":[small,smallPeak,smallMax,large,largePeak,largeMax],
+        // "lanes":[fast,fastPeak,slow,slowPeak,laneMax],"full":n,"busy":n,
+        // "drop":n}. full counts jobs refused by a full lane, busy the busy
+        // replies, and drop the frames refused without a reply.
+        case CMDS::GET_LOAD:
+        writeLog = false; // Polled by monitoring, do not want to log.
+        written = SOCKHAND::compileLoad(data.idNum, buffer, size);
+        break;
+
+        // Replies with the compressed minute history, binary, the blocks
+        // from the supp block sequence on, as many as fit. Clients page by
+        // requesting the sequence following the last block received, until
+        // it reaches nextSeq, and refetch the open block, nextSeq - 1, to
+        // update it. See WireHistory, and TSBlockWriter for the bitstream.
+        case CMDS::GET_HISTORY:
+        if (data.suppData < 0) {
+            written = snprintf(buffer, size, reply, 0, "History rangeErr", 0,
+                data.idNum);
+
+        } else {
+            writeLog = false; // Prevent large log of data
+            isBin = true;
+            written = SOCKHAND::wireHistory(data.idNum, data.suppData,
+                (uint8_t*)buffer, size);
+        }
+
+        break;
+
+        // Replies with the rolling statistics of every channel, the count,
+        // mean, standard deviation, min, max, and moving average over the
+        // windows of the supp bitmask, bit 0 for 5 minutes, 1 for 1 hour, 2
+        // for 24 hours, 0 for all. See compileStats for the format.
+        case CMDS::GET_STATS:
+        writeLog = false; // Prevent large log of data
+        written = SOCKHAND::compileStats(data.idNum, data.suppData, buffer,
+            size, hd, fd, isFrag);
+
+        if (written < 0) {
+            writeLog = true;
+            written = snprintf(buffer, size, reply, 0, "Stats rangeErr", 0,
+                data.idNum);
         }
 
         break;
     }
 
+    // Ends the GET_ALL snapshot epoch, so the change is seen by the next 
+    // GET_ALL, even within the same second.
+    if (!SOCKHAND::readOnly(data.cmd)) SOCKHAND::allGen.fetch_add(1);
+
     // Will log the JSON response string, but not as JSON. This prevents any
     // client JSON parse from having issues since logs are Read Only anyway.
+    // Logged per command, at DEBUG, which compiles away in production.
     if (writeLog) { 
 
-        static char tempBuf[SKT_REPLY_SIZE] = {0};
+        LOG_IF(Messaging::LogTag::HTTP, Messaging::Levels::DEBUG) {
+            static char tempBuf[SKT_REPLY_SIZE] = {0};
 
-        snprintf(tempBuf, sizeof(tempBuf), "%s", buffer);
+            snprintf(tempBuf, sizeof(tempBuf), "%s", buffer);
 
-        size_t iterSize = strlen(tempBuf);
+            size_t iterSize = strlen(tempBuf);
 
-        for (size_t i = 0; i < iterSize; i++) {
-            if (tempBuf[i] == '{' or tempBuf[i] == '}') {
-                tempBuf[i] = '|';
+            for (size_t i = 0; i < iterSize; i++) {
+                if (tempBuf[i] == '{' or tempBuf[i] == '}') {
+                    tempBuf[i] = '|';
+                }
             }
-        }
 
-        MASTERHAND::sendErr(tempBuf, Messaging::Levels::INFO);
+            MASTERHAND::sendErr(tempBuf, Messaging::Levels::DEBUG);
+        }
     }
 
     if (written <= 0) {
@@ -875,7 +1087,7 @@ void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
 
         MASTERHAND::sendErr(MASTERHAND::log);
 
-    } else if (written >= size) {
+    } else if (written >= (int)size) {
 
         snprintf(MASTERHAND::log, sizeof(MASTERHAND::log), 
             "%s Output truncated. Buffer size: %zu, Output size: %d", 
@@ -883,6 +1095,21 @@ void SOCKHAND::compileData(cmdData &data, char* buffer, size_t size) {
 
         MASTERHAND::sendErr(MASTERHAND::log);
     } 
+
+    if (isFrag) { // Final fragment, closes the reply even if truncated.
+        if (type != nullptr) *type = HTTPD_WS_TYPE_CONTINUE;
+        return strlen(buffer);
+    }
+
+    if (!isBin) return strlen(buffer);
+
+    if (written <= 0 || written >= (int)size) { // Reply as text instead.
+        return snprintf(buffer, size, reply, 0, "Wire fmt err", 0, 
+            data.idNum);
+    }
+
+    if (type != nullptr) *type = HTTPD_WS_TYPE_BINARY;
+    return written;
 }
 
 // Requires the lower and upper bounds, the value, the exception value, and the
@@ -919,79 +1146,29 @@ bool SOCKHAND::checkSTA(int &written, char* buffer, size_t size,
     return true; // is station mode.
 }
 
-// Requires a void pointer of type float, uint16_t or int16_t, as well as its
-// type 'f', 'u', or 'i'. Also the char buffer, buffer size, and number of 
-// iterations is required, typically 1 to 12. Casts the void pointer to the 
-// appropritae type, and populates a JSON array with the requested value to
-// send back to the client.
-void SOCKHAND::Trends(void* arr, char type, char* buf, size_t bufSize, 
-    int iter) {
-
-    if (arr == nullptr || buf == nullptr) {
-        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log), 
-            "%s nullptr passed", SOCKHAND::tag);
+// Requires source string, destination buffer, and its size. Copies the 
+// source into the destination as the body of a JSON string, escaping quotes
+// and backslashes, and replacing control chars with spaces. Stops before an
+// escape that would not fit, and null terminates. Returns chars written.
+size_t SOCKHAND::escapeJSON(const char* src, char* dst, size_t size) {
+    if (src == nullptr || dst == nullptr || size == 0) return 0;
 
-        MASTERHAND::sendErr(MASTERHAND::log);
-        return; // Block
-    }
+    size_t written = 0;
 
-    char miniBuf[32]{0}; // Used as a temporary buffer for creation.
-
-    // Cast change depending on type of array passed.
-    switch (type) {
-        case 'f': { // Float, pertains to temperature and humidity values.
-        float* a = static_cast<float*>(arr);
-
-        for (int i = 0; i < iter; i++) {
-            if (i == (iter - 1)) { // Changes last index to remove comma.
-                snprintf(miniBuf, sizeof(miniBuf), "%0.1f", a[i]);
-            } else {
-                snprintf(miniBuf, sizeof(miniBuf), "%0.1f, ", a[i]);
-            }
-
-            size_t remaining = bufSize - strlen(buf) - 1; // Null term.
-            strncat(buf, miniBuf, remaining); // Add new entry.
-        }
-        }
-
-        break;
+    for (; *src != '\0'; src++) {
+        bool escape = (*src == '"' || *src == '\\');
+        if (written + (escape ? 2 : 1) >= size) break; // Null term.
 
-        case 'u': { // uint16_t applies to spectral light.
-        uint16_t* a = static_cast<uint16_t*>(arr);
-
-        for (int i = 0; i < iter; i++) {
-            if (i == (iter - 1)) { // Changes last index to remove comma.
-                snprintf(miniBuf, sizeof(miniBuf), "%u", a[i]);
-            } else {
-                snprintf(miniBuf, sizeof(miniBuf), "%u, ", a[i]);
-            }
-
-            size_t remaining = bufSize - strlen(buf) - 1; // Null term.
-            strncat(buf, miniBuf, remaining); // Add new entry.
-        }
-        }       
-        
-        break;
-
-        case 'i': { // int16_t applies to ADC sensors, light and soil.
-        int16_t* a = static_cast<int16_t*>(arr);
-
-        for (int i = 0; i < iter; i++) {
-            if (i == (iter - 1)) { // Changes last index to remove comma.
-                snprintf(miniBuf, sizeof(miniBuf), "%d", a[i]);
-            } else {
-                snprintf(miniBuf, sizeof(miniBuf), "%d, ", a[i]);
-            }
-
-            size_t remaining = bufSize - strlen(buf) - 1; // Null term.
-            strncat(buf, miniBuf, remaining); // Add new entry.
-        }
+        if (escape) {
+            dst[written++] = '\\';
+            dst[written++] = *src;
+        } else {
+            dst[written++] = (static_cast<uint8_t>(*src) < 0x20) ? ' ' : *src;
         }
-
-        break;
-
-        default: break;
     }
+
+    dst[written] = '\0';
+    return written;
 }
 
 // Requires relay number and pointer to TempHum configuration. Ensures relay
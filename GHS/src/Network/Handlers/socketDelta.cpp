@@ -0,0 +1,147 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "esp_random.h"
+#include "Threads/Mutex.hpp"
+
+namespace Comms {
+
+// Static Setup
+deltaField SOCKHAND::fields[SKT_DELTA_FIELDS]{};
+size_t SOCKHAND::fieldQty{0};
+uint32_t SOCKHAND::deltaBase{esp_random() & 0x3FFFFFFF}; // Fits a socket int.
+uint32_t SOCKHAND::deltaVer{SOCKHAND::deltaBase};
+char SOCKHAND::deltaAll[SKT_BUF_SIZE]{0};
+Threads::Mutex SOCKHAND::deltaMtx(DELTA_TAG);
+
+// Requires the data and its length. Returns the 32 bit FNV-1a hash.
+static uint32_t hashRange(const char* data, size_t len) {
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<uint8_t>(data[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+// Requires the position within the flat GET_ALL JSON, and references to the
+// pair, pair length, and key length. Populates the "key":value pair that
+// begins at or following the position. Returns the position following the
+// pair, or nullptr if none remain. Values are numbers or strings without
+// escaped quotes, as written by compileAll().
+const char* SOCKHAND::nextField(const char* pos, const char* &pair,
+    size_t &pairLen, size_t &keyLen) {
+
+    if (*pos == '{' || *pos == ',') pos++;
+    if (*pos != '"') return nullptr; // End of object, or malformed.
+
+    const char* keyEnd = strchr(pos + 1, '"');
+    if (keyEnd == nullptr || keyEnd[1] != ':') return nullptr;
+
+    const char* val = keyEnd + 2;
+    const char* end = val;
+
+    if (*val == '"') { // String value.
+        end = strchr(val + 1, '"');
+        if (end == nullptr) return nullptr;
+        end++;
+
+    } else { // Number.
+        while (*end != ',' && *end != '}' && *end != '\0') end++;
+    }
+
+    pair = pos;
+    pairLen = end - pos;
+    keyLen = keyEnd - pos - 1;
+    return end;
+}
+
+// Requires no params, caller must hold deltaMtx. Compiles the GET_ALL reply
+// into deltaAll, and stamps each field whose value changed since the
+// previous compile with the next version. Returns true if compiled, false if
+// the reply failed to compile or exceeds SKT_DELTA_FIELDS.
+bool SOCKHAND::updateDelta() {
+    int written = SOCKHAND::compileAll(0, SOCKHAND::deltaAll,
+        sizeof(SOCKHAND::deltaAll));
+
+    if (written <= 0 || written >= (int)sizeof(SOCKHAND::deltaAll)) {
+        return false;
+    }
+
+    uint32_t next = SOCKHAND::deltaVer + 1;
+    bool changed = false;
+    size_t idx = 0;
+    const char* pair; size_t pairLen, keyLen;
+    const char* pos = SOCKHAND::deltaAll;
+
+    while (true) {
+        pos = SOCKHAND::nextField(pos, pair, pairLen, keyLen);
+        if (pos == nullptr) break;
+
+        bool isID = (keyLen == 2 && strncmp(pair + 1, "id", 2) == 0);
+        if (isID) continue; // Request id, not versioned.
+        if (idx >= SKT_DELTA_FIELDS) return false;
+
+        deltaField &field = SOCKHAND::fields[idx++];
+        uint32_t keyHash = hashRange(pair + 1, keyLen);
+        uint32_t valHash = hashRange(pair, pairLen);
+
+        if (field.keyHash != keyHash || field.valHash != valHash) {
+            field.keyHash = keyHash;
+            field.valHash = valHash;
+            field.ver = next;
+            changed = true;
+        }
+    }
+
+    SOCKHAND::fieldQty = idx;
+    if (changed) SOCKHAND::deltaVer = next;
+    return true;
+}
+
+// Requires the client version, reply id, buffer, and buffer size. Caller
+// must hold deltaMtx, following updateDelta(). Writes the fields of deltaAll
+// changed since the version, in the format
+// {"id":n,"ver":latest,"full":0|1,"key":value,...}, with full = 1 if every
+// field is written, when the version is 0 or outside of this boot. Returns
+// the bytes written, or size if the reply exceeds the buffer.
+int SOCKHAND::renderDelta(uint32_t since, uint16_t idNum, char* buffer,
+    size_t size) {
+
+    bool full = (since <= SOCKHAND::deltaBase || since > SOCKHAND::deltaVer);
+
+    int written = snprintf(buffer, size, "{\"id\":%u,\"ver\":%lu,\"full\":%d",
+        idNum, (unsigned long)SOCKHAND::deltaVer, full);
+
+    if (written <= 0 || written >= (int)size) return written;
+
+    size_t len = written;
+    size_t idx = 0;
+    const char* pair; size_t pairLen, keyLen;
+    const char* pos = SOCKHAND::deltaAll;
+
+    while (true) {
+        pos = SOCKHAND::nextField(pos, pair, pairLen, keyLen);
+        if (pos == nullptr) break;
+
+        bool isID = (keyLen == 2 && strncmp(pair + 1, "id", 2) == 0);
+        if (isID) continue; // Request id, not versioned.
+        if (idx >= SOCKHAND::fieldQty) break;
+
+        bool changed = (SOCKHAND::fields[idx++].ver > since);
+        if (!full && !changed) continue;
+
+        if (len + pairLen + 2 >= size) return size; // Room for , and }.
+
+        buffer[len++] = ',';
+        memcpy(&buffer[len], pair, pairLen);
+        len += pairLen;
+    }
+
+    buffer[len++] = '}';
+    buffer[len] = '\0';
+    return len;
+}
+
+}
@@ -0,0 +1,132 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Comms {
+
+// Static Setup
+QueueHandle_t SOCKHAND::fastQ{nullptr};
+QueueHandle_t SOCKHAND::slowQ{nullptr};
+SemaphoreHandle_t SOCKHAND::execSig{nullptr};
+
+// Static allocation, the queues are never deleted.
+static StaticQueue_t fastQBuf, slowQBuf;
+static uint8_t fastQStorage[SKT_EXEC_DEPTH * sizeof(sktJob)];
+static uint8_t slowQStorage[SKT_EXEC_DEPTH * sizeof(sktJob)];
+
+// Requires no params. Creates the fast and slow lanes of the socket task.
+// Returns true if created, false if not, which blocks all socket commands.
+bool SOCKHAND::initExec() {
+    if (SOCKHAND::execSig != nullptr) return true; // Already created.
+
+    SOCKHAND::fastQ = xQueueCreateStatic(SKT_EXEC_DEPTH, sizeof(sktJob),
+        fastQStorage, &fastQBuf);
+
+    SOCKHAND::slowQ = xQueueCreateStatic(SKT_EXEC_DEPTH, sizeof(sktJob),
+        slowQStorage, &slowQBuf);
+
+    SOCKHAND::execSig = xSemaphoreCreateBinary();
+
+    return (SOCKHAND::fastQ != nullptr && SOCKHAND::slowQ != nullptr &&
+        SOCKHAND::execSig != nullptr);
+}
+
+// Requires the command. Returns true if the command does not change the data
+// of the GET_ALL reply, run in the fast lane, false if it may, run in the
+// slow lane, which ends the snapshot epoch.
+bool SOCKHAND::readOnly(CMDS cmd) {
+    switch (cmd) {
+        case CMDS::GET_ALL: case CMDS::GET_TRENDS: case CMDS::GET_LOG_SINCE:
+        case CMDS::SET_LOG_LEVEL: case CMDS::SUBSCRIBE: case CMDS::GET_DELTA:
+        case CMDS::GET_SESSIONS: case CMDS::GET_LOAD: case CMDS::GET_HISTORY:
+        case CMDS::GET_STATS:
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+// Requires the command. Returns true if the reply commonly exceeds
+// SKT_REPLY_SIZE, and is written to a large pool arg if one is free, false
+// if the reply is the basic status, or streamed and commonly within it, such
+// as GET_SESSIONS and BATCH of basic commands, see streamed().
+bool SOCKHAND::largeReply(CMDS cmd) {
+    switch (cmd) {
+        case CMDS::GET_ALL: case CMDS::GET_TRENDS: case CMDS::GET_LOG_SINCE:
+        case CMDS::GET_DELTA: case CMDS::GET_HISTORY: case CMDS::GET_STATS:
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+// Requires the command and supp. Returns true if the reply is JSON written
+// by JsonStream, sent as fragments once exceeding the arg, so that a small
+// arg serves it when the large args are exhausted, in more frames. Returns
+// false if the reply must fit the arg, such as GET_ALL or the binary replies.
+bool SOCKHAND::streamed(CMDS cmd, int supp) {
+    switch (cmd) {
+        case CMDS::GET_TRENDS: return (supp & SKT_FMT_BIN) == 0;
+        case CMDS::BATCH: case CMDS::GET_SESSIONS: case CMDS::GET_STATS:
+        return true;
+
+        default:
+        return false;
+    }
+}
+
+// Requires the work function, its arg, and if it belongs in the slow lane.
+// Queues the job for the socket task, without blocking. Returns true if
+// queued, false if the lane is full or not created, the caller retains the
+// arg.
+bool SOCKHAND::queueJob(void (*work)(void* arg), async_resp_arg* arg,
+    bool slow) {
+
+    QueueHandle_t lane = slow ? SOCKHAND::slowQ : SOCKHAND::fastQ;
+    if (lane == nullptr || SOCKHAND::execSig == nullptr) return false;
+
+    sktJob job{work, arg};
+    if (xQueueSend(lane, &job, 0) != pdTRUE) {
+        SOCKHAND::laneFull.fetch_add(1);
+        return false;
+    }
+
+    // Records the high water mark of the lane.
+    std::atomic<uint32_t> &peak = SOCKHAND::lanePeak[slow];
+    uint32_t depth = uxQueueMessagesWaiting(lane);
+    uint32_t prev = peak.load();
+    while (depth > prev && !peak.compare_exchange_weak(prev, depth)) {}
+
+    xSemaphoreGive(SOCKHAND::execSig); // Wakes the socket task.
+    return true;
+}
+
+// Requires the max ticks to wait for a job. Called by the socket task. Runs
+// every queued fast job, then a single slow job, repeating until both lanes
+// are empty. Returns once empty, or upon the wait expiring.
+void SOCKHAND::execute(TickType_t wait) {
+    if (SOCKHAND::execSig == nullptr) {
+        vTaskDelay(wait); // Not created, nothing will be queued.
+        return;
+    }
+
+    if (xSemaphoreTake(SOCKHAND::execSig, wait) != pdTRUE) return;
+
+    sktJob job;
+
+    while (true) {
+        while (xQueueReceive(SOCKHAND::fastQ, &job, 0) == pdTRUE) {
+            job.work(job.arg);
+        }
+
+        if (xQueueReceive(SOCKHAND::slowQ, &job, 0) != pdTRUE) break;
+        job.work(job.arg); // Fast lane is checked again before the next.
+    }
+}
+
+}
@@ -1,5 +1,6 @@
 #include "Network/Handlers/socketHandler.hpp"
 #include "string.h"
+#include "esp_timer.h"
 #include "Network/NetSTA.hpp"
 #include "Config/config.hpp"
 #include "Threads/Mutex.hpp"
@@ -15,63 +16,107 @@ bool SOCKHAND::isInit{false};
 argPool SOCKHAND::pool;
 
 // Serves as a pool of resp_arg objects in order to prevent the requirement
-// to dynamically allocate memory and keep everything on the stack. The pool
-// is quite large considering the size of the buffer inside.
-argPool::argPool() : mtx(POOL_TAG) {
+// to dynamically allocate memory and keep everything on the stack. Small
+// args are sized to the basic reply, only the few large args carry the
+// buffer of the GET_ALL reply.
+argPool::argPool() : freeMap((1UL << SKT_MAX_RESP_ARGS) - 1), peak{0, 0} {
+    static_assert(SKT_MAX_RESP_ARGS <= 32, "Args exceed the free bitmap");
+    static_assert(SKT_SMALL_RESERVE < SKT_SMALL_ARGS, "No small args");
+    static_assert(SKT_LARGE_RESERVE < SKT_LARGE_ARGS, "No large args");
     
     // memset the pool to zeroize.
     memset(this->pool, 0, sizeof(this->pool));
+    memset(this->smallBuf, 0, sizeof(this->smallBuf));
+    memset(this->largeBuf, 0, sizeof(this->largeBuf));
+
+    for (int i = 0; i < SKT_SMALL_ARGS; i++) {
+        this->pool[i].Buf = this->smallBuf[i];
+        this->pool[i].bufSize = SKT_REPLY_SIZE;
+    }
+
+    for (int i = 0; i < SKT_LARGE_ARGS; i++) {
+        this->pool[SKT_SMALL_ARGS + i].Buf = this->largeBuf[i];
+        this->pool[SKT_SMALL_ARGS + i].bufSize = SKT_BUF_SIZE;
+    }
+
     Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
-        "(ARGPOOL) Ob created", Messaging::Method::SRL_LOG, true);
+        POOL_TAG " Ob created", Messaging::Method::SRL_LOG, true);
 }
 
-// Requires no params. Iterates the arg pool and returns a pointer to an open
-// allocation. Returns NULL if no availabilities.
-async_resp_arg* argPool::getArg() {
+// Requires true for large args, or false for small. Returns the bits of the
+// size class within the free bitmap.
+static uint32_t classMask(bool large) {
+    const uint32_t smallMask = (1UL << SKT_SMALL_ARGS) - 1;
+    return large ? (((1UL << SKT_MAX_RESP_ARGS) - 1) & ~smallMask) : smallMask;
+}
 
-    Threads::MutexLock guard(this->mtx);
-    if (!guard.LOCK()) {
-        return NULL; // Block if unlocked.
+// Requires true for a large arg, or false for small, and if the reserved 
+// args of the class may be used, the small by busy replies only, the large
+// by replies that must fit the arg. Claims the lowest free arg of the size
+// class by clearing its bit, retrying if another task claims an arg first.
+// Returns a pointer to the arg, or NULL if no availabilities.
+async_resp_arg* argPool::getArg(bool large, bool reserve) {
+    uint32_t mask = classMask(large);
+
+    if (!reserve) { // Excludes the highest args of the class.
+        mask &= large ?
+            (1UL << (SKT_MAX_RESP_ARGS - SKT_LARGE_RESERVE)) - 1 :
+            (1UL << (SKT_SMALL_ARGS - SKT_SMALL_RESERVE)) - 1;
     }
 
-    // Iterate Pool, and if in use is false, changes flag to true, zeros it
-    // out, and returns a pointer to the pool.
-    for (int i = 0; i < SKT_MAX_RESP_ARGS; i++) {
-        if (!this->inUse[i]) {
-            this->inUse[i] = true;
+    uint32_t map = this->freeMap.load();
+
+    while (true) {
+        uint32_t avail = map & mask;
+        if (avail == 0) return NULL; // No avail.
+
+        uint32_t bit = avail & (~avail + 1); // Lowest free.
+
+        // Reloads map upon failure, another task claimed or released.
+        if (this->freeMap.compare_exchange_weak(map, map & ~bit)) {
+            int i = __builtin_ctz(bit);
             this->pool[i].signature = POOL_SIG; // Set to indicate active.
-            return &this->pool[i]; 
+            this->pool[i].retryMs = 0;
+
+            // Records the high water mark of the size class.
+            uint32_t used = __builtin_popcount(~(map & ~bit) & 
+                classMask(large));
+
+            uint32_t prev = this->peak[large].load();
+            while (used > prev && 
+                !this->peak[large].compare_exchange_weak(prev, used)) {}
+
+            return &this->pool[i];
         }
     }
-
-    return NULL; // No avail.
 }
 
-// Requires the argument pointer. Iterates pool to check the address of the
-// argument and the pool argument. If a match, changes the inuse flag to false
-// to allow re-allocation.
+// Requires the argument pointer. Computes the index from the address of the
+// argument, and sets its free bit to allow re-allocation. Ignores pointers
+// outside of the pool.
 void argPool::releaseArg(async_resp_arg* arg) {
-
-    Threads::MutexLock guard(this->mtx);
-    if (!guard.LOCK()) {
-        return; // Block if unlocked.
+    if (arg < &this->pool[0] || arg >= &this->pool[SKT_MAX_RESP_ARGS]) {
+        return; // Block, not a pool arg.
     }
 
-    // Iterates and changes flag to false if passed arg matches a pool arg.
-    for (int i = 0; i < SKT_MAX_RESP_ARGS; i++) {
-        if (&this->pool[i] == arg) {
-            this->inUse[i] = false;
-            this->pool[i].signature = 0; // Reset to zero indiating release
-            break;
-        }
-    }
+    int i = arg - &this->pool[0];
+    this->pool[i].signature = 0; // Reset to zero indiating release
+    this->freeMap.fetch_or(1UL << i); 
+}
+
+// Requires true for large args, or false for small, and references to used
+// and peakUsed. Populates the args of the size class in use, and the most
+// in use at once since boot.
+void argPool::usage(bool large, uint32_t &used, uint32_t &peakUsed) {
+    used = __builtin_popcount(~this->freeMap.load() & classMask(large));
+    peakUsed = this->peak[large].load();
 }
 
 // Requires the handle, request, and payload buffer. Parses request 
 // for an int command, int supplementary info, and char response id.
-// Once parsed, returns httpd_queue_work to put the response in the 
-// async queue. Returns ESP_FAIL if the data is improperly passed to
-// socket server or there are no available structs.
+// Once parsed, queues the command in the fast or slow lane of the socket 
+// task. Returns ESP_FAIL if the data is improperly passed to socket server,
+// or the client is replied busy, lacking a large arg or room in the lane.
 esp_err_t SOCKHAND::trigger_async_send(httpd_handle_t handle, httpd_req_t* req,
     async_resp_arg* arg) {
 
@@ -89,6 +134,35 @@ esp_err_t SOCKHAND::trigger_async_send(httpd_handle_t handle, httpd_req_t* req,
         return ESP_FAIL;
     }
 
+    // Frames are received into small args, exchanged for a large arg only
+    // if the reply requires it. The frame is carried over, BATCH parses the
+    // commands following the header from it. Streamed replies keep the small
+    // arg if no unreserved large arg is free, sent in more fragments rather
+    // than busy, leaving the reserve to replies that must fit.
+    if (SOCKHAND::largeReply(static_cast<CMDS>(cmd)) && 
+        arg->bufSize < SKT_BUF_SIZE) {
+
+        bool stream = SOCKHAND::streamed(static_cast<CMDS>(cmd), supp);
+        async_resp_arg* large = SOCKHAND::pool.getArg(true, !stream);
+
+        if (large != NULL) {
+            memcpy(large->Buf, arg->Buf, arg->bufSize); // Null terminated.
+            large->rcvd = arg->rcvd;
+            SOCKHAND::pool.releaseArg(arg);
+            arg = large;
+
+        } else if (!stream) {
+            snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+                "%s No available large pool args, cmd %d busy", 
+                SOCKHAND::tag, cmd);
+
+            MASTERHAND::sendErr(MASTERHAND::log);
+            arg->retryMs = SKT_BUSY_RETRY_MS;
+            SOCKHAND::queueBusy(req, arg);
+            return ESP_FAIL;
+        } // Else streamed through the small arg.
+    }
+
     // Set up the arg struct with the required data for the queue.
     arg->hd = req->handle; // hd = handle
     arg->fd = httpd_req_to_sockfd(req); // fd = file desriptor
@@ -96,7 +170,21 @@ esp_err_t SOCKHAND::trigger_async_send(httpd_handle_t handle, httpd_req_t* req,
     arg->data.suppData = supp; // Convert to str to int
     arg->data.idNum = id; // Will be between 0 and 255.
 
-    return httpd_queue_work(handle, SOCKHAND::ws_async_send, arg); 
+    // Commands that may change data can block on I2C or NVS.
+    bool slow = !SOCKHAND::readOnly(arg->data.cmd);
+
+    if (!SOCKHAND::queueJob(SOCKHAND::ws_async_send, arg, slow)) {
+        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+            "%s %s lane full, cmd %d busy", SOCKHAND::tag, 
+            slow ? "Slow" : "Fast", cmd);
+
+        MASTERHAND::sendErr(MASTERHAND::log);
+        arg->retryMs = SKT_BUSY_RETRY_MS; // Other lane, the one is full.
+        SOCKHAND::queueBusy(req, arg);
+        return ESP_FAIL;
+    }
+
+    return ESP_OK;
 }
 
 // Requires arg which will be cast to async_resp_arg. Once available, uses
@@ -118,7 +206,7 @@ void SOCKHAND::ws_async_send(void* arg) {
         return;
     }
 
-    size_t bufSize = sizeof(respArg->Buf);
+    size_t bufSize = respArg->bufSize;
  
     // ATTENTION. Not required to reset the buffer before compiling data, 
     // covered in the acquiring of the arg.
@@ -126,12 +214,33 @@ void SOCKHAND::ws_async_send(void* arg) {
     // compiles data by executing commands and populating the buffer with the
     // reply. This is the meat and potatoes of fulfilling the request and 
     // sending the reply.
-    SOCKHAND::compileData(respArg->data, (char*)respArg->Buf, bufSize);
+    // Text JSON, unless the client requested the binary format, or the reply
+    // was sent partly as fragments.
+    httpd_ws_type_t type = HTTPD_WS_TYPE_TEXT;
+    size_t len = 0;
+
+    if (respArg->retryMs > 0) { // Refused, not executed.
+        int written = snprintf((char*)respArg->Buf, bufSize, 
+            "{\"status\":0,\"msg\":\"Busy\",\"supp\":0,\"id\":%u,"
+            "\"retryMs\":%lu}", respArg->data.idNum, 
+            (unsigned long)respArg->retryMs);
+
+        len = (written > 0 && written < (int)bufSize) ? written : 0;
+
+    } else {
+        len = SOCKHAND::compileData(respArg->data, (char*)respArg->Buf, 
+            bufSize, respArg->hd, respArg->fd, &type);
+    }
 
     // Sets socket pakcet payload to buffer, to send back to client.
+    memset(&wsPkt, 0, sizeof(wsPkt));
     wsPkt.payload = respArg->Buf;
-    wsPkt.len = strlen((char*)respArg->Buf); // strlen of compiled data.
-    wsPkt.type = HTTPD_WS_TYPE_TEXT; // Ensures text type is sent back to client
+    wsPkt.len = len; // Length of compiled data.
+    wsPkt.type = type;
+
+    // Closes a fragmented reply.
+    wsPkt.fragmented = (type == HTTPD_WS_TYPE_CONTINUE);
+    wsPkt.final = true;
 
     // Async sends response once avaialable using the handle, file descriptor,
     // and the web socket packet.
@@ -143,6 +252,9 @@ void SOCKHAND::ws_async_send(void* arg) {
             "%s Skt err sending async response", SOCKHAND::tag);
         
         MASTERHAND::sendErr(MASTERHAND::log);
+
+    } else {
+        SOCKHAND::sessReply(respArg->fd, len, respArg->rcvd);
     }
 
     // printf("Sending: %s\n", wsPkt.payload); // Used for troubleshooting.
@@ -190,7 +302,8 @@ bool SOCKHAND::initCheck(httpd_req_t* req) {
 // and false if not.
 bool SOCKHAND::init(Peripheral::Relay* relays) {
 
-    SOCKHAND::isInit = (relays != nullptr); // Ensure no nullptr is passed.
+    // Ensure no nullptr is passed, and the socket task lanes are created.
+    SOCKHAND::isInit = (relays != nullptr) && SOCKHAND::initExec();
 
     if (isInit) { // init, send INFO log.
 
@@ -231,24 +344,11 @@ esp_err_t SOCKHAND::wsHandler(httpd_req_t* req) {
             "%s handshake complete", SOCKHAND::tag);
         
         MASTERHAND::sendErr(MASTERHAND::log, Messaging::Levels::INFO);
+        SOCKHAND::sessOpen(req->handle, httpd_req_to_sockfd(req));
         return ESP_OK;
     }
 
     // HANDSHAKE COMPLETE. Code block above will not run in follow on requests.
-    // Gets first open arg from the argPool. 
-    async_resp_arg* arg = SOCKHAND::pool.getArg(); 
-
-    if (arg == NULL) { // No availabilities
-
-        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
-            "%s No available pool args", SOCKHAND::tag);
-        
-        MASTERHAND::sendErr(MASTERHAND::log);
-        return ESP_OK; // NOTE 1. BLOCK.
-    }
-
-    // Handshake is complete, and argument is ready for use.
-
     httpd_ws_frame_t wsPkt; // Web socket packet
     memset(&wsPkt, 0, sizeof(httpd_ws_frame_t)); // zero out
     wsPkt.type = HTTPD_WS_TYPE_TEXT; // Set type to text.
@@ -264,12 +364,77 @@ esp_err_t SOCKHAND::wsHandler(httpd_req_t* req) {
             "%s httpd_ws_rec_frame failed to get frame length. %s", 
             SOCKHAND::tag, esp_err_to_name(ret));
         
+        MASTERHAND::sendErr(MASTERHAND::log);
+        return ESP_OK; // NOTE 1. BLOCK.
+    }
+
+    // Any frame, including a pong, marks the session alive.
+    int fd = httpd_req_to_sockfd(req);
+    SOCKHAND::sessRecv(req->handle, fd, wsPkt.len, 
+        wsPkt.type == HTTPD_WS_TYPE_TEXT);
+
+    if (wsPkt.type == HTTPD_WS_TYPE_PING || wsPkt.type == HTTPD_WS_TYPE_PONG ||
+        wsPkt.type == HTTPD_WS_TYPE_CLOSE) {
+
+        SOCKHAND::wsControl(req, wsPkt);
+        return ESP_OK; // NOTE 1. BLOCK.
+    }
+
+    // Gets first open arg from the argPool, if the session is within its
+    // rate limit. Small unless the frame exceeds it, such as a BATCH.
+    uint32_t retryMs = 0;
+    bool admitted = SOCKHAND::admit(fd, retryMs);
+
+    async_resp_arg* arg = admitted ? 
+        SOCKHAND::pool.getArg(wsPkt.len >= SKT_REPLY_SIZE) : NULL; 
+
+    if (arg == NULL) { // Rate limited, or no availabilities. Replies busy.
+
+        if (admitted) {
+            snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+                "%s No available pool args", SOCKHAND::tag);
+            
+            MASTERHAND::sendErr(MASTERHAND::log);
+            retryMs = SKT_BUSY_RETRY_MS;
+        }
+
+        arg = SOCKHAND::pool.getArg(false, true); // Reserved for busy.
+
+        if (arg == NULL) {
+            SOCKHAND::busyDropped.fetch_add(1);
+            return ESP_OK; // NOTE 1. BLOCK.
+        }
+
+        arg->retryMs = retryMs;
+    }
+
+    // Handshake is complete, and argument is ready for use.
+    arg->rcvd = esp_timer_get_time(); // Reply latency begins.
+    bool received = false; // Payload already copied to the arg.
+
+    if (wsPkt.len >= arg->bufSize && arg->retryMs > 0) { 
+
+        // Refused, exceeding the small busy arg. Only the cmd/supp/id prefix
+        // is required to reply busy.
+        if (!SOCKHAND::recvRefused(req, wsPkt, arg)) {
+            SOCKHAND::busyDropped.fetch_add(1);
+            SOCKHAND::pool.releaseArg(arg);
+            return ESP_OK; // NOTE 1. BLOCK.
+        }
+
+        received = true;
+
+    } else if (wsPkt.len >= arg->bufSize) { // Exceeds even a large arg.
+
+        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+            "%s frame len %zu exceeds buffer", SOCKHAND::tag, wsPkt.len);
+        
         MASTERHAND::sendErr(MASTERHAND::log);
         SOCKHAND::pool.releaseArg(arg); // Release arg if error.
         return ESP_OK; // NOTE 1. BLOCK.
     }
 
-    if (wsPkt.len) { // It exists.
+    if (wsPkt.len && !received) { // It exists.
 
         // Sets the payload to the pre-allocated buffer.
         wsPkt.payload = arg->Buf;
@@ -301,7 +466,14 @@ esp_err_t SOCKHAND::wsHandler(httpd_req_t* req) {
     // by request from the client. A
     if (wsPkt.type == HTTPD_WS_TYPE_TEXT) {
         // printf("From Client: %s\n", wsPkt.payload); // TS
-        SOCKHAND::trigger_async_send(req->handle, req, arg);
+        if (arg->retryMs > 0) {
+            SOCKHAND::queueBusy(req, arg);
+        } else {
+            SOCKHAND::trigger_async_send(req->handle, req, arg);
+        }
+
+    } else { // Binary and continuation frames carry no commands.
+        SOCKHAND::pool.releaseArg(arg);
     }
 
     return ESP_OK;
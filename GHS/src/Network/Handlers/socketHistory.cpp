@@ -0,0 +1,62 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "Network/Handlers/socketWire.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "string.h"
+
+namespace Comms {
+
+// Requires the reply id, first block sequence, buffer, and buffer size.
+// Writes the binary GET_HISTORY reply, a WireHdr, WireHistory, then each
+// block from seq on as a WireHistBlock and its bytes, as many as fit.
+// Sequences preceding the oldest block held begin at the oldest, those from
+// nextSeq on reply with no blocks. Returns the bytes written, or size if the
+// buffer is too small for the header.
+int SOCKHAND::wireHistory(uint16_t idNum, int seq, uint8_t* buffer,
+    size_t size) {
+
+    const size_t head = sizeof(WireHdr) + sizeof(WireHistory);
+    if (head >= size) return size;
+
+    Peripheral::TimeSeries* series = Peripheral::TimeSeries::get();
+    WireHistory hist{0, 0, 0};
+    uint32_t first{0}, end{0}; // Sequences held, see getHistBlock.
+    size_t len = head;
+    uint32_t next = static_cast<uint32_t>(seq);
+
+    while (hist.qty < UINT8_MAX) {
+        WireHistBlock blk{next, 0};
+        size_t room = size - len; // Keeps size greater than len.
+        if (room <= sizeof(blk) + 1) break;
+
+        size_t bytes = series->getHistBlock(next,
+            buffer + len + sizeof(blk), room - sizeof(blk) - 1,
+            first, end);
+
+        if (bytes == 0) { // Evicted, exceeds the buffer, or none remain.
+            if (next < first && hist.qty == 0) {
+                next = first; // Begins at the oldest held.
+                continue;
+            }
+
+            break;
+        }
+
+        blk.len = static_cast<uint16_t>(bytes);
+        memcpy(buffer + len, &blk, sizeof(blk));
+        len += sizeof(blk) + bytes;
+        hist.qty++;
+        next++;
+    }
+
+    hist.firstSeq = first;
+    hist.nextSeq = end;
+
+    WireHdr hdr{SKT_WIRE_VERSION, WireType::HISTORY, idNum,
+        static_cast<uint16_t>(len - sizeof(WireHdr))};
+
+    memcpy(buffer, &hdr, sizeof(hdr));
+    memcpy(buffer + sizeof(hdr), &hist, sizeof(hist));
+    return len;
+}
+
+}
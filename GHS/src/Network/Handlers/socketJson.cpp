@@ -0,0 +1,182 @@
+#include "Network/Handlers/socketJson.hpp"
+#include "string.h"
+#include "stdio.h"
+#include "Network/Handlers/MasterHandler.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Comms {
+
+// Requires the buffer and buffer size. Optional handle and file descriptor
+// of the socket, which allows replies exceeding the buffer to be sent as
+// fragments.
+JsonStream::JsonStream(char* buf, size_t size, httpd_handle_t hd, int fd) :
+
+    buf(buf), size(size), len(0), hd(hd), fd(fd), comma(false),
+    sent(false), err(false) {
+
+    if (this->size > 0) this->buf[0] = '\0';
+}
+
+// Requires no params. Sends the written portion of the buffer as a non-final
+// fragment, and resets the buffer. Returns true if sent, false if there is
+// no socket, or the send failed.
+bool JsonStream::flush() {
+    if (this->hd == nullptr || this->len == 0) return false;
+
+    httpd_ws_frame_t wsPkt;
+    memset(&wsPkt, 0, sizeof(wsPkt));
+    wsPkt.payload = reinterpret_cast<uint8_t*>(this->buf);
+    wsPkt.len = this->len;
+    wsPkt.type = this->sent ? HTTPD_WS_TYPE_CONTINUE : HTTPD_WS_TYPE_TEXT;
+    wsPkt.fragmented = true;
+    wsPkt.final = false;
+
+    if (httpd_ws_send_frame_async(this->hd, this->fd, &wsPkt) != ESP_OK) {
+        char log[64];
+        snprintf(log, sizeof(log), "%s fd %d err sending fragment", JSON_TAG,
+            this->fd);
+
+        Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::HTTP,
+            Messaging::Levels::ERROR, log, MHAND_LOG_METHOD);
+
+        this->hd = nullptr; // Blocks further fragments.
+        return false;
+    }
+
+    this->len = 0;
+    this->sent = true;
+    return true;
+}
+
+// Requires bytes to be written. Flushes the buffer if they do not fit.
+// Returns true if they fit, false if not, marking the reply in error.
+bool JsonStream::reserve(size_t bytes) {
+    if (this->err) return false;
+    if (this->len + bytes < this->size) return true; // Room for null term.
+
+    if (bytes < this->size && this->flush()) return true;
+
+    this->err = true;
+    return false;
+}
+
+// Requires no params. Writes a comma if preceded by a value.
+void JsonStream::sep() {
+    if (this->comma) this->raw(",");
+    this->comma = false;
+}
+
+// Requires the string. Writes it as is, flushing as the buffer fills.
+void JsonStream::raw(const char* str) {
+    size_t remaining = strlen(str);
+
+    while (remaining > 0) {
+        if (!this->reserve(1)) return;
+
+        size_t room = this->size - this->len - 1;
+        size_t chunk = (remaining < room) ? remaining : room;
+
+        memcpy(&this->buf[this->len], str, chunk);
+        this->len += chunk;
+        str += chunk;
+        remaining -= chunk;
+    }
+
+    this->buf[this->len] = '\0';
+}
+
+// Requires the key. Writes "key":, the value follows.
+void JsonStream::key(const char* key) {
+    this->sep();
+    this->raw("\"");
+    this->raw(key);
+    this->raw("\":");
+}
+
+// Requires the opening bracket, { or [.
+void JsonStream::open(char bracket) {
+    const char str[2] = {bracket, '\0'};
+    this->sep();
+    this->raw(str);
+}
+
+// Requires the closing bracket, } or ].
+void JsonStream::close(char bracket) {
+    const char str[2] = {bracket, '\0'};
+    this->raw(str);
+    this->comma = true;
+}
+
+// Requires a complete JSON value, such as an object. Writes it as is, as the
+// value of a key or element of an array.
+void JsonStream::json(const char* val) {
+    this->sep();
+    this->raw(val);
+    this->comma = true;
+}
+
+// Requires the value. Formats it directly into the buffer.
+void JsonStream::num(int32_t val) {
+    this->sep();
+    if (!this->reserve(JSON_NUM_MAX)) return;
+
+    this->len += snprintf(&this->buf[this->len], JSON_NUM_MAX, "%ld",
+        (long)val);
+
+    this->comma = true;
+}
+
+// Requires the value. Formats it directly into the buffer.
+void JsonStream::num(uint32_t val) {
+    this->sep();
+    if (!this->reserve(JSON_NUM_MAX)) return;
+
+    this->len += snprintf(&this->buf[this->len], JSON_NUM_MAX, "%lu",
+        (unsigned long)val);
+
+    this->comma = true;
+}
+
+// Requires the value, and decimal places. Formats it directly into the
+// buffer.
+void JsonStream::num(float val, uint8_t decimals) {
+    this->sep();
+    if (!this->reserve(JSON_NUM_MAX)) return;
+
+    int written = snprintf(&this->buf[this->len], JSON_NUM_MAX, "%0.*f",
+        decimals, val);
+
+    // Out of range values are clamped, keeping the reply valid JSON.
+    if (written <= 0 || written >= JSON_NUM_MAX) {
+        written = snprintf(&this->buf[this->len], JSON_NUM_MAX, "0");
+    }
+
+    this->len += written;
+    this->comma = true;
+}
+
+// Requires the value, and decimal places. Writes an array element, see arr.
+void JsonStream::elem(float val, uint8_t dec) {
+    this->num(val, dec);
+}
+
+// Requires the value, decimal places are unused. See arr.
+void JsonStream::elem(uint16_t val, uint8_t) {
+    this->num((uint32_t)val);
+}
+
+// Requires the value, decimal places are unused. See arr.
+void JsonStream::elem(int16_t val, uint8_t) {
+    this->num((int32_t)val);
+}
+
+// Requires reference to fragmented. Sets fragmented true if fragments were
+// sent, the remainder in the buffer must then be sent as the final
+// HTTPD_WS_TYPE_CONTINUE fragment. Returns the bytes remaining in the buffer,
+// or the buffer size if truncated, as snprintf.
+int JsonStream::finish(bool &fragmented) {
+    fragmented = this->sent;
+    return this->err ? this->size : this->len;
+}
+
+}
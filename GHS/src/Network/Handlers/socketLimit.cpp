@@ -0,0 +1,141 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "stdio.h"
+#include "esp_timer.h"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Comms {
+
+// Static Setup
+std::atomic<uint32_t> SOCKHAND::lanePeak[2]{{0}, {0}};
+std::atomic<uint32_t> SOCKHAND::laneFull{0};
+std::atomic<uint32_t> SOCKHAND::busySent{0};
+std::atomic<uint32_t> SOCKHAND::busyDropped{0};
+
+// Requires the file descriptor, and reference to retryMs. Refills the token
+// bucket of the session at SKT_RATE_CMDS per second, up to SKT_RATE_BURST,
+// and takes a token for the frame. Returns true if admitted, false if the
+// bucket is empty, setting retryMs to the millis until the next token.
+// Untracked sessions are always admitted.
+bool SOCKHAND::admit(int fd, uint32_t &retryMs) {
+    Threads::MutexLock guard(SOCKHAND::sessMtx);
+    if (!guard.LOCK()) return true; // Never refuse upon a lock timeout.
+
+    sktSess* sess{nullptr};
+
+    for (size_t i = 0; i < SKT_MAX_SESS; i++) {
+        if (SOCKHAND::sessions[i].active && SOCKHAND::sessions[i].fd == fd) {
+            sess = &SOCKHAND::sessions[i];
+            break;
+        }
+    }
+
+    if (sess == nullptr) return true;
+
+    // Tokens are in thousandths, SKT_RATE_CMDS per second is equal to
+    // SKT_RATE_CMDS thousandths per milli.
+    int64_t now = esp_timer_get_time() / 1000;
+    int64_t refill = (now - sess->refilled) * SKT_RATE_CMDS;
+    int64_t tokens = sess->tokens + refill;
+
+    if (tokens > SKT_RATE_BURST * 1000) tokens = SKT_RATE_BURST * 1000;
+    sess->refilled = now;
+
+    if (tokens >= 1000) {
+        sess->tokens = tokens - 1000;
+        return true;
+    }
+
+    sess->tokens = tokens;
+    sess->limited++;
+    retryMs = (1000 - tokens + SKT_RATE_CMDS - 1) / SKT_RATE_CMDS; // Ceil.
+    return false;
+}
+
+// Requires the request, and the arg holding the received frame with its
+// retryMs set. Parses the id of the frame, and queues the busy reply in the
+// lane its command would have used, so it is ordered with the replies to the
+// socket as the reply of the command would be. If that lane is full, the
+// reply takes the other lane, unordered, matched by its id. Releases the arg
+// if the frame is invalid or both lanes are full.
+void SOCKHAND::queueBusy(httpd_req_t* req, async_resp_arg* arg) {
+    int cmd = -1, supp = -1, id = -1;
+    int parsed = sscanf((char*)arg->Buf, "%d/%d/%d", &cmd, &supp, &id);
+
+    if (parsed != 3) { // Unable to reply without the id.
+        SOCKHAND::busyDropped.fetch_add(1);
+        SOCKHAND::pool.releaseArg(arg);
+        return;
+    }
+
+    arg->hd = req->handle;
+    arg->fd = httpd_req_to_sockfd(req);
+    arg->data.cmd = static_cast<CMDS>(cmd);
+    arg->data.suppData = supp;
+    arg->data.idNum = id;
+
+    bool slow = !SOCKHAND::readOnly(arg->data.cmd);
+
+    if (!SOCKHAND::queueJob(SOCKHAND::ws_async_send, arg, slow) &&
+        !SOCKHAND::queueJob(SOCKHAND::ws_async_send, arg, !slow)) {
+        SOCKHAND::busyDropped.fetch_add(1);
+        SOCKHAND::pool.releaseArg(arg);
+        return;
+    }
+
+    SOCKHAND::busySent.fetch_add(1);
+}
+
+// Requires the request, the frame with its length, and the busy arg. Receives
+// a refused frame exceeding the arg, such as a BATCH, into a scratch buffer,
+// and copies its prefix, holding the cmd/supp/id of the busy reply, into the
+// arg, null terminated. The scratch is static, the httpd task runs handlers
+// serially. Returns true if received, false if the frame exceeds 
+// SKT_BUF_SIZE or the receive fails.
+bool SOCKHAND::recvRefused(httpd_req_t* req, httpd_ws_frame_t &wsPkt,
+    async_resp_arg* arg) {
+
+    static uint8_t scratch[SKT_BUF_SIZE];
+    if (wsPkt.len > sizeof(scratch)) return false;
+
+    wsPkt.payload = scratch;
+    if (httpd_ws_recv_frame(req, &wsPkt, sizeof(scratch)) != ESP_OK) {
+        return false;
+    }
+
+    size_t len = (wsPkt.len < arg->bufSize) ? wsPkt.len : arg->bufSize - 1;
+    memcpy(arg->Buf, scratch, len);
+    ((char*)arg->Buf)[len] = '\0';
+    return true;
+}
+
+// Requires the reply id, buffer, and buffer size. Writes the GET_LOAD reply,
+// compact to fit a small arg, available while the large args are exhausted.
+// See CMDS::GET_LOAD. Returns the reply length, as snprintf.
+int SOCKHAND::compileLoad(uint16_t idNum, char* buffer, size_t size) {
+    uint32_t small{0}, smallPeak{0}, large{0}, largePeak{0};
+    SOCKHAND::pool.usage(false, small, smallPeak);
+    SOCKHAND::pool.usage(true, large, largePeak);
+
+    uint32_t fast = (SOCKHAND::fastQ != nullptr) ?
+        uxQueueMessagesWaiting(SOCKHAND::fastQ) : 0;
+
+    uint32_t slow = (SOCKHAND::slowQ != nullptr) ?
+        uxQueueMessagesWaiting(SOCKHAND::slowQ) : 0;
+
+    return snprintf(buffer, size,
+        "{\"id\":%u,\"args\":[%lu,%lu,%d,%lu,%lu,%d],"
+        "\"lanes\":[%lu,%lu,%lu,%lu,%d],\"full\":%lu,\"busy\":%lu,"
+        "\"drop\":%lu}",
+        idNum, (unsigned long)small, (unsigned long)smallPeak,
+        SKT_SMALL_ARGS, (unsigned long)large, (unsigned long)largePeak,
+        SKT_LARGE_ARGS, (unsigned long)fast,
+        (unsigned long)SOCKHAND::lanePeak[0].load(), (unsigned long)slow,
+        (unsigned long)SOCKHAND::lanePeak[1].load(), SKT_EXEC_DEPTH,
+        (unsigned long)SOCKHAND::laneFull.load(),
+        (unsigned long)SOCKHAND::busySent.load(),
+        (unsigned long)SOCKHAND::busyDropped.load());
+}
+
+}
@@ -0,0 +1,204 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "esp_timer.h"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Comms {
+
+// Static Setup
+sktSub SOCKHAND::subs[SKT_MAX_SUBS]{};
+httpd_handle_t SOCKHAND::pushHd{nullptr};
+std::atomic<uint32_t> SOCKHAND::updates{0};
+std::atomic<bool> SOCKHAND::pushQueued{false};
+Threads::Mutex SOCKHAND::subMtx(SUB_TAG);
+
+// Requires the handle, file descriptor, and seconds between pushes. Adds
+// the socket to the subscribers, or updates its period if subscribed. The
+// next completed read cycle is pushed immediately. Returns true if
+// subscribed, false if the subscribers are full or locked.
+bool SOCKHAND::subscribe(httpd_handle_t hd, int fd, uint32_t periodS) {
+    Threads::MutexLock guard(SOCKHAND::subMtx);
+    if (!guard.LOCK()) return false;
+
+    sktSub* slot = nullptr;
+
+    for (size_t i = 0; i < SKT_MAX_SUBS; i++) {
+        sktSub &sub = SOCKHAND::subs[i];
+
+        if (sub.active && sub.fd == fd) { // Already subscribed.
+            slot = &sub;
+            break;
+        }
+
+        if (slot == nullptr && !sub.active) {
+            slot = &sub;
+        }
+    }
+
+    if (slot == nullptr) return false; // Full.
+
+    slot->active = true;
+    slot->fd = fd;
+    slot->periodMs = periodS * 1000;
+    slot->lastPush = 0;
+    slot->sentUpdate = SOCKHAND::updates.load() - 1; // Due upon next cycle.
+    slot->deltaVer = 0; // First push includes all fields.
+    SOCKHAND::pushHd = hd; // Single server, same for every subscriber.
+    return true;
+}
+
+// Requires the file descriptor. Removes the socket from the subscribers.
+// Returns true if it was subscribed, false if not or locked.
+bool SOCKHAND::unsubscribe(int fd) {
+    Threads::MutexLock guard(SOCKHAND::subMtx);
+    if (!guard.LOCK()) return false;
+
+    for (size_t i = 0; i < SKT_MAX_SUBS; i++) {
+        if (SOCKHAND::subs[i].active && SOCKHAND::subs[i].fd == fd) {
+            SOCKHAND::subs[i].active = false;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Requires the subscriber, current update count, and millis. Returns true
+// if a read cycle has completed since its latest push, and its period has
+// elapsed. Caller must hold subMtx.
+bool SOCKHAND::pushDue(const sktSub &sub, uint32_t update, int64_t now) {
+    return (sub.active && sub.sentUpdate != update &&
+        (now - sub.lastPush) >= sub.periodMs);
+}
+
+// Requires no params. Called by each peripheral task upon completing a read
+// cycle, marking new data for the subscribers. Non-blocking.
+void SOCKHAND::notify() {
+    SOCKHAND::updates.fetch_add(1);
+}
+
+// Requires no params. Called by the net task. If any subscriber is due a
+// push, queues a single GET_ALL compile and send in the fast lane of the 
+// socket task. Only one push is queued at a time, and a missed push is 
+// retried upon the next call.
+void SOCKHAND::push() {
+    if (SOCKHAND::pushQueued.load()) return; // Previous push pending.
+
+    uint32_t update = SOCKHAND::updates.load();
+    int64_t now = esp_timer_get_time() / 1000;
+    httpd_handle_t hd{nullptr};
+
+    { // Scope guard.
+        Threads::MutexLock guard(SOCKHAND::subMtx);
+        if (!guard.LOCK()) return;
+
+        for (size_t i = 0; i < SKT_MAX_SUBS; i++) {
+            if (SOCKHAND::pushDue(SOCKHAND::subs[i], update, now)) {
+                hd = SOCKHAND::pushHd;
+                break;
+            }
+        }
+    }
+
+    if (hd == nullptr) return; // None due.
+
+    async_resp_arg* arg = SOCKHAND::pool.getArg(true, true); // Must fit.
+    if (arg == NULL) return; // Busy, retries upon next call.
+
+    arg->hd = hd;
+    arg->fd = -1; // Sent to each subscriber.
+    arg->data.cmd = CMDS::GET_ALL;
+    arg->data.suppData = 0;
+    arg->data.idNum = SKT_PUSH_ID;
+
+    SOCKHAND::pushQueued.store(true);
+
+    if (!SOCKHAND::queueJob(SOCKHAND::ws_push_send, arg, false)) {
+        SOCKHAND::pushQueued.store(false);
+        SOCKHAND::pool.releaseArg(arg);
+    }
+}
+
+// Requires arg which will be cast to async_resp_arg. Runs on the socket task.
+// Compiles the GET_ALL fields once, and sends each subscriber that is due
+// the GET_DELTA reply of the fields changed since its previous push. 
+// Subscribers whose socket is no longer a websocket, or that fail to send,
+// are removed.
+void SOCKHAND::ws_push_send(void* arg) {
+    struct async_resp_arg* respArg = static_cast<async_resp_arg*>(arg);
+
+    if (respArg->signature != POOL_SIG) {
+        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+            "%s push arg invalid", SOCKHAND::tag);
+
+        MASTERHAND::sendErr(MASTERHAND::log);
+        SOCKHAND::pool.releaseArg(respArg);
+        SOCKHAND::pushQueued.store(false);
+        return;
+    }
+
+    struct dueSub {int fd; uint32_t since;};
+    dueSub due[SKT_MAX_SUBS]; // Copied out, not locked while sending.
+    size_t dueQty = 0;
+
+    // Captured before compiling, a cycle completing during the compile is
+    // pushed next time.
+    uint32_t update = SOCKHAND::updates.load();
+    int64_t now = esp_timer_get_time() / 1000;
+
+    Threads::MutexLock deltaGuard(SOCKHAND::deltaMtx); // Held until sent.
+    bool compiled = deltaGuard.LOCK() && SOCKHAND::updateDelta();
+
+    if (compiled) { // Scope guard.
+        Threads::MutexLock guard(SOCKHAND::subMtx);
+        if (guard.LOCK()) {
+            for (size_t i = 0; i < SKT_MAX_SUBS; i++) {
+                sktSub &sub = SOCKHAND::subs[i];
+                if (!SOCKHAND::pushDue(sub, update, now)) continue;
+
+                due[dueQty++] = {sub.fd, sub.deltaVer};
+                sub.lastPush = now;
+                sub.sentUpdate = update;
+                sub.deltaVer = SOCKHAND::deltaVer;
+            }
+        }
+    }
+
+    httpd_ws_frame_t wsPkt;
+    memset(&wsPkt, 0, sizeof(wsPkt));
+    wsPkt.payload = respArg->Buf;
+    wsPkt.type = HTTPD_WS_TYPE_TEXT;
+
+    for (size_t i = 0; i < dueQty; i++) {
+        int written = SOCKHAND::renderDelta(due[i].since, SKT_PUSH_ID, 
+            (char*)respArg->Buf, respArg->bufSize);
+
+        if (written <= 0 || written >= (int)respArg->bufSize) continue;
+        wsPkt.len = written;
+
+        // Closed sockets, or descriptors reused by a plain http client,
+        // are no longer subscribed.
+        bool isWS = (httpd_ws_get_fd_info(respArg->hd, due[i].fd) ==
+            HTTPD_WS_CLIENT_WEBSOCKET);
+
+        if (isWS && httpd_ws_send_frame_async(respArg->hd, due[i].fd,
+            &wsPkt) == ESP_OK) {
+
+            SOCKHAND::sessReply(due[i].fd, written, 0); // Not a reply.
+            continue;
+        }
+
+        SOCKHAND::unsubscribe(due[i].fd);
+        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+            "%s fd %d unsubscribed, socket closed", SOCKHAND::tag,
+            due[i].fd);
+
+        MASTERHAND::sendErr(MASTERHAND::log, Messaging::Levels::INFO);
+    }
+
+    SOCKHAND::pool.releaseArg(respArg); // Release from arg Pool once done.
+    SOCKHAND::pushQueued.store(false);
+}
+
+}
@@ -0,0 +1,84 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "Network/Handlers/socketJson.hpp"
+#include "Peripherals/TimeSeries.hpp"
+
+namespace Comms {
+
+// Requires the reply id, tier resolution index, see TSRes, quantity of
+// buckets, buffer, buffer size, handle and file descriptor of the socket,
+// and reference to fragmented. Writes the aggregates of the newest qty
+// buckets of the tier, newest first. Format {"id":n,"res":bucket secs,
+// "ageMs":millis since the newest closed,"ch":[names],"b":[[[min,max,mean,
+// count] or null if no readings, per channel],...],"qty":buckets written}.
+// Buckets are read one at a time, qty is lower than requested if the tier
+// holds fewer. Returns the reply length as snprintf, or -1 if out of range.
+int SOCKHAND::compileSeries(uint16_t idNum, int res, int qty, char* buffer,
+    size_t size, httpd_handle_t hd, int fd, bool &fragmented) {
+
+    using namespace Peripheral;
+    fragmented = false;
+
+    if (!SOCKHAND::inRange(0, TS_RES_QTY - 1, res)) return -1;
+
+    TSRes tier = static_cast<TSRes>(res);
+    if (!SOCKHAND::inRange(1, TimeSeries::capacity(tier), qty)) return -1;
+
+    TimeSeries* series = TimeSeries::get();
+    uint32_t ageMs{0};
+    uint32_t next = series->getNewest(tier, ageMs); // Sequence of newest + 1.
+    uint32_t written{0};
+    TSRow row;
+
+    JsonStream js(buffer, size, hd, fd);
+    js.open('{');
+    js.key("id"); js.num((uint32_t)idNum);
+    js.key("res"); js.num(TimeSeries::bucketSecs(tier));
+    js.key("ageMs"); js.num(ageMs);
+    js.key("ch");
+    js.open('[');
+
+    for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+        js.raw(c > 0 ? ",\"" : "\"");
+        js.raw(TSCodec::info[c].name);
+        js.raw("\"");
+    }
+
+    js.close(']');
+    js.key("b");
+    js.open('[');
+
+    // Sequences remain valid as buckets close while streaming.
+    while (written < (uint32_t)qty && written < next) {
+        if (!series->getRow(tier, next - 1 - written, row)) break;
+
+        js.open('[');
+
+        for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+            const TSBucket &bkt = row.ch[c];
+            uint8_t dec = TSCodec::info[c].dec;
+
+            if (bkt.count == 0) {
+                js.json("null");
+                continue;
+            }
+
+            js.open('[');
+            js.num(TSCodec::decode(c, bkt.min), dec);
+            js.num(TSCodec::decode(c, bkt.max), dec);
+            js.num(TSCodec::decode(c, bkt.mean), dec);
+            js.num((uint32_t)bkt.count);
+            js.close(']');
+        }
+
+        js.close(']');
+        written++;
+    }
+
+    js.close(']');
+    js.key("qty"); js.num(written);
+    js.close('}');
+
+    return js.finish(fragmented);
+}
+
+}
@@ -0,0 +1,271 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "string.h"
+#include "esp_timer.h"
+#include "Threads/Mutex.hpp"
+#include "Network/Handlers/socketJson.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Comms {
+
+// Static Setup
+sktSess SOCKHAND::sessions[SKT_MAX_SESS]{};
+uint32_t SOCKHAND::sessPeak{0};
+uint32_t SOCKHAND::sessReaped{0};
+uint32_t SOCKHAND::sessDropped{0};
+int64_t SOCKHAND::lastPing{0};
+Threads::Mutex SOCKHAND::sessMtx(SESS_TAG);
+
+// Requires the file descriptor. Returns the session of the fd, or nullptr if
+// untracked. Caller must hold sessMtx.
+static sktSess* sessFind(sktSess* sessions, int fd) {
+    for (size_t i = 0; i < SKT_MAX_SESS; i++) {
+        if (sessions[i].active && sessions[i].fd == fd) return &sessions[i];
+    }
+
+    return nullptr;
+}
+
+// Requires the handle and file descriptor. Tracks the session upon its
+// handshake, resetting the counters if the fd is reused. Sessions exceeding
+// SKT_MAX_SESS are untracked and counted as dropped.
+void SOCKHAND::sessOpen(httpd_handle_t hd, int fd) {
+    Threads::MutexLock guard(SOCKHAND::sessMtx);
+    if (!guard.LOCK()) return;
+
+    sktSess* slot = sessFind(SOCKHAND::sessions, fd);
+    uint32_t open = 0;
+
+    for (size_t i = 0; i < SKT_MAX_SESS; i++) {
+        sktSess &sess = SOCKHAND::sessions[i];
+        if (sess.active) open++;
+        if (slot == nullptr && !sess.active) slot = &sess;
+    }
+
+    if (slot == nullptr) { // Full.
+        SOCKHAND::sessDropped++;
+        return;
+    }
+
+    if (!slot->active) open++;
+    if (open > SOCKHAND::sessPeak) SOCKHAND::sessPeak = open;
+
+    int64_t now = esp_timer_get_time() / 1000;
+    memset(slot, 0, sizeof(sktSess));
+    slot->active = true;
+    slot->hd = hd;
+    slot->fd = fd;
+    slot->opened = now;
+    slot->lastActive = now;
+    slot->tokens = SKT_RATE_BURST * 1000;
+    slot->refilled = now;
+}
+
+// Requires the file descriptor. Stops tracking the session.
+void SOCKHAND::sessClose(int fd) {
+    Threads::MutexLock guard(SOCKHAND::sessMtx);
+    if (!guard.LOCK()) return;
+
+    sktSess* sess = sessFind(SOCKHAND::sessions, fd);
+    if (sess != nullptr) sess->active = false;
+}
+
+// Requires the handle, file descriptor, frame length, and if the frame is a
+// command. Called upon each frame received, marking the session alive.
+// Sessions opened prior to a full table are tracked once a slot frees.
+void SOCKHAND::sessRecv(httpd_handle_t hd, int fd, size_t len, bool isCmd) {
+    sktSess* sess{nullptr};
+
+    { // Scope guard.
+        Threads::MutexLock guard(SOCKHAND::sessMtx);
+        if (!guard.LOCK()) return;
+        sess = sessFind(SOCKHAND::sessions, fd);
+    }
+
+    if (sess == nullptr) SOCKHAND::sessOpen(hd, fd); // Untracked.
+
+    Threads::MutexLock guard(SOCKHAND::sessMtx);
+    if (!guard.LOCK()) return;
+
+    sess = sessFind(SOCKHAND::sessions, fd);
+    if (sess == nullptr) return; // Still full.
+
+    sess->missed = 0;
+    sess->lastActive = esp_timer_get_time() / 1000;
+    sess->bytesIn += len;
+    if (isCmd) sess->cmds++;
+}
+
+// Requires the file descriptor, reply length, and micros the command was
+// received, or 0 if the frame is not a reply, such as a push.
+void SOCKHAND::sessReply(int fd, size_t len, int64_t rcvd) {
+    Threads::MutexLock guard(SOCKHAND::sessMtx);
+    if (!guard.LOCK()) return;
+
+    sktSess* sess = sessFind(SOCKHAND::sessions, fd);
+    if (sess == nullptr) return;
+
+    sess->bytesOut += len;
+    if (rcvd <= 0) return;
+
+    sess->replies++;
+    sess->latencyUs += esp_timer_get_time() - rcvd;
+}
+
+// Requires no params. Called by the socket task. Every SKT_PING_S, pings
+// each session, and closes those that missed SKT_PING_MISS pings in a row.
+// Sessions whose socket is already closed are removed. Sends are made
+// outside of the lock, pongs may arrive before the sweep completes.
+void SOCKHAND::keepAlive() {
+    int64_t now = esp_timer_get_time() / 1000;
+
+    struct pingSess {httpd_handle_t hd; int fd; bool reap;};
+    pingSess due[SKT_MAX_SESS]; // Copied out, not locked while sending.
+    size_t dueQty = 0;
+
+    { // Scope guard.
+        Threads::MutexLock guard(SOCKHAND::sessMtx);
+        if (!guard.LOCK()) return;
+
+        if ((now - SOCKHAND::lastPing) < (SKT_PING_S * 1000)) return;
+        SOCKHAND::lastPing = now;
+
+        for (size_t i = 0; i < SKT_MAX_SESS; i++) {
+            sktSess &sess = SOCKHAND::sessions[i];
+            if (!sess.active) continue;
+
+            bool reap = (sess.missed >= SKT_PING_MISS);
+            due[dueQty++] = {sess.hd, sess.fd, reap};
+
+            if (reap) {
+                sess.active = false;
+            } else {
+                sess.missed++; // Reset by the pong.
+            }
+        }
+    }
+
+    httpd_ws_frame_t wsPkt;
+    memset(&wsPkt, 0, sizeof(wsPkt));
+    wsPkt.type = HTTPD_WS_TYPE_PING;
+    wsPkt.final = true;
+
+    for (size_t i = 0; i < dueQty; i++) {
+        pingSess &ps = due[i];
+
+        // Closed by the client, or purged by httpd.
+        if (httpd_ws_get_fd_info(ps.hd, ps.fd) != HTTPD_WS_CLIENT_WEBSOCKET) {
+            SOCKHAND::sessClose(ps.fd);
+            SOCKHAND::unsubscribe(ps.fd);
+            continue;
+        }
+
+        if (!ps.reap) {
+            if (httpd_ws_send_frame_async(ps.hd, ps.fd, &wsPkt) != ESP_OK) {
+                SOCKHAND::sessClose(ps.fd);
+                SOCKHAND::unsubscribe(ps.fd);
+            }
+
+            continue;
+        }
+
+        SOCKHAND::unsubscribe(ps.fd);
+        esp_err_t closed = httpd_sess_trigger_close(ps.hd, ps.fd);
+
+        { // Scope guard.
+            Threads::MutexLock guard(SOCKHAND::sessMtx);
+            if (guard.LOCK()) SOCKHAND::sessReaped++;
+        }
+
+        snprintf(MASTERHAND::log, sizeof(MASTERHAND::log),
+            "%s fd %d reaped, %d pings missed. %s", SESS_TAG, ps.fd,
+            SKT_PING_MISS, esp_err_to_name(closed));
+
+        MASTERHAND::sendErr(MASTERHAND::log, Messaging::Levels::INFO);
+    }
+}
+
+// Requires the reply id, buffer, buffer size, handle and file descriptor of
+// the socket, and reference to fragmented. Writes the GET_SESSIONS reply,
+// see CMDS::GET_SESSIONS. Returns the reply length, as snprintf.
+int SOCKHAND::compileSessions(uint16_t idNum, char* buffer, size_t size,
+    httpd_handle_t hd, int fd, bool &fragmented) {
+
+    sktSess copy[SKT_MAX_SESS]; // Copied out, not locked while streaming.
+    uint32_t peak{0}, reaped{0}, dropped{0}, open{0};
+
+    { // Scope guard.
+        Threads::MutexLock guard(SOCKHAND::sessMtx);
+        if (!guard.LOCK()) return -1;
+
+        memcpy(copy, SOCKHAND::sessions, sizeof(copy));
+        peak = SOCKHAND::sessPeak;
+        reaped = SOCKHAND::sessReaped;
+        dropped = SOCKHAND::sessDropped;
+    }
+
+    for (size_t i = 0; i < SKT_MAX_SESS; i++) if (copy[i].active) open++;
+    int64_t now = esp_timer_get_time() / 1000;
+
+    JsonStream js(buffer, size, hd, fd);
+    js.open('{');
+    js.key("id"); js.num((uint32_t)idNum);
+    js.key("open"); js.num(open);
+    js.key("peak"); js.num(peak);
+    js.key("reaped"); js.num(reaped);
+    js.key("dropped"); js.num(dropped);
+    js.key("sess");
+    js.open('[');
+
+    for (size_t i = 0; i < SKT_MAX_SESS; i++) {
+        const sktSess &sess = copy[i];
+        if (!sess.active) continue;
+
+        uint32_t latency = (sess.replies > 0) ?
+            (uint32_t)(sess.latencyUs / sess.replies) : 0;
+
+        js.open('{');
+        js.key("fd"); js.num((int32_t)sess.fd);
+        js.key("cmds"); js.num(sess.cmds);
+        js.key("in"); js.num(sess.bytesIn);
+        js.key("out"); js.num(sess.bytesOut);
+        js.key("latUs"); js.num(latency);
+        js.key("idleMs"); js.num((uint32_t)(now - sess.lastActive));
+        js.key("ageS"); js.num((uint32_t)((now - sess.opened) / 1000));
+        js.key("missed"); js.num((uint32_t)sess.missed);
+        js.key("limited"); js.num(sess.limited);
+        js.close('}');
+    }
+
+    js.close(']');
+    js.close('}');
+
+    return js.finish(fragmented);
+}
+
+// Requires the request, and the control frame with its length. Reads the
+// payload, replies to a ping with a pong, and to a close with a close,
+// ending the session. Pongs only mark the session alive, see sessRecv.
+void SOCKHAND::wsControl(httpd_req_t* req, httpd_ws_frame_t &wsPkt) {
+    uint8_t payload[SKT_CTRL_MAX]{0}; // Control frames are limited by RFC.
+    int fd = httpd_req_to_sockfd(req);
+
+    if (wsPkt.len > 0) { // Must be read, or is parsed as the next frame.
+        if (wsPkt.len > sizeof(payload)) return;
+        wsPkt.payload = payload;
+        if (httpd_ws_recv_frame(req, &wsPkt, wsPkt.len) != ESP_OK) return;
+    }
+
+    if (wsPkt.type == HTTPD_WS_TYPE_PING) {
+        wsPkt.type = HTTPD_WS_TYPE_PONG; // Echoes the payload.
+        httpd_ws_send_frame(req, &wsPkt);
+
+    } else if (wsPkt.type == HTTPD_WS_TYPE_CLOSE) {
+        wsPkt.len = 0;
+        wsPkt.payload = nullptr;
+        httpd_ws_send_frame(req, &wsPkt);
+        SOCKHAND::sessClose(fd);
+        SOCKHAND::unsubscribe(fd);
+    }
+}
+
+}
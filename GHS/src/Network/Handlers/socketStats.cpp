@@ -0,0 +1,80 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "Network/Handlers/socketJson.hpp"
+#include "Peripherals/Stats.hpp"
+
+namespace Comms {
+
+// Requires the reply id, window bitmask, see StatsWin, 0 for every window,
+// buffer, buffer size, handle and file descriptor of the socket, and
+// reference to fragmented. Writes the rolling statistics of every channel
+// over each window of the mask. Format {"id":n,"ch":[names],"w":[{"secs":
+// window secs,"s":[[count,mean,stdev,min,max,ema] or null if no readings,
+// per channel]},...]}. Returns the reply length as snprintf, or -1 if out
+// of range.
+int SOCKHAND::compileStats(uint16_t idNum, int mask, char* buffer,
+    size_t size, httpd_handle_t hd, int fd, bool &fragmented) {
+
+    using namespace Peripheral;
+    fragmented = false;
+
+    const int all = (1 << STATS_WINDOWS) - 1;
+    if (!SOCKHAND::inRange(0, all, mask)) return -1;
+    if (mask == 0) mask = all;
+
+    Stats* stats = Stats::get();
+    StatsFigures fig;
+
+    JsonStream js(buffer, size, hd, fd);
+    js.open('{');
+    js.key("id"); js.num((uint32_t)idNum);
+    js.key("ch");
+    js.open('[');
+
+    for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+        js.raw(c > 0 ? ",\"" : "\"");
+        js.raw(TSCodec::info[c].name);
+        js.raw("\"");
+    }
+
+    js.close(']');
+    js.key("w");
+    js.open('[');
+
+    for (uint8_t w = 0; w < STATS_WINDOWS; w++) {
+        if ((mask & (1 << w)) == 0) continue;
+        StatsWin win = static_cast<StatsWin>(w);
+
+        js.open('{');
+        js.key("secs"); js.num(Stats::windowSecs(win));
+        js.key("s");
+        js.open('[');
+
+        for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+            if (!stats->getFigures(static_cast<TSChan>(c), win, fig)) {
+                js.json("null");
+                continue;
+            }
+
+            uint8_t dec = TSCodec::info[c].dec + 1; // Means, finer.
+
+            js.open('[');
+            js.num(fig.count);
+            js.num(fig.mean, dec);
+            js.num(fig.stdev, dec);
+            js.num(fig.min, dec);
+            js.num(fig.max, dec);
+            js.num(fig.ema, dec);
+            js.close(']');
+        }
+
+        js.close(']');
+        js.close('}');
+    }
+
+    js.close(']');
+    js.close('}');
+
+    return js.finish(fragmented);
+}
+
+}
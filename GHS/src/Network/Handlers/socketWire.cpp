@@ -0,0 +1,178 @@
+#include "Network/Handlers/socketHandler.hpp"
+#include "Network/Handlers/socketWire.hpp"
+#include "string.h"
+#include "Config/config.hpp"
+
+namespace Comms {
+
+static_assert(TOTAL_RELAYS == 4 && SOIL_SENSORS == 4,
+    "WireAll layout, increment SKT_WIRE_VERSION");
+
+// Requires the trip config, and reading. Returns the wire trip.
+static WireTrip wireTrip(const Peripheral::TH_TRIP_CONFIG &conf, float val) {
+    WireTrip trip;
+    trip.val = val;
+    trip.reNum = conf.relay.num;
+    trip.reCond = static_cast<uint8_t>(conf.relay.condition);
+    trip.reVal = conf.relay.tripVal;
+    trip.altCond = static_cast<uint8_t>(conf.alt.condition);
+    trip.altVal = conf.alt.tripVal;
+    return trip;
+}
+
+// Requires the color averages, and packed float array of SKT_WIRE_COLORS.
+// Copies the averages in the order of the JSON keys.
+static void wireColors(const Peripheral::Color_Averages &avg, void* dst) {
+    const float src[SKT_WIRE_COLORS] = {avg.violet, avg.indigo, avg.blue,
+        avg.cyan, avg.green, avg.yellow, avg.orange, avg.red, avg.nir,
+        avg.clear};
+
+    memcpy(dst, src, sizeof(src));
+}
+
+// Requires the reply id, buffer, and buffer size. Writes the binary GET_ALL
+// reply, a WireHdr followed by WireAll, of the same data as compileAll().
+// Returns the bytes written, or size if the buffer is too small.
+int SOCKHAND::wireAll(uint16_t idNum, uint8_t* buffer, size_t size) {
+    const size_t total = sizeof(WireHdr) + sizeof(WireAll);
+    if (total >= size) return size;
+
+    allSnap snap;
+    SOCKHAND::gatherAll(snap);
+
+    WireHdr hdr{SKT_WIRE_VERSION, WireType::ALL, idNum, sizeof(WireAll)};
+    WireAll all;
+    memset(&all, 0, sizeof(all));
+
+    strncpy(all.firmv, FIRMWARE_VERSION, sizeof(all.firmv) - 1);
+    all.newLog = snap.newLog;
+    all.netMode = snap.net;
+    all.sysTime = snap.dtg.raw;
+    all.hour = snap.dtg.hour;
+    all.minute = snap.dtg.minute;
+    all.second = snap.dtg.second;
+    all.day = snap.dtg.day;
+    all.timeCalib = snap.isCal;
+
+    for (size_t i = 0; i < TOTAL_RELAYS; i++) {
+        WireRelay &re = all.relays[i];
+        re.state = static_cast<uint8_t>(snap.reState[i]);
+        re.timerEn = snap.reTimer[i].isReady;
+        re.onTime = snap.reTimer[i].onTime;
+        re.offTime = snap.reTimer[i].offTime;
+        re.days = snap.reTimer[i].days;
+        re.qty = snap.reQty[i];
+        re.man = snap.reMan[i];
+    }
+
+    all.temp = wireTrip(snap.tempConf, snap.temp);
+    all.hum = wireTrip(snap.humConf, snap.hum);
+    all.shtHealth = snap.thHlth;
+    all.shtRdOK = snap.thRdOK;
+    all.tempAvg = snap.thAvg.temp;
+    all.humAvg = snap.thAvg.hum;
+    all.tempAvgPrev = snap.thAvg.prevTemp;
+    all.humAvgPrev = snap.thAvg.prevHum;
+
+    for (size_t i = 0; i < SOIL_SENSORS; i++) {
+        WireSoil &so = all.soil[i];
+        so.val = snap.soReadings[i].val;
+        so.altCond = static_cast<uint8_t>(snap.soConf[i].condition);
+        so.altVal = snap.soConf[i].tripVal;
+        so.health = snap.soReadings[i].sensHealth;
+        so.rdOK = !snap.soReadings[i].readErr; // Negated, OK if false.
+    }
+
+    const uint16_t colors[SKT_WIRE_COLORS] = {snap.spec.F1_415nm_Violet,
+        snap.spec.F2_445nm_Indigo, snap.spec.F3_480nm_Blue,
+        snap.spec.F4_515nm_Cyan, snap.spec.F5_555nm_Green,
+        snap.spec.F6_590nm_Yellow, snap.spec.F7_630nm_Orange,
+        snap.spec.F8_680nm_Red, snap.spec.NIR, snap.spec.Clear};
+
+    memcpy(all.colors, colors, sizeof(colors));
+    all.photo = snap.photoVal;
+    wireColors(snap.ltAv.color, all.colorAvg);
+    all.photoAvg = snap.ltAv.photoResistor;
+    wireColors(snap.ltAv.prevColor, all.colorAvgPrev);
+    all.photoAvgPrev = snap.ltAv.prevPhotoResistor;
+
+    all.photoRdOK = !snap.ltH.photoReadErr; // Negated, OK if false.
+    all.specRdOK = !snap.ltH.specReadErr;
+    all.photoHealth = snap.ltH.photo;
+    all.specHealth = snap.ltH.spec;
+    all.lightRe = snap.ltConf.num;
+    all.lightReCond = static_cast<uint8_t>(snap.ltConf.condition);
+    all.lightReVal = snap.ltConf.tripVal;
+    all.lightDur = snap.ltDur;
+    all.darkVal = snap.ltConf.darkVal;
+    all.atime = snap.specConf.ATIME;
+    all.astep = snap.specConf.ASTEP;
+    all.again = static_cast<uint8_t>(snap.specConf.AGAIN);
+
+    memcpy(buffer, &hdr, sizeof(hdr));
+    memcpy(buffer + sizeof(hdr), &all, sizeof(all));
+    return total;
+}
+
+// Requires the buffer position, series, and hours. Writes the newest n hours
+// of the series, newest first. Returns the bytes written.
+template<typename T, size_t N>
+static size_t wireSeries(uint8_t* pos, const Peripheral::RingSeries<T, N> &ser,
+    size_t hours) {
+
+    return ser.read(pos, hours) * sizeof(T);
+}
+
+// Requires the reply id, hours of trends 1 - TREND_HOURS, buffer, and buffer
+// size. Writes the binary GET_TRENDS reply, see socketWire.hpp, of the same
+// data as the JSON reply. Returns the bytes written, or size if the buffer is
+// too small.
+int SOCKHAND::wireTrends(uint16_t idNum, int hours, uint8_t* buffer,
+    size_t size) {
+
+    size_t payload = 1 + hours * (sizeof(float) * 2 +
+        sizeof(uint16_t) * SKT_WIRE_COLORS + sizeof(int16_t) *
+        (1 + SOIL_SENSORS));
+
+    size_t total = sizeof(WireHdr) + payload;
+    if (total >= size) return size;
+
+    static Peripheral::TH_Trends th; // Snapshots of the requested hours.
+    Peripheral::TempHum::get()->getTrends(&th, hours);
+
+    static Peripheral::Light_Trends lt;
+    Peripheral::Light::get()->getTrends(&lt, hours);
+
+    static Peripheral::Soil_Trends soil[SOIL_SENSORS];
+    Peripheral::Soil::get()->getAllTrends(soil, hours);
+
+    WireHdr hdr{SKT_WIRE_VERSION, WireType::TRENDS, idNum,
+        static_cast<uint16_t>(payload)};
+
+    memcpy(buffer, &hdr, sizeof(hdr));
+    size_t len = sizeof(hdr);
+    buffer[len++] = hours;
+
+    // The newest n hours of each series, in the order of the JSON reply.
+    len += wireSeries(buffer + len, th.temp, hours);
+    len += wireSeries(buffer + len, th.hum, hours);
+    len += wireSeries(buffer + len, lt.clear, hours);
+    len += wireSeries(buffer + len, lt.violet, hours);
+    len += wireSeries(buffer + len, lt.indigo, hours);
+    len += wireSeries(buffer + len, lt.blue, hours);
+    len += wireSeries(buffer + len, lt.cyan, hours);
+    len += wireSeries(buffer + len, lt.green, hours);
+    len += wireSeries(buffer + len, lt.yellow, hours);
+    len += wireSeries(buffer + len, lt.orange, hours);
+    len += wireSeries(buffer + len, lt.red, hours);
+    len += wireSeries(buffer + len, lt.nir, hours);
+    len += wireSeries(buffer + len, lt.photo, hours);
+
+    for (size_t i = 0; i < SOIL_SENSORS; i++) {
+        len += wireSeries(buffer + len, soil[i], hours);
+    }
+
+    return len;
+}
+
+}
@@ -295,8 +295,8 @@ httpd_handle_t NetMain::getServer() {return this->server;}
 void NetMain::sendErr(const char* msg, Messaging::Levels lvl, 
     bool ignoreRepeat) {
 
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, 
-        NET_LOG_METHOD, ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::NET,
+        lvl, msg, NET_LOG_METHOD, ignoreRepeat);
 }
 
 // Returns the log toggle struct ptr for reading and writing.
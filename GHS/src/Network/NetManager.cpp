@@ -255,6 +255,7 @@ bool NetManager::handleDestruction(NetMain &mode) {
             // if true, will save settings and force a reset.
             if (NET_DESTROY_FAIL_FORCE_RESET) {
                 NVS::settingSaver::get()->save();
+                Messaging::MsgLogHandler::get()->sync(); // Journal the log.
                 vTaskDelay(pdMS_TO_TICKS(10)); // Brief delay before restart.
                 esp_restart();
             }
@@ -278,8 +279,8 @@ bool NetManager::handleDestruction(NetMain &mode) {
 void NetManager::sendErr(const char* msg, Messaging::Levels lvl, 
         bool ignoreRepeat) {
 
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, NET_LOG_METHOD, 
-        ignoreRepeat);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::NET,
+        lvl, msg, NET_LOG_METHOD, ignoreRepeat);
 }
 
 // Constructor. Takes station, wap, and OLED references.
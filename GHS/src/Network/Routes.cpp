@@ -79,7 +79,8 @@ httpd_uri_t ws = {
     .method       = HTTP_GET,
     .handler      = SOCKHAND::wsHandler,
     .user_ctx     = NULL,
-    .is_websocket = true
+    .is_websocket = true,
+    .handle_ws_control_frames = true // Pongs mark sessions alive.
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+#include "Network/UDPSender.hpp"
+#include <cstdint>
+#include "string.h"
+#include "Config/config.hpp"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+#include "UI/LogCodec.hpp"
+#include "Network/NetManager.hpp"
+#include "esp_timer.h"
+#include "esp_netif.h"
+#include "mdns.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+namespace Comms {
+
+Threads::Mutex UDPSender::mtx("UDPSender");
+
+// Resolution is due on the first flush.
+UDPSender::UDPSender() :
+
+    tag(UDP_TAG), sock(-1), addr(0), resolvedAt(-UDP_RESOLVE_REFRESH_MS),
+    resolveErr(false), batchLen(0), batchEntries(0), batchSince(0),
+    hbPending(false), datagrams(0), entries(0), dropped(0), sendFails(0),
+    resolves(0) {
+
+        memset(this->log, 0, sizeof(this->log));
+        memset(this->batch, 0, sizeof(this->batch));
+        memset(this->hb, 0, sizeof(this->hb));
+    }
+
+// Requires no params. Queries the primary node address by mDNS, blocking up
+// to UDP_RESOLVE_TIMEOUT. On failure, retains the previous address, which
+// is only cleared once sending fails. WARNING. Call only from flush().
+void UDPSender::resolve() {
+    this->resolvedAt = esp_timer_get_time() / 1000;
+
+    esp_ip4_addr_t ip{};
+    esp_err_t err = mdns_query_a(UDP_HOST, UDP_RESOLVE_TIMEOUT, &ip);
+
+    if (err != ESP_OK || ip.addr == 0) {
+        if (!this->resolveErr) { // Log once per failure streak.
+            snprintf(this->log, sizeof(this->log), "%s %s.local unresolved",
+                this->tag, UDP_HOST);
+
+            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
+                this->log, Messaging::Method::SRL_LOG);
+        }
+
+        this->resolveErr = true;
+        return;
+    }
+
+    if (ip.addr != this->addr.load()) { // Only log changes.
+        const uint8_t* oct = reinterpret_cast<const uint8_t*>(&ip.addr);
+        snprintf(this->log, sizeof(this->log), "%s %s.local @ %u.%u.%u.%u",
+            this->tag, UDP_HOST, oct[0], oct[1], oct[2], oct[3]);
+
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
+            this->log, Messaging::Method::SRL_LOG);
+    }
+
+    this->addr.store(ip.addr);
+    this->resolveErr = false;
+    this->resolves++;
+}
+
+// Requires data, its length, and the destination port. WARNING. Requires
+// the mutex. Sends the datagram to the primary node, opening the socket if
+// required. Upon failure, closes the socket and clears the address, so that
+// both are renewed. Returns true if sent, false if not.
+bool UDPSender::sendTo(const void* data, size_t len, uint16_t port) {
+    uint32_t ip = this->addr.load();
+    if (ip == 0) return false; // Unresolved.
+
+    if (this->sock < 0) {
+        this->sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        if (this->sock < 0) return false;
+    }
+
+    struct sockaddr_in dest = {};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(port);
+    dest.sin_addr.s_addr = ip;
+
+    if (sendto(this->sock, data, len, 0, (struct sockaddr *)&dest,
+        sizeof(dest)) < 0) {
+
+        close(this->sock);
+        this->sock = -1;
+        this->addr.store(0); // Resolve again on the next flush.
+        this->sendFails++;
+        return false;
+    }
+
+    this->datagrams++;
+    return true;
+}
+
+// Requires no params. WARNING. Requires the mutex. Sends the batched log
+// entries as one datagram, with the binary header if LOG_BINARY. If the
+// primary node is unresolved or the device is not on the LAN, retains the
+// batch. If sending fails, the batch is dropped and counted.
+void UDPSender::sendBatch() {
+    if (this->batchEntries == 0) return;
+
+    char mDNS[UDP_HDR_SIZE - LOG_BIN_MAGIC_LEN - 2]; // Excludes header.
+    if (this->addr.load() == 0 || !NetManager::onLAN(mDNS, sizeof(mDNS))) {
+        return;
+    }
+
+    bool sent = false;
+
+    if (LOG_BINARY) { // Prepend the header, static since large.
+        static uint8_t dgram[UDP_DGRAM_SIZE];
+        size_t mdnsLen = strnlen(mDNS, sizeof(mDNS));
+        size_t len = 0;
+
+        memcpy(dgram, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN);
+        len += LOG_BIN_MAGIC_LEN;
+        dgram[len++] = LOG_BIN_VERSION;
+        dgram[len++] = static_cast<uint8_t>(mdnsLen);
+        memcpy(&dgram[len], mDNS, mdnsLen);
+        len += mdnsLen;
+        memcpy(&dgram[len], this->batch, this->batchLen);
+        len += this->batchLen;
+
+        sent = this->sendTo(dgram, len, LOG_UDP_PORT);
+
+    } else {
+        sent = this->sendTo(this->batch, this->batchLen, LOG_UDP_PORT);
+    }
+
+    if (sent) {
+        this->entries += this->batchEntries;
+    } else {
+        this->dropped += this->batchEntries;
+    }
+
+    this->batchLen = 0;
+    this->batchEntries = 0;
+}
+
+// Requires no params. Returns the single instance.
+UDPSender* UDPSender::get() {
+    static UDPSender instance;
+    return &instance;
+}
+
+// Requires the entry data, its length, and kind. In text mode, data is the
+// JSON entry. In binary mode, it is the rendered text or LogCodec entry.
+// Batches the entry, sending the batch first if the entry will not fit.
+// Entries that cannot be batched are dropped and counted.
+void UDPSender::addLog(const void* data, size_t len, Messaging::LogKind kind) {
+    if (data == nullptr || len == 0) return;
+
+    // Binary records are framed, text entries are followed by a newline.
+    const size_t need = LOG_BINARY ? UDP_REC_HDR_SIZE + len : len + 1;
+
+    if (need > sizeof(this->batch)) { // Never fits.
+        this->dropped++;
+        return;
+    }
+
+    Threads::MutexLock guard(UDPSender::mtx);
+    if (!guard.LOCK()) {
+        this->dropped++;
+        return;
+    }
+
+    if (this->batchLen + need > sizeof(this->batch)) this->sendBatch();
+
+    if (this->batchLen + need > sizeof(this->batch)) { // Unsent, retained.
+        this->dropped++;
+        return;
+    }
+
+    uint8_t* pos = &this->batch[this->batchLen];
+
+    if (LOG_BINARY) {
+        uint16_t recLen = static_cast<uint16_t>(len);
+        pos[0] = static_cast<uint8_t>(kind);
+        memcpy(&pos[1], &recLen, sizeof(recLen)); // Little endian target.
+        memcpy(&pos[UDP_REC_HDR_SIZE], data, len);
+    } else {
+        memcpy(pos, data, len);
+        pos[len] = '\n';
+    }
+
+    if (this->batchEntries == 0) {
+        this->batchSince = esp_timer_get_time() / 1000;
+    }
+
+    this->batchLen += need;
+    this->batchEntries++;
+}
+
+// Requires the heartbeat message. Replaces any unsent heartbeat, which is
+// sent upon the next flush.
+void UDPSender::setHeartbeat(const char* msg) {
+    if (msg == nullptr) return;
+
+    Threads::MutexLock guard(UDPSender::mtx);
+    if (!guard.LOCK()) return;
+
+    snprintf(this->hb, sizeof(this->hb), "%s", msg);
+    this->hbPending = true;
+}
+
+// Requires no params. WARNING. Must only be called by the log task, at an
+// interval not exceeding UDP_FLUSH_MS. Resolves the primary node if due,
+// then sends the pending heartbeat and the batch once its oldest entry has
+// waited UDP_FLUSH_MS.
+void UDPSender::flush() {
+    int64_t now = esp_timer_get_time() / 1000;
+    int64_t due = (this->addr.load() == 0) ? UDP_RESOLVE_RETRY_MS :
+        UDP_RESOLVE_REFRESH_MS;
+
+    // Outside of the mutex, the query blocks.
+    if (now - this->resolvedAt >= due && NetManager::onLAN()) this->resolve();
+
+    Threads::MutexLock guard(UDPSender::mtx);
+    if (!guard.LOCK()) return;
+
+    // Retained while unresolved. Once attempted, sent or not, the next 
+    // heartbeat replaces it.
+    if (this->hbPending && this->addr.load() != 0 && NetManager::onLAN()) {
+        this->sendTo(this->hb, strlen(this->hb), HEARTBEAT_UDP_PORT);
+        this->hbPending = false;
+    }
+
+    if (this->batchEntries > 0 && now - this->batchSince >= UDP_FLUSH_MS) {
+        this->sendBatch();
+    }
+}
+
+// Requires stats reference. Populates with the counts since boot.
+void UDPSender::getStats(UDPStats &stats) {
+    stats.datagrams = this->datagrams.load();
+    stats.entries = this->entries.load();
+    stats.dropped = this->dropped.load();
+    stats.sendFails = this->sendFails.load();
+    stats.resolves = this->resolves.load();
+}
+
+}
@@ -485,7 +485,8 @@ OTA_RET OTAhandler::writeFirmware(const char* firmURL,
 
 // Requires message and level. Level default to ERROR.
 void OTAhandler::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, OTA_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::OTA,
+        lvl, msg, OTA_LOG_METHOD);
 }
 
 OTAhandler::OTAhandler(UI::Display &OLED, Comms::NetMain &station,
@@ -295,6 +295,7 @@ bool Alert::cleanup(size_t attempt) {
 
         this->sendErr(this->log, Messaging::Levels::CRITICAL);
         NVS::settingSaver::get()->save(); // Save peripheral settings
+        Messaging::MsgLogHandler::get()->sync(); // Journal the log.
 
         esp_restart(); // Restart esp attempt.
 
@@ -347,7 +348,8 @@ bool Alert::cleanup(size_t attempt) {
 
 // Requires message and messaging level. Level default to ERROR.
 void Alert::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, ALT_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::ALERT,
+        lvl, msg, ALT_LOG_METHOD);
 }
 
 // ATTENTION. For send alert and send report, introduced a delay of 300 us
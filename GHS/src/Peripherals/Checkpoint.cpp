@@ -0,0 +1,265 @@
+#include "Peripherals/Checkpoint.hpp"
+#include <cstdint>
+#include <cstddef>
+#include "string.h"
+#include "stdio.h"
+#include "Threads/Mutex.hpp"
+#include "Common/Timing.hpp"
+#include "UI/MsgLogHandler.hpp"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+namespace Peripheral {
+
+Threads::Mutex Checkpoint::mtx(CKPT_TAG);
+
+// Bytes of the header covered by the CRC, excludes the CRC itself.
+static constexpr size_t CKPT_CRC_COVER = offsetof(CheckpointHdr, crc);
+
+// Requires the header and data. Returns the CRC32 of both.
+static uint32_t snapshotCRC(const CheckpointHdr &hdr,
+    const CheckpointData &data) {
+
+    uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&hdr),
+        CKPT_CRC_COVER);
+
+    return esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t*>(&data),
+        sizeof(data));
+}
+
+// Requires no params. Unusable until begin() locates the partition.
+Checkpoint::Checkpoint() :
+
+    tag(CKPT_TAG), part(nullptr), slotQty(0), nextSlot(0), nextSeq(1),
+    lastSave(0), boot(0), data{}, loaded(false), writeErr(false) {
+
+        memset(this->log, 0, sizeof(this->log));
+    }
+
+// Requires the slot, header reference, and the data output, or nullptr to
+// read the header only. WARNING. Requires the mutex or init. Returns true if
+// the header is that of a snapshot of the current layout, and if out is
+// passed, the data read passes the CRC. Returns false if erased, torn, of a
+// prior layout, or unreadable.
+bool Checkpoint::readSlot(size_t slot, CheckpointHdr &hdr,
+    CheckpointData* out) {
+
+    size_t addr = slot * CKPT_SLOT;
+
+    if (esp_partition_read(this->part, addr, &hdr, sizeof(hdr)) != ESP_OK) {
+        return false;
+    }
+
+    if (hdr.magic != CKPT_MAGIC || hdr.len != sizeof(CheckpointData)) {
+        return false;
+    }
+
+    if (out == nullptr) return true;
+
+    if (esp_partition_read(this->part, addr + sizeof(hdr), out,
+        sizeof(CheckpointData)) != ESP_OK) return false;
+
+    return snapshotCRC(hdr, *out) == hdr.crc;
+}
+
+// Requires no params. WARNING. Requires the mutex. Writes data as the next
+// snapshot, erasing CKPT_ERASE first if the slot begins an erase unit. A
+// slot that is not erased, such as that of a torn write, is skipped along
+// with the rest of its unit. The data is written before the header, so a
+// header is only valid once its data is in place. Returns true if written.
+bool Checkpoint::writeSlot() {
+    CheckpointHdr hdr;
+
+    if (this->nextSlot % CKPT_SLOTS_ERASE != 0 &&
+        (esp_partition_read(this->part, this->nextSlot * CKPT_SLOT, &hdr,
+        sizeof(hdr)) != ESP_OK || hdr.magic != CKPT_ERASED)) {
+
+        this->nextSlot += CKPT_SLOTS_ERASE -
+            this->nextSlot % CKPT_SLOTS_ERASE;
+    }
+
+    if (this->nextSlot >= this->slotQty) this->nextSlot = 0;
+    size_t slot = this->nextSlot;
+    size_t addr = slot * CKPT_SLOT;
+
+    // Advances regardless, so a failed slot is not retried.
+    this->nextSlot = (slot + 1 >= this->slotQty) ? 0 : slot + 1;
+
+    if (slot % CKPT_SLOTS_ERASE == 0 && esp_partition_erase_range(this->part,
+        addr, CKPT_ERASE) != ESP_OK) return false;
+
+    hdr.magic = CKPT_MAGIC;
+    hdr.seq = this->nextSeq++;
+    hdr.len = sizeof(CheckpointData);
+    hdr.boot = this->boot;
+    hdr.crc = snapshotCRC(hdr, this->data);
+
+    if (esp_partition_write(this->part, addr + sizeof(hdr), &this->data,
+        sizeof(this->data)) != ESP_OK) return false;
+
+    return esp_partition_write(this->part, addr, &hdr,
+        sizeof(hdr)) == ESP_OK;
+}
+
+// Singleton class, returns a pointer to the instance of this class.
+Checkpoint* Checkpoint::get() {
+    static Checkpoint instance;
+    return &instance;
+}
+
+// Requires the boot number. Locates the partition and loads the newest valid
+// snapshot, to be copied by the sensors upon creation. Call once, prior to
+// the sensor threads. Logs its own result. Returns true if a snapshot loaded.
+bool Checkpoint::begin(uint16_t boot) {
+    Threads::MutexLock guard(Checkpoint::mtx);
+    if (!guard.LOCK() || this->part != nullptr) return this->loaded;
+
+    this->boot = boot;
+    this->part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY, CKPT_LABEL);
+
+    this->slotQty = (this->part != nullptr) ?
+        this->part->size / CKPT_ERASE * CKPT_SLOTS_ERASE : 0;
+
+    // Requires an erase unit to write while another holds the newest.
+    if (this->slotQty < 2 * CKPT_SLOTS_ERASE) {
+        snprintf(this->log, sizeof(this->log),
+            "%s partition %s unavailable, requires %u bytes", this->tag,
+            CKPT_LABEL, (unsigned)CKPT_PART_SIZE);
+
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
+            this->log, Messaging::Method::SRL_LOG);
+
+        this->part = nullptr;
+        return false;
+    }
+
+    // Writing resumes after the newest header, valid or torn.
+    CheckpointHdr hdr;
+    uint32_t newest = 0;
+
+    for (size_t i = 0; i < this->slotQty; i++) {
+        if (this->readSlot(i, hdr, nullptr) && hdr.seq >= newest) {
+            newest = hdr.seq;
+            this->nextSlot = i + 1;
+        }
+    }
+
+    this->nextSeq = newest + 1;
+    if (this->nextSlot >= this->slotQty) this->nextSlot = 0;
+
+    // Verifies the newest first, falling back to the older upon a bad CRC.
+    uint32_t below = this->nextSeq;
+
+    while (!this->loaded && below > 1) {
+        size_t pick = this->slotQty;
+        uint32_t pickSeq = 0;
+
+        for (size_t i = 0; i < this->slotQty; i++) {
+            if (this->readSlot(i, hdr, nullptr) && hdr.seq < below &&
+                hdr.seq >= pickSeq) {
+
+                pick = i;
+                pickSeq = hdr.seq;
+            }
+        }
+
+        if (pick == this->slotQty) break; // None remaining.
+        this->loaded = this->readSlot(pick, hdr, &this->data);
+        below = pickSeq;
+    }
+
+    if (this->loaded) {
+        snprintf(this->log, sizeof(this->log),
+            "%s snapshot %lu of boot %u restored", this->tag,
+            (unsigned long)hdr.seq, hdr.boot);
+    } else {
+        snprintf(this->log, sizeof(this->log), "%s no snapshot", this->tag);
+        this->data = CheckpointData{};
+    }
+
+    Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
+        this->log, Messaging::Method::SRL_LOG);
+
+    return this->loaded;
+}
+
+// Requires the averages and trends references. Copies those of the loaded
+// snapshot, if any. Returns true if copied.
+bool Checkpoint::restoreTH(TH_Averages &avg, TH_Trends &trends) {
+    Threads::MutexLock guard(Checkpoint::mtx);
+    if (!guard.LOCK() || !this->loaded) return false;
+
+    avg = this->data.thAvg;
+    trends = this->data.thTrends;
+    return true;
+}
+
+// Requires the averages, trends, and light duration references. Copies those
+// of the loaded snapshot, if any. Returns true if copied.
+bool Checkpoint::restoreLight(Light_Averages &avg, Light_Trends &trends,
+    CheckpointLight &light) {
+
+    Threads::MutexLock guard(Checkpoint::mtx);
+    if (!guard.LOCK() || !this->loaded) return false;
+
+    avg = this->data.lightAvg;
+    trends = this->data.lightTrends;
+    light = this->data.light;
+    return true;
+}
+
+// Requires the array of SOIL_SENSORS trends. Copies those of the loaded
+// snapshot, if any. Returns true if copied.
+bool Checkpoint::restoreSoil(Soil_Trends* trends) {
+    Threads::MutexLock guard(Checkpoint::mtx);
+    if (!guard.LOCK() || !this->loaded || trends == nullptr) return false;
+
+    for (size_t i = 0; i < SOIL_SENSORS; i++) {
+        trends[i] = this->data.soilTrends[i];
+    }
+
+    return true;
+}
+
+// Requires force, default false. Writes a snapshot of every sensor once
+// CKPT_PERIOD_S elapses since the previous, or immediately if forced, such as
+// prior to a restart. Call from the routine task, after the sensors are
+// created. Logs the first failure of a streak. Returns true if written.
+bool Checkpoint::save(bool force) {
+    Threads::MutexLock guard(Checkpoint::mtx);
+    if (!guard.LOCK() || this->part == nullptr) return false;
+
+    uint32_t now = Clock::DateTime::get()->seconds();
+    if (!force && now - this->lastSave < CKPT_PERIOD_S) return false;
+    this->lastSave = now;
+
+    TempHum* th = TempHum::get();
+    Light* lt = Light::get();
+    Soil* soil = Soil::get();
+
+    if (th == nullptr || lt == nullptr || soil == nullptr) return false;
+
+    // The loaded snapshot is overwritten, the sensors already copied it.
+    this->loaded = false;
+    th->getAverages(&this->data.thAvg);
+    th->getTrends(&this->data.thTrends);
+    lt->getAverages(&this->data.lightAvg);
+    lt->getTrends(&this->data.lightTrends);
+    lt->getDuration(&this->data.light.duration);
+    lt->getLightOn(&this->data.light.lightOn);
+    soil->getAllTrends(this->data.soilTrends);
+
+    bool ok = this->writeSlot();
+
+    if (!ok && !this->writeErr) { // Log once per failure streak.
+        snprintf(this->log, sizeof(this->log), "%s write err", this->tag);
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
+            this->log, Messaging::Method::SRL_LOG);
+    }
+
+    this->writeErr = !ok;
+    return ok;
+}
+
+}
@@ -1,6 +1,9 @@
 #include "Peripherals/Light.hpp"
 #include "Drivers/AS7341/AS7341_Library.hpp"
 #include "Peripherals/Relay.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "Peripherals/Checkpoint.hpp"
+#include "Peripherals/Stats.hpp"
 #include "Threads/Mutex.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "Peripherals/Alert.hpp" // Used only for sensor alerts.
@@ -23,10 +26,10 @@ Light::Light(LightParams &params) : health(),
     conf{0, LIGHT_THRESHOLD_DEF, RECOND::NONE, RECOND::NONE, nullptr, 
         LIGHT_NO_RELAY, 0, 0, 0},
 
-    lightDuration(0), photoVal(0), params(params) {
+    lightDuration(0), lightStart(0), lightOn(false), photoVal(0),
+    params(params) {
         memset(&this->readings, 0, sizeof(this->readings));
         memset(&this->averages, 0, sizeof(this->averages));
-        memset(&this->trends, 0, sizeof(this->trends));
 
         // Set the AGAIN, ASTEP, and ATIME configuration variables by reading
         // the current values witten to the AS7341 upon init.
@@ -46,26 +49,30 @@ Light::Light(LightParams &params) : health(),
         Light::sendErr(Light::log, Messaging::Levels::INFO);
     }
 
-// Requires isSpectral bool. Computes either the spectral or photoresistors
-// averages and saves them into averages variable.
+// Requires isSpectral bool. Adds either the spectral or photoresistor
+// readings to the streaming statistics, and sets the averages to their
+// rolling 24 hour means, see Stats.
 void Light::computeAverages(bool isSpec) {
 
+    Stats* stats = Stats::get();
+    StatsFigures fig;
+
     // Check if photoresistor
     if (!isSpec) {
-        this->averages.pollCtPho++; // Increment pollCt (never 0)
+        stats->add(TSChan::PHOTO, this->photoVal);
+
+        if (stats->getFigures(TSChan::PHOTO, StatsWin::DAY, fig)) {
+            this->averages.photoResistor = fig.mean;
+            this->averages.pollCtPho = fig.count;
+        }
 
-        // compute delta between current reading and averages and add that
-        // difference, divided by the new poll count, to the averages.
-        float delta = this->photoVal - this->averages.photoResistor;
-        this->averages.photoResistor += (delta / this->averages.pollCtPho); 
         return; // Block spectral below.
     }
 
     // To efficiently process everything, created two arrays that can be
-    // iterated together, have their delta computed like above, and the 
-    // difference added to the average reading.
+    // iterated together, in the channel order of TSChan from CLEAR.
 
-    uint16_t readings[] = { // Deltas of current values and average values.
+    const float readings[] = {
         this->readings.Clear, this->readings.F1_415nm_Violet,
         this->readings.F2_445nm_Indigo, this->readings.F3_480nm_Blue,
         this->readings.F4_515nm_Cyan, this->readings.F5_555nm_Green,
@@ -81,18 +88,22 @@ void Light::computeAverages(bool isSpec) {
         &this->averages.color.red, &this->averages.color.nir
     };
 
-    this->averages.pollCtClr++; // Increment poll count by 1.
+    const size_t qty = sizeof(readings) / sizeof(readings[0]);
+    stats->add(TSChan::CLEAR, readings, qty);
 
-    for (int i = 0; i < (sizeof(readings) / sizeof(readings[0])); i++) {
-        float delta = readings[i] - *averages[i];
+    for (size_t i = 0; i < qty; i++) {
+        TSChan chan = static_cast<TSChan>(
+            static_cast<uint8_t>(TSChan::CLEAR) + i);
 
-        *averages[i] += (delta / this->averages.pollCtClr);
+        if (!stats->getFigures(chan, StatsWin::DAY, fig)) continue;
+        *averages[i] = fig.mean;
+        if (i == 0) this->averages.pollCtClr = fig.count;
     }
 }
 
-// Requires no params. Gets the current hour. When the hour switches, hours
-// 0 to n - 1 will be captured and moved to position 1 to n, position 0 will
-// have the new value written into it after the move. 
+// Requires no params. Gets the current hour. When the hour switches, the
+// current readings are pushed as the newest hour of each trend, O(1)
+// regardless of TREND_HOURS.
 void Light::computeTrends() {
 
     // Get current hour. Set static last hour equal to. This should init at
@@ -101,35 +112,20 @@ void Light::computeTrends() {
     static uint8_t lastHour = hour; 
 
     if (hour != lastHour) { // Change detected.
-
-        // Set size the size of the memmoves, these will be standard. Used nir
-        // to fit on one line only, but they are all 16 bit values.
-        size_t size = sizeof(this->trends.nir) - sizeof(this->trends.nir[0]);
-        const size_t clrTot = 11; // Color total.
-
-        // Array of colors to be iterated over to populate trends at hour chg.
-        // Used pointer due to size.
-        uint16_t* clrTrends[clrTot] = {this->trends.clear, this->trends.violet,
-            this->trends.indigo, this->trends.blue, this->trends.cyan,
-            this->trends.green, this->trends.yellow, this->trends.orange,
-            this->trends.red, this->trends.nir, 
-            reinterpret_cast<uint16_t*>(this->trends.photo)};
-
-        // Coresponding current values to the color trends above. Max for 
-        // photoval is 4095, no negative exp, uint16_t cast is harmless.
-        uint16_t readings[clrTot] = {this->readings.Clear, 
-            this->readings.F1_415nm_Violet, this->readings.F2_445nm_Indigo,
-            this->readings.F3_480nm_Blue, this->readings.F4_515nm_Cyan,
-            this->readings.F5_555nm_Green, this->readings.F6_590nm_Yellow,
-            this->readings.F7_630nm_Orange, this->readings.F8_680nm_Red,
-            this->readings.NIR, static_cast<uint16_t>(this->photoVal)};
-
-        // Iterate arrays. Move block from (idx 0 to n-1), to (idx 1 to n).
-        // Opens idx 0 which is populated by the current readings.
-        for (int i = 0; i < clrTot; i++) {
-            memmove(&clrTrends[i][1], &clrTrends[i][0], size); // Moves vals.
-            clrTrends[i][0] = readings[i]; // Sets the current reading.
-        }
+        Light_Trends &tr = this->trends;
+        AS7341_DRVR::COLOR &rd = this->readings;
+
+        tr.clear.push(rd.Clear);
+        tr.violet.push(rd.F1_415nm_Violet);
+        tr.indigo.push(rd.F2_445nm_Indigo);
+        tr.blue.push(rd.F3_480nm_Blue);
+        tr.cyan.push(rd.F4_515nm_Cyan);
+        tr.green.push(rd.F5_555nm_Green);
+        tr.yellow.push(rd.F6_590nm_Yellow);
+        tr.orange.push(rd.F7_630nm_Orange);
+        tr.red.push(rd.F8_680nm_Red);
+        tr.nir.push(rd.NIR);
+        tr.photo.push(this->photoVal);
 
         lastHour = hour; // Update time for next change.
     }
@@ -144,38 +140,38 @@ void Light::computeLightTime(size_t ct, bool isLight) {
     // continuing. Once counts are met of consecutive criteria, passes.
     if (ct < LIGHT_CONSECUTIVE_CTS) return;
 
-    // Start on toggle at true. If it is dark when the device starts, light 
-    // duration will remain at 0, and will only begin counting once light
-    // is present, which will then change the toggle to false allow duration
-    // to be computed. Of toggle is used to log dark start only.
-    static bool onToggle = true, offToggle = true;
-    static uint32_t lightStart = 0;
+    // Start with the light period not in progress. If it is dark when the
+    // device starts, light duration will remain at 0, and will only begin
+    // counting once light is present, which will then set lightOn allowing
+    // the duration to be computed. A light period restored from the
+    // checkpoint continues. Off toggle is used to log dark start only.
+    static bool offToggle = true;
     Clock::TIME* dt = Clock::DateTime::get()->getTime();
 
     switch (isLight) {
         case true: // If light
         offToggle = true; // reset toggle for next dark period
-        if (onToggle) { // If true, captures start time and sets toggle to false.
-            onToggle = false;
+        if (!this->lightOn) { // Captures start time and sets the period.
+            this->lightOn = true;
             this->lightDuration = 0; // Reset at light start
-            lightStart = Clock::DateTime::get()->seconds();
+            this->lightStart = Clock::DateTime::get()->seconds();
             snprintf(Light::log, sizeof(Light::log), 
                 "%s Light start at time %u:%u:%u", this->tag, dt->hour, 
                 dt->minute, dt->second);
 
             Light::sendErr(Light::log, Messaging::Levels::INFO);
 
-        // Once toggle is set to false, the light duration can be captured.
-        } else if (!onToggle) {
+        // Once the period is in progress, the light duration can be captured.
+        } else {
 
             this->lightDuration = 
-                Clock::DateTime::get()->seconds() - lightStart;
+                Clock::DateTime::get()->seconds() - this->lightStart;
         }
 
         break;
 
         case false: // If dark
-        onToggle = true; // reset toggle for next light period
+        this->lightOn = false; // reset for next light period
 
         if (offToggle) { // If true, captures and logs the dark time.
             offToggle = false;
@@ -217,7 +213,8 @@ void Light::handleRelay(bool relayOn, size_t ct) {
 // Requires message string, and level. Level is default to ERROR. Prints to
 // both serial and log.
 void Light::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, LIGHT_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::LIGHT,
+        lvl, msg, LIGHT_LOG_METHOD);
 }
 
 // requires the int16_t readval as a reference. Adds new value into the 5 index
@@ -285,10 +282,44 @@ Light* Light::get(LightParams* parameter) {
     }
 
     static Light instance(*parameter); // Create param.
-    
+    static bool restored = instance.restore(); // Once, upon creation.
+    (void)restored;
+
     return &instance;
 }
 
+// Requires no params. Called once upon creation, prior to the instance being
+// shared. Copies the averages, trends, and light duration of the checkpoint
+// of the previous boot, seeding the rolling day averages. A light period in
+// progress resumes, its start set back by the duration, excluding the time
+// restarting. Returns true if restored.
+bool Light::restore() {
+    CheckpointLight light{0, false};
+
+    if (!Checkpoint::get()->restoreLight(this->averages, this->trends,
+        light)) return false;
+
+    // Seeds the rolling day averages with the averages restored, in the
+    // channel order of TSChan from CLEAR.
+    const Color_Averages &clr = this->averages.color;
+    const float colors[] = {clr.clear, clr.violet, clr.indigo, clr.blue,
+        clr.cyan, clr.green, clr.yellow, clr.orange, clr.red, clr.nir};
+
+    for (size_t i = 0; i < sizeof(colors) / sizeof(colors[0]); i++) {
+        Stats::get()->seed(static_cast<TSChan>(
+            static_cast<uint8_t>(TSChan::CLEAR) + i),
+            this->averages.pollCtClr, colors[i]);
+    }
+
+    Stats::get()->seed(TSChan::PHOTO, this->averages.pollCtPho,
+        this->averages.photoResistor);
+
+    this->lightDuration = light.duration;
+    this->lightOn = light.lightOn;
+    this->lightStart = Clock::DateTime::get()->seconds() - light.duration;
+    return true;
+}
+
 // Requires no parameters. Uses the AS7341 driver to read all spectral channels.
 // Returns true for a successful read, and false if not.
 bool Light::readSpectrum() {
@@ -322,12 +353,22 @@ bool Light::readSpectrum() {
         this->computeAverages(true); // Compute avg upon success.
         this->computeTrends();
 
+        // Recorded in the order of TSChan, CLEAR to NIR.
+        const float clrs[] = {tempVal.Clear, tempVal.F1_415nm_Violet,
+            tempVal.F2_445nm_Indigo, tempVal.F3_480nm_Blue,
+            tempVal.F4_515nm_Cyan, tempVal.F5_555nm_Green,
+            tempVal.F6_590nm_Yellow, tempVal.F7_630nm_Orange,
+            tempVal.F8_680nm_Red, tempVal.NIR};
+
+        TimeSeries::get()->record(TSChan::CLEAR, clrs,
+            sizeof(clrs) / sizeof(clrs[0]));
+
         if (!logOnce) { // Log for first trip only, can only be set with err.
 
-            snprintf(Light::log, sizeof(Light::log), "%s spec err fixed", 
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::LIGHT, Messaging::Levels::INFO,
+                LIGHT_LOG_METHOD, Messaging::LogFmt::LIGHT_SPEC_ERR_FIXED,
                 Light::tag);
-
-            Light::sendErr(Light::log, Messaging::Levels::INFO);
             logOnce = true; // Prevent re-log, allow err logging.
         }
         
@@ -350,11 +391,11 @@ bool Light::readSpectrum() {
 
     // Logs if sensor becomes unresponsive.
     if (this->health.spec > HEALTH_ERR_BAD && logOnce) {
-        snprintf(Light::log, sizeof(Light::log), "%s spec read err", 
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::LIGHT, Messaging::Levels::ERROR,
+            LIGHT_LOG_METHOD, Messaging::LogFmt::LIGHT_SPEC_READ_ERR,
             Light::tag);
 
-        Light::sendErr(Light::log);
-
         logOnce = false; // prevents re-log, allows fixed error log.
     }
 
@@ -405,15 +446,16 @@ bool Light::readPhoto() {
             ((tempVal / PHOTO_NOISE) * PHOTO_NOISE) : 0;
 
         this->computeAverages(false); // Comp average, false = not spectral.
+        TimeSeries::get()->record(TSChan::PHOTO, this->photoVal);
         this->health.photo *= HEALTH_EXP_DECAY; // Decays upon good read.
         this->health.photoReadErr = false;
 
         if (!logOnce) { // Log for first trip only, can only be set with err.
 
-            snprintf(Light::log, sizeof(Light::log), "%s photo err fixed", 
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::LIGHT, Messaging::Levels::INFO,
+                LIGHT_LOG_METHOD, Messaging::LogFmt::LIGHT_PHOTO_ERR_FIXED,
                 Light::tag);
-
-            Light::sendErr(Light::log, Messaging::Levels::INFO);
             logOnce = true; // Prevent re-log, allow err logging.
         }
     }
@@ -423,10 +465,10 @@ bool Light::readPhoto() {
     if (!guard.LOCK()) return false;
 
     if (this->health.photo > HEALTH_ERR_BAD && logOnce) {
-        snprintf(Light::log, sizeof(Light::log), "%s photo read err", 
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::LIGHT, Messaging::Levels::ERROR,
+            LIGHT_LOG_METHOD, Messaging::LogFmt::LIGHT_PHOTO_READ_ERR,
             Light::tag);
-
-        Light::sendErr(Light::log);
         logOnce = false; // prevents re-log, allows fixed error log.
     }
 
@@ -634,12 +676,13 @@ Light_Averages* Light::getAverages(Light_Averages* data) {
     return &this->averages;
 } 
 
-// Params data ptr is def to nullptr. Pass local by ptr to have mtx protection.
-// If mutex is locked, returns trends and updates data to trends. If not,
+// Params data ptr is def to nullptr, and hours to TREND_HOURS. Pass local by
+// ptr to have mtx protection. If mutex is locked, returns trends and updates
+// data to the newest n hours of trends, copying only those hours. If not,
 // returns and updates to an empty struct.
-Light_Trends* Light::getTrends(Light_Trends* data) {
+Light_Trends* Light::getTrends(Light_Trends* data, size_t hours) {
 
-    static Light_Trends safeEmpty = {};
+    static Light_Trends safeEmpty;
 
     Threads::MutexLock guard(Light::mtx);
 
@@ -649,14 +692,27 @@ Light_Trends* Light::getTrends(Light_Trends* data) {
     }
 
     // Locked
-    if (data != nullptr) *data = this->trends;
+    if (data != nullptr) {
+        data->clear.copyFrom(this->trends.clear, hours);
+        data->violet.copyFrom(this->trends.violet, hours);
+        data->indigo.copyFrom(this->trends.indigo, hours);
+        data->blue.copyFrom(this->trends.blue, hours);
+        data->cyan.copyFrom(this->trends.cyan, hours);
+        data->green.copyFrom(this->trends.green, hours);
+        data->yellow.copyFrom(this->trends.yellow, hours);
+        data->orange.copyFrom(this->trends.orange, hours);
+        data->red.copyFrom(this->trends.red, hours);
+        data->nir.copyFrom(this->trends.nir, hours);
+        data->photo.copyFrom(this->trends.photo, hours);
+    }
 
     return &this->trends;
 } 
 
-// Requires no parameters. Clears the current data after moving current values
-// over to previous values.
-void Light::clearAverages() {
+// Requires reset, default true. Clears the current data after moving current
+// values over to previous values, emptying the rolling statistics of the
+// spectral channels and photoresistor. If not reset, only copies them over.
+void Light::clearAverages(bool reset) {
 
     Threads::MutexLock guard(Light::mtx);
     if (!guard.LOCK()) return; // Block if unlocked.
@@ -666,10 +722,10 @@ void Light::clearAverages() {
     // Write averages into log. Prep log, do not send until complete. First
     // in order to capture current averages before resetting.
     snprintf(log, sizeof(log), 
-    "%s Averages Cleared. CL: %.1f, VI: %.1f, IN: %.1f, BL: %.1f"
+    "%s Averages %s. CL: %.1f, VI: %.1f, IN: %.1f, BL: %.1f"
     " CY %.1f, GN %1.f, YL %.1f, OR: %.1f, RD: %.1f, NIR: %.1f"
     " PHTO: %.1f. COUNT#> PHTO: %zu, SPEC: %zu", 
-    Light::tag,
+    Light::tag, reset ? "Cleared" : "Copied",
     this->averages.color.clear, this->averages.color.violet,
     this->averages.color.indigo, this->averages.color.blue,
     this->averages.color.cyan, this->averages.color.green,
@@ -683,10 +739,17 @@ void Light::clearAverages() {
     this->averages.prevColor = this->averages.color; // copies over
     this->averages.prevPhotoResistor = this->averages.photoResistor;
 
-    // Resets, the color and photoResistor only, NONE of the previous data.
-    memset(&this->averages, 0, sizeof(this->averages.color));
-    this->averages.photoResistor = 0.0f;
-    this->averages.pollCtClr = this->averages.pollCtPho = 0;
+    // Resets, the color and photoResistor only, NONE of the previous data,
+    // and the rolling statistics, unless kept.
+    if (reset) {
+        memset(&this->averages, 0, sizeof(this->averages.color));
+        this->averages.photoResistor = 0.0f;
+        this->averages.pollCtClr = this->averages.pollCtPho = 0;
+        const size_t qty = static_cast<size_t>(TSChan::PHOTO) -
+            static_cast<size_t>(TSChan::CLEAR) + 1; // Spectral and photo.
+
+        Stats::get()->clear(TSChan::CLEAR, qty);
+    }
 
     // Send log.
     Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
@@ -711,6 +774,24 @@ uint32_t Light::getDuration(uint32_t* data) {
     return this->lightDuration;
 }
 
+// Params data ptr is def to nullptr. Pass local by ptr to have mtx protection.
+// Returns and updates data to true if a light period is in progress, and
+// false if not or if the mutex is locked.
+bool Light::getLightOn(bool* data) {
+
+    Threads::MutexLock guard(Light::mtx);
+
+    if (!guard.LOCK()) {
+        if (data != nullptr) *data = false;
+        return false;
+    }
+
+    // Locked
+    if (data != nullptr) *data = this->lightOn;
+
+    return this->lightOn;
+}
+
 // Requires ATIME value. This is part of the integration method, with larger
 // values increasing the duration of light reading. Returns true if successful,
 // and false if not. Range 0 - 255. Sets class specConf variable if success.
@@ -72,14 +72,18 @@ bool Relay::changeIDState(uint8_t ID, IDSTATE newState) {
         return false; // Block.
     }
 
-    // Log the state of the change before implementing below.
-    snprintf(Relay::log, sizeof(Relay::log), 
-        "%s ID %u [%s] state changing from %s to %s", 
-        this->tag, ID, this->clientStr[ID],
-        IDSTATEMap[static_cast<uint8_t>(clients[ID])],
-        IDSTATEMap[static_cast<uint8_t>(newState)]);
+    // Log the state of the change before implementing below. Frequent, 
+    // formats only if enabled.
+    LOG_IF(Messaging::LogTag::RELAY, Messaging::Levels::INFO) {
 
-    this->sendErr(Relay::log, Messaging::Levels::INFO);
+        snprintf(Relay::log, sizeof(Relay::log), 
+            "%s ID %u [%s] state changing from %s to %s", 
+            this->tag, ID, this->clientStr[ID],
+            IDSTATEMap[static_cast<uint8_t>(clients[ID])],
+            IDSTATEMap[static_cast<uint8_t>(newState)]);
+
+        this->sendErr(Relay::log, Messaging::Levels::INFO);
+    }
 
     // Qty is limited to amount of clients actively energizing relay. Managed
     // everytime the state toggles between on and off. Qty must = 0 in order
@@ -102,8 +106,8 @@ bool Relay::changeIDState(uint8_t ID, IDSTATE newState) {
 // is set to true to allow all relay on/off activity to be tracked, even when
 // repeated.
 void Relay::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, RELAY_LOG_METHOD, 
-        true);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::RELAY,
+        lvl, msg, RELAY_LOG_METHOD, true);
 }
 
 // Require Relay Number. Dynamically creates tag. Returns the pointer to the
@@ -175,10 +179,14 @@ bool Relay::on(uint8_t ID) {
 
         // Able to set, change relay/ID state and log.
         this->relayState = RESTATE::ON;
-        snprintf(Relay::log, sizeof(Relay::log), "%s ID %u [%s] energized", 
-            this->tag, ID, this->clientStr[ID]);
 
-        this->sendErr(Relay::log, Messaging::Levels::INFO);
+        LOG_IF(Messaging::LogTag::RELAY, Messaging::Levels::INFO) {
+
+            snprintf(Relay::log, sizeof(Relay::log), "%s ID %u [%s] energized", 
+                this->tag, ID, this->clientStr[ID]);
+
+            this->sendErr(Relay::log, Messaging::Levels::INFO);
+        }
     } 
 
     return IDstate;
@@ -230,10 +238,14 @@ bool Relay::off(uint8_t ID) {
 
         // Changed level successfully. Log and change ID state.
         this->relayState = RESTATE::OFF;
-        snprintf(Relay::log, sizeof(Relay::log), "%s ID %u [%s] de-energized", 
-            this->tag, ID, this->clientStr[ID]);
 
-        this->sendErr(Relay::log, Messaging::Levels::INFO);
+        LOG_IF(Messaging::LogTag::RELAY, Messaging::Levels::INFO) {
+
+            snprintf(Relay::log, sizeof(Relay::log), "%s ID %u [%s] de-energized", 
+                this->tag, ID, this->clientStr[ID]);
+
+            this->sendErr(Relay::log, Messaging::Levels::INFO);
+        }
     } 
 
     return IDstate; 
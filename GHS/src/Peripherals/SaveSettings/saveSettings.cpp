@@ -4,6 +4,7 @@
 #include "Peripherals/TempHum.hpp"
 #include "Peripherals/Soil.hpp"
 #include "Peripherals/Light.hpp"
+#include "Peripherals/Checkpoint.hpp"
 #include "Peripherals/Relay.hpp"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -31,7 +32,8 @@ settingSaver::settingSaver() :
 
 // Requires messaging and messaging level. Level default to error.
 void settingSaver::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, SAVESETTING_ERR_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::SETTINGS,
+        lvl, msg, SAVESETTING_ERR_METHOD);
 }
 
 // Returns a pointer to the singleton instance.
@@ -126,35 +128,16 @@ void settingSaver::saveAndRestart() {
     }
 
     this->save(); // Save settings.
+    Peripheral::Checkpoint::get()->save(true); // Averages and trends.
     Clock::DateTime* dtg = Clock::DateTime::get();
 
-    // Next extract the tail of the current log to write to NVS.
-    const char* curLog = Messaging::MsgLogHandler::get()->getLog();
-    size_t logTailIdx = strlen(curLog); // use strlen to include the null term.
-
-    // Check if the current log is larger than the required pull. Set to the 
-    // smaller of the 2.
-    size_t moveSize = logTailIdx < LOG_TAIL_SIZE ? logTailIdx : LOG_TAIL_SIZE;
-    int delimPos = -2; // Delimiter position init, use to ensure success.
-
-    if (moveSize == logTailIdx) { // Indicates that log is < requested size.
-        delimPos = -1; // Allows for extraction of full log.
-
-    } else {
-        // Iterate the current log to find the first delim within req size.
-        for (int i = logTailIdx - moveSize; i < logTailIdx; i++) {
-            if (curLog[i] == MLH_DELIM) {
-                delimPos = i; // Set new position to i.
-                break;
-            }
-        }
-    }
+    // Next extract the tail of the current log to write to NVS. Only whole
+    // entries are rendered, the newest that fit within the tail.
+    size_t tailLen = Messaging::MsgLogHandler::get()->getLogTail(
+        this->logTail, sizeof(this->logTail));
 
-    if (delimPos != -2) { // Successfully found, populate the logTail.
-        memcpy(this->logTail, &curLog[delimPos + 1], moveSize);
-        this->logTail[moveSize] = '\0'; // Null term to be safe.
-    } else {
-        snprintf(this->logTail, strlen(this->logTail) + 1, "NO LOG TAIL");
+    if (tailLen == 0) {
+        snprintf(this->logTail, sizeof(this->logTail), "NO LOG TAIL");
     }
 
     // Write the log tail to the NVS to be logged as a load entry upon restart.
@@ -184,6 +167,10 @@ void settingSaver::saveAndRestart() {
         this->sendErr(this->log);
     }
 
+    // Writes the queued entries and journal batch to flash, which retains
+    // the full log of this boot beyond the tail.
+    Messaging::MsgLogHandler::get()->sync();
+
     esp_restart(); // Restart after log.
 }
 
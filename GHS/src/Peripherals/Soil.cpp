@@ -1,5 +1,8 @@
 #include "Peripherals/Soil.hpp"
 #include "Peripherals/Alert.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "Peripherals/Checkpoint.hpp"
+#include "Peripherals/Stats.hpp"
 #include "Threads/Mutex.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "string.h"
@@ -23,7 +26,6 @@ Soil::Soil(SoilParams &params) :
     }, params(params) {
 
         memset(this->data, 0, sizeof(this->data));
-        memset(this->trends, 0, sizeof(this->trends)); // Clear all trend data.
         snprintf(Soil::log, sizeof(Soil::log), "%s Ob created", Soil::tag);
         Soil::sendErr(Soil::log, Messaging::Levels::INFO);
     }
@@ -99,12 +101,13 @@ void Soil::handleAlert(AlertConfigSo &conf, SoilReadings &data,
 
 // Requires message and messaging level. Default level set to ERROR.
 void Soil::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, SOIL_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::SOIL,
+        lvl, msg, SOIL_LOG_METHOD);
 }
 
-// Requires no params. Gets the current hour. When the hour switches, hours
-// 0 to n - 1 will be captured and moved to position 1 to n, position 0 will
-// have the new value written into it after the move. 
+// Requires the sensor index number. Gets the current hour. When the hour
+// switches, the current reading is pushed as the newest hour of the sensor
+// trend, O(1) regardless of TREND_HOURS.
 void Soil::computeTrends(uint8_t indexNum) {
 
     // Get current hour. Set static last hour equal to. This should init at
@@ -116,13 +119,7 @@ void Soil::computeTrends(uint8_t indexNum) {
     static uint8_t lastHours[SOIL_SENSORS] = {hour, hour, hour, hour};
 
     if (hour != lastHours[indexNum]) { // Change detected.
-
-        // Move (idx 0 to n-1) to (idx 1 to n). Opens idx 0 for new val.
-        memmove(&this->trends[indexNum][1], this->trends[indexNum], 
-            sizeof(this->trends[indexNum]) - sizeof(this->trends[0][0]));
-
-        this->trends[indexNum][0] = this->data[indexNum].val; // Current
-
+        this->trends[indexNum].push(this->data[indexNum].val); // Current
         lastHours[indexNum] = hour; // Update time for next change.
     }
 }
@@ -190,7 +187,12 @@ Soil* Soil::get(SoilParams* parameter) {
     }
 
     static Soil instance(*parameter);
-    
+
+    // Once, upon creation, resumes the trends of the checkpoint of the
+    // previous boot.
+    static bool restored = Checkpoint::get()->restoreSoil(instance.trends);
+
+    (void)restored;
     return &instance;
 }
 
@@ -310,13 +312,19 @@ void Soil::readAll() {
 
             this->computeTrends(i); // Compute trends for soil sensor.
 
+            TSChan chan = static_cast<TSChan>(
+                static_cast<uint8_t>(TSChan::SOIL0) + i);
+
+            TimeSeries::get()->record(chan, this->data[i].val);
+            Stats::get()->add(chan, this->data[i].val);
+
             // Log fixing error if triggered by previous err and err is fixed.
             if (!logOnce[i]) { // Can only be set by err below.
 
-            snprintf(Soil::log, sizeof(Soil::log), "%s snsr %d err fixed",
-                Soil::tag, i);
-
-            Soil::sendErr(Soil::log, Messaging::Levels::INFO);
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::SOIL, Messaging::Levels::INFO,
+                SOIL_LOG_METHOD, Messaging::LogFmt::SOIL_ERR_FIXED, Soil::tag,
+                i);
             logOnce[i] = true; // Preven re-log, allow err logging.
             }
         }
@@ -327,10 +335,10 @@ void Soil::readAll() {
 
         // If several consecutive bad reads, log sensor issue.
         if (this->data[i].sensHealth > HEALTH_ERR_BAD && logOnce[i]) {
-            snprintf(Soil::log, sizeof(Soil::log), "%s snsr %d read err",
-                Soil::tag, i);
-
-            Soil::sendErr(Soil::log);
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::SOIL, Messaging::Levels::ERROR,
+                SOIL_LOG_METHOD, Messaging::LogFmt::SOIL_READ_ERR, Soil::tag,
+                i);
             logOnce[i] = false; // Prevents re-log, allows fixed error log only.
         }
     }  
@@ -467,11 +475,12 @@ void Soil::checkBounds() {
     }
 }
 
-// Requires the sensor number, and data ptr that is default to nullptr. 
-// WARNING: If passing a data pointer, ensure a 1D array int16_t arr[12], for
-// a total of 24 bytes. If mtx is locked, updates data under mtx protection,
-// and returns trends. If not, does this same but with an empty set.
-int16_t* Soil::getTrends(uint8_t indexNum, int16_t* data) {
+// Requires the sensor number, data ptr that is default to nullptr, and hours
+// default to TREND_HOURS. If mtx is locked, updates data under mtx protection
+// with the newest n hours, and returns trends. If not, does this same but
+// with an empty set.
+Soil_Trends* Soil::getTrends(uint8_t indexNum, Soil_Trends* data,
+    size_t hours) {
 
     // Ensure the index num is within range.
     if (indexNum >= SOIL_SENSORS) {
@@ -482,50 +491,48 @@ int16_t* Soil::getTrends(uint8_t indexNum, int16_t* data) {
         return nullptr;
     }
 
-    static int16_t safeEmpty[TREND_HOURS] = {};
+    static Soil_Trends safeEmpty;
 
     // Idx within range lock to prevent modification.
     Threads::MutexLock guard(Soil::mtx);
 
     if (!guard.LOCK()) {
-        if (data != nullptr) {
-            memcpy(data, safeEmpty, sizeof(safeEmpty));
-        }
-
-        return safeEmpty;
+        if (data != nullptr) *data = safeEmpty;
+        return &safeEmpty;
     }
 
     // Locked
-    if (data != nullptr) {
-        memcpy(data, this->trends[indexNum], sizeof(this->trends[indexNum]));
-    }
+    if (data != nullptr) data->copyFrom(this->trends[indexNum], hours);
 
-    return this->trends[indexNum];
+    return &this->trends[indexNum];
 }
 
-// Param data pointer is def to nullptr. If passing by pointer, ensure a 2D
-// array int16_t arr[4][12] is passed, for a total of 96 butes. If mtx is 
-// locked, updates data under mtx protection, and returns all trends. If not,
-// does the same but with an empty set.
-int16_t* Soil::getAllTrends(int16_t *data) {
+// Param data pointer is def to nullptr, and hours to TREND_HOURS. If passing
+// by pointer, ensure an array Soil_Trends arr[SOIL_SENSORS] is passed. If mtx
+// is locked, updates data under mtx protection with the newest n hours, and
+// returns all trends. If not, does the same but with an empty set.
+Soil_Trends* Soil::getAllTrends(Soil_Trends* data, size_t hours) {
 
-    static int16_t safeEmpty[SOIL_SENSORS][TREND_HOURS] = {}; 
+    static Soil_Trends safeEmpty[SOIL_SENSORS];
 
     Threads::MutexLock guard(Soil::mtx);
 
     if (!guard.LOCK()) {
         if (data != nullptr) {
-            memcpy(data, safeEmpty, sizeof(safeEmpty));
-            return &safeEmpty[0][0];
+            for (size_t i = 0; i < SOIL_SENSORS; i++) data[i] = safeEmpty[i];
         }
+
+        return safeEmpty;
     }
 
     // Locked
     if (data != nullptr) {
-        memcpy(data, this->trends, sizeof(this->trends));
+        for (size_t i = 0; i < SOIL_SENSORS; i++) {
+            data[i].copyFrom(this->trends[i], hours);
+        }
     }
 
-    return &this->trends[0][0];
+    return this->trends;
 }
 
 // Used for testing. Comment out when done.
@@ -0,0 +1,369 @@
+#include "Peripherals/Stats.hpp"
+#include "string.h"
+#include "math.h"
+#include "Threads/Mutex.hpp"
+#include "Common/Timing.hpp"
+
+namespace Peripheral {
+
+// Static Setup
+Threads::Mutex Stats::mtx(STATS_TAG);
+
+// Bucket millis, buckets, closed slots, and ring offset of each window, see
+// StatsWin. A window holds its open bucket and one less closed, spanning at
+// most its buckets.
+static const uint32_t bucketMs[STATS_WINDOWS] = {
+    STATS_SHORT_MS, STATS_HOUR_MS, STATS_DAY_MS};
+
+static const uint8_t buckets[STATS_WINDOWS] = {
+    STATS_SHORT_BUCKETS, STATS_HOUR_BUCKETS, STATS_DAY_BUCKETS};
+
+static const uint8_t slots[STATS_WINDOWS] = {
+    STATS_SHORT_BUCKETS - 1, STATS_HOUR_BUCKETS - 1, STATS_DAY_BUCKETS - 1};
+
+static const uint8_t offsets[STATS_WINDOWS] = {
+    0, STATS_SHORT_BUCKETS - 1, STATS_SHORT_BUCKETS + STATS_HOUR_BUCKETS - 2};
+
+static_assert(STATS_RING <= 255, "STATS_RING exceeds the deque slots");
+static_assert(sizeof(Stats) <= STATS_MAX_BYTES, "Stats exceeds its budget");
+static_assert(STATS_SHORT_BUCKETS > 1 && STATS_HOUR_BUCKETS > 1 &&
+    STATS_DAY_BUCKETS > 1, "Stats windows require 2 buckets");
+
+Stats::Stats() {
+    memset(this->chans, 0, sizeof(this->chans));
+
+    for (size_t c = 0; c < TS_CHANNELS; c++) {
+        for (uint8_t w = 0; w < STATS_WINDOWS; w++) {
+            Stats::resetTier(this->chans[c].tier[w]);
+        }
+    }
+}
+
+// Requires the window state. Empties it, its open bucket, closed buckets,
+// and moving average. The bucket index is kept, the next roll aligns it.
+void Stats::resetTier(StatsTier &tier) {
+    Stats::resetBucket(tier.open);
+    tier.closed = tier.held = 0;
+    tier.minHead = tier.minQty = tier.maxHead = tier.maxQty = 0;
+    tier.aggCount = 0;
+    tier.aggMean = tier.aggM2 = 0.0;
+    tier.ema = 0.0f;
+    tier.emaAt = -1;
+    tier.seedCount = tier.seedAt = 0;
+    tier.seedMean = 0.0f;
+}
+
+// Requires the bucket. Empties it.
+void Stats::resetBucket(StatsBucket &bkt) {
+    bkt.mean = bkt.m2 = bkt.min = bkt.max = 0.0f;
+    bkt.count = 0;
+}
+
+// Requires the aggregate count, mean, and m2 references, the bucket, and
+// remove, default false. Merges the bucket into the aggregate, or removes
+// it, by the parallel form of Welford's method. Removal clamps m2 to 0,
+// absorbing rounding.
+void Stats::merge(uint32_t &count, double &mean, double &m2,
+    const StatsBucket &bkt, bool remove) {
+
+    if (bkt.count == 0) return;
+    double nb = bkt.count;
+
+    if (!remove) {
+        double n = static_cast<double>(count) + nb;
+        double delta = bkt.mean - mean;
+        mean += delta * nb / n;
+        m2 += bkt.m2 + delta * delta * count * nb / n;
+        count += bkt.count;
+        return;
+    }
+
+    if (bkt.count >= count) { // Nothing remains.
+        count = 0;
+        mean = m2 = 0.0;
+        return;
+    }
+
+    double n = static_cast<double>(count - bkt.count);
+    double newMean = (mean * count - bkt.mean * nb) / n;
+    double delta = bkt.mean - newMean;
+    m2 -= bkt.m2 + delta * delta * n * nb / count;
+    if (m2 < 0.0) m2 = 0.0;
+    mean = newMean;
+    count -= bkt.count;
+}
+
+// Requires the channel, window, and bucket index of the runtime. Closes the
+// open bucket, and any empty buckets elapsed since, so the oldest leave the
+// window. A gap exceeding the window empties it. Caller must hold mtx.
+void Stats::roll(StatsChan &ch, uint8_t win, uint32_t idx) {
+    StatsTier &tier = ch.tier[win];
+    if (idx <= tier.openIdx) return;
+
+    if (idx - tier.openIdx > buckets[win]) {
+        float ema = tier.ema;
+        int64_t emaAt = tier.emaAt;
+        Stats::resetTier(tier);
+        tier.ema = ema; // The average decays across the gap.
+        tier.emaAt = emaAt;
+        tier.openIdx = idx;
+        return;
+    }
+
+    while (tier.openIdx < idx) {
+        this->push(ch, win, tier.open);
+        Stats::resetBucket(tier.open);
+        tier.openIdx++;
+    }
+}
+
+// Requires the window state and window. Returns the readings of the seed
+// still weighed, its count less a bucket share per bucket closed since,
+// 0 once the closed buckets and the open one span the window.
+uint32_t Stats::seedLeft(const StatsTier &tier, uint8_t win) {
+    const uint32_t span = slots[win]; // Excludes the open bucket.
+    uint32_t since = tier.closed - tier.seedAt;
+    if (tier.seedCount == 0 || since >= span) return 0;
+
+    return static_cast<uint32_t>(static_cast<uint64_t>(tier.seedCount) *
+        (span - since) / span);
+}
+
+// Requires the channel and window. Removes the oldest closed bucket from the
+// aggregate, and from the front of the deques if held there. Caller must
+// hold mtx.
+void Stats::evict(StatsChan &ch, uint8_t win) {
+    StatsTier &tier = ch.tier[win];
+    const uint8_t cap = slots[win];
+    const uint8_t off = offsets[win];
+
+    uint8_t slot = (tier.closed - tier.held) % cap;
+    Stats::merge(tier.aggCount, tier.aggMean, tier.aggM2, ch.ring[off + slot],
+        true);
+
+    if (tier.minQty > 0 && ch.minQ[off + tier.minHead] == slot) {
+        tier.minHead = (tier.minHead + 1) % cap;
+        tier.minQty--;
+    }
+
+    if (tier.maxQty > 0 && ch.maxQ[off + tier.maxHead] == slot) {
+        tier.maxHead = (tier.maxHead + 1) % cap;
+        tier.maxQty--;
+    }
+
+    tier.held--;
+}
+
+// Requires the channel, window, and the closed bucket. Pushes it as the
+// newest of the window, evicting the oldest once its slots are full, so the
+// closed buckets and the open one span the window. Buckets with extremes
+// enter the deques, after popping those from the back that they surpass,
+// each slot entering and leaving once, O(1) amortized. Caller must hold mtx.
+void Stats::push(StatsChan &ch, uint8_t win, const StatsBucket &bkt) {
+    StatsTier &tier = ch.tier[win];
+    const uint8_t cap = slots[win];
+    const uint8_t off = offsets[win];
+
+    if (tier.held == cap) this->evict(ch, win);
+
+    uint8_t slot = tier.closed % cap;
+    ch.ring[off + slot] = bkt;
+    Stats::merge(tier.aggCount, tier.aggMean, tier.aggM2, bkt);
+    tier.closed++;
+    tier.held++;
+
+    if (bkt.count == 0) return; // No extremes.
+
+    while (tier.minQty > 0) { // Ascending mins from the front.
+        uint8_t back = ch.minQ[off + (tier.minHead + tier.minQty - 1) % cap];
+        if (ch.ring[off + back].min < bkt.min) break;
+        tier.minQty--;
+    }
+
+    ch.minQ[off + (tier.minHead + tier.minQty) % cap] = slot;
+    tier.minQty++;
+
+    while (tier.maxQty > 0) { // Descending maxes from the front.
+        uint8_t back = ch.maxQ[off + (tier.maxHead + tier.maxQty - 1) % cap];
+        if (ch.ring[off + back].max > bkt.max) break;
+        tier.maxQty--;
+    }
+
+    ch.maxQ[off + (tier.maxHead + tier.maxQty) % cap] = slot;
+    tier.maxQty++;
+}
+
+// Requires no params. Returns the instance.
+Stats* Stats::get() {
+    static Stats instance;
+    return &instance;
+}
+
+// Requires the first channel, values, and quantity of consecutive channels.
+// Adds each reading to every window of its channel, rolling elapsed buckets
+// first.
+void Stats::add(TSChan first, const float* vals, size_t qty) {
+    size_t start = static_cast<size_t>(first);
+    if (start + qty > TS_CHANNELS) return; // Range.
+
+    int64_t now = Clock::DateTime::get()->millis();
+
+    Threads::MutexLock guard(Stats::mtx);
+    if (!guard.LOCK()) return;
+
+    for (size_t i = 0; i < qty; i++) {
+        StatsChan &ch = this->chans[start + i];
+        float val = vals[i];
+
+        for (uint8_t w = 0; w < STATS_WINDOWS; w++) {
+            this->roll(ch, w, static_cast<uint32_t>(now / bucketMs[w]));
+
+            StatsTier &tier = ch.tier[w];
+            StatsBucket &bkt = tier.open;
+
+            if (bkt.count == 0 || val < bkt.min) bkt.min = val;
+            if (bkt.count == 0 || val > bkt.max) bkt.max = val;
+            bkt.count++;
+            float delta = val - bkt.mean;
+            bkt.mean += delta / bkt.count;
+            bkt.m2 += delta * (val - bkt.mean);
+
+            // Time weighted, readings at irregular periods weigh by the
+            // time since the previous.
+            if (tier.emaAt < 0) {
+                tier.ema = val;
+            } else {
+                float dt = static_cast<float>(now - tier.emaAt);
+                float tau = static_cast<float>(bucketMs[w]) * buckets[w];
+                tier.ema += (val - tier.ema) * dt / (tau + dt);
+            }
+
+            tier.emaAt = now;
+        }
+    }
+}
+
+// Requires the channel and value. Adds a single reading, see above.
+void Stats::add(TSChan chan, float val) {
+    this->add(chan, &val, 1);
+}
+
+// Requires the channel, window, and figures reference. Sets the figures of
+// the readings within the window, rolling elapsed buckets first. The count
+// and mean include what remains of a seed, the stdev only the readings. If
+// no extremes are held, such as only a seed, min and max are the mean.
+// Returns true if the window holds readings, false if not, out of range, or
+// unable to lock, the figures then 0.
+bool Stats::getFigures(TSChan chan, StatsWin win, StatsFigures &out) {
+    memset(&out, 0, sizeof(out));
+    size_t c = static_cast<size_t>(chan);
+    uint8_t w = static_cast<uint8_t>(win);
+    if (c >= TS_CHANNELS || w >= STATS_WINDOWS) return false;
+
+    int64_t now = Clock::DateTime::get()->millis();
+
+    Threads::MutexLock guard(Stats::mtx);
+    if (!guard.LOCK()) return false;
+
+    StatsChan &ch = this->chans[c];
+    this->roll(ch, w, static_cast<uint32_t>(now / bucketMs[w]));
+
+    const StatsTier &tier = ch.tier[w];
+    const uint8_t off = offsets[w];
+    uint32_t count = tier.aggCount;
+    double mean = tier.aggMean, m2 = tier.aggM2;
+    Stats::merge(count, mean, m2, tier.open);
+
+    out.stdev = (count > 1) ? static_cast<float>(sqrt(m2 / (count - 1))) :
+        0.0f;
+
+    StatsBucket seed{tier.seedMean, 0.0f, 0.0f, 0.0f,
+        Stats::seedLeft(tier, w)};
+
+    Stats::merge(count, mean, m2, seed);
+
+    if (count == 0) {
+        out.stdev = 0.0f;
+        return false;
+    }
+
+    out.count = count;
+    out.mean = static_cast<float>(mean);
+
+    bool hasMin{false}, hasMax{false};
+
+    if (tier.minQty > 0) {
+        out.min = ch.ring[off + ch.minQ[off + tier.minHead]].min;
+        hasMin = true;
+    }
+
+    if (tier.maxQty > 0) {
+        out.max = ch.ring[off + ch.maxQ[off + tier.maxHead]].max;
+        hasMax = true;
+    }
+
+    if (tier.open.count > 0) {
+        if (!hasMin || tier.open.min < out.min) out.min = tier.open.min;
+        if (!hasMax || tier.open.max > out.max) out.max = tier.open.max;
+        hasMin = hasMax = true;
+    }
+
+    if (!hasMin) out.min = out.mean;
+    if (!hasMax) out.max = out.mean;
+    out.ema = (tier.emaAt < 0) ? out.mean : tier.ema;
+    return true;
+}
+
+// Requires the first channel, and quantity of consecutive channels. Empties
+// every window of each channel.
+void Stats::clear(TSChan first, size_t qty) {
+    size_t start = static_cast<size_t>(first);
+    if (start + qty > TS_CHANNELS) return; // Range.
+
+    Threads::MutexLock guard(Stats::mtx);
+    if (!guard.LOCK()) return;
+
+    for (size_t i = 0; i < qty; i++) {
+        for (uint8_t w = 0; w < STATS_WINDOWS; w++) {
+            Stats::resetTier(this->chans[start + i].tier[w]);
+        }
+    }
+}
+
+// Requires the channel, count, and mean. Seeds the day window with the mean
+// of count readings, and starts its moving average from it. Used to resume
+// a day average restored upon boot, standing in for the part of the day not
+// yet covered by closed buckets, its count tapering by a bucket share as
+// each closes, so it expires once a day of buckets close after it.
+void Stats::seed(TSChan chan, uint32_t count, float mean) {
+    size_t c = static_cast<size_t>(chan);
+    if (c >= TS_CHANNELS || count == 0) return;
+
+    int64_t now = Clock::DateTime::get()->millis();
+    uint8_t w = static_cast<uint8_t>(StatsWin::DAY);
+
+    Threads::MutexLock guard(Stats::mtx);
+    if (!guard.LOCK()) return;
+
+    StatsChan &ch = this->chans[c];
+    this->roll(ch, w, static_cast<uint32_t>(now / bucketMs[w]));
+
+    StatsTier &tier = ch.tier[w];
+    tier.seedCount = count;
+    tier.seedMean = mean;
+    tier.seedAt = tier.closed;
+
+    if (tier.emaAt < 0) {
+        tier.ema = mean;
+        tier.emaAt = now;
+    }
+}
+
+// Requires the window. Returns the seconds it spans.
+uint32_t Stats::windowSecs(StatsWin win) {
+    uint8_t w = static_cast<uint8_t>(win);
+    if (w >= STATS_WINDOWS) return 0;
+    return bucketMs[w] / 1000 * buckets[w];
+}
+
+}
@@ -0,0 +1,499 @@
+#include "Peripherals/TSCodec.hpp"
+#include "string.h"
+#include "math.h"
+
+namespace Peripheral {
+
+// Temp and hum at 0.01 resolution, from -40 C and 0 %. AS7341 counts, photo,
+// and soil are stored as read. History tolerances exceed the noise of the
+// minute mean, 0.05 C, 0.25 %, 8 counts and 6 % of the AS7341 channels and
+// photo, and SOIL_NOISE.
+const TSChanInfo TSCodec::info[TS_CHANNELS] = {
+    {"temp", -40.0f, 100.0f, 2, 5, 0}, {"hum", 0.0f, 100.0f, 2, 25, 0},
+    {"clear", 0.0f, 1.0f, 0, 8, 16}, {"violet", 0.0f, 1.0f, 0, 8, 16},
+    {"indigo", 0.0f, 1.0f, 0, 8, 16}, {"blue", 0.0f, 1.0f, 0, 8, 16},
+    {"cyan", 0.0f, 1.0f, 0, 8, 16}, {"green", 0.0f, 1.0f, 0, 8, 16},
+    {"yellow", 0.0f, 1.0f, 0, 8, 16}, {"orange", 0.0f, 1.0f, 0, 8, 16},
+    {"red", 0.0f, 1.0f, 0, 8, 16}, {"nir", 0.0f, 1.0f, 0, 8, 16},
+    {"photo", 0.0f, 1.0f, 0, 5, 16}, {"soil_0", 0.0f, 1.0f, 0, 10, 0},
+    {"soil_1", 0.0f, 1.0f, 0, 10, 0}, {"soil_2", 0.0f, 1.0f, 0, 10, 0},
+    {"soil_3", 0.0f, 1.0f, 0, 10, 0}};
+
+static_assert(static_cast<size_t>(TSChan::SOIL3) + 1 == TS_CHANNELS,
+    "TSChan does not match TS_CHANNELS");
+
+static_assert(TS_BLOCK_SIZE - sizeof(TSBlockHdr) <= 0xFFFF / 8,
+    "TSBlockHdr bits overflow");
+
+// Requires the channel index and value. Returns the quantized value, see
+// TSChanInfo.
+uint16_t TSCodec::encode(uint8_t chan, float val) {
+    const TSChanInfo &ch = TSCodec::info[chan];
+    float code = roundf((val - ch.offset) * ch.scale);
+
+    if (code < 0.0f) return 0;
+    if (code > TS_CODE_MAX) return TS_CODE_MAX;
+    return static_cast<uint16_t>(code);
+}
+
+// Requires the channel index, and quantized value. Returns the value.
+float TSCodec::decode(uint8_t chan, uint16_t code) {
+    const TSChanInfo &ch = TSCodec::info[chan];
+    return code / ch.scale + ch.offset;
+}
+
+// Requires a signed value. Returns it interleaved, 0, -1, 1, -2... as
+// 0, 1, 2, 3..., keeping small magnitudes small.
+uint32_t TSCodec::zigzag(int32_t val) {
+    return (static_cast<uint32_t>(val) << 1) ^ static_cast<uint32_t>(val >> 31);
+}
+
+// Requires the zig-zag value. Returns the signed value.
+int32_t TSCodec::unzigzag(uint32_t val) {
+    return static_cast<int32_t>(val >> 1) ^ -static_cast<int32_t>(val & 1);
+}
+
+// Requires the channel index, and the reference code. Returns the codes a
+// value may differ from the reference, and be stored as the reference, see
+// TSChanInfo band and rel.
+int32_t TSCodec::tolerance(uint8_t chan, uint16_t ref) {
+    const TSChanInfo &ch = TSCodec::info[chan];
+    return ch.band + ((static_cast<int32_t>(ref) * ch.rel) >> 8);
+}
+
+// Requires the trend, and the code of the first row. Starts it without
+// slope.
+void TSCodec::trendStart(TSTrend &trend, uint16_t code) {
+    trend = {static_cast<int32_t>(code) << 4, 0, code, 0};
+}
+
+// Requires the trend. Returns the code predicted for the next row, clamped
+// to 0 - TS_CODE_MAX.
+uint16_t TSCodec::trendPredict(const TSTrend &trend) {
+    int32_t pred = (trend.pos + trend.slope + 8) >> 4;
+
+    if (pred < 0) return 0;
+    if (pred > TS_CODE_MAX) return TS_CODE_MAX;
+    return static_cast<uint16_t>(pred);
+}
+
+// Requires the trend, and the code of the row. Advances the trend if the
+// code is as predicted, else anchors the code, the slope becoming that from
+// the previous anchor.
+void TSCodec::trendUpdate(TSTrend &trend, uint16_t code) {
+    if (code == TSCodec::trendPredict(trend)) {
+        trend.pos += trend.slope;
+
+        // Bounds the position to the codes, the slope held.
+        const int32_t max = static_cast<int32_t>(TS_CODE_MAX) << 4;
+        if (trend.pos < 0) trend.pos = 0;
+        if (trend.pos > max) trend.pos = max;
+        if (trend.since < UINT16_MAX) trend.since++;
+        return;
+    }
+
+    trend.slope = ((static_cast<int32_t>(code) - trend.anchor) << 4) /
+        (trend.since + 1);
+
+    trend.pos = static_cast<int32_t>(code) << 4;
+    trend.anchor = code;
+    trend.since = 0;
+}
+
+// Requires the trends of every channel, the channel index, and the codes
+// of the row being encoded or decoded, those prior to chan set. Returns the
+// predicted code. The AS7341 channels and photo share the light of CLEAR,
+// and are predicted to hold their ratio to it, following passing clouds.
+// The remaining channels continue their trend.
+uint16_t TSCodec::predict(const TSTrend* trends, uint8_t chan,
+    const uint16_t* row) {
+
+    const uint8_t clr = static_cast<uint8_t>(TSChan::CLEAR);
+    const TSTrend &clrTrend = trends[clr];
+
+    if (chan <= clr || chan > static_cast<uint8_t>(TSChan::PHOTO) ||
+        clrTrend.pos < 16) { // Below 1 count, the ratio is unknown.
+        return TSCodec::trendPredict(trends[chan]);
+    }
+
+    uint64_t pred = (static_cast<uint64_t>(trends[chan].pos) * row[clr] +
+        clrTrend.pos / 2) / clrTrend.pos;
+
+    return (pred > TS_CODE_MAX) ? TS_CODE_MAX : static_cast<uint16_t>(pred);
+}
+
+TSBitWriter::TSBitWriter() : buf(nullptr), capBits(0), pos(0) {}
+
+// Requires the buffer, its size, and the bit position to resume from.
+void TSBitWriter::begin(uint8_t* buf, size_t size, size_t pos) {
+    this->buf = buf;
+    this->capBits = size * 8;
+    this->pos = pos;
+}
+
+// Requires the value, and its width in bits, 1 - 32. Writes the low bits of
+// the value. Returns true if written, false if it does not fit.
+bool TSBitWriter::put(uint32_t val, uint8_t bits) {
+    if (this->buf == nullptr || this->pos + bits > this->capBits) return false;
+
+    while (bits > 0) {
+        size_t byte = this->pos >> 3;
+        uint8_t used = this->pos & 7; // Bits used of the current byte.
+        uint8_t room = 8 - used;
+        uint8_t take = (bits < room) ? bits : room;
+
+        uint8_t chunk = (val >> (bits - take)) & ((1u << take) - 1);
+        if (used == 0) this->buf[byte] = 0; // Clears stale bytes.
+        this->buf[byte] |= chunk << (room - take);
+
+        this->pos += take;
+        bits -= take;
+    }
+
+    return true;
+}
+
+size_t TSBitWriter::getPos() const {return this->pos;}
+
+// Requires a bit position previously returned by getPos(). Discards the
+// bits written after it.
+void TSBitWriter::rewind(size_t pos) {
+    if (pos >= this->pos) return;
+
+    this->pos = pos;
+    uint8_t used = pos & 7;
+
+    if (used > 0) { // Clears the partial byte, put() ORs into it.
+        this->buf[pos >> 3] &= static_cast<uint8_t>(0xFF << (8 - used));
+    }
+}
+
+TSBitReader::TSBitReader(const uint8_t* buf, size_t lenBits) :
+
+    buf(buf), lenBits(lenBits), pos(0) {}
+
+// Requires the width in bits, 1 - 32, and reference to the value. Returns
+// true if read, false if exceeding the bitstream.
+bool TSBitReader::get(uint8_t bits, uint32_t &val) {
+    if (this->pos + bits > this->lenBits) return false;
+
+    val = 0;
+
+    while (bits > 0) {
+        uint8_t used = this->pos & 7;
+        uint8_t room = 8 - used;
+        uint8_t take = (bits < room) ? bits : room;
+
+        uint8_t chunk = (this->buf[this->pos >> 3] >> (room - take)) &
+            ((1u << take) - 1);
+
+        val = (val << take) | chunk;
+        this->pos += take;
+        bits -= take;
+    }
+
+    return true;
+}
+
+TSBlockWriter::TSBlockWriter() : block(nullptr), hdr{}, prevMin(0),
+    prevDelta(1), trend{} {}
+
+// Requires the block, TS_BLOCK_SIZE, and boot number. Starts an empty block.
+void TSBlockWriter::begin(uint8_t* block, uint16_t boot) {
+    this->block = block;
+    this->hdr = {TS_CODEC_VERSION, TS_CHANNELS, boot, 0, 0, 0};
+    this->bits.begin(block + sizeof(TSBlockHdr),
+        TS_BLOCK_SIZE - sizeof(TSBlockHdr));
+
+    memcpy(this->block, &this->hdr, sizeof(this->hdr));
+}
+
+// Requires the runtime minute, later than the previous row, and the codes
+// of each channel. Appends the row. Returns true if appended, false if the
+// block is full or not begun, leaving it unchanged.
+bool TSBlockWriter::append(uint32_t minute, const uint16_t* codes) {
+    if (this->block == nullptr) return false;
+
+    size_t mark = this->bits.getPos();
+    bool ok = true;
+
+    if (this->hdr.rows == 0) { // Raw.
+        for (size_t c = 0; c < TS_CHANNELS && ok; c++) {
+            ok = this->bits.put(codes[c], 16);
+        }
+
+        if (ok) {
+            this->hdr.startMin = minute;
+            this->prevDelta = 1; // A regular minute follows for 1 bit.
+        }
+
+    } else {
+        int32_t delta = static_cast<int32_t>(minute - this->prevMin);
+        uint32_t dod = TSCodec::zigzag(delta - this->prevDelta);
+
+        if (dod == 0) {
+            ok = this->bits.put(0, 1);
+        } else if (dod < (1u << 7)) {
+            ok = this->bits.put(0b10, 2) && this->bits.put(dod, 7);
+        } else if (dod < (1u << 9)) {
+            ok = this->bits.put(0b110, 3) && this->bits.put(dod, 9);
+        } else if (dod < (1u << 12)) {
+            ok = this->bits.put(0b1110, 4) && this->bits.put(dod, 12);
+        } else {
+            ok = this->bits.put(0b1111, 4) && this->bits.put(dod, 32);
+        }
+
+        for (uint8_t c = 0; c < TS_CHANNELS && ok; c++) {
+            uint32_t zz = TSCodec::zigzag(
+                static_cast<int32_t>(codes[c]) - this->predict(c, codes));
+
+            if (zz == 0) continue; // As predicted.
+
+            ok = this->bits.put(1, 1) && this->bits.put(c, TS_CHAN_BITS);
+
+            if (!ok) {
+                break;
+            } else if (zz <= (1u << 4)) { // Stored less 1, never 0.
+                ok = this->bits.put(0b0, 1) && this->bits.put(zz - 1, 4);
+            } else if (zz <= (1u << 8)) {
+                ok = this->bits.put(0b10, 2) && this->bits.put(zz - 1, 8);
+            } else {
+                ok = this->bits.put(0b11, 2) && this->bits.put(zz - 1, 17);
+            }
+        }
+
+        ok = ok && this->bits.put(0, 1); // Ends the row.
+        if (ok) this->prevDelta = delta;
+    }
+
+    if (!ok) { // Full, the row begins the next block.
+        this->bits.rewind(mark);
+        return false;
+    }
+
+    this->prevMin = minute;
+
+    for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+        if (this->hdr.rows == 0) {
+            TSCodec::trendStart(this->trend[c], codes[c]);
+        } else {
+            TSCodec::trendUpdate(this->trend[c], codes[c]);
+        }
+    }
+
+    this->hdr.rows++;
+    this->hdr.bits = static_cast<uint16_t>(this->bits.getPos());
+    memcpy(this->block, &this->hdr, sizeof(this->hdr));
+    return true;
+}
+
+// Requires no params. Seals the block, further appends are refused.
+void TSBlockWriter::end() {this->block = nullptr;}
+
+bool TSBlockWriter::isOpen() const {return this->block != nullptr;}
+
+uint16_t TSBlockWriter::getRows() const {return this->hdr.rows;}
+
+// Requires the channel index, and the codes of the next row prior to chan.
+// Returns the code predicted for the channel, valid once a row is appended.
+uint16_t TSBlockWriter::predict(uint8_t chan, const uint16_t* row) const {
+    return TSCodec::predict(this->trend, chan, row);
+}
+
+// Requires the block, and its length. Validates the header against the
+// length, an invalid block reads no rows.
+TSBlockReader::TSBlockReader(const uint8_t* block, size_t len) :
+
+    hdr{}, bits(nullptr, 0), row(0), prevMin(0), prevDelta(1), trend{},
+    valid(false) {
+
+    if (len < sizeof(TSBlockHdr)) return;
+    memcpy(&this->hdr, block, sizeof(this->hdr));
+
+    size_t bytes = (this->hdr.bits + 7) / 8;
+
+    this->valid = (this->hdr.version == TS_CODEC_VERSION &&
+        this->hdr.chans == TS_CHANNELS &&
+        sizeof(TSBlockHdr) + bytes <= len);
+
+    if (this->valid) {
+        this->bits = TSBitReader(block + sizeof(TSBlockHdr), this->hdr.bits);
+    }
+}
+
+// Requires reference to the minute, and the codes of TS_CHANNELS. Decodes
+// the next row. Returns true if decoded, false once all rows are read, or if
+// the block is malformed, leaving the codes undefined.
+bool TSBlockReader::next(uint32_t &minute, uint16_t* codes) {
+    if (!this->valid || this->row >= this->hdr.rows) return false;
+
+    uint32_t val{0};
+
+    if (this->row == 0) { // Raw.
+        for (size_t c = 0; c < TS_CHANNELS; c++) {
+            if (!this->bits.get(16, val)) return (this->valid = false);
+            codes[c] = static_cast<uint16_t>(val);
+            TSCodec::trendStart(this->trend[c], codes[c]);
+        }
+
+        this->prevMin = this->hdr.startMin;
+        this->prevDelta = 1;
+
+    } else {
+        uint8_t prefix = 0; // Leading 1 bits, up to 4.
+        while (prefix < 4 && this->bits.get(1, val) && val == 1) prefix++;
+
+        static const uint8_t dodBits[] = {0, 7, 9, 12, 32};
+        uint32_t dod{0};
+
+        if (prefix > 0 && !this->bits.get(dodBits[prefix], dod)) {
+            return (this->valid = false);
+        }
+
+        this->prevDelta += TSCodec::unzigzag(dod);
+        this->prevMin += this->prevDelta;
+
+        int32_t diff[TS_CHANNELS] = {0}; // From prediction.
+        uint32_t more{0}, chan{0}, width{0}, zz{0};
+
+        while (true) {
+            if (!this->bits.get(1, more)) return (this->valid = false);
+            if (more == 0) break; // Row ends.
+
+            if (!this->bits.get(TS_CHAN_BITS, chan) || chan >= TS_CHANNELS ||
+                !this->bits.get(1, width)) return (this->valid = false);
+
+            uint8_t bits = 4;
+
+            if (width == 1) {
+                if (!this->bits.get(1, width)) return (this->valid = false);
+                bits = (width == 1) ? 17 : 8;
+            }
+
+            if (!this->bits.get(bits, zz)) return (this->valid = false);
+            diff[chan] = TSCodec::unzigzag(zz + 1);
+        }
+
+        for (uint8_t c = 0; c < TS_CHANNELS; c++) { // In order, see predict.
+            codes[c] = TSCodec::predict(this->trend, c, codes) + diff[c];
+        }
+
+        for (uint8_t c = 0; c < TS_CHANNELS; c++) {
+            TSCodec::trendUpdate(this->trend[c], codes[c]);
+        }
+    }
+
+    minute = this->prevMin;
+    this->row++;
+    return true;
+}
+
+const TSBlockHdr &TSBlockReader::getHdr() const {return this->hdr;}
+
+TSHistory::TSHistory() : firstSeq(0), nextSeq(0), last{0}, boot(0),
+    hasLast(false) {}
+
+// Requires the boot number. Stamped upon the blocks started from here on.
+void TSHistory::setBoot(uint16_t boot) {this->boot = boot;}
+
+// Requires no params. Seals the newest block, and starts the next, evicting
+// the oldest if full. Returns true.
+bool TSHistory::start() {
+    if (this->nextSeq - this->firstSeq >= TS_HIST_BLOCKS) this->firstSeq++;
+
+    uint8_t* block = this->blocks[this->nextSeq % TS_HIST_BLOCKS];
+    this->writer.begin(block, this->boot);
+    this->nextSeq++;
+    return true;
+}
+
+// Requires the runtime minute, codes of each channel, and bitwise channels
+// present, bit 0 being TSChan::TEMP. Codes absent, or within the band of the
+// previous code, repeat it. Rows without channels present are skipped, the
+// minute encodes the gap. Returns true if a block was sealed, see
+// getSealedEnd().
+bool TSHistory::append(uint32_t minute, const uint16_t* codes,
+    uint32_t present) {
+
+    if (present == 0) return false;
+
+    uint16_t row[TS_CHANNELS];
+
+    for (size_t c = 0; c < TS_CHANNELS; c++) {
+        bool has = (present >> c) & 1;
+        uint16_t pred = (this->writer.isOpen() && this->writer.getRows() > 0)
+            ? this->writer.predict(c, row) : this->last[c];
+
+        int32_t drift = static_cast<int32_t>(codes[c]) - pred;
+        int32_t band = TSCodec::tolerance(c, pred);
+
+        if (!has) { // Holds.
+            row[c] = this->last[c];
+        } else if (this->hasLast && drift <= band && drift >= -band) {
+            row[c] = pred;
+        } else {
+            row[c] = codes[c];
+        }
+    }
+
+    bool sealed = false;
+    if (!this->writer.isOpen()) this->start();
+
+    if (!this->writer.append(minute, row)) { // Full.
+        sealed = this->start();
+        this->writer.append(minute, row); // Raw, always fits an empty block.
+    }
+
+    memcpy(this->last, row, sizeof(this->last));
+    this->hasLast = true;
+    return sealed;
+}
+
+// Requires a sealed block, and its length. Appends it as the newest block,
+// used to restore the blocks persisted prior to a restart, oldest first,
+// before any append. Returns true if loaded, false if invalid.
+bool TSHistory::load(const uint8_t* block, size_t len) {
+    TSBlockReader rd(block, len);
+    uint32_t minute{0};
+    uint16_t codes[TS_CHANNELS];
+
+    if (len > TS_BLOCK_SIZE || !rd.next(minute, codes)) return false;
+
+    this->writer.end();
+    this->start();
+    this->writer.end(); // Sealed, appends start the next block.
+
+    uint8_t* dst = this->blocks[(this->nextSeq - 1) % TS_HIST_BLOCKS];
+    memset(dst, 0, TS_BLOCK_SIZE);
+    memcpy(dst, block, len);
+    return true;
+}
+
+// Requires the block sequence, buffer, and buffer size. Copies the header
+// and the used bytes of the block. Returns the bytes copied, or 0 if the
+// block is not held, or exceeds the buffer.
+size_t TSHistory::getBlock(uint32_t seq, uint8_t* out, size_t size) const {
+    if (seq < this->firstSeq || seq >= this->nextSeq) return 0;
+
+    const uint8_t* block = this->blocks[seq % TS_HIST_BLOCKS];
+    TSBlockHdr hdr;
+    memcpy(&hdr, block, sizeof(hdr));
+
+    size_t len = sizeof(hdr) + (hdr.bits + 7) / 8;
+    if (len > size || len > TS_BLOCK_SIZE) return 0;
+
+    memcpy(out, block, len);
+    return len;
+}
+
+uint32_t TSHistory::getFirstSeq() const {return this->firstSeq;}
+
+uint32_t TSHistory::getNextSeq() const {return this->nextSeq;}
+
+// Requires no params. Returns the sequence following the newest sealed
+// block, the open block is not sealed.
+uint32_t TSHistory::getSealedEnd() const {
+    return this->writer.isOpen() ? this->nextSeq - 1 : this->nextSeq;
+}
+
+}
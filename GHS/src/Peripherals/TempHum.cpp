@@ -3,6 +3,9 @@
 #include "Drivers/SHT_Library.hpp"
 #include "Peripherals/Relay.hpp"
 #include "Peripherals/Alert.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "Peripherals/Checkpoint.hpp"
+#include "Peripherals/Stats.hpp"
 #include "Threads/Mutex.hpp"
 #include "UI/MsgLogHandler.hpp"
 #include "Network/NetCreds.hpp"
@@ -37,7 +40,6 @@ TempHum::TempHum(TempHumParams &params) :
     params(params) {
 
         memset(&this->averages, 0, sizeof(this->averages));
-        memset(&this->trends, 0.0f, sizeof(this->trends));
 
         snprintf(TempHum::log, sizeof(TempHum::log), "%s Ob Created", 
             TempHum::tag);
@@ -251,24 +253,29 @@ void TempHum::alertBounds(float value, alertConfigTH &conf, bool isTemp,
     }
 }
 
-// Requires no parameters, and when called, computes the new average temp
-// and humidity.
+// Requires no parameters, and when called, adds the temp and humidity to the
+// streaming statistics, and sets the averages to their rolling 24 hour
+// means, see Stats.
 void TempHum::computeAvgs() {
 
-    // The deltas are the change between the current and averages. Then the
-    // new addition is added to the current running averages in a small amount.
-    // The actual formula is:
-    // NewAv = (Av * pollct + new temp)/(new poll ct)
-    float deltaT = this->data.tempC - this->averages.temp;
-    float deltaH = this->data.hum - this->averages.hum;
-    this->averages.pollCt++;
-    this->averages.temp += (deltaT / this->averages.pollCt); 
-    this->averages.hum += (deltaH / this->averages.pollCt);
+    const float vals[2] = {this->data.tempC, this->data.hum};
+    Stats* stats = Stats::get();
+    stats->add(TSChan::TEMP, vals, 2);
+
+    StatsFigures fig;
+    if (stats->getFigures(TSChan::TEMP, StatsWin::DAY, fig)) {
+        this->averages.temp = fig.mean;
+        this->averages.pollCt = fig.count;
+    }
+
+    if (stats->getFigures(TSChan::HUM, StatsWin::DAY, fig)) {
+        this->averages.hum = fig.mean;
+    }
 }
 
-// Requires no params. Gets the current hour. When the hour switches, hours
-// 0 to n - 1 will be captured and moved to position 1 to n, position 0 will
-// have the new value written into it after the move. 
+// Requires no params. Gets the current hour. When the hour switches, the
+// current readings are pushed as the newest hour of the trends, O(1)
+// regardless of TREND_HOURS.
 void TempHum::computeTrends() {
 
     // Get current hour. Set static last hour equal to. This should init at
@@ -277,19 +284,8 @@ void TempHum::computeTrends() {
     static uint8_t lastHour = hour; 
 
     if (hour != lastHour) { // Change detected.
-
-        // Move (idx 0 to n-1) to (idx 1 to n). Opens idx 0 for new val.
-        memmove(&this->trends.temp[1], this->trends.temp, 
-            sizeof(this->trends.temp) - sizeof(this->trends.temp[0]));
-
-        this->trends.temp[0] = this->data.tempC; // Insert current reading.
-
-        // Same as above.
-        memmove(&this->trends.hum[1], this->trends.hum, 
-            sizeof(this->trends.hum) - sizeof(this->trends.hum[0]));
-
-        this->trends.hum[0] = this->data.hum; // same.
-
+        this->trends.temp.push(this->data.tempC); // Insert current reading.
+        this->trends.hum.push(this->data.hum); // same.
         lastHour = hour; // Update time for next change.
     }
 }
@@ -347,7 +343,8 @@ void TempHum::median3(SHT_DRVR::SHT_VALS &vals) {
 
 // Requires messand and messaging level. Level default to ERROR.
 void TempHum::sendErr(const char* msg, Messaging::Levels lvl) {
-    Messaging::MsgLogHandler::get()->handle(lvl, msg, TEMP_HUM_LOG_METHOD);
+    Messaging::MsgLogHandler::get()->handle(Messaging::LogTag::TEMPHUM,
+        lvl, msg, TEMP_HUM_LOG_METHOD);
 }
 
 // Singleton class object, requires temphum parameters for first init. Once
@@ -368,10 +365,31 @@ TempHum* TempHum::get(TempHumParams* parameter) {
     }
 
     static TempHum instance(*parameter);
-    
+
+    static bool restored = instance.restore(); // Once, upon creation.
+    (void)restored;
+
     return &instance;
 }
 
+// Requires no params. Called once upon creation, prior to the instance being
+// shared. Copies the averages and trends of the checkpoint of the previous
+// boot, seeding the rolling day averages with the averages restored. Returns
+// true if restored.
+bool TempHum::restore() {
+    if (!Checkpoint::get()->restoreTH(this->averages, this->trends)) {
+        return false;
+    }
+
+    Stats::get()->seed(TSChan::TEMP, this->averages.pollCt,
+        this->averages.temp);
+
+    Stats::get()->seed(TSChan::HUM, this->averages.pollCt,
+        this->averages.hum);
+
+    return true;
+}
+
 // WARNING. Mutex locks are placed in the simple return functions below
 // to get temp/hum, amongst other values. The returns will be 0, nullptr, or
 // some other null value. This does not have to be handled on the other side,
@@ -414,11 +432,14 @@ bool TempHum::read() {
         this->computeTrends();
         this->sensHealth *= HEALTH_EXP_DECAY; // Decay unit per good read.
 
+        const float vals[2] = {this->data.tempC, this->data.hum};
+        TimeSeries::get()->record(TSChan::TEMP, vals, 2); // Temp and hum.
+
         if (!logOnce) {
-            snprintf(TempHum::log, sizeof(TempHum::log), "%s err fixed",
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::TEMPHUM, Messaging::Levels::INFO,
+                TEMP_HUM_LOG_METHOD, Messaging::LogFmt::SENS_ERR_FIXED,
                 TempHum::tag);
-
-            TempHum::sendErr(TempHum::log, Messaging::Levels::INFO);
             logOnce = true; // Prevent re-log, allow err logging.
         }
 
@@ -440,10 +461,10 @@ bool TempHum::read() {
     if (this->sensHealth > HEALTH_ERR_BAD) {
 
         if (logOnce) {
-            snprintf(TempHum::log, sizeof(TempHum::log), "%s read err",
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::TEMPHUM, Messaging::Levels::ERROR,
+                TEMP_HUM_LOG_METHOD, Messaging::LogFmt::SENS_READ_ERR,
                 TempHum::tag);
-
-            TempHum::sendErr(TempHum::log);
             logOnce = false; // Prevents re-log, allows fixed error log.
         }
     } 
@@ -476,7 +497,7 @@ float TempHum::getHum(float* data) {
 }
 
 // Requires Celcius or Faren, defaults to C, all functionality of this program
-// uses C in all computation. param data ptr is def to nullptr. If mtx not 
+// uses C in all computation. param data ptr is def to nullptr. If mtx not
 // locked, returns and sets data to 0.0. If locked, returns and sets temp val.
 float TempHum::getTemp(char CorF, float* data) { // Cel or Faren
 
@@ -596,11 +617,12 @@ TH_Averages* TempHum::getAverages(TH_Averages* data) {
     return &this->averages;
 }
 
-// Param data ptr is def to nullptr. If mtx not locked, returns and sets data
-// to empty set. If locked, returns and sets data to temphum trends.
-TH_Trends* TempHum::getTrends(TH_Trends* data) { 
+// Param data ptr is def to nullptr, and hours to TREND_HOURS. If mtx not
+// locked, returns and sets data to empty set. If locked, returns and sets data
+// to the newest n hours of temphum trends, copying only those hours.
+TH_Trends* TempHum::getTrends(TH_Trends* data, size_t hours) { 
 
-    static TH_Trends safeEmpty = {};
+    static TH_Trends safeEmpty;
 
     Threads::MutexLock guard(TempHum::mtx);
 
@@ -610,13 +632,18 @@ TH_Trends* TempHum::getTrends(TH_Trends* data) {
     }
 
     // Locked
-    if (data != nullptr) *data = this->trends;
+    if (data != nullptr) {
+        data->temp.copyFrom(this->trends.temp, hours);
+        data->hum.copyFrom(this->trends.hum, hours);
+    }
 
     return &this->trends;
 }
 
-// Clears the current data after copying it over to the previous values.
-void TempHum::clearAverages() {
+// Requires reset, default true. Clears the current data after copying it
+// over to the previous values, emptying the rolling statistics of temp and
+// humidity. If not reset, only copies it over.
+void TempHum::clearAverages(bool reset) {
 
     Threads::MutexLock guard(TempHum::mtx);
     if (!guard.LOCK()) return; // Block if locked.
@@ -624,9 +651,9 @@ void TempHum::clearAverages() {
     // Write averages into log. Prep log, do not send until complete. First
     // in order to capture current averages before resetting.
     snprintf(TempHum::log, sizeof(TempHum::log),
-        "%s Averages Cleared. TempC: %.1f, TempF: %.1f,"
+        "%s Averages %s. TempC: %.1f, TempF: %.1f,"
         " Hum: %.1f. Count %zu", 
-        TempHum::tag,
+        TempHum::tag, reset ? "Cleared" : "Copied",
         this->averages.temp, (this->averages.temp * 1.8 + 32),
         this->averages.hum, this->averages.pollCt
     );
@@ -635,10 +662,13 @@ void TempHum::clearAverages() {
     this->averages.prevHum = this->averages.hum;
     this->averages.prevTemp = this->averages.temp;
 
-    // Reset current values.
-    this->averages.hum = 0.0f;
-    this->averages.temp = 0.0f;
-    this->averages.pollCt = 0; 
+    // Reset current values, and the rolling statistics, unless kept.
+    if (reset) {
+        this->averages.hum = 0.0f;
+        this->averages.temp = 0.0f;
+        this->averages.pollCt = 0;
+        Stats::get()->clear(TSChan::TEMP, 2); // Temp and hum.
+    }
 
     // Send log
     Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
@@ -0,0 +1,339 @@
+#include "Peripherals/TimeSeries.hpp"
+#include "string.h"
+#include "math.h"
+#include "Threads/Mutex.hpp"
+#include "Common/Timing.hpp"
+#include "UI/MsgLogHandler.hpp"
+#include "esp_rom_crc.h"
+#include "stdio.h"
+
+namespace Peripheral {
+
+// Static Setup
+Threads::Mutex TimeSeries::mtx(TS_TAG);
+
+const uint32_t TimeSeries::minutes[TS_RES_QTY] = {1, 15, 60, 1440};
+
+TimeSeries::TimeSeries() : closed{0}, openMin(0), closedAt{0}, savedSeq(0),
+    saveNum(0), slot{}, log{0}, fileErr(false) {
+
+    for (size_t r = 0; r < TS_RES_QTY; r++) {
+        for (size_t c = 0; c < TS_CHANNELS; c++) {
+            TimeSeries::resetAccum(this->open[r][c]);
+        }
+    }
+}
+
+// Requires the accumulator. Empties it.
+void TimeSeries::resetAccum(TSAccum &acc) {
+    acc.sum = 0.0f;
+    acc.min = 0.0f;
+    acc.max = 0.0f;
+    acc.count = 0;
+}
+
+// Requires the runtime millis. Closes every minute bucket elapsed since the
+// open bucket, cascading into the higher tiers. Minutes without readings
+// close as empty buckets. Caller must hold mtx.
+void TimeSeries::roll(int64_t now) {
+    uint32_t nowMin = static_cast<uint32_t>(now / 60000);
+
+    // A gap exceeding every tier leaves nothing to keep, skips ahead.
+    const uint32_t keep = TS_DAY_BUCKETS * TimeSeries::minutes[
+        static_cast<uint8_t>(TSRes::DAY)];
+
+    if (nowMin - this->openMin > keep) {
+        this->openMin = nowMin - keep;
+    }
+
+    while (this->openMin < nowMin) {
+        this->openMin++;
+
+        for (uint8_t r = 0; r < TS_RES_QTY; r++) {
+            if (this->openMin % TimeSeries::minutes[r] != 0) break;
+            this->close(static_cast<TSRes>(r), now);
+        }
+    }
+}
+
+// Requires the tier resolution, and runtime millis. Pushes the open bucket
+// of the tier, and merges it into the open bucket of the next tier. Caller
+// must hold mtx.
+void TimeSeries::close(TSRes res, int64_t now) {
+    uint8_t r = static_cast<uint8_t>(res);
+    TSRow row;
+    uint16_t means[TS_CHANNELS]; // History row.
+    uint32_t present{0}; // Bitwise channels with readings.
+
+    for (size_t c = 0; c < TS_CHANNELS; c++) {
+        TSAccum &acc = this->open[r][c];
+        TSBucket &bkt = row.ch[c];
+        bkt.count = acc.count;
+
+        if (acc.count == 0) {
+            bkt.min = bkt.max = bkt.mean = means[c] = 0;
+            continue;
+        }
+
+        bkt.min = TSCodec::encode(c, acc.min);
+        bkt.max = TSCodec::encode(c, acc.max);
+        bkt.mean = means[c] = TSCodec::encode(c, acc.sum / acc.count);
+        present |= 1u << c;
+
+        if (r + 1 < TS_RES_QTY) { // Rolls up.
+            TSAccum &up = this->open[r + 1][c];
+
+            if (up.count == 0 || acc.min < up.min) up.min = acc.min;
+            if (up.count == 0 || acc.max > up.max) up.max = acc.max;
+            up.sum += acc.sum;
+            up.count += acc.count;
+        }
+
+        TimeSeries::resetAccum(acc);
+    }
+
+    switch (res) {
+        case TSRes::MINUTE:
+        this->minTier.push(row);
+        this->hist.append(this->openMin - 1, means, present); // Closed min.
+        break;
+
+        case TSRes::QUARTER: this->qtrTier.push(row); break;
+        case TSRes::HOUR: this->hourTier.push(row); break;
+        case TSRes::DAY: this->dayTier.push(row); break;
+    }
+
+    this->closed[r]++;
+    this->closedAt[r] = now;
+}
+
+// Requires no params. Returns the instance.
+TimeSeries* TimeSeries::get() {
+    static TimeSeries instance;
+    return &instance;
+}
+
+// Requires the first channel, values, and quantity of consecutive channels.
+// Aggregates the readings into the open minute bucket, closing any elapsed
+// buckets first.
+void TimeSeries::record(TSChan first, const float* vals, size_t qty) {
+    size_t start = static_cast<size_t>(first);
+    if (start + qty > TS_CHANNELS) return; // Range.
+
+    int64_t now = Clock::DateTime::get()->millis();
+
+    Threads::MutexLock guard(TimeSeries::mtx);
+    if (!guard.LOCK()) return;
+
+    this->roll(now);
+
+    TSAccum* accs = this->open[static_cast<uint8_t>(TSRes::MINUTE)];
+
+    for (size_t i = 0; i < qty; i++) {
+        TSAccum &acc = accs[start + i];
+        float val = vals[i];
+
+        if (acc.count == 0 || val < acc.min) acc.min = val;
+        if (acc.count == 0 || val > acc.max) acc.max = val;
+        acc.sum += val;
+        acc.count++;
+    }
+}
+
+// Requires the channel and value. Records a single reading, see above.
+void TimeSeries::record(TSChan chan, float val) {
+    this->record(chan, &val, 1);
+}
+
+// Requires the tier resolution, and reference to ageMs. Closes any elapsed
+// buckets, and sets ageMs to the millis since the newest bucket closed, or
+// since boot if none. Returns the quantity of buckets ever closed by the
+// tier, the sequence of the newest being one less, see getRow. Returns 0 if
+// none.
+uint32_t TimeSeries::getNewest(TSRes res, uint32_t &ageMs) {
+    int64_t now = Clock::DateTime::get()->millis();
+
+    Threads::MutexLock guard(TimeSeries::mtx);
+    if (!guard.LOCK()) return 0;
+
+    this->roll(now);
+    uint8_t r = static_cast<uint8_t>(res);
+    ageMs = static_cast<uint32_t>(now - this->closedAt[r]);
+    return this->closed[r];
+}
+
+// Requires the tier resolution, bucket sequence, and reference to the row.
+// Sets the row to the closed bucket of the sequence. Sequences are fixed
+// to their bucket, allowing the tier to be read one row at a time while
+// buckets close. Returns true if set, false if overwritten, not yet closed,
+// or unable to lock.
+bool TimeSeries::getRow(TSRes res, uint32_t seq, TSRow &row) {
+    Threads::MutexLock guard(TimeSeries::mtx);
+    if (!guard.LOCK()) return false;
+
+    uint32_t closed = this->closed[static_cast<uint8_t>(res)];
+    if (seq >= closed) return false;
+
+    size_t age = closed - 1 - seq;
+    if (age >= TimeSeries::capacity(res)) return false;
+
+    switch (res) {
+        case TSRes::MINUTE: row = this->minTier[age]; break;
+        case TSRes::QUARTER: row = this->qtrTier[age]; break;
+        case TSRes::HOUR: row = this->hourTier[age]; break;
+        case TSRes::DAY: row = this->dayTier[age]; break;
+    }
+
+    return true;
+}
+
+// Requires the tier resolution. Returns the buckets held by the tier.
+size_t TimeSeries::capacity(TSRes res) {
+    switch (res) {
+        case TSRes::MINUTE: return TS_MIN_BUCKETS;
+        case TSRes::QUARTER: return TS_QTR_BUCKETS;
+        case TSRes::HOUR: return TS_HOUR_BUCKETS;
+        case TSRes::DAY: return TS_DAY_BUCKETS;
+    }
+
+    return 0;
+}
+
+// Requires the tier resolution. Returns the seconds per bucket.
+uint32_t TimeSeries::bucketSecs(TSRes res) {
+    return TimeSeries::minutes[static_cast<uint8_t>(res)] * 60;
+}
+
+// Requires the history block sequence, buffer, buffer size, and references
+// to firstSeq and nextSeq. Copies the block, see TSHistory::getBlock, and
+// sets firstSeq and nextSeq to the sequences held, the newest block being
+// nextSeq - 1 and still open. Returns the bytes copied, or 0 if not held,
+// exceeding the buffer, or unable to lock.
+size_t TimeSeries::getHistBlock(uint32_t seq, uint8_t* out, size_t size,
+    uint32_t &firstSeq, uint32_t &nextSeq) {
+
+    int64_t now = Clock::DateTime::get()->millis();
+
+    Threads::MutexLock guard(TimeSeries::mtx);
+    if (!guard.LOCK()) return 0;
+
+    this->roll(now);
+    firstSeq = this->hist.getFirstSeq();
+    nextSeq = this->hist.getNextSeq();
+    return this->hist.getBlock(seq, out, size);
+}
+
+// Requires the boot number. Loads the blocks saved in TS_FILE, oldest
+// first, and stamps the boot number upon the blocks started from here on.
+// Slots failing their CRC are skipped. Must be called once upon boot,
+// after mounting spiffs, prior to recording.
+void TimeSeries::restore(uint16_t boot) {
+    uint32_t order[TS_FILE_BLOCKS]; // Valid slot save numbers.
+    bool valid[TS_FILE_BLOCKS] = {false};
+    size_t loaded{0};
+
+    FILE* f = fopen(TS_FILE, "rb");
+
+    if (f != nullptr) {
+        for (size_t i = 0; i < TS_FILE_BLOCKS; i++) {
+            if (fread(&this->slot, sizeof(this->slot), 1, f) != 1) break;
+
+            valid[i] = (this->slot.magic == TS_FILE_MAGIC &&
+                this->slot.crc == esp_rom_crc32_le(0, this->slot.block,
+                TS_BLOCK_SIZE));
+
+            order[i] = this->slot.saveNum;
+        }
+    }
+
+    Threads::MutexLock guard(TimeSeries::mtx);
+    if (!guard.LOCK()) {
+        if (f != nullptr) fclose(f);
+        return;
+    }
+
+    this->hist.setBoot(boot);
+
+    while (f != nullptr) { // Loads the oldest remaining slot each pass.
+        size_t oldest = TS_FILE_BLOCKS;
+
+        for (size_t i = 0; i < TS_FILE_BLOCKS; i++) {
+            if (valid[i] && (oldest == TS_FILE_BLOCKS ||
+                order[i] < order[oldest])) oldest = i;
+        }
+
+        if (oldest == TS_FILE_BLOCKS) break; // All loaded.
+        valid[oldest] = false;
+
+        if (fseek(f, oldest * sizeof(this->slot), SEEK_SET) != 0 ||
+            fread(&this->slot, sizeof(this->slot), 1, f) != 1) continue;
+
+        if (this->hist.load(this->slot.block, TS_BLOCK_SIZE)) {
+            this->saveNum = this->slot.saveNum + 1;
+            loaded++;
+        }
+    }
+
+    if (f != nullptr) fclose(f);
+    this->savedSeq = this->hist.getNextSeq(); // Loaded are saved.
+
+    snprintf(this->log, sizeof(this->log), "%s %zu history blocks restored",
+        TS_TAG, loaded);
+
+    Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
+        this->log, Messaging::Method::SRL_LOG);
+}
+
+// Requires no params. Saves the oldest sealed history block not yet saved
+// to the next slot of TS_FILE. Blocks seal every few hours, a call without
+// one is a comparison only. Must be called periodically by a single task.
+void TimeSeries::persist() {
+    { // Copies the block under lock, writes without.
+        Threads::MutexLock guard(TimeSeries::mtx);
+        if (!guard.LOCK()) return;
+
+        if (this->savedSeq < this->hist.getFirstSeq()) { // Evicted unsaved.
+            this->savedSeq = this->hist.getFirstSeq();
+        }
+
+        if (this->savedSeq >= this->hist.getSealedEnd()) return; // None.
+
+        memset(this->slot.block, 0, TS_BLOCK_SIZE);
+        this->hist.getBlock(this->savedSeq, this->slot.block, TS_BLOCK_SIZE);
+    }
+
+    this->slot.magic = TS_FILE_MAGIC;
+    this->slot.saveNum = this->saveNum;
+    this->slot.crc = esp_rom_crc32_le(0, this->slot.block, TS_BLOCK_SIZE);
+
+    FILE* f = fopen(TS_FILE, "r+b"); // Keeps the remaining slots.
+    if (f == nullptr) f = fopen(TS_FILE, "wb");
+
+    size_t pos = (this->saveNum % TS_FILE_BLOCKS) * sizeof(this->slot);
+    bool ok = (f != nullptr && fseek(f, pos, SEEK_SET) == 0 &&
+        fwrite(&this->slot, sizeof(this->slot), 1, f) == 1);
+
+    if (f != nullptr && fclose(f) != 0) ok = false;
+
+    // Advances upon failure as well, the block is dropped rather than
+    // retried every call.
+    this->savedSeq++;
+
+    if (ok) {
+        this->saveNum++;
+        this->fileErr = false;
+        return;
+    }
+
+    if (!this->fileErr) {
+        snprintf(this->log, sizeof(this->log), "%s history not saved",
+            TS_TAG);
+
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
+            this->log, Messaging::Method::SRL_LOG);
+    }
+
+    this->fileErr = true;
+}
+
+}
@@ -32,4 +32,8 @@ routineThreadParams::routineThreadParams(uint32_t delay,
 
     delay(delay), relays(relays), relayQty(relayQty) {}
 
+logThreadParams::logThreadParams(uint32_t delay) : delay(delay) {}
+
+sktThreadParams::sktThreadParams(uint32_t delay) : delay(delay) {}
+
 }
\ No newline at end of file
@@ -13,9 +13,14 @@
 #include "UI/MsgLogHandler.hpp"
 #include "math.h"
 #include "Peripherals/saveSettings.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "Peripherals/Checkpoint.hpp"
 #include "Common/heartbeat.hpp"
 #include "Drivers/ADC.hpp"
 #include "Network/NetManager.hpp"
+#include "Network/UDPSender.hpp"
+#include "Network/Handlers/socketHandler.hpp"
+#include "UI/LogJournal.hpp"
 #include "Common/Timing.hpp"
 
 namespace ThreadTask {
@@ -47,21 +52,20 @@ TickType_t delay(TickType_t work, TickType_t period) {
 // ensure that its high water mark is not approaching zero. If LTE to the 
 // minimum, a critical log entry will occur.
 void highWaterMark(const char* tag, UBaseType_t HWM) {
-    static char msg[128];
 
     if (HWM <= HWM_MIN_WORDS) {
-        
-        snprintf(msg, sizeof(msg), "%s Thread High Water Mark @ %u words", 
-            tag, HWM);
-
-        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::CRITICAL,
-            msg, Messaging::Method::SRL_LOG, true, false);
+        Messaging::MsgLogHandler::get()->handleFmt(
+            Messaging::LogTag::THREAD, Messaging::Levels::CRITICAL,
+            Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_HWM, tag,
+            HWM);
     }
 }
 
-// Requires no params. Runs end of day checks. Hard coded to clear all avgs
-// at 23:59:50 and to log NEW day @ 00:00:00, both with the padding of 10 
-// seconds, meaning this must be ran < 10 Hz interval to capture all.
+// Requires no params. Runs end of day checks. Hard coded to copy all avgs
+// to the previous day at 23:59:50 and to log NEW day @ 00:00:00, both with
+// the padding of 10 seconds, meaning this must be ran < 10 Hz interval to
+// capture all. The averages are rolling 24 hour means, and are not reset,
+// see Stats.
 void endOfDay() {
     static Clock::TIME t;
     static bool clrTog = true, dayTog = true;
@@ -70,10 +74,10 @@ void endOfDay() {
 
     uint32_t sysTime = t.raw; // seconds for the day from 0 - 86399.
 
-    if (sysTime >= 86350 && clrTog) { // Clear avgs at 23:59:50
+    if (sysTime >= 86350 && clrTog) { // Copy avgs at 23:59:50
         clrTog = false;
-        Peripheral::TempHum::get()->clearAverages();
-        Peripheral::Light::get()->clearAverages(); 
+        Peripheral::TempHum::get()->clearAverages(false);
+        Peripheral::Light::get()->clearAverages(false);
 
     } else if (sysTime <= 10 && dayTog) { // Log new day @ 00:00:00
         dayTog = false;
@@ -124,6 +128,9 @@ void netTask(void* parameter) { // Runs on 1 second intervals.
         // Check in to reset heart beat expiration.
         heartbeat::Heartbeat::get()->rogerUp(HBID, NET_HEARTBEAT);
 
+        // Queues a GET_ALL push to websocket subscribers, if due.
+        Comms::SOCKHAND::push();
+
         // Scan the network, if scan was performed, adjust scan gain to prevent
         // overrun error. A heartbeat extension is passed, and it will be 
         // extended if a scan is required, to prevent unresponsive alert issues.
@@ -146,14 +153,11 @@ void netTask(void* parameter) { // Runs on 1 second intervals.
         // Log overruns to ensure that works tasks are not exceeding count.
         // If long scan was performed, 
         if (work > (adjPeriod)) {
-            char buf[96];
-            snprintf(buf, sizeof(buf), 
-                "Net overrun: Work (%lu)ms exceeds period (%lu)ms",
-                (work * portTICK_PERIOD_MS), (adjPeriod  * portTICK_PERIOD_MS));
-
-            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
-                buf, Messaging::Method::SRL_LOG
-            );
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::THREAD, Messaging::Levels::WARNING,
+                Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_OVERRUN,
+                "Net", (work * portTICK_PERIOD_MS),
+                (adjPeriod * portTICK_PERIOD_MS));
         }
 
         vTaskDelay(delay(work, period));
@@ -196,6 +200,7 @@ void SHTTask(void* parameter) {
 
         // Only check bounds upon successful read.
         if (th->read()) th->checkBounds(); 
+        Comms::SOCKHAND::notify(); // New data for socket subscribers.
 
         // Check in to reset heart beat expiration.
         heartbeat::Heartbeat::get()->rogerUp(HBID, TEMPHUM_HEARTBEAT);
@@ -207,14 +212,11 @@ void SHTTask(void* parameter) {
 
         // Log overruns to ensure that works tasks are not exceeding count.
         if (work > period) {
-            char buf[96];
-            snprintf(buf, sizeof(buf), 
-                "SHT overrun: Work (%lu)ms exceeds period (%lu)ms",
-                (work * portTICK_PERIOD_MS), (period * portTICK_PERIOD_MS));
-
-            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
-                buf, Messaging::Method::SRL_LOG
-            );
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::THREAD, Messaging::Levels::WARNING,
+                Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_OVERRUN,
+                "SHT", (work * portTICK_PERIOD_MS),
+                (period * portTICK_PERIOD_MS));
         }
 
         vTaskDelay(delay(work, period));
@@ -259,6 +261,7 @@ void LightTask(void* parameter) { // AS7341 & photo Resistor
     
         // Checks bounds for photo resistor upon successful read.
         if (lt->readPhoto()) lt->checkBounds();
+        Comms::SOCKHAND::notify(); // New data for socket subscribers.
 
         // Check in to reset heart beat expiration.
         heartbeat::Heartbeat::get()->rogerUp(HBID, LIGHT_HEARTBEAT);
@@ -270,14 +273,11 @@ void LightTask(void* parameter) { // AS7341 & photo Resistor
 
         // Log overruns to ensure that works tasks are not exceeding count.
         if (work > period) {
-            char buf[96];
-            snprintf(buf, sizeof(buf), 
-                "Light overrun: Work (%lu)ms exceeds period (%lu)ms",
-                (work * portTICK_PERIOD_MS), (period * portTICK_PERIOD_MS));
-
-            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
-                buf, Messaging::Method::SRL_LOG
-            );
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::THREAD, Messaging::Levels::WARNING,
+                Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_OVERRUN,
+                "Light", (work * portTICK_PERIOD_MS),
+                (period * portTICK_PERIOD_MS));
         }
 
         vTaskDelay(delay(work, period));
@@ -326,6 +326,7 @@ void soilTask(void* parameter) { // Soil sensors
         // bounds only if read is good, this does not due to iteration.
         soil->readAll();
         soil->checkBounds();
+        Comms::SOCKHAND::notify(); // New data for socket subscribers.
 
         // Check in to reset heart beat expiration.
         heartbeat::Heartbeat::get()->rogerUp(HBID, SOIL_HEARTBEAT);
@@ -337,14 +338,11 @@ void soilTask(void* parameter) { // Soil sensors
 
         // Log overruns to ensure that works tasks are not exceeding count.
         if (work > period) {
-            char buf[96];
-            snprintf(buf, sizeof(buf), 
-                "Soil overrun: Work (%lu)ms exceeds period (%lu)ms",
-                (work * portTICK_PERIOD_MS), (period * portTICK_PERIOD_MS));
-
-            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
-                buf, Messaging::Method::SRL_LOG
-            );
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::THREAD, Messaging::Levels::WARNING,
+                Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_OVERRUN,
+                "Soil", (work * portTICK_PERIOD_MS),
+                (period * portTICK_PERIOD_MS));
         }
 
         vTaskDelay(delay(work, period));
@@ -394,7 +392,7 @@ void routineTask(void* parameter) {
             params->relays[i].manageTimer(); 
         }
 
-        // Manage the clearing of averages at the end of the day as well as 
+        // Manage the copying of averages at the end of the day as well as
         // new day logging. Att must run < 10 Hz, which we already are.
         endOfDay(); 
 
@@ -408,6 +406,12 @@ void routineTask(void* parameter) {
             count = 0; // Reset count.
         }
 
+        // Saves any newly sealed block of the compressed sensor history.
+        Peripheral::TimeSeries::get()->persist();
+
+        // Checkpoints the sensor averages and trends every CKPT_PERIOD_S.
+        Peripheral::Checkpoint::get()->save();
+
         // Check in to reset heart beat expiration.
         HB->rogerUp(HBID, ROUTINE_HEATBEAT);
 
@@ -425,18 +429,98 @@ void routineTask(void* parameter) {
 
         // Log overruns to ensure that works tasks are not exceeding count.
         if (work > period) {
-            char buf[96];
-            snprintf(buf, sizeof(buf), 
-                "Rtn overrun: Work (%lu)ms exceeds period (%lu)ms",
-                (work * portTICK_PERIOD_MS), (period * portTICK_PERIOD_MS));
-
-            Messaging::MsgLogHandler::get()->handle(Messaging::Levels::WARNING,
-                buf, Messaging::Method::SRL_LOG
-            );
+            Messaging::MsgLogHandler::get()->handleFmt(
+                Messaging::LogTag::THREAD, Messaging::Levels::WARNING,
+                Messaging::Method::SRL_LOG, Messaging::LogFmt::THREAD_OVERRUN,
+                "Rtn", (work * portTICK_PERIOD_MS),
+                (period * portTICK_PERIOD_MS));
         }
 
         vTaskDelay(delay(work, period));
     }
 }
 
-}
\ No newline at end of file
+// Requires the logThreadParams pointer. Responsible for running the thread
+// dedicated to draining the log queue, fanning out each record to serial,
+// the log, OLED, and UDP. Runs event driven, blocking on the queue for up to
+// the delay, rather than on a fixed period.
+void logTask(void* parameter) {
+
+    if (parameter == nullptr) {
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::CRITICAL,
+            "LOG task fail", Messaging::Method::SRL_LOG);
+        return;
+
+    } else {
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
+            "LOG task running", Messaging::Method::SRL_LOG);
+    }
+
+    Threads::logThreadParams* params = 
+        static_cast<Threads::logThreadParams*>(parameter);
+
+    Messaging::MsgLogHandler* msglogerr = Messaging::MsgLogHandler::get();
+
+    // Convert ms delay to to ticks.
+    const TickType_t wait = pdMS_TO_TICKS(params->delay);
+
+    // Register task with heartbeat.
+    uint8_t HBID = heartbeat::Heartbeat::get()->getBlockID("LOG", HB_DELAY);
+
+    while (true) {
+
+        // Blocks until records are queued or the wait expires, then drains.
+        // Switches the handler to async on the first call.
+        msglogerr->drain(wait);
+
+        // Sends batched log entries and the heartbeat once due.
+        Comms::UDPSender::get()->flush();
+
+        // Writes the journal batch to flash once due.
+        Messaging::LogJournal::get()->flush();
+
+        // Check in to reset heart beat expiration.
+        heartbeat::Heartbeat::get()->rogerUp(HBID, LOG_HEARTBEAT);
+
+        highWaterMark("Log", uxTaskGetStackHighWaterMark(NULL));
+    }
+}
+
+// Executes socket commands queued by the httpd task, and pushes queued by the
+// net task, in their fast and slow lanes, see socketHandler.hpp. Blocks until
+// a job is queued, or the delay expires to check in.
+void sktTask(void* parameter) {
+
+    if (parameter == nullptr) {
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::CRITICAL,
+            "SKT task fail", Messaging::Method::SRL_LOG);
+        return;
+
+    } else {
+        Messaging::MsgLogHandler::get()->handle(Messaging::Levels::INFO,
+            "SKT task running", Messaging::Method::SRL_LOG);
+    }
+
+    Threads::sktThreadParams* params = 
+        static_cast<Threads::sktThreadParams*>(parameter);
+
+    // Convert ms delay to to ticks.
+    const TickType_t wait = pdMS_TO_TICKS(params->delay);
+
+    // Register task with heartbeat.
+    uint8_t HBID = heartbeat::Heartbeat::get()->getBlockID("SKT", HB_DELAY);
+
+    while (true) {
+
+        // Blocks until jobs are queued or the wait expires, then runs them.
+        Comms::SOCKHAND::execute(wait);
+        Comms::SOCKHAND::keepAlive(); // Pings and reaps sessions when due.
+
+        // Check in to reset heart beat expiration.
+        heartbeat::Heartbeat::get()->rogerUp(HBID, SKT_HEARTBEAT);
+
+        highWaterMark("Skt", uxTaskGetStackHighWaterMark(NULL));
+    }
+}
+
+}
@@ -0,0 +1,276 @@
+#include "UI/LogCodec.hpp"
+#include <cstdint>
+#include <cstdio>
+#include "string.h"
+#include "UI/LogFormats.hpp"
+#include "UI/MsgLogHandler.hpp"
+
+namespace Messaging {
+
+// Maps to levels. Used in printing. Defined with the codec, rather than the
+// handler, allowing the host decoder to render entries without the handler.
+const char LevelsMap[5][11]{"[DEBUG]", "[INFO]", "[WARNING]", "[ERROR]",
+    "[CRITICAL]"};
+
+LogArgs::LogArgs() : len(0) {}
+
+// Requires argument type, pointer to its value, and size. Appends the tag and
+// value. Arguments that do not fit are dropped, and render as missing.
+void LogArgs::put(LogArg type, const void* val, size_t size) {
+    if (this->len + 1 + size > sizeof(this->data)) return;
+
+    this->data[this->len++] = static_cast<uint8_t>(type);
+    memcpy(&this->data[this->len], val, size);
+    this->len += size;
+}
+
+// Requires string. Appends the tag, length, and up to LOG_BIN_STR_MAX chars.
+void LogArgs::putStr(const char* str) {
+    if (str == nullptr) str = "";
+
+    size_t strLen = strnlen(str, LOG_BIN_STR_MAX);
+    if (this->len + 2 + strLen > sizeof(this->data)) return;
+
+    this->data[this->len++] = static_cast<uint8_t>(LogArg::STR);
+    this->data[this->len++] = static_cast<uint8_t>(strLen);
+    memcpy(&this->data[this->len], str, strLen);
+    this->len += strLen;
+}
+
+const uint8_t* LogArgs::getData() const {return this->data;}
+uint8_t LogArgs::getLen() const {return this->len;}
+
+namespace LogCodec {
+
+namespace {
+
+// Requires an argument pointer and the remaining bytes. Returns the packed
+// size of the argument including its tag, or 0 if malformed. Strings longer
+// than LOG_BIN_STR_MAX are malformed, putStr() never packs them, and entries
+// read from captures or flash are untrusted.
+size_t argSize(const uint8_t* arg, size_t remaining) {
+    if (remaining < 1) return 0;
+
+    size_t size = 0;
+
+    switch (static_cast<LogArg>(arg[0])) {
+        case LogArg::I32: case LogArg::U32: case LogArg::F32:
+        size = 1 + 4; break;
+
+        case LogArg::I64: case LogArg::U64:
+        size = 1 + 8; break;
+
+        case LogArg::STR:
+        if (remaining < 2 || arg[1] > LOG_BIN_STR_MAX) return 0;
+        size = 2 + arg[1]; break;
+
+        default: return 0;
+    }
+
+    return (size <= remaining) ? size : 0;
+}
+
+// Requires a conversion spec without its length modifier, the conversion
+// char, the packed argument, and output. Writes the argument as the spec
+// requires. If the spec does not match the packed type, uses the natural
+// conversion of the packed type to avoid undefined behavior. WARNING. The
+// argument must pass argSize(). Returns chars written, as snprintf.
+int formatArg(const char* spec, char conv, const uint8_t* arg, char* out,
+    size_t size) {
+
+    char fmt[24]; // Spec with the length modifier required by the type.
+    const bool isInt = (strchr("diouxXc", conv) != nullptr);
+    const bool isFloat = (strchr("fFeEgGaA", conv) != nullptr);
+    const uint8_t* val = arg + 1;
+
+    switch (static_cast<LogArg>(arg[0])) {
+        case LogArg::I32: {
+            int32_t i; memcpy(&i, val, sizeof(i));
+            snprintf(fmt, sizeof(fmt), "%s%c", spec, isInt ? conv : 'd');
+            if (!isInt) snprintf(fmt, sizeof(fmt), "%%d");
+            return snprintf(out, size, fmt, (int)i);
+        }
+
+        case LogArg::U32: {
+            uint32_t u; memcpy(&u, val, sizeof(u));
+            snprintf(fmt, sizeof(fmt), "%s%c", spec, isInt ? conv : 'u');
+            if (!isInt) snprintf(fmt, sizeof(fmt), "%%u");
+            return snprintf(out, size, fmt, (unsigned int)u);
+        }
+
+        case LogArg::I64: {
+            int64_t i; memcpy(&i, val, sizeof(i));
+            snprintf(fmt, sizeof(fmt), "%sll%c", spec, isInt ? conv : 'd');
+            if (!isInt) snprintf(fmt, sizeof(fmt), "%%lld");
+            return snprintf(out, size, fmt, (long long)i);
+        }
+
+        case LogArg::U64: {
+            uint64_t u; memcpy(&u, val, sizeof(u));
+            snprintf(fmt, sizeof(fmt), "%sll%c", spec, isInt ? conv : 'u');
+            if (!isInt) snprintf(fmt, sizeof(fmt), "%%llu");
+            return snprintf(out, size, fmt, (unsigned long long)u);
+        }
+
+        case LogArg::F32: {
+            float f; memcpy(&f, val, sizeof(f));
+            snprintf(fmt, sizeof(fmt), "%s%c", spec, isFloat ? conv : 'g');
+            if (!isFloat) snprintf(fmt, sizeof(fmt), "%%g");
+            return snprintf(out, size, fmt, (double)f);
+        }
+
+        case LogArg::STR: {
+            char str[LOG_BIN_STR_MAX + 1]; // Null terminated copy.
+            size_t strLen = (arg[1] > LOG_BIN_STR_MAX) ? LOG_BIN_STR_MAX :
+                arg[1];
+
+            memcpy(str, arg + 2, strLen);
+            str[strLen] = '\0';
+
+            snprintf(fmt, sizeof(fmt), "%ss", spec);
+            if (conv != 's') snprintf(fmt, sizeof(fmt), "%%s");
+            return snprintf(out, size, fmt, str);
+        }
+
+        default: return -1;
+    }
+}
+
+}
+
+// Requires output buffer and size, level, system seconds, format ID, and the
+// packed arguments. Encodes a binary log entry. Returns the bytes encoded, or
+// 0 if the output is too small.
+size_t encode(uint8_t* out, size_t size, uint8_t level, uint32_t seconds,
+    LogFmt fmt, const LogArgs &args) {
+
+    LogBinHdr hdr = {level, seconds, static_cast<uint16_t>(fmt),
+        args.getLen()};
+
+    size_t total = sizeof(hdr) + hdr.argBytes;
+    if (out == nullptr || total > size) return 0;
+
+    memcpy(out, &hdr, sizeof(hdr));
+    memcpy(out + sizeof(hdr), args.getData(), hdr.argBytes);
+    return total;
+}
+
+// Requires a binary entry, its length, and a header reference. Copies the
+// header and returns true if the entry is well formed.
+bool header(const uint8_t* entry, size_t len, LogBinHdr &hdr) {
+    if (entry == nullptr || len < sizeof(hdr)) return false;
+
+    memcpy(&hdr, entry, sizeof(hdr));
+    return (sizeof(hdr) + hdr.argBytes <= len);
+}
+
+// Requires a binary entry, its length, output buffer, and size. Renders the
+// message of the entry, from its format string and arguments, and null
+// terminates. Unknown formats render as their ID with raw argument count.
+// Returns the chars written, excluding the null terminator.
+size_t format(const uint8_t* entry, size_t len, char* out, size_t size) {
+    if (out == nullptr || size == 0) return 0;
+    out[0] = '\0';
+
+    LogBinHdr hdr;
+    if (!header(entry, len, hdr)) return 0;
+
+    const uint8_t* arg = entry + sizeof(hdr);
+    size_t argRemaining = hdr.argBytes;
+    const char* fmt = logFmtString(hdr.fmt);
+    size_t written = 0;
+
+    // Appends n chars from src, truncating at the end of the output.
+    auto put = [&](const char* src, size_t n) {
+        size_t room = size - 1 - written;
+        if (n > room) n = room;
+        memcpy(&out[written], src, n);
+        written += n;
+    };
+
+    if (fmt == nullptr) { // Format table does not match the producer.
+        char unk[40];
+        int n = snprintf(unk, sizeof(unk), "<fmt %u, %u arg bytes>",
+            hdr.fmt, hdr.argBytes);
+
+        if (n > 0) put(unk, n);
+        out[written] = '\0';
+        return written;
+    }
+
+    while (*fmt != '\0' && written < size - 1) {
+
+        if (*fmt != '%') { // Literal run up to the next conversion.
+            const char* next = strchr(fmt, '%');
+            size_t n = (next != nullptr) ? next - fmt : strlen(fmt);
+            put(fmt, n);
+            fmt += n;
+            continue;
+        }
+
+        if (fmt[1] == '%') { // Escaped percent.
+            put("%", 1);
+            fmt += 2;
+            continue;
+        }
+
+        // Collect flags, width, and precision, and skip length modifiers,
+        // which are replaced as required by the packed type.
+        char spec[16] = "%";
+        size_t specLen = 1;
+        fmt++;
+
+        while (*fmt != '\0' && strchr("-+ #0123456789.", *fmt) != nullptr) {
+            if (specLen < sizeof(spec) - 1) spec[specLen++] = *fmt;
+            fmt++;
+        }
+
+        while (*fmt != '\0' && strchr("hlLqjzt", *fmt) != nullptr) fmt++;
+        spec[specLen] = '\0';
+
+        char conv = *fmt;
+        if (conv == '\0') break;
+        fmt++;
+
+        size_t argLen = argSize(arg, argRemaining);
+
+        if (argLen == 0) { // Missing argument.
+            put("<?>", 3);
+            continue;
+        }
+
+        char val[LOG_BIN_STR_MAX + 16];
+        int n = formatArg(spec, conv, arg, val, sizeof(val));
+        if (n > 0) put(val, ((size_t)n < sizeof(val)) ? n : sizeof(val) - 1);
+
+        arg += argLen;
+        argRemaining -= argLen;
+    }
+
+    out[written] = '\0';
+    return written;
+}
+
+// Requires a binary entry, its length, output buffer, and size. Renders the
+// entry as a text log entry, in the format LEVEL (seconds): msg, and null
+// terminates. Returns the chars written, excluding the null terminator.
+size_t render(const uint8_t* entry, size_t len, char* out, size_t size) {
+    if (out == nullptr || size == 0) return 0;
+    out[0] = '\0';
+
+    LogBinHdr hdr;
+    if (!header(entry, len, hdr)) return 0;
+
+    const char* level = (hdr.level < 5) ? LevelsMap[hdr.level] : "[?]";
+    int prefix = snprintf(out, size, "%s (%lu): ", level,
+        (unsigned long)hdr.seconds);
+
+    if (prefix < 0) return 0;
+    if ((size_t)prefix >= size) return size - 1;
+
+    return prefix + format(entry, len, out + prefix, size - prefix);
+}
+
+}
+
+}
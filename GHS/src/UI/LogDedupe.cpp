@@ -0,0 +1,202 @@
+#include "UI/LogDedupe.hpp"
+#include <cstdint>
+#include <cstdio>
+#include "string.h"
+#include "Config/config.hpp"
+
+namespace Messaging {
+
+LogDedupe::LogDedupe() : evicted(0) {
+    memset(this->slots, 0, sizeof(this->slots));
+}
+
+// Requires the kind, signature, and its length. Returns the 32 bit FNV-1a
+// hash of both, never DEDUPE_EMPTY.
+uint32_t LogDedupe::hash(LogKind kind, const uint8_t* sig, size_t len) {
+    uint32_t h = 2166136261u;
+    h ^= static_cast<uint8_t>(kind);
+    h *= 16777619u;
+
+    for (size_t i = 0; i < len; i++) {
+        h ^= sig[i];
+        h *= 16777619u;
+    }
+
+    return (h == DEDUPE_EMPTY) ? 1 : h;
+}
+
+// Requires the hash, kind, signature, and its length. Returns the slot
+// holding the signature within the probe, or nullptr if not held. The
+// signature is compared as well, lowering the chance that a hash collision
+// suppresses another message. Text is compared by its prefix only.
+DedupeSlot* LogDedupe::find(uint32_t hash, LogKind kind, const uint8_t* sig,
+    size_t len) {
+
+    for (size_t i = 0; i < DEDUPE_PROBE; i++) {
+        DedupeSlot &slot = this->slots[(hash + i) % LOG_DEDUPE_SLOTS];
+
+        if (slot.hash == hash && slot.kind == kind && slot.len == len &&
+            memcmp(slot.sig, sig, len) == 0) {
+
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+// Requires the message and the current time in seconds. Returns true if
+// the message is new, or a repeat that is allowed, and false if it is a
+// suppressed repeat, which is counted for the next summary.
+bool LogDedupe::check(const char* message, uint32_t time) {
+    if (message == nullptr) message = "";
+
+    const uint8_t* sig = reinterpret_cast<const uint8_t*>(message);
+    size_t len = strlen(message);
+    uint32_t h = LogDedupe::hash(LogKind::TEXT, sig, len); // Whole message.
+
+    // The prefix is kept, for the summary and to compare.
+    return this->admit(h, LogKind::TEXT, sig,
+        (len < DEDUPE_TEXT) ? len : DEDUPE_TEXT - 1, time);
+}
+
+// Requires a binary entry, see LogCodec, its length, and the current time in
+// seconds. Checks as above, signed by the format ID and raw arguments, so
+// entries of the same message with other values are not repeats. Returns
+// true if allowed, or malformed, false if suppressed.
+bool LogDedupe::check(const uint8_t* entry, size_t len, uint32_t time) {
+    LogBinHdr hdr;
+    if (!LogCodec::header(entry, len, hdr)) return true;
+
+    uint8_t key[DEDUPE_KEY];
+    size_t keyLen = sizeof(hdr.fmt) + hdr.argBytes;
+
+    // The header bounds the arguments by the entry only, not by the key.
+    if (keyLen > sizeof(key)) return true; // Malformed, unchecked.
+
+    memcpy(key, &hdr.fmt, sizeof(hdr.fmt));
+    memcpy(key + sizeof(hdr.fmt), entry + sizeof(hdr), hdr.argBytes);
+
+    return this->admit(LogDedupe::hash(LogKind::BIN, key, keyLen),
+        LogKind::BIN, key, keyLen, time);
+}
+
+// Requires the hash, kind, signature of up to DEDUPE_SIG bytes, its length,
+// and the current time in seconds. Returns true if the signature is new, or
+// a repeat that is allowed, and false if it is a suppressed repeat, which is
+// counted for the next summary.
+bool LogDedupe::admit(uint32_t h, LogKind kind, const uint8_t* sig,
+    size_t len, uint32_t time) {
+
+    DedupeSlot* slot = this->find(h, kind, sig, len);
+
+    if (slot != nullptr) { // Repeat.
+        slot->lastSeen = time;
+        if (slot->count < UINT16_MAX) slot->count++;
+
+        // First the consecutive entries, then one per timeout.
+        if (slot->count <= CONSECUTIVE_ENTRIES || time >= slot->resetTime) {
+            slot->resetTime = time + CONSECUTIVE_ENTRY_TIMEOUT;
+            return true; // Allow log.
+        }
+
+        slot->suppressed++;
+        return false; // Prevent log.
+    }
+
+    // New signature. Takes an unused slot in the probe, otherwise the least
+    // recently seen, preferring one without unreported repeats.
+    DedupeSlot* victim = nullptr;
+
+    for (size_t i = 0; i < DEDUPE_PROBE; i++) {
+        DedupeSlot* cand = &this->slots[(h + i) % LOG_DEDUPE_SLOTS];
+
+        if (cand->hash == DEDUPE_EMPTY) {
+            victim = cand;
+            break;
+        }
+
+        if (victim == nullptr) {
+            victim = cand;
+            continue;
+        }
+
+        bool candQuiet = (cand->suppressed == 0);
+        bool victimQuiet = (victim->suppressed == 0);
+
+        if ((candQuiet && !victimQuiet) || (candQuiet == victimQuiet &&
+            cand->lastSeen < victim->lastSeen)) {
+
+            victim = cand;
+        }
+    }
+
+    this->evicted += victim->suppressed; // Reported in aggregate.
+
+    memset(victim, 0, sizeof(*victim));
+    victim->hash = h;
+    victim->lastSeen = time;
+    victim->reportedAt = time;
+    victim->kind = kind;
+    victim->len = static_cast<uint8_t>(len);
+    memcpy(victim->sig, sig, len);
+    return true; // Allow write, new entry.
+}
+
+// Requires the slot, data buffer, and its size. Writes the message of the
+// signature, rendering a binary signature as a level 0 entry.
+void LogDedupe::render(const DedupeSlot &slot, char* data, size_t size) {
+    if (slot.kind == LogKind::TEXT) {
+        snprintf(data, size, "%.*s", (int)slot.len,
+            reinterpret_cast<const char*>(slot.sig));
+
+        return;
+    }
+
+    uint16_t fmt;
+    memcpy(&fmt, slot.sig, sizeof(fmt));
+    LogBinHdr hdr = {0, 0, fmt,
+        static_cast<uint8_t>(slot.len - sizeof(fmt))};
+
+    uint8_t entry[sizeof(hdr) + LOG_BIN_ARGS_SIZE];
+    memcpy(entry, &hdr, sizeof(hdr));
+    memcpy(entry + sizeof(hdr), slot.sig + sizeof(fmt), hdr.argBytes);
+    LogCodec::format(entry, sizeof(hdr) + hdr.argBytes, data, size);
+}
+
+// Requires the current time in seconds, data buffer, and its size. Writes
+// one summary of suppressed repeats, in the format xN: message, for the
+// first signature whose latest summary is at least LOG_DEDUPE_REPORT old.
+// Binary signatures are rendered here. Call repeatedly until false. Returns
+// true if written, false if none due.
+bool LogDedupe::summarize(uint32_t time, char* data, size_t size) {
+    if (data == nullptr || size == 0) return false;
+
+    for (size_t i = 0; i < LOG_DEDUPE_SLOTS; i++) {
+        DedupeSlot &slot = this->slots[i];
+
+        if (slot.hash == DEDUPE_EMPTY || slot.suppressed == 0 ||
+            time - slot.reportedAt < LOG_DEDUPE_REPORT) continue;
+
+        int n = snprintf(data, size, "x%lu: ",
+            (unsigned long)slot.suppressed);
+
+        if (n > 0 && (size_t)n < size) this->render(slot, data + n, size - n);
+
+        slot.suppressed = 0;
+        slot.reportedAt = time;
+        return true;
+    }
+
+    if (this->evicted > 0) {
+        snprintf(data, size, "x%lu: repeats of evicted entries",
+            (unsigned long)this->evicted);
+
+        this->evicted = 0;
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,21 @@
+#include "UI/LogFormats.hpp"
+#include <cstdint>
+
+namespace Messaging {
+
+#define LOG_FMT_STRING(id, fmt) fmt,
+
+const char* const LogFmtTable[] = {
+    LOG_FORMATS(LOG_FMT_STRING)
+};
+
+#undef LOG_FMT_STRING
+
+// Requires the format ID. Returns the format string, or nullptr if the ID is
+// unknown, such as a capture from newer firmware.
+const char* logFmtString(uint16_t fmtID) {
+    if (fmtID >= static_cast<uint16_t>(LogFmt::COUNT)) return nullptr;
+    return LogFmtTable[fmtID];
+}
+
+}
@@ -0,0 +1,446 @@
+#include "UI/LogJournal.hpp"
+#include <cstdint>
+#include <cstddef>
+#include "string.h"
+#include "Threads/Mutex.hpp"
+#include "UI/MsgLogHandler.hpp"
+#include "UI/LogCodec.hpp"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_timer.h"
+
+namespace Messaging {
+
+Threads::Mutex LogJournal::mtx(JOURNAL_TAG);
+
+// Bytes of the record header covered by the CRC, excludes the CRC itself.
+static constexpr size_t JOURNAL_CRC_COVER = offsetof(JournalRecHdr, crc);
+
+// Requires the record header and entry. Returns the CRC32 of both.
+static uint32_t recordCRC(const JournalRecHdr &hdr, const uint8_t* data) {
+    uint32_t crc = esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&hdr),
+        JOURNAL_CRC_COVER);
+
+    return esp_rom_crc32_le(crc, data, hdr.len);
+}
+
+// Requires no params. Unusable until begin() locates the partition, though
+// entries are batched from construction on.
+LogJournal::LogJournal() :
+
+    tag(JOURNAL_TAG), part(nullptr), sectorQty(0), active(0),
+    offset(JOURNAL_SECTOR), nextSectorSeq(1), boot(JOURNAL_BOOT_NONE),
+    bufLen(0), bufSince(0), urgent(false), init(false), writeErr(false),
+    dropped(0), writes(0) {
+
+        memset(this->log, 0, sizeof(this->log));
+        memset(this->sectors, 0, sizeof(this->sectors));
+        memset(this->buf, 0, sizeof(this->buf));
+        memset(this->scratch, 0, sizeof(this->scratch));
+    }
+
+// Requires the sector index, offset within the sector, and header reference.
+// Reads the record header and its entry into scratch, and verifies the CRC.
+// Returns true if valid, false if erased, torn, or unreadable.
+bool LogJournal::readRecord(size_t sector, size_t offset,
+    JournalRecHdr &hdr) {
+
+    if (offset + sizeof(hdr) > JOURNAL_SECTOR) return false;
+    size_t addr = sector * JOURNAL_SECTOR + offset;
+
+    if (esp_partition_read(this->part, addr, &hdr, sizeof(hdr)) != ESP_OK) {
+        return false;
+    }
+
+    if (hdr.len == JOURNAL_ERASED || hdr.len > JOURNAL_REC_MAX ||
+        offset + sizeof(hdr) + hdr.len > JOURNAL_SECTOR) return false;
+
+    if (esp_partition_read(this->part, addr + sizeof(hdr), this->scratch,
+        hdr.len) != ESP_OK) return false;
+
+    return recordCRC(hdr, this->scratch) == hdr.crc;
+}
+
+// Requires the sector index and the last boot reference. WARNING. Requires
+// the mutex or init. Indexes the sector, raising lastBoot to the greatest
+// boot of its records. Returns the offset following its last valid record,
+// or JOURNAL_SECTOR if the sector is unused or ends in a torn record, which
+// prevents further writes to it.
+size_t LogJournal::scanSector(size_t idx, uint16_t &lastBoot) {
+    JournalSector &sec = this->sectors[idx];
+    memset(&sec, 0, sizeof(sec));
+
+    JournalSectorHdr shdr;
+    if (esp_partition_read(this->part, idx * JOURNAL_SECTOR, &shdr,
+        sizeof(shdr)) != ESP_OK || shdr.magic != JOURNAL_MAGIC) {
+
+        return JOURNAL_SECTOR; // Unused, erased before use.
+    }
+
+    sec.sectorSeq = shdr.sectorSeq;
+    size_t offset = sizeof(shdr);
+    JournalRecHdr hdr{};
+
+    while (this->readRecord(idx, offset, hdr)) {
+        if (!sec.hasFirst) {
+            sec.firstBoot = hdr.boot;
+            sec.firstSeq = hdr.seq;
+            sec.hasFirst = true;
+        }
+
+        if (hdr.boot > lastBoot) lastBoot = hdr.boot;
+        offset += sizeof(hdr) + hdr.len;
+    }
+
+    // Either the erased remainder, or a torn write from a crash.
+    if (offset + sizeof(hdr) <= JOURNAL_SECTOR && hdr.len != JOURNAL_ERASED) {
+        return JOURNAL_SECTOR;
+    }
+
+    return offset;
+}
+
+// Requires no params. WARNING. Requires the mutex. Advances to the next
+// sector in ring order, the oldest, erasing it and writing its header.
+// Returns true if successful, false if not, and the sector is retried on
+// the next write.
+bool LogJournal::startSector() {
+    size_t next = (this->active + 1) % this->sectorQty;
+    size_t addr = next * JOURNAL_SECTOR;
+
+    if (esp_partition_erase_range(this->part, addr, JOURNAL_SECTOR) != ESP_OK) {
+        return false;
+    }
+
+    JournalSectorHdr shdr = {JOURNAL_MAGIC, this->nextSectorSeq};
+
+    if (esp_partition_write(this->part, addr, &shdr, sizeof(shdr)) != ESP_OK) {
+        return false;
+    }
+
+    this->active = next;
+    this->offset = sizeof(shdr);
+    memset(&this->sectors[next], 0, sizeof(this->sectors[next]));
+    this->sectors[next].sectorSeq = this->nextSectorSeq++;
+    return true;
+}
+
+// Requires the length of the batch. WARNING. Requires the mutex. Stamps each
+// batched record with the boot number and CRC, and writes them. Each run of
+// records fitting the active sector is a single flash write, beginning a new
+// sector once full. Returns true if all are written, false if not, and the
+// batch is discarded either way.
+bool LogJournal::writeRecords(size_t len) {
+    size_t pos = 0;
+
+    while (pos < len) {
+        size_t run = 0; // Bytes of whole records fitting the active sector.
+        size_t room = JOURNAL_SECTOR - this->offset;
+
+        while (pos + run < len) {
+            JournalRecHdr* hdr = reinterpret_cast<JournalRecHdr*>(
+                &this->buf[pos + run]);
+
+            size_t recLen = sizeof(JournalRecHdr) + hdr->len;
+            if (run + recLen > room) break;
+
+            hdr->boot = this->boot;
+            hdr->crc = recordCRC(*hdr, &this->buf[pos + run + sizeof(*hdr)]);
+            run += recLen;
+        }
+
+        if (run == 0) { // Active sector is full.
+            if (!this->startSector()) return false;
+            continue;
+        }
+
+        size_t addr = this->active * JOURNAL_SECTOR + this->offset;
+
+        if (esp_partition_write(this->part, addr, &this->buf[pos], run)
+            != ESP_OK) {
+
+            this->offset = JOURNAL_SECTOR; // Unknown state, begin another.
+            return false;
+        }
+
+        JournalSector &sec = this->sectors[this->active];
+        if (!sec.hasFirst) {
+            const JournalRecHdr* first = reinterpret_cast<const JournalRecHdr*>(
+                &this->buf[pos]);
+
+            sec.firstBoot = first->boot;
+            sec.firstSeq = first->seq;
+            sec.hasFirst = true;
+        }
+
+        this->offset += run;
+        this->writes++;
+        pos += run;
+    }
+
+    return true;
+}
+
+// Requires the position, 0 being the oldest. Returns the sector index at
+// that position in ring order, which follows the active sector.
+size_t LogJournal::order(size_t pos) const {
+    return (this->active + 1 + pos) % this->sectorQty;
+}
+
+// Requires the position, boot, and sequence number. Returns true if every
+// record of the sector at position precedes the boot and sequence number,
+// known by the first record of the following sector.
+bool LogJournal::skipSector(size_t pos, uint16_t boot, uint32_t seq) const {
+    if (pos + 1 >= this->sectorQty) return false; // Active, nothing follows.
+
+    const JournalSector &next = this->sectors[this->order(pos + 1)];
+    if (next.sectorSeq == 0 || !next.hasFirst) return false;
+
+    return next.firstBoot < boot || (next.firstBoot == boot &&
+        next.firstSeq <= seq);
+}
+
+// Requires no params. Returns the single instance.
+LogJournal* LogJournal::get() {
+    static LogJournal instance;
+    return &instance;
+}
+
+// Requires no params. Locates the journal partition and indexes each sector,
+// resuming writes following the newest record, and sets the boot number to
+// one greater than the newest recorded. Call once, early in boot. Returns
+// true if the journal is usable, false if not, and entries are not kept.
+bool LogJournal::begin() {
+    Threads::MutexLock guard(LogJournal::mtx);
+    if (!guard.LOCK() || this->init) return this->init;
+
+    this->part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+        ESP_PARTITION_SUBTYPE_ANY, JOURNAL_LABEL);
+
+    size_t qty = (this->part != nullptr) ?
+        this->part->size / JOURNAL_SECTOR : 0;
+
+    if (qty < 2) { // Requires a sector to write while another is erased.
+        snprintf(this->log, sizeof(this->log), "%s partition %s unavailable",
+            this->tag, JOURNAL_LABEL);
+
+        MsgLogHandler::get()->handle(Levels::WARNING, this->log,
+            Method::SRL_LOG);
+
+        this->part = nullptr;
+        return false;
+    }
+
+    this->sectorQty = (qty > JOURNAL_MAX_SECTORS) ? JOURNAL_MAX_SECTORS : qty;
+    uint16_t lastBoot = JOURNAL_BOOT_NONE;
+    uint32_t newest = 0;
+
+    // The newest sector is active. If none are in use, the first write
+    // starts sector 0, following the last.
+    this->active = this->sectorQty - 1;
+    this->offset = JOURNAL_SECTOR;
+
+    for (size_t i = 0; i < this->sectorQty; i++) {
+        size_t end = this->scanSector(i, lastBoot);
+
+        if (this->sectors[i].sectorSeq > newest) {
+            newest = this->sectors[i].sectorSeq;
+            this->active = i;
+            this->offset = end;
+        }
+    }
+
+    this->nextSectorSeq = newest + 1;
+    this->boot = lastBoot + 1;
+    if (this->boot == JOURNAL_BOOT_NONE) this->boot++; // Wrapped.
+    this->init = true;
+
+    snprintf(this->log, sizeof(this->log), "%s boot %u, %u sectors",
+        this->tag, this->boot, (unsigned)this->sectorQty);
+
+    MsgLogHandler::get()->handle(Levels::INFO, this->log, Method::SRL_LOG);
+    return true;
+}
+
+// Requires no params. WARNING. Requires the mutex. Writes the RAM batch,
+// discarding it either way, and logs the first failure of a streak.
+void LogJournal::writeBatch() {
+    bool ok = this->writeRecords(this->bufLen);
+    this->bufLen = 0;
+    this->urgent = false;
+
+    if (!ok && !this->writeErr) { // Log once per failure streak.
+        snprintf(this->log, sizeof(this->log), "%s write err", this->tag);
+        MsgLogHandler::get()->handle(Levels::ERROR, this->log,
+            Method::SRL_LOG);
+    }
+
+    this->writeErr = !ok;
+}
+
+// Requires the entry as stored in the log ring, its length and kind, its
+// log ring sequence number, and if it is CRITICAL. Copies the entry to the
+// RAM batch. CRITICAL entries are written upon the next flush. Only if the
+// batch is full is it written here, such as during a burst of entries 
+// before a restart. Entries that do not fit are dropped and counted.
+void LogJournal::append(const void* data, size_t len, LogKind kind,
+    uint32_t seq, bool critical) {
+
+    if (data == nullptr || len == 0) return;
+    if (len > JOURNAL_REC_MAX) len = JOURNAL_REC_MAX; // Truncates text.
+
+    Threads::MutexLock guard(LogJournal::mtx);
+    if (!guard.LOCK()) {
+        this->dropped++;
+        return;
+    }
+
+    // Until begin() runs, it is unknown whether the journal exists. Once
+    // known to be absent, nothing is batched.
+    if (this->init && this->part == nullptr) return;
+
+    const size_t need = sizeof(JournalRecHdr) + len;
+    if (this->bufLen + need > sizeof(this->buf) && this->part != nullptr) {
+        this->writeBatch(); // Full, unknown until begin().
+    }
+
+    if (this->bufLen + need > sizeof(this->buf)) {
+        this->dropped++;
+        return;
+    }
+
+    // Boot and CRC are set when written, the boot may be unknown until then.
+    JournalRecHdr hdr = {static_cast<uint16_t>(len), kind, JOURNAL_BOOT_NONE,
+        seq, 0};
+
+    memcpy(&this->buf[this->bufLen], &hdr, sizeof(hdr));
+    memcpy(&this->buf[this->bufLen + sizeof(hdr)], data, len);
+
+    if (this->bufLen == 0) this->bufSince = esp_timer_get_time() / 1000;
+    this->bufLen += need;
+    this->urgent = this->urgent || critical;
+}
+
+// Requires force, default false. WARNING. Must be called by the log task
+// each loop, and before restarts with force. Writes the RAM batch once a
+// CRITICAL entry is batched, it is half full, or its oldest entry has waited
+// JOURNAL_FLUSH_MS, and always if forced.
+void LogJournal::flush(bool force) {
+    Threads::MutexLock guard(LogJournal::mtx);
+    if (!guard.LOCK() || !this->init || this->bufLen == 0) return;
+
+    if (this->part == nullptr) { // Unavailable, discard.
+        this->bufLen = 0;
+        return;
+    }
+
+    int64_t now = esp_timer_get_time() / 1000;
+    bool due = force || this->urgent ||
+        this->bufLen >= sizeof(this->buf) / 2 ||
+        now - this->bufSince >= JOURNAL_FLUSH_MS;
+
+    if (due) this->writeBatch();
+}
+
+// Requires the boot number, data buffer, its size, and the sequence number
+// to begin at, 0 beginning at the oldest entry of that boot. Renders whole
+// written entries of that boot, in the format of LogRing::render(), setting
+// seq to follow the last entry rendered. Call repeatedly, passing seq back,
+// to page through the boot. Entries batched but not yet written are not
+// included. Returns bytes written, 0 once complete or if unavailable.
+size_t LogJournal::render(uint16_t boot, char* data, size_t size,
+    uint32_t &seq) {
+
+    if (data == nullptr || size < 2) return 0; // Room for delim and term.
+    data[0] = '\0';
+
+    Threads::MutexLock guard(LogJournal::mtx);
+    if (!guard.LOCK() || this->part == nullptr) return 0;
+
+    size_t written = 0;
+    char text[LOGRING_RENDER_MAX]; // Binary entries render here.
+
+    for (size_t pos = 0; pos < this->sectorQty; pos++) {
+        size_t idx = this->order(pos);
+        if (this->sectors[idx].sectorSeq == 0) continue; // Unused.
+        if (this->skipSector(pos, boot, seq)) continue;
+
+        const JournalSector &sec = this->sectors[idx];
+        if (sec.hasFirst && sec.firstBoot > boot) break; // Boots ascend.
+
+        size_t offset = sizeof(JournalSectorHdr);
+        JournalRecHdr hdr{};
+
+        while (this->readRecord(idx, offset, hdr)) {
+            offset += sizeof(hdr) + hdr.len;
+
+            if (hdr.boot > boot) { // Complete.
+                data[written] = '\0';
+                return written;
+            }
+
+            if (hdr.boot < boot || hdr.seq < seq) continue;
+
+            const char* entry = reinterpret_cast<const char*>(this->scratch);
+            size_t len = hdr.len;
+
+            if (hdr.kind == LogKind::BIN) {
+                len = LogCodec::render(this->scratch, hdr.len, text,
+                    sizeof(text));
+
+                // String arguments may contain the delimiter.
+                for (size_t i = 0; i < len; i++) {
+                    if (text[i] == MLH_DELIM) text[i] = MLH_DELIM_REP;
+                }
+
+                entry = text;
+            }
+
+            size_t remaining = size - written - 1; // - 1 for null term.
+
+            if (len + 1 > remaining) { // + 1 for the delimiter.
+                if (written > 0) { // Resume with this entry next call.
+                    data[written] = '\0';
+                    return written;
+                }
+
+                len = remaining - 1; // Truncate, empty buffer.
+            }
+
+            memcpy(&data[written], entry, len);
+            written += len;
+            data[written++] = MLH_DELIM;
+            seq = hdr.seq + 1;
+        }
+    }
+
+    data[written] = '\0';
+    return written;
+}
+
+// Requires no params. Returns the current boot number, 0 if unavailable.
+uint16_t LogJournal::getBoot() const {
+    return (this->part != nullptr) ? this->boot : JOURNAL_BOOT_NONE;
+}
+
+// Requires no params. Returns the boot number of the oldest written entry,
+// the current boot if none, or 0 if unavailable or the mutex is locked.
+uint16_t LogJournal::getOldestBoot() {
+    Threads::MutexLock guard(LogJournal::mtx);
+    if (!guard.LOCK() || this->part == nullptr) return JOURNAL_BOOT_NONE;
+
+    for (size_t pos = 0; pos < this->sectorQty; pos++) {
+        const JournalSector &sec = this->sectors[this->order(pos)];
+        if (sec.sectorSeq != 0 && sec.hasFirst) return sec.firstBoot;
+    }
+
+    return this->boot;
+}
+
+// Requires no params. Returns the entries dropped since boot.
+uint32_t LogJournal::getDropped() const {return this->dropped.load();}
+
+// Requires no params. Returns the flash writes since boot.
+uint32_t LogJournal::getWrites() const {return this->writes.load();}
+
+}
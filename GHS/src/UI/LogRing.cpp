@@ -0,0 +1,243 @@
+#include "UI/LogRing.hpp"
+#include <cstdint>
+#include "string.h"
+#include "UI/MsgLogHandler.hpp"
+#include "UI/LogCodec.hpp"
+
+namespace Messaging {
+
+// Requires no params. Ring starts empty with the first sequence number.
+LogRing::LogRing() :
+
+    head(0), tail(0), count(0), firstSeq(LOGRING_SEQ_START),
+    nextSeq(LOGRING_SEQ_START) {
+
+        memset(this->buf, 0, sizeof(this->buf));
+    }
+
+// Requires the offset of a record or wrap marker. Returns offset 0 if the
+// ring wraps at the offset, or the offset if it points to a record.
+size_t LogRing::normalize(size_t offset) const {
+
+    // No room for a header at the end of the buffer, wrap implicitly.
+    if (offset + sizeof(LogRecordHdr) > LOG_SIZE) return 0;
+
+    LogRecordHdr hdr;
+    this->readHdr(offset, hdr);
+    return (hdr.len == LOGRING_WRAP) ? 0 : offset;
+}
+
+// Requires the offset and header reference. Copies the header at the offset
+// into hdr. Uses memcpy since records are not aligned.
+void LogRing::readHdr(size_t offset, LogRecordHdr &hdr) const {
+    memcpy(&hdr, &this->buf[offset], sizeof(hdr));
+}
+
+// Requires no params. Removes the oldest record. Does nothing if empty.
+void LogRing::evict() {
+    if (this->count == 0) return;
+
+    LogRecordHdr hdr;
+    this->head = this->normalize(this->head);
+    this->readHdr(this->head, hdr);
+
+    this->head += sizeof(hdr) + hdr.len;
+    this->firstSeq = hdr.seq + 1;
+    this->count--;
+
+    if (this->count == 0) { // Restart at 0 to avoid needless wrapping.
+        this->head = this->tail = 0;
+    } else {
+        this->head = this->normalize(this->head);
+    }
+}
+
+// Requires the record data, its length, and kind, default text. Text is 
+// truncated to fit the ring if required. Evicts the oldest records until the
+// new record fits, and appends it. Returns the sequence number assigned to 
+// the record.
+uint32_t LogRing::append(const void* data, size_t len, LogKind kind) {
+    const size_t maxLen = LOG_SIZE - sizeof(LogRecordHdr);
+    if (len > maxLen) len = maxLen;
+    if (len >= LOGRING_WRAP) len = LOGRING_WRAP - 1;
+
+    const size_t need = sizeof(LogRecordHdr) + len;
+    size_t pos = 0; // Offset the record will be written to.
+    bool wrap = false; // Record will not fit before the end of the buffer.
+
+    // Evict the oldest records until the region at pos is free. If the
+    // stored records have not yet wrapped, they occupy [head, tail). If they
+    // have, they occupy [head, end) and [0, tail).
+    while (true) {
+        if (this->count == 0) this->head = this->tail = 0;
+
+        wrap = (this->tail + need > LOG_SIZE);
+        pos = wrap ? 0 : this->tail;
+
+        if (this->count == 0) break; // Empty, always fits.
+
+        if (this->head < this->tail) { // Not wrapped.
+            if (!wrap || need <= this->head) break;
+        } else if (!wrap && this->tail + need <= this->head) { // Wrapped.
+            break;
+        }
+
+        this->evict();
+    }
+
+    // Leaves a marker for readers, if there is room for one. If not, readers
+    // wrap implicitly, see normalize().
+    if (wrap && this->tail + sizeof(LogRecordHdr) <= LOG_SIZE) {
+        LogRecordHdr marker = {0, LOGRING_WRAP, LogKind::TEXT};
+        memcpy(&this->buf[this->tail], &marker, sizeof(marker));
+    }
+
+    LogRecordHdr hdr = {this->nextSeq, static_cast<uint16_t>(len), kind};
+    memcpy(&this->buf[pos], &hdr, sizeof(hdr));
+    memcpy(&this->buf[pos + sizeof(hdr)], data, len);
+
+    if (this->count == 0) this->firstSeq = hdr.seq;
+    this->tail = pos + need;
+    this->count++;
+
+    return this->nextSeq++;
+}
+
+// Requires the record offset, its header, a scratch buffer and size, and a
+// text pointer reference. Sets text to the rendered record, pointing into 
+// the ring for text records, or to scratch for binary records which are 
+// decoded into it. Returns the text length.
+size_t LogRing::recordText(size_t offset, const LogRecordHdr &hdr, 
+    char* scratch, size_t size, const char* &text) const {
+
+    const char* data = &this->buf[offset + sizeof(hdr)];
+
+    if (hdr.kind == LogKind::TEXT) {
+        text = data;
+        return hdr.len;
+    }
+
+    text = scratch;
+    size_t len = LogCodec::render(reinterpret_cast<const uint8_t*>(data), 
+        hdr.len, scratch, size);
+
+    // String arguments may contain the delimiter, replace as with text.
+    for (size_t i = 0; i < len; i++) {
+        if (scratch[i] == MLH_DELIM) scratch[i] = MLH_DELIM_REP;
+    }
+
+    return len;
+}
+
+// Requires the data buffer, its size, and the sequence number to begin at,
+// 0 beginning at the oldest record. Optionally the sequence number to end 
+// before, default unbounded. Renders whole records, beginning with the first
+// at or after seq, in the format entry1;entry2;...;entryn; and null 
+// terminates. A record too large for an empty buffer is truncated to ensure
+// progress. Sets seq to the sequence number following the last rendered 
+// record, which is passed to the next call to resume. Returns the bytes 
+// written, excluding the null terminator, 0 once all are rendered.
+size_t LogRing::render(char* data, size_t size, uint32_t &seq, 
+    uint32_t end) const {
+
+    if (data == nullptr || size < 2) return 0; // Room for delim and term.
+
+    size_t written = 0;
+    size_t offset = this->head;
+    char scratch[LOGRING_RENDER_MAX]; // Binary records render here.
+    data[0] = '\0';
+
+    for (size_t i = 0; i < this->count; i++) {
+        LogRecordHdr hdr;
+        offset = this->normalize(offset);
+        this->readHdr(offset, hdr);
+
+        if (hdr.seq < seq) { // Already rendered by the caller.
+            offset += sizeof(hdr) + hdr.len;
+            continue;
+        }
+
+        if (hdr.seq >= end) break; // Records are in sequence order.
+
+        const char* text = nullptr;
+        size_t len = this->recordText(offset, hdr, scratch, sizeof(scratch),
+            text);
+
+        offset += sizeof(hdr) + hdr.len;
+        size_t remaining = size - written - 1; // - 1 for null term.
+
+        if (len + 1 > remaining) { // + 1 for the delimiter.
+            if (written > 0) break; // Resume with this record next call.
+            len = remaining - 1; // Truncate, empty buffer.
+        }
+
+        memcpy(&data[written], text, len);
+        written += len;
+        data[written++] = MLH_DELIM;
+        seq = hdr.seq + 1;
+    }
+
+    data[written] = '\0';
+    return written;
+}
+
+// Requires the data buffer and its size. Renders the newest whole records
+// that fit within size, including delimiters and the null terminator, in
+// the same format as render(). Returns the bytes written, excluding the
+// null terminator.
+size_t LogRing::renderTail(char* data, size_t size) const {
+    if (data == nullptr || size == 0) return 0;
+
+    // Total rendered size, each record is followed by a delimiter. Binary
+    // records are rendered to find their size. Only used upon restart.
+    char scratch[LOGRING_RENDER_MAX];
+    const char* text = nullptr;
+    size_t total = 0;
+    size_t offset = this->head;
+
+    for (size_t i = 0; i < this->count; i++) {
+        LogRecordHdr hdr;
+        offset = this->normalize(offset);
+        this->readHdr(offset, hdr);
+        total += this->recordText(offset, hdr, scratch, sizeof(scratch), 
+            text) + 1;
+
+        offset += sizeof(hdr) + hdr.len;
+    }
+
+    // Skip the oldest records until the remainder fits.
+    offset = this->head;
+    uint32_t seq = this->firstSeq;
+
+    for (size_t i = 0; i < this->count && total > size - 1; i++) {
+        LogRecordHdr hdr;
+        offset = this->normalize(offset);
+        this->readHdr(offset, hdr);
+        total -= this->recordText(offset, hdr, scratch, sizeof(scratch), 
+            text) + 1;
+
+        offset += sizeof(hdr) + hdr.len;
+        seq = hdr.seq + 1;
+    }
+
+    if (total == 0) {
+        data[0] = '\0';
+        return 0;
+    }
+
+    return this->render(data, size, seq);
+}
+
+// Requires no params. Returns the quantity of records stored.
+size_t LogRing::getCount() const {return this->count;}
+
+// Requires no params. Returns the sequence number of the oldest record. If
+// empty, this equals the next sequence number.
+uint32_t LogRing::getFirstSeq() const {
+    return (this->count > 0) ? this->firstSeq : this->nextSeq;
+}
+
+// Requires no params. Returns the sequence number of the next record.
+uint32_t LogRing::getNextSeq() const {return this->nextSeq;}
+
+}
@@ -6,31 +6,42 @@
 #include "Common/Timing.hpp"
 #include "freertos/FreeRTOS.h"
 #include "Config/config.hpp"
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include "Network/NetManager.hpp"
+#include "Network/UDPSender.hpp"
+#include "UI/LogCodec.hpp"
+#include "UI/LogJournal.hpp"
 
 namespace Messaging {
 
 Threads::Mutex MsgLogHandler::mtx(MLH_TAG); // Create static instance
+Threads::Mutex MsgLogHandler::drainMtx(MLH_DRAIN_TAG);
 
-// Maps to levels. Used in printing.
-const char LevelsMap[5][11]{"[DEBUG]", "[INFO]", "[WARNING]", "[ERROR]",
-    "[CRITICAL]"};
+// LevelsMap is defined in LogCodec.cpp, shared with the host decoder.
 
 // Used for serial display, allows different colors for error types.
 const char LevelsColors[5][10]{SRL_CYN, SRL_GRN, SRL_YEL, SRL_RED, SRL_MAG};
 
+#define LOG_TAG_NAME(name) #name,
+const char* const LogTagMap[LOG_TAG_QTY]{LOG_TAGS(LOG_TAG_NAME)};
+#undef LOG_TAG_NAME
+
 // Requires no params allowing immediate use. Relies on timing, and will likely
 // init the dateTime singleton.
 MsgLogHandler::MsgLogHandler() : 
 
-    tag(MLH_TAG), OLED(nullptr), serialOn(SERIAL_ON), newLogEntry{false} {
+    tag(MLH_TAG), OLED(nullptr), serialOn(SERIAL_ON), newLogEntry{false},
+    summarizedAt(0), queue(nullptr), async(false), dropped(0), 
+    droppedReported(0) {
 
         memset(this->errLog, 0, sizeof(this->errLog));
-        memset(this->log, 0, LOG_SIZE);
         memset(this->OLEDqueue, 0, sizeof(this->OLEDqueue));
+
+        for (auto &lvl : this->tagLevels) lvl.store(LOG_DEF_LEVEL);
+
+        // Static allocation, the queue is never deleted. If this fails, the
+        // queue remains nullptr and handle() always processes inline.
+        this->queue = xQueueCreateStatic(LOG_QUEUE_DEPTH, sizeof(LogRecord),
+            this->queueStorage, &this->queueBuf);
         
         snprintf(this->errLog, sizeof(this->errLog), "%s init", this->tag);
         this->handle(Levels::INFO, this->errLog, Method::SRL_LOG);
@@ -116,13 +127,19 @@ bool MsgLogHandler::writeOLED(Levels level, const char* message,
 // Requires level, message, time in seconds, ignore repeating entries, and
 // big log. Repeating entries are filtered to prevent log pollution, for ex:
 // in the event of a disconnected sensor wire. Those will display at a set
-// interval. IF ignore repeat is set to true, it will repeat chosen entries,
+// interval, and the suppressed repeats are summarized by the log task, see
+// LogDedupe.hpp. IF ignore repeat is set to true, it will repeat chosen entries,
 // such as a class logging the creation of several objects at once. The big log
 // will allow up to 512 bytes vs 128 bytes. This must be set to true to allow
-// the increased size of up to 512 bytes. The log is sent via http in the 
-// format: entry1;entry2;...;entryn; with the delimiter being a semicolon.
+// the increased size of up to 512 bytes. Each entry is appended to the log
+// ring as its own record, and is rendered for http on demand in the format:
+// entry1;entry2;...;entryn; with the delimiter being a semicolon. If a binary
+// entry is passed, the message is unused, the repeat analysis signs the 
+// format ID and raw arguments, and the binary entry is appended unrendered.
+// Each record is also batched to the flash journal, see LogJournal.hpp.
 void MsgLogHandler::writeLog(Levels level, const char* message, 
-    uint32_t seconds, bool ignoreRepeat, bool bigLog) {
+    uint32_t seconds, bool ignoreRepeat, bool bigLog, const uint8_t* bin,
+    size_t binLen) {
 
     // Prevents the analysis from running if set to ignore repeat is set to
     // false or if sending a big log entry.
@@ -131,7 +148,20 @@ void MsgLogHandler::writeLog(Levels level, const char* message,
         // Check for block. If true, allows a write, if false, it does not. This
         // analyzes repeating entries ensuring logbook pollution control and 
         // will write repeat entries only when set conditions are met.
-        if (!this->analyzeLogEntry(message, seconds)) return;
+        bool allow = (bin != nullptr) ? 
+            this->dedupe.check(bin, binLen, seconds) :
+            this->dedupe.check(message, seconds);
+
+        if (!allow) return;
+    }
+
+    const bool critical = (level == Levels::CRITICAL);
+
+    if (bin != nullptr) { // Binary entry, rendered when read.
+        uint32_t seq = this->log.append(bin, binLen, LogKind::BIN);
+        LogJournal::get()->append(bin, binLen, LogKind::BIN, seq, critical);
+        this->newLogEntry = true;
+        return;
     }
 
     // Max log size throughout the program is limited to 128 bytes. The max
@@ -142,139 +172,30 @@ void MsgLogHandler::writeLog(Levels level, const char* message,
                                          LOG_MAX_ENTRY + LOG_MAX_ENTRY_PAD;
     
     char entry[maxEntrySize] = {0};
-    size_t remaining = LOG_SIZE - strlen(this->log) - 1;  // - 1 for null term
-
-    // Write the data to the entry to be concat to the log array. Used sprintf
-    // in order to avoid null termination by snprintf, this must be terminated
-    // by the delimiter. EXPLICITYLY DID NOT CHECK TO SEE IF WRITTEN EXCEEDS
-    // ENTRY SIZE, IT OVER, IT WILL BE TRUNCATED. Format is INFO (seconds): msg
-    int written = snprintf(entry, maxEntrySize, "%s (%lu): %s%c", 
-        LevelsMap[static_cast<uint8_t>(level)], seconds, message, MLH_DELIM);
-
-    // If written is greater than max entry size, ensures it has a closing
-    // delimiter before the null terminator.
-    if (written > maxEntrySize) {
-        printf("MLH: Message size exceeds max entry\n");
-        entry[maxEntrySize - 2] = MLH_DELIM;
-    }
 
-    // Iterates the entry - 1, to avoid replacing the closing delimiter. If a
-    // delimiter is found, it is replaced with another CHAR.
-    for (int i = 0; i < strlen(entry) - 1; i++) {
-        if (entry[i] == MLH_DELIM) entry[i] = MLH_DELIM_REP;
-    }
-
-    // Checks to see if the entry is larger than the remaining space left in
-    // the log. If yes, this will strip the first message off, potentially 
-    // several times until the remaining space is large enough to accomodate
-    // the new entry.
-    if (strlen(entry) >= remaining) { // Purge beginning
+    // Write the data to the entry, the delimiter is added when rendered.
+    // EXPLICITYLY DID NOT CHECK TO SEE IF WRITTEN EXCEEDS ENTRY SIZE, IF OVER,
+    // IT WILL BE TRUNCATED. Format is INFO (seconds): msg
+    int written = snprintf(entry, maxEntrySize, "%s (%lu): %s", 
+        LevelsMap[static_cast<uint8_t>(level)], seconds, message);
 
-        while(true) { 
-
-            remaining = this->stripLogMsg(written);
-            if (remaining >= written) break;
-        }
-    }
-
-    // Concatenate entry to log. Automatically null terminates.
-    strncat(this->log, entry, written); 
-    this->newLogEntry = true; // Used for client to know new entry avialable.
-}
+    if (written < 0) return; // Encoding error.
 
-// Requires no parameters. Strips the first message from the LOG when a new
-// entry is added, but the data space is full. Returns remaining size after
-// stripping entry.
-
-// Requires the size of the new message length. This strips the first message
-// from the log when a new entry is added, but the log is full. Returns the
-// remaining size after the beginning entry(ies) is/are stripped.
-size_t MsgLogHandler::stripLogMsg(size_t newMsgLen) {
-    int delimPos = -1; // Indicates no delimiter exists
-
-    // Iterates the log to find the first delimiter. Sets position to idx val.
-    for (int i = 0; i < LOG_SIZE; i++) {
-        if (this->log[i] == MLH_DELIM) {
-            delimPos = i;
-            break;
-        }
-    }
-
-    // If -1, means no delimiter and the log will be reset to 0. If not -1,
-    // removes the first entry, and moves the remaining log to index 0.
-    if (delimPos != -1) {
-        size_t start = delimPos + 1; // Account for start of 2nd entry
-        size_t moveSize = strlen(this->log) - start; // How many bytes to move
-
-        memmove(this->log, this->log + start, moveSize);
-        this->log[moveSize] = '\0'; // Null terminate the new log
-    } else { // No messages exist, zero everything out
-        memset(this->log, 0, LOG_SIZE);
+    if (written >= (int)maxEntrySize) {
+        printf("MLH: Message size exceeds max entry\n");
+        written = maxEntrySize - 1; // Truncated length.
     }
 
-    // Returns the remaining size
-    return LOG_SIZE - strlen(this->log) - 1; // -1 for the null term
-}
-
-// Requires the message and current time in seconds. Compares the new entry
-// with the previous n entries. If it is the same, returns false unless either
-// the consecutive entry timeout is met, or the quantity of consecutive 
-// entires is met. Returns true if the new entry does not equal the previous.
-bool MsgLogHandler::analyzeLogEntry(const char* message, uint32_t time) {
-
-    // Purpose: This is to prevent an error, such as an error with a peripheral
-    // device, to continue logging the same error over and over, polluting the
-    // log. If a limit of 3 entries is set, it will allow 3 entries, and then
-    // block any additional until the time is greater than or equal to the 
-    // reset time. An array of previous messages is used to prevent message
-    // clusters from defying this logic. For example, if the SHT driver fails
-    // and logs the failure, and it also causes the temphum read to fail, which
-    // also logs the failure, it will keep resetting itself preventing the
-    // intent of this function.
-
-    // These arrays will be responsible to hold the previous n entries. This
-    // allows for specific control for each entry, rather than other entries
-    // affecting other entries.
-    static char prevMsgs[LOG_PREV_MSGS][LOG_MAX_ENTRY] = {""};
-    static uint32_t resetTimes[LOG_PREV_MSGS]{0}; // Allows log to be re-ran
-    static size_t consecutiveCts[LOG_PREV_MSGS]{0}; // Allows n consec logs.
-
-    static size_t index = 0; // Used with prevMsgs to index new entries.
-
-    for (int i = 0; i < LOG_PREV_MSGS; i++) { // Iterate all prev messages.
-
-        // Compares current message with each previous message. Action is only
-        // taken here if there is a match. If matched, and below the consec
-        // entries limit, returns true which will log. If below the limit, will
-        // log when the reset time is reached.
-        if (strcmp(message, prevMsgs[i]) == 0) {
-            consecutiveCts[i]++; 
-
-            // First check entries.
-            if (consecutiveCts[i] <= CONSECUTIVE_ENTRIES) {
-                resetTimes[i] = time + CONSECUTIVE_ENTRY_TIMEOUT; // Establish
-                return true; // Allow log
-
-            // Then times if all consecutive entries have been logged.
-            } else if (time >= resetTimes[i]) {
-                resetTimes[i] = time + CONSECUTIVE_ENTRY_TIMEOUT; // Re-estab
-                return true; // Allow log
-            }
-
-            return false; // Prevent log.
-        }
+    // Iterates the entry. If a delimiter is found, it is replaced with 
+    // another CHAR, keeping the rendered log parseable.
+    for (int i = 0; i < written; i++) {
+        if (entry[i] == MLH_DELIM) entry[i] = MLH_DELIM_REP;
     }
 
-    // No match to any previous entry. New entry is added into the array.
-    snprintf(prevMsgs[index], LOG_MAX_ENTRY, "%s", message);
-    consecutiveCts[index] = 0; // Set count to 0.
-    index++; // Increment after adding values and adjusting times.
-
-    // Runs between 0 and max. This ensures that the log is cyclic 0 - n, 0 - n,
-    // always clearing the oldest entires next. 
-    index %= LOG_PREV_MSGS; 
-    
-    return true; // ALlow write, new entry.
+    // Append to the ring, evicting the oldest entries if full. O(1).
+    uint32_t seq = this->log.append(entry, written);
+    LogJournal::get()->append(entry, written, LogKind::TEXT, seq, critical);
+    this->newLogEntry = true; // Used for client to know new entry avialable.
 }
 
 // Requires no params. Returns true if OLED != nullptr and can proceed.
@@ -283,7 +204,7 @@ bool MsgLogHandler::OLEDcheck() {
         snprintf(this->errLog, sizeof(this->errLog), "%s OLED req adding",
             this->tag);
 
-        this->handle(Levels::WARNING, this->log, Method::SRL_LOG);
+        this->handle(Levels::WARNING, this->errLog, Method::SRL_LOG);
     }
 
     return (this->OLED != nullptr);
@@ -369,44 +290,47 @@ bool MsgLogHandler::OLEDQueueRemove() {
 }
 
 // Requires level, message, and time in seconds. This is prepared by the 
-// handle function.
+// handle function. Binary entry and length default to nullptr and 0. Adds 
+// the entry to the UDP sender batch, see UDPSender.hpp for the datagram 
+// formats. Passes the binary entry if passed, the message then unused. 
+// Otherwise in binary mode, passes the rendered text entry, and in text 
+// mode, the JSON entry.
 void MsgLogHandler::sendUDPLog(Levels level, const char* msg, 
-    uint32_t seconds) {
+    uint32_t seconds, const uint8_t* bin, size_t binLen) {
 
     char mDNS[64];
 
     // Only allow UDP if conn to LAN. If successful return, mDNS is updated.
-    if (!Comms::NetManager::onLAN(mDNS, sizeof(mDNS)) || msg == nullptr ||
-        msg[0] == '\0') return; 
+    if (!Comms::NetManager::onLAN(mDNS, sizeof(mDNS)) || (bin == nullptr &&
+        (msg == nullptr || msg[0] == '\0'))) return; 
    
     // ATTENTION. All logs will attempt to be sent by UDP, which will only work
     // after device connected to LAN. Until then, they will just fire into the
     // abyss. Upon the receipt of a log, it is the responsibility of the client
     // to get the total log, inspect it, and aggregate the log entries together.
 
-    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP); // Create socket.
-
-    if (sock < 0) return;
+    if (bin != nullptr) { // Binary entry, only passed in binary mode.
+        Comms::UDPSender::get()->addLog(bin, binLen, LogKind::BIN);
+        return;
+    }
 
     char log[BIGLOG_MAX_ENTRY + 64] = {0}; // Some padding for mdns.
+    int written = 0;
 
-    // Before processing and mtx, send log entry. WARNING. Logs will be sent
-    // to the UDP abyss, and will only be received once this is connected to 
-    // the LAN.
-    int written = snprintf(log, sizeof(log), 
-        "{\"mdns\": \"%s\", \"entry\": \"%s (%lu): %s%c\"}", mDNS,
-        LevelsMap[static_cast<uint8_t>(level)], seconds, msg, MLH_DELIM);
-
-    if (written <= 0) return; // Indicates unsuccessful write.
+    if (LOG_BINARY) { // Rendered text entry, mDNS is in the datagram header.
+        written = snprintf(log, sizeof(log), "%s (%lu): %s", 
+            LevelsMap[static_cast<uint8_t>(level)], seconds, msg);
 
-    struct sockaddr_in dest; 
-    dest.sin_family = AF_INET;
-    dest.sin_port = htons(LOG_UDP_PORT);
-    dest.sin_addr.s_addr = inet_addr(UDP_URL);
+    } else {
+        written = snprintf(log, sizeof(log), 
+            "{\"mdns\": \"%s\", \"entry\": \"%s (%lu): %s%c\"}", mDNS,
+            LevelsMap[static_cast<uint8_t>(level)], seconds, msg, MLH_DELIM);
+    }
 
-    sendto(sock, log, strlen(log), 0, (struct sockaddr *)&dest, sizeof(dest));
+    if (written <= 0) return; // Indicates unsuccessful write.
 
-    close(sock);
+    size_t len = ((size_t)written < sizeof(log)) ? written : sizeof(log) - 1;
+    Comms::UDPSender::get()->addLog(log, len, LogKind::TEXT);
 }
 
 // Requires no params. Returns static instance to class.
@@ -434,16 +358,18 @@ void MsgLogHandler::OLEDMessageMgr() {
     this->OLEDQueueRemove();
 }
 
-// Requires the level of error, message, sending method, option to ignore 
-// repeated logs (def false), and if bigLog (def false), which exceeds the 
-// typlical log entry max of 128 bytes, at 512 bytes. OLED is restricted to 200 
-// bytes, and serial is unrestricted.
-void MsgLogHandler::handle(Levels level, const char* message, Method method,
-    bool ignoreRepeat, bool bigLog) {
-
-    uint32_t seconds = Clock::DateTime::get()->seconds();
+// Requires the level of error, message, sending method, system seconds, 
+// option to ignore repeated logs, and if bigLog. Binary entry and length 
+// default to nullptr and 0, if passed, message is its rendered text for 
+// serial and OLED, or empty if neither is written, see dispatchBin(). Sends
+// the message by UDP and to each destination of the method. Runs on the log
+// task when async, and on the caller when not.
+void MsgLogHandler::dispatch(Levels level, const char* message, Method method,
+    uint32_t seconds, bool ignoreRepeat, bool bigLog, const uint8_t* bin,
+    size_t binLen) {
 
-    this->sendUDPLog(level, message, seconds); // Sends UDP upon every msg.
+    // Sends UDP upon every msg.
+    this->sendUDPLog(level, message, seconds, bin, binLen); 
 
     Threads::MutexLock guard(MsgLogHandler::mtx);
     if (!guard.LOCK()) {
@@ -462,7 +388,8 @@ void MsgLogHandler::handle(Levels level, const char* message, Method method,
 
         case Method::SRL_LOG:
         this->writeSerial(level, message, seconds);
-        this->writeLog(level, message, seconds, ignoreRepeat, bigLog);
+        this->writeLog(level, message, seconds, ignoreRepeat, bigLog, bin,
+            binLen);
         break;
 
         case Method::OLED:
@@ -471,23 +398,269 @@ void MsgLogHandler::handle(Levels level, const char* message, Method method,
 
         case Method::OLED_LOG:
         this->writeOLED(level, message, seconds);
-        this->writeLog(level, message, seconds, ignoreRepeat, bigLog);
+        this->writeLog(level, message, seconds, ignoreRepeat, bigLog, bin,
+            binLen);
         break;
 
         case Method::LOG:
-        this->writeLog(level, message, seconds, ignoreRepeat, bigLog);
+        this->writeLog(level, message, seconds, ignoreRepeat, bigLog, bin,
+            binLen);
         break;
 
         case Method::SRL_OLED_LOG:
         this->writeSerial(level, message, seconds);
         this->writeOLED(level, message, seconds);
-        this->writeLog(level, message, seconds, ignoreRepeat, bigLog);
+        this->writeLog(level, message, seconds, ignoreRepeat, bigLog, bin,
+            binLen);
         break;
 
         default:;
     }
 }
 
+// Requires binary entry, its length, and sending method. Renders the message
+// text only if the method writes text, to serial if enabled, or to OLED, and
+// dispatches the entry. The log, journal, and UDP take the entry unrendered,
+// rendered once read by getLog() or the host decoder.
+void MsgLogHandler::dispatchBin(const uint8_t* bin, size_t binLen, 
+    Method method) {
+
+    LogBinHdr hdr;
+    if (!LogCodec::header(bin, binLen, hdr) || hdr.level > 
+        static_cast<uint8_t>(Levels::CRITICAL)) return;
+
+    bool text = false;
+
+    switch (method) {
+        case Method::SRL: case Method::SRL_LOG:
+        text = this->serialOn; break;
+
+        case Method::SRL_OLED: case Method::OLED: case Method::OLED_LOG:
+        case Method::SRL_OLED_LOG:
+        text = true; break;
+
+        default:;
+    }
+
+    char msg[LOG_MAX_ENTRY] = {0};
+    if (text) LogCodec::format(bin, binLen, msg, sizeof(msg));
+
+    this->dispatch(static_cast<Levels>(hdr.level), msg, method, hdr.seconds,
+        false, false, bin, binLen);
+}
+
+// Requires no params. Logs the quantity of records dropped since the last
+// report, if any. Called by the log task, or by sync() before a restart.
+// WARNING. Requires drainMtx.
+void MsgLogHandler::reportDrops() {
+    uint32_t dropped = this->dropped.load();
+    if (dropped == this->droppedReported) return;
+
+    char msg[LOG_MAX_ENTRY];
+    snprintf(msg, sizeof(msg), "%s %lu log entries dropped, queue full", 
+        this->tag, (unsigned long)(dropped - this->droppedReported));
+
+    this->droppedReported = dropped;
+    this->dispatch(Levels::WARNING, msg, Method::SRL_LOG, 
+        Clock::DateTime::get()->seconds(), true, false);
+}
+
+// Requires no params. Logs the "xN" summaries of repeat entries suppressed
+// since their previous summary, sweeping once per second at most. Called by
+// the log task only.
+void MsgLogHandler::reportRepeats() {
+    uint32_t now = Clock::DateTime::get()->seconds();
+    if (now == this->summarizedAt) return;
+    this->summarizedAt = now;
+
+    char summary[LOG_MAX_ENTRY];
+    char msg[LOG_MAX_ENTRY];
+
+    while (true) {
+        {
+            Threads::MutexLock guard(MsgLogHandler::mtx);
+            if (!guard.LOCK() || 
+                !this->dedupe.summarize(now, summary, sizeof(summary))) {
+                
+                return; 
+            }
+        }
+
+        snprintf(msg, sizeof(msg), "%s %s", this->tag, summary);
+        this->dispatch(Levels::WARNING, msg, Method::SRL_LOG, now, true, 
+            false);
+    }
+}
+
+// Requires the level of error, message, sending method, option to ignore 
+// repeated logs (def false), and if bigLog (def false), which exceeds the 
+// typlical log entry max of 128 bytes, at 512 bytes. OLED is restricted to 200 
+// bytes, and serial is unrestricted. Once the log task is running, the message
+// is queued and this returns immediately, never blocking the caller. If the
+// queue is full, the message is dropped and counted.
+void MsgLogHandler::handle(Levels level, const char* message, Method method,
+    bool ignoreRepeat, bool bigLog) {
+
+    if (message == nullptr) return;
+
+    uint32_t seconds = Clock::DateTime::get()->seconds();
+
+    // Big logs exceed the record size and are rare, occuring on boot and 
+    // restart. Those process inline to avoid truncation.
+    if (!this->async.load() || bigLog || this->queue == nullptr) {
+        this->dispatch(level, message, method, seconds, ignoreRepeat, bigLog);
+        return;
+    }
+
+    LogRecord rec;
+    rec.level = level;
+    rec.method = method;
+    rec.ignoreRepeat = ignoreRepeat;
+    rec.seconds = seconds;
+    rec.kind = LogKind::TEXT;
+    rec.len = 0;
+    snprintf(rec.msg, sizeof(rec.msg), "%s", message);
+
+    if (xQueueSend(this->queue, &rec, 0) != pdTRUE) { // Never wait.
+        this->dropped++; // Reported by the log task.
+    }
+}
+
+// Requires the level, sending method, format ID, and packed arguments, see
+// handleFmt(). Encodes the binary entry and queues it as handle() does. If 
+// LOG_BINARY is false, renders the entry and logs it as text.
+void MsgLogHandler::handleBin(Levels level, Method method, LogFmt fmt,
+    const LogArgs &args) {
+
+    LogRecord rec;
+    rec.level = level;
+    rec.method = method;
+    rec.ignoreRepeat = false;
+    rec.seconds = Clock::DateTime::get()->seconds();
+    rec.kind = LogKind::BIN;
+    rec.len = LogCodec::encode(reinterpret_cast<uint8_t*>(rec.msg), 
+        sizeof(rec.msg), static_cast<uint8_t>(level), rec.seconds, fmt, args);
+
+    if (rec.len == 0) return; // Does not fit, args are bounded, never occurs.
+
+    if (!LOG_BINARY) { // Text mode, format now.
+        char msg[LOG_MAX_ENTRY];
+        LogCodec::format(reinterpret_cast<const uint8_t*>(rec.msg), rec.len,
+            msg, sizeof(msg));
+
+        this->handle(level, msg, method);
+        return;
+    }
+
+    if (!this->async.load() || this->queue == nullptr) {
+        this->dispatchBin(reinterpret_cast<const uint8_t*>(rec.msg), rec.len,
+            method);
+
+        return;
+    }
+
+    if (xQueueSend(this->queue, &rec, 0) != pdTRUE) { // Never wait.
+        this->dropped++; // Reported by the log task.
+    }
+}
+
+// Requires the ticks to wait for the first record. Blocks up to wait for a
+// record, then processes all queued records up to LOG_DRAIN_MAX. WARNING.
+// Requires drainMtx, so records are dispatched in order by one drainer. 
+// Returns the quantity processed.
+size_t MsgLogHandler::process(TickType_t wait) {
+    if (this->queue == nullptr) return 0;
+
+    LogRecord rec;
+    size_t processed = 0;
+
+    while (processed < LOG_DRAIN_MAX) {
+
+        // Only wait for the first record, then take what is available.
+        if (xQueueReceive(this->queue, &rec, (processed == 0) ? wait : 0) 
+            != pdTRUE) break;
+
+        if (rec.kind == LogKind::BIN) {
+            this->dispatchBin(reinterpret_cast<const uint8_t*>(rec.msg), 
+                rec.len, rec.method);
+        } else {
+            this->dispatch(rec.level, rec.msg, rec.method, rec.seconds, 
+                rec.ignoreRepeat, false);
+        }
+
+        processed++;
+    }
+
+    return processed;
+}
+
+// Requires the ticks to wait for the first record. WARNING. Must only be 
+// called by the log task. Enables async logging on the first call. Blocks 
+// up to wait for a record, without holding drainMtx, then processes all 
+// queued records up to the LOG_DRAIN_MAX, and logs any drops. Returns the 
+// quantity processed.
+size_t MsgLogHandler::drain(TickType_t wait) {
+    if (this->queue == nullptr) return 0;
+
+    this->async.store(true); // Callers queue from here on.
+
+    LogRecord rec; // Left queued, process() takes it in order.
+    xQueuePeek(this->queue, &rec, wait);
+
+    Threads::MutexLock guard(MsgLogHandler::drainMtx);
+    if (!guard.LOCK()) return 0; // sync() is draining.
+
+    size_t processed = this->process(0);
+    this->reportDrops();
+    this->reportRepeats();
+    return processed;
+}
+
+// Requires no params. Processes every queued record without waiting, logs
+// any drops, and writes the journal batch to flash. Call prior to a 
+// deliberate restart, keeping the final entries in the journal. Holds 
+// drainMtx, so the log task does not drain concurrently, which would 
+// reorder records in the journal.
+void MsgLogHandler::sync() {
+    {
+        Threads::MutexLock guard(MsgLogHandler::drainMtx);
+
+        if (guard.LOCK()) {
+
+            // Bounded, since other tasks may keep queueing while draining.
+            for (size_t i = 0; i < LOG_QUEUE_DEPTH; i++) {
+                if (this->process(0) < LOG_DRAIN_MAX) break; // Empty.
+            }
+
+            this->reportDrops();
+        }
+    }
+
+    LogJournal::get()->flush(true);
+}
+
+// Requires the tag and level. Sets the runtime level of the tag, entries
+// below which are discarded. Returns true if set, false if out of range.
+bool MsgLogHandler::setTagLevel(LogTag tag, Levels level) {
+    if (tag >= LogTag::COUNT || level > Levels::CRITICAL) return false;
+
+    this->tagLevels[static_cast<size_t>(tag)].store(
+        static_cast<uint8_t>(level));
+
+    return true;
+}
+
+// Requires the tag. Returns its runtime level, DEBUG if out of range.
+Levels MsgLogHandler::getTagLevel(LogTag tag) const {
+    if (tag >= LogTag::COUNT) return Levels::DEBUG;
+    return static_cast<Levels>(
+        this->tagLevels[static_cast<size_t>(tag)].load());
+}
+
+// Requires no params. Returns the total quantity of log records dropped due
+// to a full queue since boot.
+uint32_t MsgLogHandler::getDropped() {return this->dropped.load();}
+
 // Requires no parameters. Returns true if new log available. Used to
 // alert client that a new log entry is available to avoid constant polling
 // of data.
@@ -506,27 +679,57 @@ void MsgLogHandler::resetNewLogFlag() {
     }
 }
 
-// Param data is def to nullptr. If mtx is unlocked, sets to empty string and
-// returns empty string. If locked, sets data to and returns log.
-// WARNING. If data is passed as a local var pointer, ensure that the size is
-// 16384, as this is the log size.
-const char* MsgLogHandler::getLog(char* data) {
+// Requires data buffer, its size, and the sequence number to begin at, 0
+// to begin at the oldest entry. Optionally the sequence number to end 
+// before, default unbounded. Renders as many whole entries as fit into 
+// data, in the format entry1;entry2;...;entryn; and sets seq to the sequence
+// number following the last entry rendered. Call repeatedly, passing seq
+// back, to page through the full log without holding the mutex throughout.
+// Returns bytes written, 0 once complete or if the mutex is locked.
+size_t MsgLogHandler::getLog(char* data, size_t size, uint32_t &seq,
+    uint32_t end) {
 
-    static const char safeEmpty[] = "";
+    if (data == nullptr || size == 0) return 0;
 
     Threads::MutexLock guard(MsgLogHandler::mtx);
 
     if (!guard.LOCK()) {
-        if (data != nullptr) data[0] = '\0';
-        return safeEmpty;
+        data[0] = '\0';
+        return 0;
     }
 
-    // Locked
-    if (data != nullptr) {
-        memcpy(data, this->log, sizeof(this->log));
+    return this->log.render(data, size, seq, end);
+}
+
+// Requires first and next references. Sets first to the sequence number of
+// the oldest entry held, and next to the sequence number the next entry 
+// will be assigned. Entries first through next - 1 are available. Used by
+// clients to retrieve only entries newer than their cursor. Returns true if
+// set, false if the mutex is locked.
+bool MsgLogHandler::getLogSeq(uint32_t &first, uint32_t &next) {
+    Threads::MutexLock guard(MsgLogHandler::mtx);
+    if (!guard.LOCK()) return false;
+
+    first = this->log.getFirstSeq();
+    next = this->log.getNextSeq();
+    return true;
+}
+
+// Requires data buffer and its size. Renders the newest whole entries that
+// fit into data, in the same format as getLog(). Returns bytes written, 0 if
+// empty or if the mutex is locked.
+size_t MsgLogHandler::getLogTail(char* data, size_t size) {
+
+    if (data == nullptr || size == 0) return 0;
+
+    Threads::MutexLock guard(MsgLogHandler::mtx);
+
+    if (!guard.LOCK()) {
+        data[0] = '\0';
+        return 0;
     }
 
-    return this->log;
+    return this->log.renderTail(data, size);
 }
 
 // Requires reference to OLED object. This function is to allow additon of 
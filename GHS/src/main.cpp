@@ -185,6 +185,7 @@
 #include "Drivers/SSD1306_Library.hpp" 
 #include "UI/Display.hpp"
 #include "UI/MsgLogHandler.hpp"
+#include "UI/LogJournal.hpp"
 #include "Common/Timing.hpp"
 #include "Threads/Threads.hpp"
 #include "Threads/ThreadParameters.hpp"
@@ -205,6 +206,8 @@
 #include "Drivers/AS7341/AS7341_Library.hpp" 
 #include "Peripherals/Relay.hpp"
 #include "Peripherals/saveSettings.hpp"
+#include "Peripherals/TimeSeries.hpp"
+#include "Peripherals/Checkpoint.hpp"
 #include "Drivers/ADC.hpp"
 #include "esp_log.h"
 
@@ -269,6 +272,16 @@ Threads::soilThreadParams soilParams(SOIL_FRQ, soil);
 Threads::Thread routineThread("routineThread");
 Threads::routineThreadParams routineParams(ROUTINE_FRQ, relays, TOTAL_RELAYS);
 
+// Drains the log queue, fanning out to serial, log, OLED, and UDP. Not
+// suspended during OTA, to keep logging the update.
+Threads::Thread logThread("logThread");
+Threads::logThreadParams logParams(LOG_FRQ);
+
+// Executes socket commands and pushes, off of the httpd task. Not suspended
+// during OTA, to keep answering socket clients.
+Threads::Thread sktThread("sktThread");
+Threads::sktThreadParams sktParams(SKT_FRQ);
+
 Threads::Thread* toSuspend[TOTAL_THREADS] = {&SHTThread, &lightThread, 
     &soilThread, &routineThread};
 
@@ -279,9 +292,12 @@ static StackType_t shtStack[SHT_STACK];
 static StackType_t lightStack[LIGHT_STACK];
 static StackType_t soilStack[SOIL_STACK];
 static StackType_t routineStack[ROUTINE_STACK];
+static StackType_t logStack[LOG_STACK];
+static StackType_t sktStack[SKT_STACK];
 
 // Create Task Control Blocks (TCB) for each thread stack.
-static StaticTask_t netTCB, shtTCB, lightTCB, soilTCB, routineTCB;
+static StaticTask_t netTCB, shtTCB, lightTCB, soilTCB, routineTCB, logTCB,
+    sktTCB;
 
 // OTA 
 OTA::OTAhandler ota(OLED, station, toSuspend, TOTAL_THREADS); 
@@ -291,6 +307,10 @@ void app_main() {
 
     Messaging::MsgLogHandler::get()->addOLED(OLED);
 
+    // Index the flash log journal and set the boot number, before the bulk
+    // of the boot entries are written. Logs its own errors.
+    Messaging::LogJournal::get()->begin();
+
     char log[30] = {0}; // Used for logging, size accomodates all msging.
     Messaging::Levels msgType[] = { // Used for mounting and init, with log.
         Messaging::Levels::CRITICAL, Messaging::Levels::INFO
@@ -337,6 +357,16 @@ void app_main() {
     Messaging::MsgLogHandler::get()->handle(msgType[spiffs == ESP_OK],
             log, Messaging::Method::SRL_LOG);
 
+    // Restores the compressed sensor history saved to spiffs, prior to the
+    // sensor threads recording. Logs its own result.
+    Peripheral::TimeSeries::get()->restore(
+        Messaging::LogJournal::get()->getBoot());
+
+    // Loads the checkpoint of the sensor averages and trends, copied by each
+    // sensor upon creation by its thread. Logs its own result.
+    Peripheral::Checkpoint::get()->begin(
+        Messaging::LogJournal::get()->getBoot());
+
     // Checks partition upon boot to ensure that it is valid by matching
     // the signature with the firmware running. If invalid, the program
     // will not continue.
@@ -362,10 +392,17 @@ void app_main() {
 
     // Start threads, and init periph. Must occur before loading settings
     // due to initialized periph params before calling the get(), to prevent
-    // nullptr return.
+    // nullptr return. The log thread starts first, with the lowest priority,
+    // taking logging off of the calling threads from here on.
+    logThread.initThread(ThreadTask::logTask, LOG_STACK, &logParams, 1,
+        logStack, logTCB, 0);
+
     netThread.initThread(ThreadTask::netTask, NET_STACK, &netParams, 1,
         netStack, netTCB, 0);
 
+    sktThread.initThread(ThreadTask::sktTask, SKT_STACK, &sktParams, 2,
+        sktStack, sktTCB, 0);
+
     SHTThread.initThread(ThreadTask::SHTTask, SHT_STACK, &SHTParams, 2,
         shtStack, shtTCB, 1);
 
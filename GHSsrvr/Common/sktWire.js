@@ -0,0 +1,178 @@
+// ATTENTION. Decodes the binary GET_ALL and GET_TRENDS replies of the esp32,
+// requested with SKT_FMT_BIN in the supp data, and the GET_HISTORY reply.
+// Ensure the layout matches the structs and SKT_WIRE_VERSION on
+// socketWire.hpp. Replies decode to the same keys and rounding as the JSON
+// replies, little endian.
+
+const tsCodec = require("./tsCodec");
+
+const SKT_FMT_BIN = 0x100; // Supp flag requesting the binary reply.
+const WIRE_VERSION = 1;
+const WIRE_HDR_SIZE = 6;
+const WIRE_TYPE = {"ALL": 1, "TRENDS": 2, "HISTORY": 3};
+
+// Order of the colors within WireAll, each keyed as the JSON.
+const COLORS = ["violet", "indigo", "blue", "cyan", "green", "yellow",
+    "orange", "red", "nir", "clear"];
+
+// Order of the trend arrays following the hour count.
+const TRENDS = [["temp", "f32"], ["hum", "f32"], ["clear", "u16"],
+    ["violet", "u16"], ["indigo", "u16"], ["blue", "u16"], ["cyan", "u16"],
+    ["green", "u16"], ["yellow", "u16"], ["orange", "u16"], ["red", "u16"],
+    ["nir", "u16"], ["photo", "i16"], ["soil_0", "i16"], ["soil_1", "i16"],
+    ["soil_2", "i16"], ["soil_3", "i16"]];
+
+// Sequential little endian reader of a Buffer.
+const Reader = function(buf, pos) {
+    this.buf = buf;
+    this.pos = pos;
+
+    const read = (fn, size) => () => {
+        const val = this.buf[fn](this.pos);
+        this.pos += size;
+        return val;
+    };
+
+    this.u8 = read("readUInt8", 1);
+    this.u16 = read("readUInt16LE", 2);
+    this.u32 = read("readUInt32LE", 4);
+    this.i16 = read("readInt16LE", 2);
+    this.i32 = read("readInt32LE", 4);
+    this.f32 = read("readFloatLE", 4);
+
+    this.str = (size) => {
+        const end = this.buf.indexOf(0, this.pos);
+        const len = (end < 0 || end > this.pos + size) ? size : end - this.pos;
+        const val = this.buf.toString("latin1", this.pos, this.pos + len);
+        this.pos += size;
+        return val;
+    };
+
+    return this;
+}
+
+// Requires the value and decimals. Rounds as the JSON format string.
+const fixed = (val, dec) => Number(val.toFixed(dec));
+
+// Requires the reader. Decodes WireAll into the GET_ALL JSON keys.
+const decodeAll = function(rd, out) {
+    out.firmv = rd.str(12);
+    out.newLog = rd.u8();
+    out.netMode = rd.u8();
+    out.sysTime = rd.u32();
+    out.hhmmss = `${rd.u8()}:${rd.u8()}:${rd.u8()}`;
+    out.day = rd.u8();
+    out.timeCalib = rd.u8();
+
+    for (let i = 0; i < 4; i++) {
+        out[`re${i}`] = rd.u8();
+        out[`re${i}TimerEn`] = rd.u8();
+        out[`re${i}TimerOn`] = rd.u32();
+        out[`re${i}TimerOff`] = rd.u32();
+        out[`re${i}Days`] = rd.u8();
+        out[`re${i}Qty`] = rd.u8();
+        out[`re${i}Man`] = rd.u8();
+    }
+
+    ["temp", "hum"].forEach(key => {
+        out[key] = fixed(rd.f32(), 2);
+        out[`${key}Re`] = rd.u8();
+        out[`${key}ReCond`] = rd.u8();
+        out[`${key}ReVal`] = rd.i32();
+        out[`${key}AltCond`] = rd.u8();
+        out[`${key}AltVal`] = rd.i32();
+    });
+
+    out.SHTH = fixed(rd.f32(), 2);
+    out.SHTRdOK = rd.u8();
+    out.tempAvg = fixed(rd.f32(), 1);
+    out.humAvg = fixed(rd.f32(), 1);
+    out.tempAvgPrev = fixed(rd.f32(), 1);
+    out.humAvgPrev = fixed(rd.f32(), 1);
+
+    for (let i = 0; i < 4; i++) {
+        out[`soil${i}`] = rd.i16();
+        out[`soil${i}AltCond`] = rd.u8();
+        out[`soil${i}AltVal`] = rd.i32();
+        out[`soil${i}H`] = fixed(rd.f32(), 2);
+        out[`soil${i}RdOK`] = rd.u8();
+    }
+
+    COLORS.forEach(color => out[color] = rd.u16());
+    out.photo = rd.i32();
+    COLORS.forEach(color => out[`${color}Avg`] = fixed(rd.f32(), 1));
+    out.photoAvg = fixed(rd.f32(), 1);
+    COLORS.forEach(color => out[`${color}AvgPrev`] = fixed(rd.f32(), 1));
+    out.photoAvgPrev = fixed(rd.f32(), 1);
+
+    out.photoRdOK = rd.u8();
+    out.specRdOK = rd.u8();
+    out.photoH = fixed(rd.f32(), 2);
+    out.specH = fixed(rd.f32(), 2);
+    out.lightRe = rd.u8();
+    out.lightReCond = rd.u8();
+    out.lightReVal = rd.u16();
+    out.lightDur = rd.u32();
+    out.darkVal = rd.u16();
+    out.atime = rd.u8();
+    out.astep = rd.u16();
+    out.again = rd.u8();
+}
+
+// Requires the reader. Decodes the trends into the GET_TRENDS JSON keys.
+const decodeTrends = function(rd, out) {
+    const hours = rd.u8();
+
+    TRENDS.forEach(([key, type]) => {
+        out[key] = [];
+
+        for (let i = 0; i < hours; i++) {
+            const val = rd[type]();
+            out[key].push(type === "f32" ? fixed(val, 1) : val);
+        }
+    });
+}
+
+// Requires the reader. Decodes WireHistory and its blocks into {firstSeq,
+// nextSeq, ch, blocks}, each block {seq, boot, rows}, see tsCodec.js. The
+// newest block, nextSeq - 1, is open and grows until sealed.
+const decodeHistory = function(rd, out) {
+    out.firstSeq = rd.u32();
+    out.nextSeq = rd.u32();
+    out.ch = tsCodec.names;
+    out.blocks = [];
+
+    for (let qty = rd.u8(); qty > 0; qty--) {
+        const seq = rd.u32();
+        const len = rd.u16();
+
+        out.blocks.push({seq, ...tsCodec.decodeBlock(rd.buf, rd.pos)});
+        rd.pos += len;
+    }
+}
+
+// Requires the binary message Buffer. Returns the reply object, keyed as the
+// JSON reply of the same command. Throws if the version, type, or length
+// does not match.
+const decode = function(buf) {
+    if (buf.length < WIRE_HDR_SIZE) throw("Wire reply too short");
+
+    const rd = new Reader(buf, 0);
+    const version = rd.u8();
+    const type = rd.u8();
+    const out = {"id": rd.u16()};
+    const len = rd.u16();
+
+    if (version !== WIRE_VERSION) throw(`Wire version ${version} unsupported`);
+    if (buf.length !== WIRE_HDR_SIZE + len) throw("Wire reply length mismatch");
+
+    if (type === WIRE_TYPE.ALL) decodeAll(rd, out);
+    else if (type === WIRE_TYPE.TRENDS) decodeTrends(rd, out);
+    else if (type === WIRE_TYPE.HISTORY) decodeHistory(rd, out);
+    else throw(`Wire type ${type} unsupported`);
+
+    if (rd.pos !== buf.length) throw("Wire reply layout mismatch");
+    return out;
+}
+
+module.exports = {SKT_FMT_BIN, decode};
@@ -7,13 +7,33 @@ const CMDS = [
     "RELAY_CTRL", "RELAY_TIMER", "RELAY_TIMER_DAY", "ATTACH_RELAYS", 
     "SET_TEMPHUM", "SET_SOIL", "SET_LIGHT", "SET_SPEC_INTEGRATION_TIME", 
     "SET_SPEC_GAIN", "CLEAR_AVERAGES", "CLEAR_AVG_SET_TIME", 
-    "SAVE_AND_RESTART", "GET_TRENDS"
+    "SAVE_AND_RESTART", "GET_TRENDS", "GET_LOG_SINCE",
+    "SET_LOG_LEVEL", "SUBSCRIBE", "GET_DELTA", "BATCH", "GET_SESSIONS",
+    "GET_LOAD", "GET_HISTORY", "GET_STATS"
 ];
 
+// Response id of GET_ALL data pushed by the esp32 to subscribed sockets,
+// outside of the 0 - 255 range of requests. SKT_PUSH_ID on socketHandler.hpp.
+const SKT_PUSH_ID = 256;
+
+// Max commands per BATCH frame. SKT_BATCH_MAX on socketHandler.hpp.
+const SKT_BATCH_MAX = 16;
+
+// Resolutions of GET_TRENDS, SKT_TREND_RES_SHIFT on socketHandler.hpp. POINT
+// replies with the hourly readings, the rest with the min/max/mean/count of
+// each bucket of the tier.
+const SKT_TREND_RES = {"POINT": 0, "MINUTE": 1, "QUARTER": 2, "HOUR": 3,
+    "DAY": 4};
+
+// Requires the SKT_TREND_RES key, and quantity of hours or buckets. Returns
+// the GET_TRENDS supp data.
+const trendSupp = (res, qty) => (SKT_TREND_RES[res] << 12) | (qty & 0xFF);
+
 // Iterate each CMD, populate SKT_CMD and add 1 to the index value to match
 // he enumeration in the esp32.
 CMDS.forEach((CMD, idx) => {
     SKT_CMD[CMD] = idx+1;
 });
 
-module.exports = {SKT_CMD};
\ No newline at end of file
+module.exports = {SKT_CMD, SKT_PUSH_ID, SKT_BATCH_MAX, SKT_TREND_RES,
+    trendSupp};
\ No newline at end of file
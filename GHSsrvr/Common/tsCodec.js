@@ -0,0 +1,147 @@
+// ATTENTION. Decodes the compressed minute history blocks of the esp32,
+// received through GET_HISTORY. Ensure the channel table, TS_CODEC_VERSION,
+// and the bitstream match TSCodec.hpp and TSCodec.cpp on the esp32. Each
+// block is a 12 byte little endian header, then a bitstream, MSB first.
+
+const TS_CODEC_VERSION = 1;
+const TS_HDR_SIZE = 12;
+const TS_CODE_MAX = 0xFFFF;
+const TS_CHAN_BITS = 5;
+
+// Channels in order, [name, offset, scale, decimals], see TSCodec::info.
+const CHANNELS = [["temp", -40, 100, 2], ["hum", 0, 100, 2],
+    ["clear", 0, 1, 0], ["violet", 0, 1, 0], ["indigo", 0, 1, 0],
+    ["blue", 0, 1, 0], ["cyan", 0, 1, 0], ["green", 0, 1, 0],
+    ["yellow", 0, 1, 0], ["orange", 0, 1, 0], ["red", 0, 1, 0],
+    ["nir", 0, 1, 0], ["photo", 0, 1, 0], ["soil_0", 0, 1, 0],
+    ["soil_1", 0, 1, 0], ["soil_2", 0, 1, 0], ["soil_3", 0, 1, 0]];
+
+const CLEAR = 2, PHOTO = 12; // Channels sharing the light of CLEAR.
+const DOD_BITS = [0, 7, 9, 12, 32]; // By leading 1 bits, up to 4.
+
+// MSB first reader of a Buffer, limited to len bits.
+const BitReader = function(buf, pos, len) {
+    this.buf = buf;
+    this.start = pos * 8;
+    this.pos = 0;
+    this.len = len;
+
+    // Requires the width, 1 - 32. Returns the value, throws if exceeding.
+    this.get = (bits) => {
+        if (this.pos + bits > this.len) throw("History block truncated");
+        let val = 0;
+
+        for (let i = 0; i < bits; i++, this.pos++) {
+            const at = this.start + this.pos;
+            val = val * 2 + ((this.buf[at >> 3] >> (7 - (at & 7))) & 1);
+        }
+
+        return val;
+    };
+
+    return this;
+}
+
+const unzigzag = (zz) => (zz % 2) ? -(zz + 1) / 2 : zz / 2;
+
+// Prediction of a channel, see TSTrend and TSCodec::trend* on the esp32.
+const trendStart = (code) => ({"pos": code * 16, "slope": 0,
+    "anchor": code, "since": 0});
+
+const trendPredict = (t) => {
+    const pred = (t.pos + t.slope + 8) >> 4;
+    return Math.min(Math.max(pred, 0), TS_CODE_MAX);
+}
+
+const trendUpdate = (t, code) => {
+    if (code === trendPredict(t)) {
+        t.pos = Math.min(Math.max(t.pos + t.slope, 0), TS_CODE_MAX * 16);
+        if (t.since < 0xFFFF) t.since++;
+        return;
+    }
+
+    t.slope = Math.trunc(((code - t.anchor) * 16) / (t.since + 1));
+    t.pos = code * 16;
+    t.anchor = code;
+    t.since = 0;
+}
+
+// Requires the trends, channel, and the codes of the row prior to chan.
+// Returns the predicted code, see TSCodec::predict.
+const predict = (trends, chan, row) => {
+    const clr = trends[CLEAR];
+
+    if (chan <= CLEAR || chan > PHOTO || clr.pos < 16) {
+        return trendPredict(trends[chan]);
+    }
+
+    const pred = Math.floor((trends[chan].pos * row[CLEAR] +
+        Math.floor(clr.pos / 2)) / clr.pos);
+
+    return Math.min(pred, TS_CODE_MAX);
+}
+
+// Requires the block Buffer, and its offset. Returns {boot, rows}, each row
+// [runtime minute, values in the order of CHANNELS]. Throws if malformed.
+const decodeBlock = function(buf, pos) {
+    const version = buf.readUInt8(pos);
+    const chans = buf.readUInt8(pos + 1);
+    const boot = buf.readUInt16LE(pos + 2);
+    let minute = buf.readUInt32LE(pos + 4);
+    const rowQty = buf.readUInt16LE(pos + 8);
+    const bits = buf.readUInt16LE(pos + 10);
+
+    if (version !== TS_CODEC_VERSION || chans !== CHANNELS.length) {
+        throw(`History block version ${version} unsupported`);
+    }
+
+    const rd = new BitReader(buf, pos + TS_HDR_SIZE, bits);
+    const trends = [];
+    const rows = [];
+    let delta = 1;
+
+    for (let r = 0; r < rowQty; r++) {
+        const codes = new Array(CHANNELS.length).fill(0);
+
+        if (r === 0) { // Raw.
+            CHANNELS.forEach((ch, c) => {
+                codes[c] = rd.get(16);
+                trends.push(trendStart(codes[c]));
+            });
+
+        } else {
+            let prefix = 0;
+            while (prefix < 4 && rd.get(1) === 1) prefix++;
+
+            delta += prefix > 0 ? unzigzag(rd.get(DOD_BITS[prefix])) : 0;
+            minute += delta;
+
+            const diff = new Array(CHANNELS.length).fill(0);
+
+            while (rd.get(1) === 1) { // Codes differing from prediction.
+                const chan = rd.get(TS_CHAN_BITS);
+                const width = rd.get(1) === 0 ? 4 : (rd.get(1) ? 17 : 8);
+
+                if (chan >= CHANNELS.length) throw("History block malformed");
+                diff[chan] = unzigzag(rd.get(width) + 1);
+            }
+
+            CHANNELS.forEach((ch, c) => {
+                codes[c] = (predict(trends, c, codes) + diff[c]) & 0xFFFF;
+            });
+
+            CHANNELS.forEach((ch, c) => trendUpdate(trends[c], codes[c]));
+        }
+
+        rows.push([minute, ...codes.map((code, c) => {
+            const [name, offset, scale, dec] = CHANNELS[c];
+            return Number((code / scale + offset).toFixed(dec));
+        })]);
+    }
+
+    return {boot, rows};
+}
+
+const names = CHANNELS.map(ch => ch[0]);
+
+module.exports = {decodeBlock, names};
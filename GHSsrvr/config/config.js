@@ -27,6 +27,7 @@ const config = {
 
     // Polling data 
     POLL_FREQ: 1000, // polls each device at this interval accumulating data.
+    PUSH_FREQ_S: 1, // Seconds between pushed data when subscribed, no poll.
     POLL_SKT_PORT: 51004, // Port to reply to with polling data from esp.
     RE_INIT_SKT_DELTA: 5000, // If no comm in n ms, restart web socket to esp.
 
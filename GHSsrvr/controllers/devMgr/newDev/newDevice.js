@@ -1,5 +1,7 @@
-const {manageSocket, updateDev, sktSend, poll, startPoll, stopPoll, 
-    clearAvgs} = require("../newDev/newDevice.methods");
+const {manageSocket, updateDev, sktSend, poll, subscribe, startPoll, 
+    stopPoll, clearAvgs, sktBatch, getSeries, getHistory,
+    getStats} =
+    require("../newDev/newDevice.methods");
 
 const {devMap} = require("../config.devMgr");
 
@@ -25,6 +27,8 @@ const newDevice = function (devData, ip) {
     this.pollInt = null; // Polling interval
     this.devSysData = {}; // This will store the most current allData string
                           // from the esp device as JS object once parsed.
+    this.deltaVer = 0; // Version of devSysData, sent with GET_DELTA.
+    this.busyUntil = 0; // Millis polling resumes, once the esp replied busy.
 
     // All averages for each sensor. Soil uses an array, since its data is
     // equal and there are 4 sensors. WARNING, ensure that the keys match
@@ -52,9 +56,14 @@ const newDevice = function (devData, ip) {
     this.updateDev = updateDev;
     this.sktSend = sktSend;
     this.poll = poll;
+    this.subscribe = subscribe;
     this.startPoll = startPoll;
     this.stopPoll = stopPoll;
     this.clearAvgs = clearAvgs;
+    this.sktBatch = sktBatch;
+    this.getSeries = getSeries;
+    this.getHistory = getHistory;
+    this.getStats = getStats;
     
     // Establish socket immediately upon creation
     this.manageSocket();
@@ -1,8 +1,9 @@
 const WebSocket = require('ws');
 const {handleResponse, getID} = require("../sktHand/sktHand");
-const {getAll} = require("../sktHand/sktHand.callbacks");
+const {getDelta} = require("../sktHand/sktHand.callbacks");
 const {config} = require("../../../config/config");
-const {SKT_CMD} = require("../../../Common/socketCmds");
+const {SKT_CMD, SKT_BATCH_MAX, trendSupp} =
+    require("../../../Common/socketCmds");
 
 // Manages web socket connection between this server acting as a client, to
 // the esp32 device socket server.
@@ -31,17 +32,18 @@ const manageSocket = function() {
     // web socket.
     this.ws.on("open", () => {
         console.log(`WS connection @ ${this.ip} OPEN`);
-        this.startPoll(); // Start polling once socket is open.
+        this.subscribe(); // Pushed data once socket is open, else polls.
     });
 
-    this.ws.on("message", (msg) => {
-        handleResponse(this.mDNS, msg); // Pass devMap key, and message.
+    this.ws.on("message", (msg, isBinary) => {
+        handleResponse(this.mDNS, msg, isBinary); // Pass devMap key, and msg.
     });
 
     this.ws.on("close", () => {
         console.log(`WS connection @ ${this.ip} CLOSED`);
         this.ws = null;
         this.isUp = false;
+        this.deltaVer = 0; // Next data includes all fields.
         this.stopPoll(); // Stops polling upon socket close.
     });
 
@@ -91,19 +93,101 @@ const sktSend = function(msg) {
     }
 }
 
-// Requires no params. Polls data from esp device and updates class instance
-// devSysData{} to match that of the esp. 
+// Requires no params. Polls data changed since the previous poll from esp 
+// device and updates class instance devSysData{} to match that of the esp. 
 const poll = function() {
 
+    // The esp replied busy, skips polls until its retry after has passed.
+    if (Date.now() < this.busyUntil) return;
+
     const params = this.mDNS; // Key for devMap.
-    const {id, promise} = getID(getAll, params, null);
+    const {id, promise} = getID(getDelta, params, null);
 
-    promise.catch(err => console.error(err));
+    promise.catch(err => {
+        if (err.retryMs) this.busyUntil = Date.now() + err.retryMs;
+        else console.error(err);
+    });
 
-    const msg = `${SKT_CMD["GET_ALL"]}/0/${id}`;
+    const msg = `${SKT_CMD["GET_DELTA"]}/${this.deltaVer}/${id}`;
     this.sktSend(msg);
 }
 
+// Requires no params. Subscribes to the data pushed by the esp upon each
+// sensor read cycle, replacing polling. Polls instead if the subscription is
+// refused or unanswered.
+const subscribe = function() {
+
+    const {id, promise} = getID(null, null, null);
+
+    promise.catch(err => {
+        console.error(`Subscribe ${this.name} failed, polling:`, err);
+        this.startPoll();
+    });
+
+    const msg = `${SKT_CMD["SUBSCRIBE"]}/${config.PUSH_FREQ_S}/${id}`;
+    if (!this.sktSend(msg)) this.startPoll();
+}
+
+// Requires an array of commands, each {cmd, supp, CB, params, KVobj} with cmd
+// the SKT_CMD key, and the rest as getID(). Sends the commands as BATCH 
+// frames of up to SKT_BATCH_MAX, executed in order by the esp, which replies
+// once per frame. Commands with large replies, such as GET_ALL, are refused
+// by the esp. Returns a promise resolving once every command succeeds, or
+// rejecting upon the first failure or timeout.
+const sktBatch = function(cmds) {
+    const promises = [];
+
+    for (let i = 0; i < cmds.length; i += SKT_BATCH_MAX) {
+        const chunk = cmds.slice(i, i + SKT_BATCH_MAX);
+        const batch = getID(null, null, null);
+        let msg = `${SKT_CMD["BATCH"]}/${chunk.length}/${batch.id}/`;
+
+        chunk.forEach(({cmd, supp, CB = null, params = null, KVobj = null}) => {
+            const {id, promise} = getID(CB, params, KVobj);
+            msg += `${SKT_CMD[cmd]}/${supp}/${id}/`;
+            promises.push(promise);
+        });
+
+        batch.promise.catch(err => console.error(err));
+        this.sktSend(msg);
+    }
+
+    return Promise.all(promises);
+}
+
+// Requires the SKT_TREND_RES key, quantity of buckets, and callback receiving
+// the reply. Requests the aggregates of the newest qty buckets of the tier,
+// {res, ageMs, ch, b, qty}, see compileSeries on the esp. Returns the
+// promise of getID().
+const getSeries = function(res, qty, CB) {
+    const {id, promise} = getID(CB, null, null);
+    const msg = `${SKT_CMD["GET_TRENDS"]}/${trendSupp(res, qty)}/${id}`;
+    this.sktSend(msg);
+    return promise;
+}
+
+// Requires the first block sequence, and callback receiving the reply.
+// Requests the compressed minute history from seq on, {firstSeq, nextSeq,
+// ch, blocks}, as many blocks as fit a reply, see sktWire.js. Page by
+// requesting the seq following the last block received. Returns the
+// promise of getID().
+const getHistory = function(seq, CB) {
+    const {id, promise} = getID(CB, null, null);
+    this.sktSend(`${SKT_CMD["GET_HISTORY"]}/${seq}/${id}`);
+    return promise;
+}
+
+// Requires the window bitmask, bit 0 for 5 minutes, 1 for 1 hour, 2 for 24
+// hours, 0 for all, and callback receiving the reply. Requests the rolling
+// statistics of every channel, {id, ch, w:[{secs, s}]}, each of s the
+// [count, mean, stdev, min, max, ema] of a channel, or null if it has no
+// readings, see compileStats on the esp. Returns the promise of getID().
+const getStats = function(wins, CB) {
+    const {id, promise} = getID(CB, null, null);
+    this.sktSend(`${SKT_CMD["GET_STATS"]}/${wins}/${id}`);
+    return promise;
+}
+
 // Requires no params. Starts polling esp at set interval of 1 Hz freq.
 const startPoll = function() {
 
@@ -152,5 +236,6 @@ const clearAvgs = function() {
     });
 }
 
-module.exports = {manageSocket, updateDev, sktSend, poll, startPoll, stopPoll,
-    clearAvgs};
\ No newline at end of file
+module.exports = {manageSocket, updateDev, sktSend, poll, subscribe, startPoll,
+    stopPoll, clearAvgs, sktBatch, getSeries, getHistory,
+    getStats};
\ No newline at end of file
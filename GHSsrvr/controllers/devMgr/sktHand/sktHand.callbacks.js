@@ -13,4 +13,16 @@ const getAll = function(response, mdnsKey) {
 
 
 
-module.exports = {getAll};
\ No newline at end of file
+// Requires the GET_DELTA response, holding only the fields changed since the
+// device's deltaVer, or all fields if full, and the devMap key. Merges the 
+// fields into devSysData, and runs the handlers as getAll() does.
+const getDelta = function(response, mdnsKey) {
+    const dev = devMap[mdnsKey];
+    if (response.full === 1) dev.devSysData = {};
+    dev.deltaVer = response.ver;
+
+    ["id", "ver", "full"].forEach(key => delete response[key]);
+    getAll(Object.assign(dev.devSysData, response), mdnsKey);
+}
+
+module.exports = {getAll, getDelta};
\ No newline at end of file
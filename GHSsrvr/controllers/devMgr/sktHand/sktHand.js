@@ -1,6 +1,9 @@
 const { clearTimeout } = require("timers");
 const {config} = require("../../../config/config");
 const {devMap} = require("../config.devMgr");
+const {getDelta} = require("./sktHand.callbacks");
+const {SKT_PUSH_ID} = require("../../../Common/socketCmds");
+const {decode} = require("../../../Common/sktWire");
 const EventEmitter = require("events");
 const bus = new EventEmitter();
 
@@ -70,6 +73,10 @@ const getID = (CB = null, params = null, KVobj = null) => {
                     handleCallbacks(rMap, respOb);
                     resolve("OK");
                  
+                } else if (respOb.response.retryMs) { // Device busy.
+                    reject({"msg": "SKT BUSY", 
+                        "retryMs": respOb.response.retryMs});
+
                 } else { // Failure.
                     reject("SKT STATUS FAIL");
                 }
@@ -117,8 +124,9 @@ const handleCallbacks = (responseMap, responseOb) => {
 }
 
 // Requires the mdns, which is the key value used in devMap, to allow device
-// lookup, as well as the json message returned by the esp.
-const handleResponse = (mdnsKey, msg) => {
+// lookup, as well as the json message returned by the esp, and if the message
+// is binary, see sktWire.js.
+const handleResponse = (mdnsKey, msg, isBinary = false) => {
 
     // ATTENTION. The esp uses Async sockets, and this function is designed 
     // to run async as well. When a message is sent to the esp, it includes
@@ -131,16 +139,28 @@ const handleResponse = (mdnsKey, msg) => {
     
     let sktResp = null;
 
-    // All messages will be sent via JSON, check for accuracy in reply and
-    // parse message.
+    // All messages will be sent via JSON, unless the binary format was
+    // requested, check for accuracy in reply and parse message.
     try {
-        sktResp = JSON.parse(msg.toString());
+        sktResp = isBinary ? decode(msg) : JSON.parse(msg.toString());
 
     } catch (err) {
         console.error("Invalid skt resp from device:", err);
         return;
     }
 
+    dispatch(mdnsKey, sktResp);
+}
+
+// Requires the mdns, and the parsed socket response. Emits the response to
+// the promise awaiting its ID. A BATCH response emits each of its command
+// responses first, resolving the promise of each, then the batch itself.
+const dispatch = (mdnsKey, sktResp) => {
+
+    if (Array.isArray(sktResp.batch)) {
+        sktResp.batch.forEach(entry => dispatch(mdnsKey, entry));
+    }
+
     // If valid JSON response, populate the response ID to know which callback
     // functions to run.
     sktResp.id = Number(sktResp.id); // Explicitly convert to number.
@@ -149,6 +169,13 @@ const handleResponse = (mdnsKey, msg) => {
         return; // Block, will not be able to run correct function if NaN.
     }
 
+    // Pushed data to a subscribed socket, unrequested and has no promise.
+    // Handled as a polled GET_DELTA response.
+    if (sktResp.id === SKT_PUSH_ID) {
+        getDelta(sktResp, mdnsKey);
+        return;
+    }
+
     // Not all socket responses from the esp include a status, only those that
     // require a change. Polling data does not. This allows a status to default
     // to 1 if it is not included, bypassing future checks.